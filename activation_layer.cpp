@@ -28,6 +28,14 @@ namespace NeuralNetwork {
 
         return output;
     }
+
+
+    std::shared_ptr<Computation::Graph::Tensor> NeuralNetwork::ActivationFunctions::ReLU::doForward(std::shared_ptr<Computation::Graph::Tensor> input, Computation::Graph::InferenceTag _tag) noexcept{
+
+        Computation::Graph::TensorOp relu(Matrix::Operations::Unary::ReLU{});
+
+        return relu(_tag, input);
+    }
     
     std::shared_ptr<Computation::Graph::Tensor> NeuralNetwork::ActivationFunctions::SoftMax::doForward(std::shared_ptr<Computation::Graph::Tensor> input) noexcept{
 
@@ -42,6 +50,14 @@ namespace NeuralNetwork {
         return output;
     }
 
+
+    std::shared_ptr<Computation::Graph::Tensor> NeuralNetwork::ActivationFunctions::SoftMax::doForward(std::shared_ptr<Computation::Graph::Tensor> input, Computation::Graph::InferenceTag _tag) noexcept{
+
+        Computation::Graph::TensorOp softmax(Matrix::Operations::Unary::SoftMax{});
+
+        return softmax(_tag, input);
+    }
+
     
 
 
@@ -0,0 +1,113 @@
+#include "async_checkpoint.h"
+
+#include <assert.h>
+
+
+namespace NeuralNetwork {
+
+    namespace Serialization {
+
+
+        AsyncCheckpointer::AsyncCheckpointer(Sequential& _model, size_t _max_pending) noexcept :
+            flat(_model.flat_parameters() ? _model.flat_parameters() : _model.flatten()),
+            entries(_model.describe()),
+            modules(_model.modules()),
+            staging(_max_pending) {
+
+            assert(_max_pending > 0 && "At least one snapshot must be allowed in flight.");
+            assert(assign_offsets(entries) == flat->size() && "Flat buffer does not match the checkpoint layout.");
+
+            for (size_t b = _max_pending; b > 0; b--) free_buffers.push_back(b - 1);
+
+            writer = std::thread(&AsyncCheckpointer::_write, this);
+        }
+
+
+        AsyncCheckpointer::~AsyncCheckpointer() noexcept {
+
+            wait();
+
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                stopping = true;
+            }
+
+            work.notify_all();
+            writer.join();
+        }
+
+
+        void AsyncCheckpointer::save(const std::string& _path) noexcept {
+
+            size_t buffer;
+            {
+                std::unique_lock<std::mutex> guard(lock);
+                done.wait(guard, [this]() { return !free_buffers.empty(); });
+
+                buffer = free_buffers.back();
+                free_buffers.pop_back();
+            }
+
+            // Buffers are allocated on first use and then reused.
+            staging[buffer].resize(flat->size());
+            flat->snapshot(staging[buffer].data());
+
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                jobs.push_back(Job { _path, buffer });
+            }
+
+            work.notify_one();
+        }
+
+
+        void AsyncCheckpointer::wait() noexcept {
+            std::unique_lock<std::mutex> guard(lock);
+            done.wait(guard, [this]() { return free_buffers.size() == staging.size(); });
+        }
+
+
+        u_int64_t AsyncCheckpointer::completed() const noexcept {
+            std::lock_guard<std::mutex> guard(lock);
+            return writes;
+        }
+
+
+        u_int64_t AsyncCheckpointer::failed() const noexcept {
+            std::lock_guard<std::mutex> guard(lock);
+            return failures;
+        }
+
+
+        void AsyncCheckpointer::_write() noexcept {
+
+            while (true) {
+
+                Job job;
+                {
+                    std::unique_lock<std::mutex> guard(lock);
+                    work.wait(guard, [this]() { return stopping || !jobs.empty(); });
+
+                    if (jobs.empty()) return;
+
+                    job = std::move(jobs.front());
+                    jobs.pop_front();
+                }
+
+                const auto& snapshot = staging[job.buffer];
+                bool written = write_checkpoint(job.path, modules, entries, snapshot.data(), snapshot.size());
+
+                {
+                    std::lock_guard<std::mutex> guard(lock);
+                    (written ? writes : failures)++;
+                    free_buffers.push_back(job.buffer);
+                }
+
+                done.notify_all();
+            }
+        }
+
+
+    }
+
+}
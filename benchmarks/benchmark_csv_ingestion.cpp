@@ -0,0 +1,48 @@
+#include <iostream>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <random>
+
+#include "../include/matrix.h"
+#include "../include/csv.h"
+
+int main(void) {
+
+    std::cout << "[500000,32] CSV Ingestion Benchmark:" << std::endl << std::endl ;
+    std::cout << "..." << std::endl;
+
+    constexpr u_int64_t ROWS = 500000;
+    constexpr u_int64_t COLUMNS = 32;
+
+    const std::string path = (std::filesystem::temp_directory_path() / "wirikuta_benchmark.csv").string();
+
+    {
+        std::ofstream file(path);
+        std::mt19937 generator(0);
+        std::normal_distribution<float> normal(0, 1);
+
+        for (u_int64_t i = 0; i < ROWS; i++) {
+            for (u_int64_t c = 0; c < COLUMNS; c++) file << normal(generator) << (c + 1 < COLUMNS ? ',' : '\n');
+        }
+    }
+
+    const double megabytes = std::filesystem::file_size(path) / 1e6;
+
+    auto start = std::chrono::steady_clock::now();
+
+    NeuralNetwork::Data::CSVReader csv(path);
+    Matrix::Representation samples = Matrix::Representation(Matrix::Rows(csv.rows()), Matrix::Columns(csv.columns()));
+    bool valid = csv.read(samples);
+
+    auto end = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(end - start).count();
+
+    std::cout << (valid ? "" : "FAILED ") << megabytes << " MB in " << seconds * 1000 << " ms: "
+              << megabytes / seconds << " MB/sec." << std::endl;
+
+    std::remove(path.c_str());
+
+    return 0;
+}
@@ -0,0 +1,64 @@
+#include <iostream>
+#include <chrono>
+
+#include <cilk/cilk_api.h>
+
+#include "../include/matrix.h"
+#include "../include/generator.h"
+#include "../include/network_layer.h"
+#include "../include/activation_layer.h"
+#include "../include/data_parallel.h"
+#include "../include/optimizer.h"
+
+int main(void) {
+
+    std::cout << "[256,784] Minibatch MLP 784-128-10 Data Parallel Training Benchmark:" << std::endl << std::endl ;
+    std::cout << "..." << std::endl;
+
+    constexpr u_int64_t BATCH = 256;
+    constexpr int STEPS = 20;
+
+    using matrix_t = Matrix::Representation; 
+
+    auto build = [](NeuralNetwork::Sequential& model) {
+        model.add(std::make_unique<NeuralNetwork::Layer>(
+                std::make_unique<NeuralNetwork::MatrixMultiplyStep>(Matrix::Rows(784), Matrix::Columns(128)),
+                std::make_unique<NeuralNetwork::AddStep>(Matrix::Columns(128))));
+        model.add(std::make_unique<NeuralNetwork::ActivationFunctions::ReLU>());
+        model.add(std::make_unique<NeuralNetwork::Layer>(
+                std::make_unique<NeuralNetwork::MatrixMultiplyStep>(Matrix::Rows(128), Matrix::Columns(10)),
+                std::make_unique<NeuralNetwork::AddStep>(Matrix::Columns(10))));
+    };
+
+    matrix_t inputs = matrix_t(Matrix::Rows(BATCH), Matrix::Columns(784));
+    matrix_t labels = matrix_t(Matrix::Rows(BATCH), Matrix::Columns(10));
+    Matrix::Generation::Normal<0, 1> normal_distribution_init;
+
+    inputs = normal_distribution_init(inputs);
+    for (u_int64_t i = 0; i < BATCH; i++) labels.put(i, i % 10, 1);
+
+    const size_t max_workers = __cilkrts_get_nworkers();
+
+    for (size_t workers = 1; workers <= max_workers; workers *= 2) {
+
+        NeuralNetwork::Sequential model;
+        build(model);
+
+        NeuralNetwork::Training::DataParallel trainer(model, build, workers);
+        NeuralNetwork::Optimization::SGD sgd(model.flat_parameters(), 0.001f);
+
+        auto start = std::chrono::steady_clock::now();
+
+        for (int i = 0; i < STEPS; i++) {
+            trainer.step(inputs, labels);
+            sgd.step();
+        }
+
+        auto end = std::chrono::steady_clock::now();
+        double seconds = std::chrono::duration<double>(end - start).count();
+
+        std::cout << workers << " workers: " << BATCH * STEPS / seconds << " samples/sec." << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,92 @@
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include "../include/matrix.h"
+#include "../include/generator.h"
+#include "../include/m_algorithms.h"
+#include "../include/half_precision.h"
+
+int main(void) {
+
+    std::cout << "[1,4096] x [4096,4096] GEMV and 16M Element Add, fp32 vs bf16 / fp16 Storage:" << std::endl << std::endl ;
+    std::cout << "..." << std::endl;
+
+#if defined(__F16C__)
+    std::cout << "fp16 conversion: F16C" << std::endl;
+#else
+    std::cout << "fp16 conversion: bit manipulation (build with NATIVE=1 for F16C)" << std::endl;
+#endif
+
+    constexpr u_int64_t N = 4096;
+    constexpr u_int64_t ELEMENTS = 1 << 24;
+    constexpr int RUNS = 20;
+
+    Matrix::Generation::Normal<0, 1> normal_distribution_init;
+
+    Matrix::Representation W = Matrix::Representation(Matrix::Rows(N), Matrix::Columns(N));
+    W = normal_distribution_init(W);
+
+    Matrix::Representation x = Matrix::Representation(Matrix::Rows(1), Matrix::Columns(N));
+    x = normal_distribution_init(x);
+
+    Matrix::BFloat16Representation W_bf16 = Matrix::narrow<Matrix::bfloat16>(W);
+    Matrix::Float16Representation  W_fp16 = Matrix::narrow<Matrix::float16>(W);
+
+    // Best of RUNS in ms, and the bandwidth that streaming `bytes` in that time implies.
+    auto time = [](const char* name, u_int64_t bytes, auto&& kernel) {
+        double best = 1e30;
+        volatile float sink = 0;
+
+        for (int i = 0; i < RUNS; i++) {
+            auto start = std::chrono::steady_clock::now();
+            Matrix::Representation y = kernel();
+            best = std::min(best, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+            sink = y.constScanStart()[0];
+        }
+
+        std::cout << name << ": " << best << " ms, " << bytes / best / 1e6 << " GB/s of storage." << std::endl;
+        return best;
+    };
+
+    Matrix::Operations::Binary::Multiplication::ParallelDNC mul;
+
+    std::cout << std::endl << "GEMV, " << W.bytes() << " bytes of fp32 weights:" << std::endl;
+
+    time("fp32 ParallelDNC", W.bytes(), [&] { return mul(x, W); });
+
+    // The same row-streaming loop over fp32, the fair baseline for the widening kernels.
+    double fp32 = time("fp32 streaming", W.bytes(), [&] {
+        Matrix::Representation y = Matrix::Representation(Matrix::Rows(1), Matrix::Columns(N));
+        for (u_int64_t k = 0; k < N; k++) {
+            const float scale = x.constScanStart()[k];
+            const float* row = W.constScanStart() + k * N;
+            for (u_int64_t j = 0; j < N; j++) y.scanStart()[j] += scale * row[j];
+        }
+        return Matrix::Representation{std::move(y)};
+    });
+    double bf16 = time("bf16", W_bf16.bytes(), [&] { return Matrix::Operations::LowPrecision::multiply(x, W_bf16); });
+    double fp16 = time("fp16", W_fp16.bytes(), [&] { return Matrix::Operations::LowPrecision::multiply(x, W_fp16); });
+
+    std::cout << "Speedup: bf16 " << fp32 / bf16 << "x, fp16 " << fp32 / fp16 << "x." << std::endl;
+
+    Matrix::Representation a = Matrix::Representation(Matrix::Rows(ELEMENTS / N), Matrix::Columns(N));
+    Matrix::Representation b = Matrix::Representation(Matrix::Rows(ELEMENTS / N), Matrix::Columns(N));
+    a = normal_distribution_init(a);
+    b = normal_distribution_init(b);
+
+    Matrix::BFloat16Representation a_bf16 = Matrix::narrow<Matrix::bfloat16>(a);
+    Matrix::BFloat16Representation b_bf16 = Matrix::narrow<Matrix::bfloat16>(b);
+
+    Matrix::Operations::Binary::Addition::Std add;
+
+    std::cout << std::endl << "Add, two " << a.bytes() << " byte fp32 operands:" << std::endl;
+
+    fp32 = time("fp32 Addition::Std", 3 * a.bytes(), [&] { return add(a, b); });
+    bf16 = time("bf16 + bf16", 2 * a_bf16.bytes() + a.bytes(), [&] { return Matrix::Operations::LowPrecision::add(a_bf16, b_bf16); });
+
+    std::cout << "Speedup: bf16 " << fp32 / bf16 << "x." << std::endl;
+
+    return 0;
+}
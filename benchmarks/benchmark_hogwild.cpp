@@ -0,0 +1,85 @@
+#include <iostream>
+#include <chrono>
+#include <thread>
+
+#include "../include/matrix.h"
+#include "../include/generator.h"
+#include "../include/network_layer.h"
+#include "../include/activation_layer.h"
+#include "../include/optimizer.h"
+#include "../include/data_parallel.h"
+#include "../include/hogwild.h"
+
+int main(void) {
+
+    std::cout << "[4096,512] MLP 512-256-10 Hogwild vs Synchronous SGD Benchmark:" << std::endl << std::endl ;
+    std::cout << "..." << std::endl;
+
+    constexpr u_int64_t SAMPLES = 4096;
+    constexpr u_int64_t BATCH   = 16;
+    constexpr int EPOCHS = 3;
+    constexpr float LEARNING_RATE = 0.001f;
+
+    using matrix_t = Matrix::Representation; 
+
+    auto build = [](NeuralNetwork::Sequential& model) {
+        model.add(std::make_unique<NeuralNetwork::Layer>(
+                std::make_unique<NeuralNetwork::MatrixMultiplyStep>(Matrix::Rows(512), Matrix::Columns(256)),
+                std::make_unique<NeuralNetwork::AddStep>(Matrix::Columns(256))));
+        model.add(std::make_unique<NeuralNetwork::ActivationFunctions::ReLU>());
+        model.add(std::make_unique<NeuralNetwork::Layer>(
+                std::make_unique<NeuralNetwork::MatrixMultiplyStep>(Matrix::Rows(256), Matrix::Columns(10)),
+                std::make_unique<NeuralNetwork::AddStep>(Matrix::Columns(10))));
+    };
+
+    matrix_t inputs = matrix_t(Matrix::Rows(SAMPLES), Matrix::Columns(512));
+    matrix_t labels = matrix_t(Matrix::Rows(SAMPLES), Matrix::Columns(10));
+    Matrix::Generation::Normal<0, 1> normal_distribution_init;
+
+    inputs = normal_distribution_init(inputs);
+    for (u_int64_t i = 0; i < SAMPLES; i++) labels.put(i, i % 10, 1);
+
+    auto report = [](const char* name, double seconds, float loss) {
+        std::cout << name << ": " << SAMPLES * EPOCHS / seconds << " samples/sec, "
+                  << "final epoch loss " << loss << "." << std::endl;
+    };
+
+    {
+        NeuralNetwork::Sequential model;
+        build(model);
+        NeuralNetwork::Optimization::SGD sgd(model.flatten(), LEARNING_RATE);
+        auto& context = NeuralNetwork::Computation::Graph::GraphContext::get();
+
+        float epoch_loss = 0;
+        auto start = std::chrono::steady_clock::now();
+
+        for (int e = 0; e < EPOCHS; e++) {
+            epoch_loss = 0;
+            for (u_int64_t first = 0; first < SAMPLES; first += BATCH) {
+                epoch_loss += NeuralNetwork::Training::train_rows(model, context, inputs, labels, first, first + BATCH);
+                sgd.step();
+            }
+        }
+
+        report("Synchronous", std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(), epoch_loss);
+    }
+
+    for (auto policy: {NeuralNetwork::Training::UpdatePolicy::RACY,
+                       NeuralNetwork::Training::UpdatePolicy::RELAXED_ATOMIC}) {
+
+        NeuralNetwork::Sequential model;
+        build(model);
+
+        NeuralNetwork::Training::Hogwild trainer(model, build, std::thread::hardware_concurrency(), LEARNING_RATE, policy);
+
+        float epoch_loss = 0;
+        auto start = std::chrono::steady_clock::now();
+
+        for (int e = 0; e < EPOCHS; e++) epoch_loss = trainer.epoch(inputs, labels, BATCH);
+
+        report(policy == NeuralNetwork::Training::UpdatePolicy::RACY ? "Hogwild (racy)" : "Hogwild (relaxed atomic)",
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(), epoch_loss);
+    }
+
+    return 0;
+}
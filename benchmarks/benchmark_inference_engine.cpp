@@ -0,0 +1,72 @@
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include "../include/matrix.h"
+#include "../include/tensor.h"
+#include "../include/grad_mode.h"
+#include "../include/network_layer.h"
+#include "../include/activation_layer.h"
+#include "../include/inference_engine.h"
+
+int main(void) {
+
+    std::cout << "[1,2000] MLP 2000-1000-10 Single Sample Inference Benchmark:" << std::endl << std::endl ;
+    std::cout << "..." << std::endl;
+
+    constexpr int RUNS = 500;
+
+    NeuralNetwork::Sequential model;
+    model.add(std::make_unique<NeuralNetwork::Layer>(
+            std::make_unique<NeuralNetwork::MatrixMultiplyStep>(Matrix::Rows(2000), Matrix::Columns(1000)),
+            std::make_unique<NeuralNetwork::AddStep>(Matrix::Columns(1000))));
+    model.add(std::make_unique<NeuralNetwork::ActivationFunctions::ReLU>());
+    model.add(std::make_unique<NeuralNetwork::Layer>(
+            std::make_unique<NeuralNetwork::MatrixMultiplyStep>(Matrix::Rows(1000), Matrix::Columns(10)),
+            std::make_unique<NeuralNetwork::AddStep>(Matrix::Columns(10))));
+    model.add(std::make_unique<NeuralNetwork::ActivationFunctions::SoftMax>());
+
+    std::vector<float> sample(2000, 0.5f);
+
+    auto report = [](const char* name, std::vector<double>& micros) {
+        std::sort(micros.begin(), micros.end());
+        std::cout << name << ": p50 " << micros[micros.size() / 2] << " us, p99 "
+                  << micros[micros.size() * 99 / 100] << " us." << std::endl;
+    };
+
+    {
+        NeuralNetwork::Computation::Graph::NoGradGuard no_grad;
+        std::vector<double> micros;
+
+        for (int i = 0; i < RUNS; i++) {
+            auto start = std::chrono::steady_clock::now();
+
+            Matrix::Representation x = Matrix::Representation(Matrix::Rows(1), Matrix::Columns(2000));
+            std::copy(sample.begin(), sample.end(), x.scanStart());
+            auto out = model.forward(std::make_shared<NeuralNetwork::Computation::Graph::Tensor>(std::move(x)));
+
+            micros.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+        }
+
+        report("Sequential no-grad forward", micros);
+    }
+
+    {
+        NeuralNetwork::Inference::InferenceEngine engine(model, 2000);
+        std::vector<double> micros;
+        volatile float sink = 0;
+
+        for (int i = 0; i < RUNS; i++) {
+            auto start = std::chrono::steady_clock::now();
+
+            sink = engine.run(sample.data())[0];
+
+            micros.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+        }
+
+        report("Ping-pong inference engine", micros);
+    }
+
+    return 0;
+}
@@ -0,0 +1,64 @@
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "../include/matrix.h"
+#include "../include/network_layer.h"
+#include "../include/activation_layer.h"
+#include "../include/inference_server.h"
+
+int main(void) {
+
+    std::cout << "MLP 784-128-10 Batched Inference Server Benchmark (16 clients):" << std::endl << std::endl ;
+    std::cout << "..." << std::endl;
+
+    constexpr int CLIENTS = 16;
+    constexpr int REQUESTS = 200;
+
+    NeuralNetwork::Sequential model;
+    model.add(std::make_unique<NeuralNetwork::Layer>(
+            std::make_unique<NeuralNetwork::MatrixMultiplyStep>(Matrix::Rows(784), Matrix::Columns(128)),
+            std::make_unique<NeuralNetwork::AddStep>(Matrix::Columns(128))));
+    model.add(std::make_unique<NeuralNetwork::ActivationFunctions::ReLU>());
+    model.add(std::make_unique<NeuralNetwork::Layer>(
+            std::make_unique<NeuralNetwork::MatrixMultiplyStep>(Matrix::Rows(128), Matrix::Columns(10)),
+            std::make_unique<NeuralNetwork::AddStep>(Matrix::Columns(10))));
+
+    for (u_int64_t max_batch: {1, 8, 32}) {
+
+        NeuralNetwork::Serving::InferenceServer server(model, 784, max_batch, std::chrono::microseconds(500));
+
+        std::vector<std::vector<double>> latencies(CLIENTS);
+        std::vector<std::thread> clients;
+
+        auto start = std::chrono::steady_clock::now();
+
+        for (int c = 0; c < CLIENTS; c++) {
+            clients.emplace_back([&server, &latencies, c]() {
+                for (int i = 0; i < REQUESTS; i++) {
+                    auto sent = std::chrono::steady_clock::now();
+                    server.submit(std::vector<float>(784, 0.5f)).get();
+                    latencies[c].push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - sent).count());
+                }
+            });
+        }
+
+        for (auto& client: clients) client.join();
+
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::vector<double> all;
+        for (auto& l: latencies) all.insert(all.end(), l.begin(), l.end());
+        std::sort(all.begin(), all.end());
+
+        server.stop();
+
+        std::cout << "max batch " << max_batch << ": " << CLIENTS * REQUESTS / seconds << " requests/sec, "
+                  << "mean batch " << double(server.requests()) / server.batches() << ", "
+                  << "p50 " << all[all.size() / 2] << " us, p99 " << all[all.size() * 99 / 100] << " us." << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,99 @@
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include "../include/matrix.h"
+#include "../include/generator.h"
+#include "../include/m_algorithms.h"
+#include "../include/network_layer.h"
+#include "../include/inference_engine.h"
+#include "../include/decomposition.h"
+
+int main(void) {
+
+    constexpr u_int64_t IN = 2000;
+    constexpr u_int64_t OUT = 1000;
+    constexpr u_int64_t RANK = 64;
+    constexpr u_int64_t BATCH = 64;
+    constexpr int RUNS = 20;
+
+    std::cout << "[" << IN << "," << OUT << "] Layer, Dense vs Rank " << RANK << " Factorization:" << std::endl << std::endl;
+    std::cout << "..." << std::endl;
+
+    Matrix::Operations::Binary::Multiplication::ParallelDNC mul;
+    Matrix::Generation::Normal<0, 1> normal_distribution_init;
+
+    // A trained-looking weight: rank RANK signal plus a little noise.
+    Matrix::Representation a = Matrix::Representation(Matrix::Rows(IN), Matrix::Columns(RANK));
+    Matrix::Representation b = Matrix::Representation(Matrix::Rows(RANK), Matrix::Columns(OUT));
+    Matrix::Representation noise = Matrix::Representation(Matrix::Rows(IN), Matrix::Columns(OUT));
+    a = normal_distribution_init(a);
+    b = normal_distribution_init(b);
+    noise = normal_distribution_init(noise);
+
+    Matrix::Representation W = mul(a, b);
+    for (u_int64_t k = 0; k < W.size(); k++) W.scanStart()[k] += 0.001f * noise.constScanStart()[k];
+
+    auto start = std::chrono::steady_clock::now();
+    auto low_rank = std::make_unique<NeuralNetwork::LowRankLinearStep>(W, RANK);
+    double factorize = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "Factorized in " << factorize << " ms, relative error " << low_rank->reconstruction_error() << "." << std::endl;
+    std::cout << low_rank->weight_count() * sizeof(float) << " bytes vs " << W.bytes() << " dense." << std::endl;
+
+    NeuralNetwork::Sequential dense_model;
+    auto dense = std::make_unique<NeuralNetwork::MatrixMultiplyStep>(Matrix::Rows(IN), Matrix::Columns(OUT));
+    std::vector<std::shared_ptr<NeuralNetwork::Computation::Graph::Tensor>> params;
+    dense->collect_parameters(params);
+    params.front()->release_matrix() = Matrix::Representation{W};
+    dense_model.add(std::move(dense));
+
+    NeuralNetwork::Sequential low_rank_model;
+    low_rank_model.add(std::move(low_rank));
+
+    // Best of RUNS in ms.
+    auto time = [](const char* name, auto&& kernel) {
+        double best = 1e30;
+
+        for (int i = 0; i < RUNS; i++) {
+            auto start = std::chrono::steady_clock::now();
+            kernel();
+            best = std::min(best, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        }
+
+        std::cout << name << ": " << best << " ms." << std::endl;
+        return best;
+    };
+
+    std::vector<float> sample(IN);
+    for (u_int64_t c = 0; c < IN; c++) sample[c] = float(c % 7) - 3;
+
+    NeuralNetwork::Inference::InferenceEngine dense_engine(dense_model, IN);
+    NeuralNetwork::Inference::InferenceEngine low_rank_engine(low_rank_model, IN);
+
+    volatile float sink = 0;
+
+    std::cout << std::endl << "Single sample, InferenceEngine:" << std::endl;
+
+    double full    = time("Dense", [&] { sink = dense_engine.run(sample.data())[0]; });
+    double reduced = time("Low rank", [&] { sink = low_rank_engine.run(sample.data())[0]; });
+
+    std::cout << "Speedup: " << full / reduced << "x." << std::endl;
+
+    Matrix::Representation x = Matrix::Representation(Matrix::Rows(BATCH), Matrix::Columns(IN));
+    x = normal_distribution_init(x);
+
+    auto factors = low_rank_model.parameters();
+    const Matrix::Representation& left  = factors[0]->release_matrix();
+    const Matrix::Representation& right = factors[1]->release_matrix();
+
+    std::cout << std::endl << "Batch of " << BATCH << ", ParallelDNC:" << std::endl;
+
+    full    = time("Dense", [&] { sink = mul(x, W).constScanStart()[0]; });
+    reduced = time("Low rank", [&] { sink = mul(mul(x, left), right).constScanStart()[0]; });
+
+    std::cout << "Speedup: " << full / reduced << "x." << std::endl;
+
+    return 0;
+}
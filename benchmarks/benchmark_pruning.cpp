@@ -0,0 +1,87 @@
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include "../include/matrix.h"
+#include "../include/generator.h"
+#include "../include/m_algorithms.h"
+#include "../include/network_layer.h"
+#include "../include/inference_engine.h"
+#include "../include/pruning.h"
+#include "../include/sparse.h"
+
+int main(void) {
+
+    constexpr u_int64_t IN = 2000;
+    constexpr u_int64_t OUT = 1000;
+    constexpr u_int64_t BATCH = 64;
+    constexpr float SPARSITY = 0.9f;
+    constexpr int RUNS = 20;
+
+    std::cout << "[" << IN << "," << OUT << "] Layer Pruned To " << SPARSITY * 100 << "% Zero Blocks, Dense vs Block Sparse:" << std::endl << std::endl;
+    std::cout << "..." << std::endl;
+
+#if defined(__AVX2__) && defined(__FMA__)
+    std::cout << "Block kernel: AVX2 / FMA" << std::endl;
+#else
+    std::cout << "Block kernel: portable (build with NATIVE=1 for AVX2 / FMA)" << std::endl;
+#endif
+
+    Matrix::Generation::Normal<0, 1> normal_distribution_init;
+
+    NeuralNetwork::Sequential model;
+    model.add(std::make_unique<NeuralNetwork::Layer>(
+        std::make_unique<NeuralNetwork::MatrixMultiplyStep>(Matrix::Rows(IN), Matrix::Columns(OUT)),
+        std::make_unique<NeuralNetwork::AddStep>(Matrix::Columns(OUT))));
+
+    for (auto& param: model.parameters()) param->release_matrix() = normal_distribution_init(param->release_matrix());
+
+    auto pruned = NeuralNetwork::Inference::prune_blocks(model, SPARSITY);
+    const Matrix::Representation& W = model.parameters().front()->release_matrix();
+
+    std::cout << pruned[0]->blocks() << " blocks kept, " << pruned[0]->bytes() << " bytes vs " << W.bytes() << " dense." << std::endl;
+
+    // Best of RUNS in ms.
+    auto time = [](const char* name, auto&& kernel) {
+        double best = 1e30;
+
+        for (int i = 0; i < RUNS; i++) {
+            auto start = std::chrono::steady_clock::now();
+            kernel();
+            best = std::min(best, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        }
+
+        std::cout << name << ": " << best << " ms." << std::endl;
+        return best;
+    };
+
+    std::vector<float> sample(IN);
+    for (u_int64_t c = 0; c < IN; c++) sample[c] = float(c % 7) - 3;
+
+    NeuralNetwork::Inference::InferenceEngine dense_engine(model, IN);
+    NeuralNetwork::Inference::InferenceEngine sparse_engine(model, IN, pruned);
+
+    volatile float sink = 0;
+
+    std::cout << std::endl << "Single sample, InferenceEngine:" << std::endl;
+
+    double dense  = time("Dense", [&] { sink = dense_engine.run(sample.data())[0]; });
+    double sparse = time("Block sparse", [&] { sink = sparse_engine.run(sample.data())[0]; });
+
+    std::cout << "Speedup: " << dense / sparse << "x." << std::endl;
+
+    Matrix::Representation x = Matrix::Representation(Matrix::Rows(BATCH), Matrix::Columns(IN));
+    x = normal_distribution_init(x);
+
+    Matrix::Operations::Binary::Multiplication::ParallelDNC mul;
+
+    std::cout << std::endl << "Batch of " << BATCH << ":" << std::endl;
+
+    dense  = time("Dense ParallelDNC", [&] { sink = mul(x, W).constScanStart()[0]; });
+    sparse = time("Block sparse", [&] { sink = Matrix::Operations::Sparse::multiply(x, *pruned[0]).constScanStart()[0]; });
+
+    std::cout << "Speedup: " << dense / sparse << "x." << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,91 @@
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+#include "../include/config.h"
+#include "../include/matrix.h"
+#include "../include/generator.h"
+#include "../include/network_layer.h"
+#include "../include/activation_layer.h"
+#include "../include/inference_engine.h"
+#include "../include/quantization.h"
+
+int main(void) {
+
+    std::cout << "[1,2000] MLP 2000-1000-10 Int8 vs fp32 Inference Benchmark:" << std::endl << std::endl ;
+    std::cout << "..." << std::endl;
+
+#if defined(__AVX2__)
+    std::cout << "int8 kernel: AVX2" << std::endl;
+#else
+    std::cout << "int8 kernel: scalar (build with NATIVE=1 for AVX2)" << std::endl;
+#endif
+
+    constexpr u_int64_t INPUTS = 2000;
+    constexpr u_int64_t SAMPLES = 200;
+    constexpr int RUNS = 500;
+
+    NeuralNetwork::Sequential model;
+    model.add(std::make_unique<NeuralNetwork::Layer>(
+            std::make_unique<NeuralNetwork::MatrixMultiplyStep>(Matrix::Rows(INPUTS), Matrix::Columns(1000)),
+            std::make_unique<NeuralNetwork::AddStep>(Matrix::Columns(1000))));
+    model.add(std::make_unique<NeuralNetwork::ActivationFunctions::ReLU>());
+    model.add(std::make_unique<NeuralNetwork::Layer>(
+            std::make_unique<NeuralNetwork::MatrixMultiplyStep>(Matrix::Rows(1000), Matrix::Columns(10)),
+            std::make_unique<NeuralNetwork::AddStep>(Matrix::Columns(10))));
+    model.add(std::make_unique<NeuralNetwork::ActivationFunctions::SoftMax>());
+
+    for (auto& param: model.parameters()) {
+        auto& matrix = param->release_matrix();
+        if (matrix.num_rows() > 1) matrix = (1 / DAMPEN / std::sqrt(float(matrix.num_rows()))) * matrix;
+    }
+
+    Matrix::Generation::Normal<0, 1> normal_distribution_init;
+    Matrix::Representation samples = Matrix::Representation(Matrix::Rows(SAMPLES), Matrix::Columns(INPUTS));
+    samples = normal_distribution_init(samples);
+    samples = (1 / DAMPEN) * samples;
+
+    NeuralNetwork::Inference::InferenceEngine fp32(model, INPUTS);
+    NeuralNetwork::Inference::QuantizedInferenceEngine int8(model, INPUTS, samples);
+
+    // Accuracy on the samples against fp32.
+    float worst = 0;
+    int agree = 0;
+
+    for (u_int64_t s = 0; s < SAMPLES; s++) {
+        const float* x = samples.constScanStart() + s * INPUTS;
+        std::vector<float> expected(fp32.run(x), fp32.run(x) + 10);
+        const float* y = int8.run(x);
+
+        for (int c = 0; c < 10; c++) worst = std::max(worst, std::abs(y[c] - expected[c]));
+        agree += std::max_element(y, y + 10) - y == std::max_element(expected.begin(), expected.end()) - expected.begin();
+    }
+
+    std::cout << "Weights: " << (INPUTS * 1000 + 1000 * 10) * sizeof(float) << " -> " << int8.weight_bytes() << " bytes." << std::endl;
+    std::cout << "Top-1 agreement " << 100.0 * agree / SAMPLES << "%, max probability error " << worst << "." << std::endl;
+
+    auto time = [&samples](auto& engine) {
+        std::vector<double> micros;
+        volatile float sink = 0;
+
+        for (int i = 0; i < RUNS; i++) {
+            auto start = std::chrono::steady_clock::now();
+            sink = engine.run(samples.constScanStart() + (i % SAMPLES) * INPUTS)[0];
+            micros.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+        }
+
+        std::sort(micros.begin(), micros.end());
+        return micros;
+    };
+
+    auto f = time(fp32);
+    auto q = time(int8);
+
+    std::cout << "fp32: p50 " << f[RUNS / 2] << " us, p99 " << f[RUNS * 99 / 100] << " us." << std::endl;
+    std::cout << "int8: p50 " << q[RUNS / 2] << " us, p99 " << q[RUNS * 99 / 100] << " us." << std::endl;
+    std::cout << "Speedup (p50): " << f[RUNS / 2] / q[RUNS / 2] << "x." << std::endl;
+
+    return 0;
+}
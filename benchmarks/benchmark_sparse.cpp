@@ -0,0 +1,77 @@
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+
+#include "../include/matrix.h"
+#include "../include/generator.h"
+#include "../include/m_algorithms.h"
+#include "../include/sparse.h"
+
+int main(void) {
+
+    constexpr u_int64_t BATCH = 256;
+    constexpr u_int64_t FEATURES = 20000;
+    constexpr u_int64_t HIDDEN = 128;
+    constexpr u_int64_t EVERY = 200;
+    constexpr int RUNS = 5;
+
+    std::cout << "[" << BATCH << "," << FEATURES << "] x [" << FEATURES << "," << HIDDEN << "] First Layer, "
+              << "Bag-of-Words Input 0.5% Nonzero, Dense vs CSR:" << std::endl << std::endl;
+    std::cout << "..." << std::endl;
+
+    Matrix::Generation::Normal<0, 1> normal_distribution_init;
+
+    Matrix::Representation inputs = Matrix::Representation(Matrix::Rows(BATCH), Matrix::Columns(FEATURES));
+    for (u_int64_t k = 0; k < inputs.size(); k++) {
+        if ((k * 2654435761u) % EVERY == 0) inputs.scanStart()[k] = 1;
+    }
+
+    Matrix::Representation W = Matrix::Representation(Matrix::Rows(FEATURES), Matrix::Columns(HIDDEN));
+    W = normal_distribution_init(W);
+
+    Matrix::Representation g = Matrix::Representation(Matrix::Rows(BATCH), Matrix::Columns(HIDDEN));
+    g = normal_distribution_init(g);
+
+    Matrix::SparseRepresentation x(inputs);
+
+    std::cout << x.nonzeros() << " nonzeros, " << x.bytes() << " bytes CSR vs " << inputs.bytes() << " dense." << std::endl;
+
+    // Best of RUNS in ms.
+    auto time = [](const char* name, auto&& kernel) {
+        double best = 1e30;
+        volatile float sink = 0;
+
+        for (int i = 0; i < RUNS; i++) {
+            auto start = std::chrono::steady_clock::now();
+            Matrix::Representation y = kernel();
+            best = std::min(best, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+            sink = y.constScanStart()[0];
+        }
+
+        std::cout << name << ": " << best << " ms." << std::endl;
+        return best;
+    };
+
+    Matrix::Operations::Binary::Multiplication::ParallelDNC mul;
+    Matrix::Operations::Unary::Transpose transpose;
+
+    std::cout << std::endl << "Forward:" << std::endl;
+
+    double dense  = time("Dense ParallelDNC", [&] { return mul(inputs, W); });
+    double sparse = time("CSR SpMM", [&] { return Matrix::Operations::Sparse::multiply(x, W); });
+
+    std::cout << "Speedup: " << dense / sparse << "x." << std::endl;
+
+    std::cout << std::endl << "Weight Gradient:" << std::endl;
+
+    dense  = time("Dense transpose + ParallelDNC", [&] { return mul(transpose(inputs), g); });
+    sparse = time("CSR touched rows", [&] {
+        Matrix::Representation dW = Matrix::Representation(Matrix::Rows(FEATURES), Matrix::Columns(HIDDEN));
+        Matrix::Operations::Sparse::accumulate_transpose_product(x, g, dW);
+        return Matrix::Representation{std::move(dW)};
+    });
+
+    std::cout << "Speedup: " << dense / sparse << "x." << std::endl;
+
+    return 0;
+}
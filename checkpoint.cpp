@@ -0,0 +1,141 @@
+#include "checkpoint.h"
+
+#include <cstdio>
+#include <cstring>
+
+#include <assert.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+namespace NeuralNetwork {
+
+    namespace Serialization {
+
+
+        namespace {
+
+            constexpr u_int64_t FLOATS_PER_LINE = CHECKPOINT_ALIGNMENT / sizeof(float);
+
+            constexpr u_int64_t align_up(u_int64_t value, u_int64_t alignment) noexcept {
+                return (value + alignment - 1) / alignment * alignment;
+            }
+
+            constexpr u_int64_t data_offset(u_int64_t parameters) noexcept {
+                return align_up(sizeof(CheckpointHeader) + parameters * sizeof(CheckpointEntry), CHECKPOINT_ALIGNMENT);
+            }
+
+        }
+
+
+        u_int64_t assign_offsets(std::vector<CheckpointEntry>& entries) noexcept {
+
+            u_int64_t total = 0;
+
+            for (auto& entry: entries) {
+                entry.offset = total;
+                total += align_up(entry.rows * entry.columns, FLOATS_PER_LINE);
+            }
+
+            return total;
+        }
+
+
+        bool write_checkpoint(const std::string& path, u_int64_t modules,
+            const std::vector<CheckpointEntry>& entries, const float* data, u_int64_t floats) noexcept {
+
+            CheckpointHeader header = {};
+            std::memcpy(header.magic, CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC));
+            header.version     = CHECKPOINT_VERSION;
+            header.modules     = modules;
+            header.parameters  = entries.size();
+            header.data_offset = data_offset(entries.size());
+            header.data_floats = floats;
+
+            const u_int64_t table_bytes = entries.size() * sizeof(CheckpointEntry);
+            const u_int64_t padding     = header.data_offset - sizeof(header) - table_bytes;
+            const char zeros[CHECKPOINT_ALIGNMENT] = {};
+
+            // Written next to the target and renamed over it, so a crash never leaves half a checkpoint.
+            const std::string staging = path + ".tmp";
+
+            std::FILE* file = std::fopen(staging.c_str(), "wb");
+            if (!file) return false;
+
+            bool written =
+                std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+                std::fwrite(entries.data(), 1, table_bytes, file) == table_bytes &&
+                std::fwrite(zeros, 1, padding, file) == padding &&
+                std::fwrite(data, sizeof(float), floats, file) == floats;
+
+            written = std::fflush(file) == 0 && ::fsync(::fileno(file)) == 0 && written;
+            written = std::fclose(file) == 0 && written;
+
+            if (!written || std::rename(staging.c_str(), path.c_str()) != 0) {
+                std::remove(staging.c_str());
+                return false;
+            }
+
+            return true;
+        }
+
+
+        MappedCheckpoint::MappedCheckpoint(const std::string& _path) noexcept {
+
+            int fd = ::open(_path.c_str(), O_RDONLY);
+            if (fd < 0) return;
+
+            struct stat info;
+            if (::fstat(fd, &info) != 0 || static_cast<u_int64_t>(info.st_size) < sizeof(CheckpointHeader)) {
+                ::close(fd);
+                return;
+            }
+
+            const u_int64_t length = info.st_size;
+
+            void* address = ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+            ::close(fd);
+
+            if (address == MAP_FAILED) return;
+
+            const char* base = static_cast<const char*>(address);
+            std::memcpy(&header, base, sizeof(CheckpointHeader));
+
+            bool valid =
+                std::memcmp(header.magic, CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC)) == 0 &&
+                header.version == CHECKPOINT_VERSION &&
+                header.data_offset == data_offset(header.parameters) &&
+                header.data_offset + header.data_floats * sizeof(float) <= length;
+
+            if (valid) {
+                auto entries = reinterpret_cast<const CheckpointEntry*>(base + sizeof(CheckpointHeader));
+                table.assign(entries, entries + header.parameters);
+
+                auto expected = table;
+                valid = assign_offsets(expected) == header.data_floats && expected == table;
+            }
+
+            if (!valid) {
+                ::munmap(address, length);
+                header = {};
+                table.clear();
+                return;
+            }
+
+            mapping = std::shared_ptr<void>(address, [length](void* a) { ::munmap(a, length); });
+        }
+
+
+        std::shared_ptr<void> MappedCheckpoint::weights() const noexcept {
+
+            assert(is_open() && "Checkpoint failed to open.");
+
+            return std::shared_ptr<void>(mapping, static_cast<char*>(mapping.get()) + header.data_offset);
+        }
+
+
+    }
+
+}
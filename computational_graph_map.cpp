@@ -1,6 +1,9 @@
 #include "tensor.h"
 #include "computational_graph_map.h"
 #include "m_algorithms_register.h"
+#include "sparse.h"
+
+#include <unordered_set>
 
 #include <assert.h>
 
@@ -11,7 +14,7 @@ namespace NeuralNetwork {
 
         namespace Graph {
 
-            TensorID ComputationalGraphMap::tensor_id = TensorID(0);
+            thread_local ComputationalGraphMap* ComputationalGraphMap::current = nullptr;
 
 
             FunctionObject ComputationalGraphMap::_get_operation(TensorID my_tensor_id) noexcept { 
@@ -41,6 +44,106 @@ namespace NeuralNetwork {
                 
                 recovered_tensor_id.push(my_tensor_id);
                 tensor_registry.at(my_tensor_id.get()) = nullptr;
+                segment_registry.at(my_tensor_id.get()) = nullptr;
+                sparse_registry.at(my_tensor_id.get()) = nullptr;
+            }
+
+
+            void ComputationalGraphMap::_register_segment(TensorID my_tensor_id, Segment _segment) noexcept {
+
+                assert(my_tensor_id <= tensor_id && "OP registry not this large");
+
+                segment_registry.at(my_tensor_id.get()) = std::move(_segment);
+            }
+
+
+            Segment& ComputationalGraphMap::_get_segment(TensorID my_tensor_id) noexcept {
+
+                assert(my_tensor_id > TensorID(0) && "Must be an op_id greater than 0.");
+                assert(segment_registry.at(my_tensor_id.get()) && "No segment registered for tensor.");
+
+                return segment_registry.at(my_tensor_id.get());
+            }
+
+
+            void ComputationalGraphMap::_register_sparse_operand(TensorID my_tensor_id, std::shared_ptr<const Matrix::SparseRepresentation> _operand) noexcept {
+
+                assert(my_tensor_id <= tensor_id && "OP registry not this large");
+
+                sparse_registry.at(my_tensor_id.get()) = std::move(_operand);
+            }
+
+
+            const Matrix::SparseRepresentation& ComputationalGraphMap::_get_sparse_operand(TensorID my_tensor_id) noexcept {
+
+                assert(my_tensor_id > TensorID(0) && "Must be an op_id greater than 0.");
+                assert(sparse_registry.at(my_tensor_id.get()) && "No sparse operand registered for tensor.");
+
+                return *sparse_registry.at(my_tensor_id.get());
+            }
+
+
+            /*
+                Releases every recorded operation between root and boundary
+                back to the registry. Tensors without operands (inputs and 
+                parameters) are owned by their steps and are left alone.
+            */
+            void ComputationalGraphMap::_detach_subgraph(TensorID root, TensorID boundary) noexcept {
+
+                std::stack<TensorID> pending;
+                pending.push(root);
+
+                while (!pending.empty()) {
+
+                    TensorID tid = pending.top();
+                    pending.pop();
+
+                    if (tid == boundary || tensor_registry.at(tid.get()) == nullptr) continue;
+
+                    auto operands = op_registry.at(tid.get()).serialize();
+
+                    if (!operands[1]) continue;
+
+                    for (std::size_t i = 1; i < operands.size(); i++) {
+                        if (operands[i]) pending.push(TensorID(operands[i]->get()));
+                    }
+
+                    _recover_tensor_id(tid);
+                }
+            }
+
+
+
+            std::vector<TensorID> ComputationalGraphMap::_topological_order(TensorID root) noexcept {
+
+                std::vector<TensorID> order;
+                std::unordered_set<u_int16_t> visited;
+                std::stack<std::pair<TensorID, bool>> pending;
+
+                pending.emplace(root, false);
+
+                while (!pending.empty()) {
+
+                    auto [tid, expanded] = pending.top();
+                    pending.pop();
+
+                    if (expanded) {
+                        order.push_back(tid);
+                        continue;
+                    }
+
+                    if (!visited.insert(tid.get()).second) continue;
+
+                    pending.emplace(tid, true);
+
+                    for (std::size_t i = 0; const auto operand: op_registry.at(tid.get()).serialize()) {
+                        if (i++ && operand && !visited.contains(operand->get())) {
+                            pending.emplace(TensorID(operand->get()), false);
+                        }
+                    }
+                }
+
+                return order;
             }
 
 
@@ -71,6 +174,7 @@ namespace NeuralNetwork {
 
                 op_registry.at(my_tensor_id.get()) = _node;
                 tensor_registry.at(my_tensor_id.get()) = _t;
+                creation_registry.at(my_tensor_id.get()) = 0;
 
 
                 std::cout << "Updated Operation: OP[" << my_tensor_id.get() << "]" << std::endl;
@@ -0,0 +1,227 @@
+#include "csv.h"
+#include "dataset.h"
+
+#include <cilk/cilk.h>
+#include <cilk/cilk_api.h>
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <cstring>
+
+#include <assert.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+namespace NeuralNetwork {
+
+    namespace Data {
+
+
+        namespace {
+
+            constexpr size_t RANGES_PER_WORKER = 4;
+            constexpr u_int64_t MIN_RANGE_BYTES = 1 << 16;
+
+            constexpr bool is_space(char c) noexcept {
+                return c == ' ' || c == '\t' || c == '\r';
+            }
+
+            const char* line_end(const char* p, const char* last) noexcept {
+                auto end = static_cast<const char*>(std::memchr(p, '\n', last - p));
+                return end ? end : last;
+            }
+
+            bool is_blank(const char* p, const char* end) noexcept {
+                return std::all_of(p, end, is_space);
+            }
+
+            const char* skip_spaces(const char* p, const char* end) noexcept {
+                while (p < end && is_space(*p)) p++;
+                return p;
+            }
+
+            u_int64_t count_fields(const char* p, const char* end, char delimiter) noexcept {
+                return 1 + std::count(p, end, delimiter);
+            }
+
+            /*
+                Parses one line of columns fields, the first split into
+                head and the rest into tail. False if a field is not a
+                number or the count is off.
+            */
+            bool parse_line(const char* p, const char* end, char delimiter, u_int64_t columns,
+                u_int64_t split, float* head, float* tail) noexcept {
+
+                for (u_int64_t c = 0; c < columns; c++) {
+
+                    p = skip_spaces(p, end);
+                    if (p < end && *p == '+') p++;
+
+                    auto [next, error] = std::from_chars(p, end, c < split ? head[c] : tail[c - split]);
+                    if (error != std::errc()) return false;
+
+                    p = skip_spaces(next, end);
+
+                    if (c + 1 < columns) {
+                        if (p == end || *p != delimiter) return false;
+                        p++;
+                    }
+                }
+
+                return p == end;
+            }
+
+        }
+
+
+        CSVReader::CSVReader(const std::string& _path, char _delimiter, bool _header, size_t _ranges) noexcept :
+            delimiter(_delimiter) {
+
+            int fd = ::open(_path.c_str(), O_RDONLY);
+            if (fd < 0) return;
+
+            struct stat info;
+            if (::fstat(fd, &info) != 0 || info.st_size == 0) {
+                ::close(fd);
+                return;
+            }
+
+            const u_int64_t length = info.st_size;
+
+            void* address = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+            ::close(fd);
+
+            if (address == MAP_FAILED) return;
+
+            ::madvise(address, length, MADV_WILLNEED);
+
+            mapping = std::shared_ptr<void>(address, [length](void* a) { ::munmap(a, length); });
+
+            const char* first = static_cast<const char*>(address);
+            const char* last  = first + length;
+
+            if (_header) first = std::min(last, line_end(first, last) + 1);
+
+            // The first non-blank line fixes the number of columns.
+            for (const char* p = first; p < last; ) {
+                const char* end = line_end(p, last);
+                if (!is_blank(p, end)) {
+                    total_columns = count_fields(p, end, delimiter);
+                    break;
+                }
+                p = end + 1;
+            }
+
+            if (_ranges == 0) {
+                _ranges = std::clamp<u_int64_t>((last - first) / MIN_RANGE_BYTES, 1,
+                    RANGES_PER_WORKER * __cilkrts_get_nworkers());
+            }
+
+            // Split evenly, then move every boundary past the next line break.
+            const u_int64_t bytes = last - first;
+
+            for (size_t r = 0; r < _ranges; r++) {
+
+                const char* begin = ranges.empty() ? first : ranges.back().last;
+                const char* end   = first + bytes * (r + 1) / _ranges;
+
+                if (end < begin) end = begin;
+                if (end > first && end < last && end[-1] != '\n') end = std::min(last, line_end(end, last) + 1);
+
+                ranges.push_back(Range { begin, end, 0 });
+            }
+
+            std::vector<u_int64_t> counts(ranges.size());
+
+            cilk_for (size_t r = 0; r < ranges.size(); r++) {
+
+                u_int64_t lines = 0;
+
+                for (const char* p = ranges[r].first; p < ranges[r].last; ) {
+                    const char* end = line_end(p, ranges[r].last);
+                    if (!is_blank(p, end)) lines++;
+                    p = end + 1;
+                }
+
+                counts[r] = lines;
+            }
+
+            for (size_t r = 0; r < ranges.size(); r++) {
+                ranges[r].row = total_rows;
+                total_rows += counts[r];
+            }
+        }
+
+
+        bool CSVReader::read(Matrix::Representation& _into) const noexcept {
+
+            assert(_into.num_rows() == total_rows && _into.num_cols() == total_columns && "Matrix does not match the file.");
+
+            return _read(_into.scanStart(), total_columns, nullptr);
+        }
+
+
+        bool CSVReader::read(Matrix::Representation& _head, Matrix::Representation& _tail) const noexcept {
+
+            assert(_head.num_rows() == total_rows && _tail.num_rows() == total_rows && "Matrix does not match the file.");
+            assert(_head.num_cols() + _tail.num_cols() == total_columns && "Matrices do not split the file's columns.");
+
+            return _read(_head.scanStart(), _head.num_cols(), _tail.scanStart());
+        }
+
+
+        bool CSVReader::_read(float* _head, u_int64_t _split, float* _tail) const noexcept {
+
+            assert(is_open() && "Reading a CSV file that failed to open.");
+
+            const u_int64_t tail_columns = total_columns - _split;
+
+            std::atomic<bool> valid = true;
+
+            cilk_for (size_t r = 0; r < ranges.size(); r++) {
+
+                float* head = _head + ranges[r].row * _split;
+                float* tail = _tail + ranges[r].row * tail_columns;
+
+                for (const char* p = ranges[r].first; p < ranges[r].last; ) {
+
+                    const char* end = line_end(p, ranges[r].last);
+
+                    if (!is_blank(p, end)) {
+                        if (!parse_line(p, end, delimiter, total_columns, _split, head, tail)) {
+                            valid.store(false, std::memory_order_relaxed);
+                            break;
+                        }
+                        head += _split;
+                        tail += tail_columns;
+                    }
+
+                    p = end + 1;
+                }
+            }
+
+            return valid.load();
+        }
+
+
+        bool csv_to_dataset(const std::string& csv_path, const std::string& dataset_path,
+            u_int64_t label_columns, char delimiter, bool header) noexcept {
+
+            CSVReader csv(csv_path, delimiter, header);
+
+            if (!csv.is_open() || csv.columns() <= label_columns) return false;
+
+            // Parsed straight into the output file's mapping, no copy of the data is held.
+            return write_dataset(dataset_path, csv.rows(), csv.columns() - label_columns, label_columns,
+                [&csv](Matrix::Representation& features, Matrix::Representation& labels) {
+                    return csv.read(features, labels);
+                });
+        }
+
+
+    }
+
+}
@@ -0,0 +1,194 @@
+#include "data_parallel.h"
+#include "tensor.h"
+#include "tensor_factory.h"
+#include "tensor_forward_wrapper.h"
+
+#include <cilk/cilk.h>
+#include <algorithm>
+#include <numeric>
+
+#include <assert.h>
+
+
+namespace NeuralNetwork {
+
+    namespace Training {
+
+
+        namespace {
+
+            constexpr size_t BLOCK = 4096;
+
+            void accumulate(float* __restrict into, const float* __restrict from, size_t n) noexcept {
+
+                cilk_for (size_t b = 0; b < (n + BLOCK - 1) / BLOCK; b++) {
+
+                    const size_t end = std::min(n, (b + 1) * BLOCK);
+
+                    for (size_t i = b * BLOCK; i < end; i++) into[i] += from[i];
+                }
+            }
+
+            void sum(float* __restrict into, const float* __restrict a, const float* __restrict b, size_t n) noexcept {
+
+                cilk_for (size_t k = 0; k < (n + BLOCK - 1) / BLOCK; k++) {
+
+                    const size_t end = std::min(n, (k + 1) * BLOCK);
+
+                    for (size_t i = k * BLOCK; i < end; i++) into[i] = a[i] + b[i];
+                }
+            }
+
+        }
+
+
+        Matrix::Representation slice_rows(const Matrix::Representation& m, u_int64_t first, u_int64_t last) noexcept {
+
+            assert(first <= last && last <= m.num_rows() && "Row slice out of range.");
+
+            Matrix::Representation shard = Matrix::Representation(
+                Matrix::Rows(last - first), Matrix::Columns(m.num_cols()));
+
+            std::copy(m.constScanStart() + first * m.num_cols(),
+                      m.constScanStart() + last  * m.num_cols(), shard.scanStart());
+
+            return Matrix::Representation{std::move(shard)};
+        }
+
+
+        float train_rows(Sequential& model, GraphContext& context,
+            const Matrix::Representation& inputs, const Matrix::Representation& labels,
+            u_int64_t first, u_int64_t last) noexcept {
+
+            std::shared_ptr<Computation::Graph::Tensor> x, y;
+            {
+                GraphContext::Bind bind(context);
+
+                x = Computation::Graph::TensorConstructor::create(slice_rows(inputs, first, last));
+                y = Computation::Graph::TensorConstructor::create(slice_rows(labels, first, last));
+            }
+
+            return train_batch(model, Data::Batch(std::move(x), std::move(y)));
+        }
+
+
+        float train_batch(Sequential& model, const Data::Batch& batch) noexcept {
+
+            Computation::Graph::TensorOp CE(Matrix::Operations::Metric::CrossEntropy{});
+
+            auto loss = CE(batch.labels, model.forward(batch.inputs));
+            loss->backwards();
+
+            auto& value = loss->release_matrix();
+            float total = std::accumulate(value.constScanStart(), value.constScanEnd(), 0.0f);
+
+            batch.inputs->get_context()._detach_subgraph(loss->get_tensor_id(), Computation::Graph::TensorID(0));
+
+            return total;
+        }
+
+
+        DataParallel::DataParallel(Sequential& _master, const ModelBuilder& _build, size_t _workers) noexcept {
+
+            assert(_workers > 0 && "Data parallel training needs at least one worker.");
+
+            master = _master.flat_parameters() ? _master.flat_parameters() : _master.flatten();
+
+            for (size_t w = 0; w < _workers; w++) {
+
+                auto replica = std::make_unique<Replica>();
+
+                {
+                    GraphContext::Bind bind(replica->context);
+                    _build(replica->model);
+                }
+
+                replica->flat = replica->model.flatten();
+
+                assert(replica->flat->size() == master->size() && "Replica does not match the master model.");
+
+                replicas.push_back(std::move(replica));
+            }
+        }
+
+
+        float DataParallel::step(const Matrix::Representation& _inputs, const Matrix::Representation& _labels) noexcept {
+
+            assert(_inputs.num_rows() == _labels.num_rows() && "Every sample needs a label.");
+
+            const u_int64_t batch  = _inputs.num_rows();
+            const u_int64_t shards = replicas.size();
+
+            _broadcast();
+
+            cilk_for (u_int64_t w = 0; w < shards; w++) {
+
+                auto& replica = *replicas[w];
+
+                u_int64_t first = batch * w / shards;
+                u_int64_t last  = batch * (w + 1) / shards;
+
+                replica.flat->zero_grad();
+                replica.loss = 0;
+
+                if (first == last) continue;
+
+                replica.loss = train_rows(replica.model, replica.context, _inputs, _labels, first, last);
+            }
+
+            _all_reduce();
+
+            return std::accumulate(replicas.begin(), replicas.end(), 0.0f,
+                [](float total, const std::unique_ptr<Replica>& replica) { return total + replica->loss; });
+        }
+
+
+        void DataParallel::_broadcast() noexcept {
+
+            cilk_for (size_t w = 0; w < replicas.size(); w++) {
+                replicas[w]->flat->restore(master->weights());
+            }
+        }
+
+
+        /*
+            Pairwise tree: at every level replica i absorbs replica
+            i + stride, all pairs of a level in parallel. The master is
+            the root, the last level writes the sum of the two remaining
+            subtrees straight into its gradients.
+        */
+        void DataParallel::_all_reduce() noexcept {
+
+            const size_t n = master->size();
+            const size_t W = replicas.size();
+
+            size_t stride = 1;
+
+            for (; 2 * stride < W; stride *= 2) {
+
+                const size_t pairs = (W - stride + 2 * stride - 1) / (2 * stride);
+
+                cilk_for (size_t p = 0; p < pairs; p++) {
+
+                    size_t i = p * 2 * stride;
+
+                    accumulate(replicas[i]->flat->gradients(), replicas[i + stride]->flat->gradients(), n);
+                }
+            }
+
+            if (W == 1) {
+                std::copy(replicas.front()->flat->gradients(), replicas.front()->flat->gradients() + n, master->gradients());
+            }
+            else {
+                sum(master->gradients(), replicas.front()->flat->gradients(), replicas[stride]->flat->gradients(), n);
+            }
+
+            master->forget_grad_rows();
+
+            for (size_t i = 0; i < W; i += 2) replicas[i]->flat->forget_grad_rows();
+        }
+
+
+    }
+
+}
@@ -0,0 +1,349 @@
+#include "dataset.h"
+#include "tensor_factory.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <numeric>
+#include <random>
+#include <utility>
+
+#include <assert.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+namespace NeuralNetwork {
+
+    namespace Data {
+
+
+        namespace {
+
+            constexpr u_int64_t PAGE = 4096;
+
+            constexpr u_int64_t align_up(u_int64_t bytes) noexcept {
+                return (bytes + DATASET_ALIGNMENT - 1) / DATASET_ALIGNMENT * DATASET_ALIGNMENT;
+            }
+
+            bool write_padded(std::FILE* file, const void* data, u_int64_t bytes, u_int64_t padded) noexcept {
+
+                static const char zeros[DATASET_ALIGNMENT] = {};
+
+                if (bytes && std::fwrite(data, 1, bytes, file) != bytes) return false;
+
+                return padded == bytes || std::fwrite(zeros, 1, padded - bytes, file) == padded - bytes;
+            }
+
+            // Reads one float per page so the faults are taken here.
+            void touch(const float* first, const float* last) noexcept {
+
+                volatile float sink = 0;
+
+                for (const char* p = reinterpret_cast<const char*>(first); p < reinterpret_cast<const char*>(last); p += PAGE) {
+                    sink = *reinterpret_cast<const float*>(p);
+                }
+
+                (void) sink;
+            }
+
+        }
+
+
+        bool write_dataset(const std::string& path, const Matrix::Representation& features,
+            const Matrix::Representation& labels) noexcept {
+
+            assert(features.num_rows() == labels.num_rows() && "Every sample needs a label.");
+
+            DatasetHeader header = {};
+            std::memcpy(header.magic, DATASET_MAGIC, sizeof(DATASET_MAGIC));
+            header.version         = DATASET_VERSION;
+            header.samples         = features.num_rows();
+            header.features        = features.num_cols();
+            header.label_columns   = labels.num_cols();
+            header.features_offset = align_up(sizeof(DatasetHeader));
+            header.labels_offset   = header.features_offset + align_up(features.size() * sizeof(float));
+
+            std::FILE* file = std::fopen(path.c_str(), "wb");
+            if (!file) return false;
+
+            bool written =
+                write_padded(file, &header, sizeof(header), header.features_offset) &&
+                write_padded(file, features.constScanStart(), features.size() * sizeof(float),
+                    header.labels_offset - header.features_offset) &&
+                write_padded(file, labels.constScanStart(), labels.size() * sizeof(float),
+                    labels.size() * sizeof(float));
+
+            return std::fclose(file) == 0 && written;
+        }
+
+
+        bool write_dataset(const std::string& path, u_int64_t samples, u_int64_t features, u_int64_t label_columns,
+            const std::function<bool(Matrix::Representation&, Matrix::Representation&)>& fill) noexcept {
+
+            DatasetHeader header = {};
+            std::memcpy(header.magic, DATASET_MAGIC, sizeof(DATASET_MAGIC));
+            header.version         = DATASET_VERSION;
+            header.samples         = samples;
+            header.features        = features;
+            header.label_columns   = label_columns;
+            header.features_offset = align_up(sizeof(DatasetHeader));
+            header.labels_offset   = header.features_offset + align_up(samples * features * sizeof(float));
+
+            const u_int64_t length = std::max<u_int64_t>(1, header.labels_offset + samples * label_columns * sizeof(float));
+
+            int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+            if (fd < 0) return false;
+
+            void* address = ::ftruncate(fd, length) == 0 ?
+                ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) : MAP_FAILED;
+            ::close(fd);
+
+            if (address == MAP_FAILED) {
+                ::unlink(path.c_str());
+                return false;
+            }
+
+            char* base = static_cast<char*>(address);
+            std::memcpy(base, &header, sizeof(header));
+
+            Matrix::Representation x = Matrix::Representation::view_of(Matrix::Rows(samples), Matrix::Columns(features),
+                reinterpret_cast<float*>(base + header.features_offset));
+            Matrix::Representation y = Matrix::Representation::view_of(Matrix::Rows(samples), Matrix::Columns(label_columns),
+                reinterpret_cast<float*>(base + header.labels_offset));
+
+            bool written = fill(x, y) && ::msync(address, length, MS_SYNC) == 0;
+
+            ::munmap(address, length);
+
+            if (!written) ::unlink(path.c_str());
+
+            return written;
+        }
+
+
+        MappedDataset::MappedDataset(const std::string& _path) noexcept {
+
+            int fd = ::open(_path.c_str(), O_RDONLY);
+            if (fd < 0) return;
+
+            struct stat info;
+            if (::fstat(fd, &info) != 0 || static_cast<u_int64_t>(info.st_size) < sizeof(DatasetHeader)) {
+                ::close(fd);
+                return;
+            }
+
+            const u_int64_t length = info.st_size;
+
+            // Private and writable: copy-on-write pages, the file is never modified.
+            void* address = ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+            ::close(fd);
+
+            if (address == MAP_FAILED) return;
+
+            std::memcpy(&header, address, sizeof(DatasetHeader));
+
+            bool valid =
+                std::memcmp(header.magic, DATASET_MAGIC, sizeof(DATASET_MAGIC)) == 0 &&
+                header.version == DATASET_VERSION &&
+                header.features_offset % DATASET_ALIGNMENT == 0 &&
+                header.labels_offset   % DATASET_ALIGNMENT == 0 &&
+                header.features_offset + header.samples * header.features * sizeof(float) <= length &&
+                header.labels_offset + header.samples * header.label_columns * sizeof(float) <= length;
+
+            if (!valid) {
+                ::munmap(address, length);
+                header = {};
+                return;
+            }
+
+            base    = static_cast<char*>(address);
+            mapping = std::shared_ptr<void>(address, [length](void* a) { ::munmap(a, length); });
+        }
+
+
+        const float* MappedDataset::feature_row(u_int64_t _sample) const noexcept {
+            return reinterpret_cast<const float*>(base + header.features_offset) + _sample * header.features;
+        }
+
+
+        const float* MappedDataset::label_row(u_int64_t _sample) const noexcept {
+            return reinterpret_cast<const float*>(base + header.labels_offset) + _sample * header.label_columns;
+        }
+
+
+        Matrix::Representation MappedDataset::features(u_int64_t _first, u_int64_t _last) const noexcept {
+
+            assert(is_open() && _first <= _last && _last <= samples() && "Row range out of the dataset.");
+
+            return Matrix::Representation::view_of(Matrix::Rows(_last - _first), Matrix::Columns(header.features),
+                const_cast<float*>(feature_row(_first)), mapping);
+        }
+
+
+        Matrix::Representation MappedDataset::labels(u_int64_t _first, u_int64_t _last) const noexcept {
+
+            assert(is_open() && _first <= _last && _last <= samples() && "Row range out of the dataset.");
+
+            return Matrix::Representation::view_of(Matrix::Rows(_last - _first), Matrix::Columns(header.label_columns),
+                const_cast<float*>(label_row(_first)), mapping);
+        }
+
+
+        void MappedDataset::will_need(u_int64_t _first, u_int64_t _last) const noexcept {
+
+            auto advise = [](const float* first, const float* last) {
+                auto start = reinterpret_cast<uintptr_t>(first) / PAGE * PAGE;
+                auto end   = reinterpret_cast<uintptr_t>(last);
+                if (end > start) ::madvise(reinterpret_cast<void*>(start), end - start, MADV_WILLNEED);
+            };
+
+            advise(feature_row(_first), feature_row(_last));
+            advise(label_row(_first), label_row(_last));
+        }
+
+
+        BatchLoader::BatchLoader(std::shared_ptr<const MappedDataset> _data, u_int64_t _batch_size,
+            Shuffle _shuffle, u_int64_t _seed, size_t _depth) noexcept :
+                data(std::move(_data)), batch_size(_batch_size), shuffle(_shuffle), seed(_seed), depth(_depth) {
+
+            assert(data && data->is_open() && "Loader needs an open dataset.");
+            assert(batch_size > 0 && depth > 0 && "Batch size and prefetch depth must be positive.");
+
+            _start();
+        }
+
+
+        BatchLoader::~BatchLoader() noexcept {
+            _stop();
+        }
+
+
+        Batch::~Batch() noexcept {
+            if (inputs) inputs->detatch_from_computational_graph();
+            if (labels) labels->detatch_from_computational_graph();
+        }
+
+
+        std::optional<Batch> BatchLoader::next() noexcept {
+
+            if (consumed == batches()) return std::nullopt;
+
+            std::unique_lock<std::mutex> guard(lock);
+            ready.wait(guard, [this]() { return !queue.empty(); });
+
+            Minibatch minibatch = std::move(queue.front());
+            queue.pop_front();
+            consumed++;
+
+            guard.unlock();
+            space.notify_one();
+
+            return std::optional<Batch>(std::in_place,
+                Computation::Graph::TensorConstructor::create(std::move(minibatch.inputs)),
+                Computation::Graph::TensorConstructor::create(std::move(minibatch.labels)));
+        }
+
+
+        void BatchLoader::reset() noexcept {
+            _stop();
+            epochs++;
+            _start();
+        }
+
+
+        void BatchLoader::_start() noexcept {
+
+            order.resize(shuffle == Shuffle::SAMPLES ? data->samples() : batches());
+            std::iota(order.begin(), order.end(), 0);
+
+            if (shuffle != Shuffle::NONE) {
+                std::mt19937_64 generator(seed + epochs);
+                std::shuffle(order.begin(), order.end(), generator);
+            }
+
+            consumed = 0;
+            stopping = false;
+            queue.clear();
+
+            prefetcher = std::thread(&BatchLoader::_produce, this);
+        }
+
+
+        void BatchLoader::_stop() noexcept {
+
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                stopping = true;
+            }
+
+            space.notify_all();
+
+            if (prefetcher.joinable()) prefetcher.join();
+        }
+
+
+        void BatchLoader::_produce() noexcept {
+
+            for (u_int64_t b = 0; b < batches(); b++) {
+
+                {
+                    std::unique_lock<std::mutex> guard(lock);
+                    space.wait(guard, [this]() { return stopping || queue.size() < depth; });
+                    if (stopping) return;
+                }
+
+                Minibatch minibatch = _load(b);
+
+                {
+                    std::lock_guard<std::mutex> guard(lock);
+                    queue.push_back(std::move(minibatch));
+                }
+
+                ready.notify_one();
+            }
+        }
+
+
+        BatchLoader::Minibatch BatchLoader::_load(u_int64_t _batch) const noexcept {
+
+            const u_int64_t samples = data->samples();
+
+            if (shuffle != Shuffle::SAMPLES) {
+
+                u_int64_t first = order[_batch] * batch_size;
+                u_int64_t last  = std::min(samples, first + batch_size);
+
+                data->will_need(first, last);
+                touch(data->feature_row(first), data->feature_row(last));
+                touch(data->label_row(first), data->label_row(last));
+
+                return Minibatch { data->features(first, last), data->labels(first, last) };
+            }
+
+            u_int64_t first = _batch * batch_size;
+            u_int64_t last  = std::min(samples, first + batch_size);
+
+            Matrix::Representation inputs = Matrix::Representation(
+                Matrix::Rows(last - first), Matrix::Columns(data->features()));
+            Matrix::Representation labels = Matrix::Representation(
+                Matrix::Rows(last - first), Matrix::Columns(data->label_columns()));
+
+            for (u_int64_t i = first; i < last; i++) {
+
+                const float* x = data->feature_row(order[i]);
+                const float* y = data->label_row(order[i]);
+
+                std::copy(x, x + data->features(), inputs.scanStart() + (i - first) * data->features());
+                std::copy(y, y + data->label_columns(), labels.scanStart() + (i - first) * data->label_columns());
+            }
+
+            return Minibatch { Matrix::Representation{std::move(inputs)}, Matrix::Representation{std::move(labels)} };
+        }
+
+
+    }
+
+}
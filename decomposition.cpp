@@ -0,0 +1,265 @@
+#include "decomposition.h"
+#include "m_algorithms.h"
+
+#include <cilk/cilk.h>
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+
+#include <assert.h>
+
+
+namespace Matrix {
+
+    namespace Operations {
+
+        namespace Decomposition {
+
+
+            namespace {
+
+                constexpr int JACOBI_SWEEPS = 30;
+
+                // Sums in double, the rounding of long fp32 dot products is what spoils orthogonality.
+                template <typename L, typename R>
+                double dot(const L* x, const R* y, u_int64_t n) noexcept {
+                    double sum = 0;
+                    for (u_int64_t i = 0; i < n; i++) sum += double(x[i]) * double(y[i]);
+                    return sum;
+                }
+
+
+                /*
+                    Householder reflectors of the rows of at (k x m), the
+                    columns of a, as unit vectors over [j, m) stored in
+                    row j of the result. Leaves R in the upper triangle
+                    of at's transpose.
+                */
+                std::vector<double> householder(std::vector<double>& at, u_int64_t k, u_int64_t m) noexcept {
+
+                    std::vector<double> reflectors(k * m, 0.0);
+
+                    for (u_int64_t j = 0; j < k; j++) {
+
+                        double* x = at.data() + j * m;
+                        double* v = reflectors.data() + j * m;
+
+                        const double norm = std::sqrt(dot(x + j, x + j, m - j));
+
+                        if (norm == 0) continue;
+
+                        const double alpha = x[j] > 0 ? -norm : norm;
+
+                        std::copy(x + j, x + m, v + j);
+                        v[j] -= alpha;
+
+                        const double scale = 1 / std::sqrt(dot(v + j, v + j, m - j));
+                        for (u_int64_t i = j; i < m; i++) v[i] *= scale;
+
+                        cilk_for (u_int64_t c = j; c < k; c++) {
+
+                            double* column = at.data() + c * m;
+                            const double projection = 2 * dot(v + j, column + j, m - j);
+
+                            for (u_int64_t i = j; i < m; i++) column[i] -= projection * v[i];
+                        }
+                    }
+
+                    return reflectors;
+                }
+
+
+                /*
+                    Rotates pairs of rows of b (k x n) until they are
+                    orthogonal, applying every rotation to the rows of j
+                    (k x k) as well. With j starting as the identity,
+                    j · b_original = b throughout.
+                */
+                void one_sided_jacobi(std::vector<double>& b, std::vector<double>& j, u_int64_t k, u_int64_t n) noexcept {
+
+                    constexpr double TOLERANCE = 1e-12;
+
+                    auto rotate = [](double* p, double* q, u_int64_t len, double c, double s) {
+                        for (u_int64_t i = 0; i < len; i++) {
+                            const double x = p[i];
+                            const double y = q[i];
+                            p[i] = c * x - s * y;
+                            q[i] = s * x + c * y;
+                        }
+                    };
+
+                    for (int sweep = 0; sweep < JACOBI_SWEEPS; sweep++) {
+
+                        bool converged = true;
+
+                        for (u_int64_t p = 0; p + 1 < k; p++) {
+                            for (u_int64_t q = p + 1; q < k; q++) {
+
+                                double* bp = b.data() + p * n;
+                                double* bq = b.data() + q * n;
+
+                                const double alpha = dot(bp, bp, n);
+                                const double beta  = dot(bq, bq, n);
+                                const double gamma = dot(bp, bq, n);
+
+                                if (std::abs(gamma) <= TOLERANCE * std::sqrt(alpha * beta)) continue;
+
+                                converged = false;
+
+                                const double zeta = (beta - alpha) / (2 * gamma);
+                                const double t = (zeta >= 0 ? 1.0 : -1.0) / (std::abs(zeta) + std::sqrt(1 + zeta * zeta));
+                                const double c = 1 / std::sqrt(1 + t * t);
+                                const double s = c * t;
+
+                                rotate(bp, bq, n, c, s);
+                                rotate(j.data() + p * k, j.data() + q * k, k, c, s);
+                            }
+                        }
+
+                        if (converged) break;
+                    }
+                }
+
+
+                Matrix::Representation to_float(const std::vector<double>& m, u_int64_t rows, u_int64_t columns) noexcept {
+                    Matrix::Representation out = Matrix::Representation(Rows(rows), Columns(columns));
+                    std::transform(m.begin(), m.end(), out.scanStart(), [](double x) { return float(x); });
+                    return Matrix::Representation{std::move(out)};
+                }
+
+            }
+
+
+            QR qr(const Matrix::Representation& a) noexcept {
+
+                const u_int64_t m = a.num_rows();
+                const u_int64_t k = a.num_cols();
+
+                assert(m >= k && "Thin QR needs at least as many rows as columns.");
+
+                Matrix::Operations::Unary::Transpose transpose;
+                Matrix::Representation t = transpose(a);
+
+                std::vector<double> at(t.constScanStart(), t.constScanEnd());
+                std::vector<double> reflectors = householder(at, k, m);
+
+                // Q's columns, rows of its transpose: the reflectors applied in reverse to the identity.
+                std::vector<double> qt(k * m, 0.0);
+                for (u_int64_t c = 0; c < k; c++) qt[c * m + c] = 1;
+
+                for (u_int64_t j = k; j-- > 0;) {
+
+                    const double* v = reflectors.data() + j * m;
+
+                    cilk_for (u_int64_t c = 0; c < k; c++) {
+
+                        double* column = qt.data() + c * m;
+                        const double projection = 2 * dot(v + j, column + j, m - j);
+
+                        for (u_int64_t i = j; i < m; i++) column[i] -= projection * v[i];
+                    }
+                }
+
+                QR result;
+                result.Q = transpose(to_float(qt, k, m));
+                result.R = Matrix::Representation(Rows(k), Columns(k));
+
+                for (u_int64_t i = 0; i < k; i++) {
+                    for (u_int64_t c = i; c < k; c++) result.R.put(i, c, float(at[c * m + i]));
+                }
+
+                return result;
+            }
+
+
+            SVD randomized_svd(const Matrix::Representation& a, u_int64_t rank,
+                u_int64_t oversampling, u_int64_t power_iterations, u_int64_t seed) noexcept {
+
+                const u_int64_t m = a.num_rows();
+                const u_int64_t n = a.num_cols();
+                const u_int64_t k = std::min(rank + oversampling, std::min(m, n));
+
+                assert(rank > 0 && rank <= std::min(m, n) && "Rank must be between 1 and the smaller dimension.");
+
+                Matrix::Operations::Binary::Multiplication::ParallelDNC mul;
+                Matrix::Operations::Unary::Transpose transpose;
+
+                Matrix::Representation omega = Matrix::Representation(Rows(n), Columns(k));
+
+                std::mt19937_64 engine(seed);
+                std::normal_distribution<float> normal(0.0f, 1.0f);
+                std::generate(omega.scanStart(), omega.scanEnd(), [&]() { return normal(engine); });
+
+                Matrix::Representation at = transpose(a);
+
+                // Range finder; re-orthonormalizing between passes keeps small directions from drowning.
+                Matrix::Representation Q{qr(mul(a, omega)).Q};
+
+                for (u_int64_t i = 0; i < power_iterations; i++) {
+                    Matrix::Representation Z{qr(mul(at, Q)).Q};
+                    Q = qr(mul(a, Z)).Q;
+                }
+
+                // B = Qᵀ a, k x n, factorized exactly.
+                Matrix::Representation B = mul(transpose(Q), a);
+
+                std::vector<double> b(B.constScanStart(), B.constScanEnd());
+                std::vector<double> j(k * k, 0.0);
+                for (u_int64_t i = 0; i < k; i++) j[i * k + i] = 1;
+
+                one_sided_jacobi(b, j, k, n);
+
+                // j · B has orthogonal rows σ_i v_i, so B = jᵀ diag(σ) V.
+                std::vector<double> sigma(k);
+                for (u_int64_t i = 0; i < k; i++) sigma[i] = std::sqrt(dot(b.data() + i * n, b.data() + i * n, n));
+
+                std::vector<u_int64_t> order(k);
+                std::iota(order.begin(), order.end(), 0);
+                std::stable_sort(order.begin(), order.end(), [&sigma](u_int64_t x, u_int64_t y) { return sigma[x] > sigma[y]; });
+
+                SVD result;
+                result.S.resize(rank);
+                result.V = Matrix::Representation(Rows(rank), Columns(n));
+
+                Matrix::Representation small = Matrix::Representation(Rows(k), Columns(rank));
+
+                for (u_int64_t r = 0; r < rank; r++) {
+
+                    const u_int64_t i = order[r];
+                    const double inverse = sigma[i] > 0 ? 1 / sigma[i] : 0;
+
+                    result.S[r] = float(sigma[i]);
+
+                    for (u_int64_t c = 0; c < n; c++) result.V.put(r, c, float(b[i * n + c] * inverse));
+                    for (u_int64_t c = 0; c < k; c++) small.put(c, r, float(j[i * k + c]));
+                }
+
+                result.U = mul(Q, small);
+
+                return result;
+            }
+
+
+            float relative_error(const Matrix::Representation& a, const Matrix::Representation& l, const Matrix::Representation& r) noexcept {
+
+                assert(l.num_rows() == a.num_rows() && r.num_cols() == a.num_cols() && l.num_cols() == r.num_rows() &&
+                    "Factors do not multiply to the shape of the matrix.");
+
+                Matrix::Operations::Binary::Multiplication::ParallelDNC mul;
+                Matrix::Representation product = mul(l, r);
+
+                const double residual = std::transform_reduce(a.constScanStart(), a.constScanEnd(), product.constScanStart(), 0.0,
+                    std::plus<>(), [](float x, float y) { return (double(x) - y) * (double(x) - y); });
+
+                const double norm = dot(a.constScanStart(), a.constScanStart(), a.size());
+
+                return norm > 0 ? float(std::sqrt(residual / norm)) : 0.0f;
+            }
+
+
+        }
+
+    }
+
+}
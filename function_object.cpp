@@ -1,8 +1,13 @@
 #include "computational_graph_map.h"
 #include "function_object.h"
 #include "tensor.h"
+#include "tensor_factory.h"
 #include "matrix.h"
 #include "m_algorithms.h"
+#include "sparse.h"
+
+#include <algorithm>
+#include <functional>
 
 namespace NeuralNetwork {
 
@@ -31,8 +36,6 @@ namespace NeuralNetwork {
                 auto rtid = ce.right_op_id();
                 
 
-                ComputationalGraphMap& map = ComputationalGraphMap::get();
-                
                 auto right_op = map._get_tensor(rtid);
 
                 auto left_matrix  = Matrix::Representation{map._get_tensor(ltid)->release_matrix()};
@@ -48,7 +51,7 @@ namespace NeuralNetwork {
                     df.gradient = transpose(df.gradient);
                 }
 
-                right_op->get_grad() = df.gradient;
+                right_op->write_grad(df.gradient);
                 
                 return States::Invalidated{};
             }
@@ -65,26 +68,16 @@ namespace NeuralNetwork {
                         dJ/dx = dj/dz * dz/dx
 
 
-            Three cases:
-
-                Suppose incoming gradient dj/dz.
-
-                1)
-                    z = Wx, where z and x are vectors in R^n,
-                    and W is a matrix in R^m*n.
-                    
-                    dj/dx = dj/dz * W
-                    dj/dW = outerproduct{(dj/dz)^T, x^T}    
-
-                
-                2)    
-                    z = xW, where z and x are vectors in R^m 
-                    and R^n respectively, and W is a matrix 
-                    in R^m*n.
+                Suppose incoming gradient dj/dZ for Z = LR, where L is in 
+                R^b*n and R is in R^n*m. 
 
-                    dj/dx = dj/dz * W^T
-                    dj/dW = outerproduct{x^T, dj/dz}    
+                    dj/dL = dj/dZ * R^T
+                    dj/dR = L^T * dj/dZ
 
+                This covers a single sample (z = xW with x a row vector, 
+                z = Wx with x a column vector) as well as a minibatch of 
+                b rows, where dj/dW accumulates over the batch in the 
+                inner dimension of L^T * dj/dZ.
 
 
                 FIXME: cyclical computation graph could result in overwriting gradient
@@ -95,77 +88,108 @@ namespace NeuralNetwork {
                 auto ltid = mm.left_op_id();
                 auto rtid = mm.right_op_id();
                 
-                ComputationalGraphMap& map = ComputationalGraphMap::get();
-                
                 auto left_op = map._get_tensor(ltid);
                 auto right_op = map._get_tensor(rtid);
 
 
-                auto left_matrix  = Matrix::Representation{left_op->release_matrix()};
-                auto right_matrix = Matrix::Representation{right_op->release_matrix()};
-
-                bool row_times_matrix = left_matrix.get_type() == Matrix::Representation::Type::ROW_VECTOR && 
-                    right_matrix.get_type() == Matrix::Representation::Type::MATRIX;
-
-                bool matrix_times_col = left_matrix.get_type() == Matrix::Representation::Type::MATRIX && 
-                    right_matrix.get_type() == Matrix::Representation::Type::COLUMN_VECTOR;
+                const auto& left_matrix  = left_op->release_matrix();
+                const auto& right_matrix = right_op->release_matrix();
 
-                assert(row_times_matrix || matrix_times_col && "Matrix Multiply was invalid.");
+                assert(left_matrix.num_rows()  == df.gradient.num_rows() && 
+                       right_matrix.num_cols() == df.gradient.num_cols() && "Matrix Multiply was invalid.");
 
                 Matrix::Operations::Unary::Transpose transpose;
                 Matrix::Operations::Binary::Multiplication::ParallelDNC mult;
-                Matrix::Operations::Binary::OuterProduct::Naive outer;
 
-                std::cout << "Matrix Multiply Derivatives." << std::endl;
+                auto djdL = mult(df.gradient, transpose(right_matrix));
+                auto djdR = mult(transpose(left_matrix), df.gradient);
 
-                if (row_times_matrix) {
+                left_op->write_grad(std::move(djdL));
+                right_op->write_grad(std::move(djdR));
 
-                    std::cout << "row_times_matrix" << std::endl;
-                    auto xT   = transpose(left_matrix);                   
-                    auto djdW = outer(xT, df.gradient);
+                return States::Invalidated{};
+            }
 
-                    auto wT   = transpose(right_matrix);
-                    auto djdx = mult(df.gradient, wT);
-                    
-                    left_op->get_grad()  = djdx;
-                    right_op->get_grad() = djdW;
-                }
-                else if (matrix_times_col) {
-                    std::cout << "matrix_times_col" << std::endl;
 
-                    auto djdx = mult(df.gradient, left_matrix);
+            namespace {
 
-                    auto xT   = transpose(right_matrix);
-                    auto dfT  = transpose(df.gradient);
-                    auto djdW = outer(dfT, xT);
-                    
-                    
-                    left_op->get_grad()  = djdW;
-                    right_op->get_grad() = djdx;
+                /*
+                    Sums the incoming gradient back down to the shape of an
+                    operand that was broadcast in the forward pass. An operand
+                    whose matrix was already released holds no shape and was
+                    never broadcast (only parameters are), so the gradient 
+                    passes through unchanged.
+                */
+                Matrix::Representation reduce_to_operand(
+                    const Matrix::Representation& g, const std::shared_ptr<Tensor>& operand) noexcept {
 
+                    if (operand->release_matrix().size() == 0) return Matrix::Representation{g};
+
+                    return Matrix::Operations::Binary::reduce_to_shape(g, 
+                        Matrix::Rows(operand->num_rows().get()), Matrix::Columns(operand->num_cols().get()));
                 }
-                else assert (row_times_matrix || matrix_times_col && "Invalid Operands.");
 
-                return States::Invalidated{};
             }
 
+
+            /*
+                dj/dL = dj/dZ and dj/dR = dj/dZ for Z = L + R. An operand
+                broadcast over rows or columns (a bias over a minibatch)
+                receives the gradient summed over the broadcast axes.
+            */
             OperationTransitioner::State OperationTransitioner::operator()(States::Plus add, Events::Differentiate& df) noexcept {
                 
                 auto ltid = add.left_op_id();
                 auto rtid = add.right_op_id();
 
-                ComputationalGraphMap& map = ComputationalGraphMap::get();
-
                 auto left_op = map._get_tensor(ltid);
                 auto right_op = map._get_tensor(rtid);
 
+                left_op->write_grad(reduce_to_operand(df.gradient, left_op));
+                right_op->write_grad(reduce_to_operand(df.gradient, right_op));
+                
+                return States::Invalidated{};
+
+            }
 
-                auto left_matrix  = Matrix::Representation{left_op->release_matrix()};
-                auto right_matrix = Matrix::Representation{right_op->release_matrix()};
+
+            /*
+                dj/dL = dj/dZ and dj/dR = -dj/dZ for Z = L - R, reduced
+                over broadcast axes as for addition.
+            */
+            OperationTransitioner::State OperationTransitioner::operator()(States::Minus sub, Events::Differentiate& df) noexcept {
+                
+                auto left_op = map._get_tensor(sub.left_op_id());
+                auto right_op = map._get_tensor(sub.right_op_id());
+
+                auto negated = Matrix::Representation{df.gradient};
+                std::transform(negated.scanStart(), negated.scanEnd(), negated.scanStart(), std::negate<float>());
+
+                left_op->write_grad(reduce_to_operand(df.gradient, left_op));
+                right_op->write_grad(reduce_to_operand(negated, right_op));
+                
+                return States::Invalidated{};
+
+            }
 
 
-                left_op->get_grad() = left_matrix;
-                right_op->get_grad() = right_matrix;
+            /*
+                dj/dL = dj/dZ ⊙ R and dj/dR = dj/dZ ⊙ L for Z = L ⊙ R. The
+                products broadcast the same way the forward pass did and 
+                are then reduced back to each operand's shape.
+            */
+            OperationTransitioner::State OperationTransitioner::operator()(States::Hadamard hp, Events::Differentiate& df) noexcept {
+                
+                auto left_op = map._get_tensor(hp.left_op_id());
+                auto right_op = map._get_tensor(hp.right_op_id());
+
+                Matrix::Operations::Binary::HadamardProduct::Std hadamard;
+
+                auto djdL = hadamard(df.gradient, right_op->release_matrix());
+                auto djdR = hadamard(df.gradient, left_op->release_matrix());
+
+                left_op->write_grad(reduce_to_operand(djdL, left_op));
+                right_op->write_grad(reduce_to_operand(djdR, right_op));
                 
                 return States::Invalidated{};
 
@@ -177,8 +201,6 @@ namespace NeuralNetwork {
 
                 auto ltid = relu.left_op_id();
 
-                ComputationalGraphMap& map = ComputationalGraphMap::get();
-
                 auto left_op = map._get_tensor(ltid);
 
 
@@ -187,12 +209,79 @@ namespace NeuralNetwork {
                 Matrix::Operations::Unary::Sign sign;
                 Matrix::Operations::Binary::HadamardProduct::Std hadamard;
 
-                left_op->get_grad() = hadamard(sign(left_matrix), df.gradient);
+                left_op->write_grad(hadamard(sign(left_matrix), df.gradient));
                 
                 return States::Invalidated{};
 
             }
 
+            /*
+                DESCRIPTION:
+
+                    Recomputes the checkpointed segment from a detached 
+                    copy of its input, seeds the recomputed output with 
+                    the incoming gradient and runs the reverse pass over 
+                    the segment alone. Parameters inside the segment are 
+                    shared with the steps, so their gradients land in place.
+                    The recomputed interior is released straight after.
+            */
+            OperationTransitioner::State OperationTransitioner::operator()(States::Checkpoint cp, Events::Differentiate& df) noexcept {
+
+                auto tid  = cp.get_tensor_id();
+                auto ltid = cp.left_op_id();
+
+                auto left_op = map._get_tensor(ltid);
+                auto segment = map._get_segment(tid);
+
+                std::shared_ptr<Tensor> boundary;
+                {
+                    ComputationalGraphMap::Bind bind(map);
+                    boundary = TensorConstructor::create(left_op->release_matrix());
+                }
+
+                auto output = segment(boundary);
+
+                output->get_grad() = df.gradient;
+
+                output->backwards();
+
+                left_op->write_grad(boundary->get_grad());
+
+                map._detach_subgraph(output->get_tensor_id(), boundary->get_tensor_id());
+                boundary->detatch_from_computational_graph();
+
+                return States::Invalidated{};
+            }
+
+
+            /*
+                DESCRIPTION:
+
+                    Weight gradient of a sparse input times the weights,
+                    xᵀ · g, summed straight into the rows of the weight 
+                    gradient that the input touches. The arithmetic scales
+                    with the input's nonzeros; overwrite mode clears only 
+                    the rows the previous write touched, see 
+                    Tensor::sparse_grad(). The input is not a tensor and 
+                    gets no gradient.
+            */
+            OperationTransitioner::State OperationTransitioner::operator()(States::SparseMatrixMultiply smm, Events::Differentiate& df) noexcept {
+
+                auto weights = map._get_tensor(smm.left_op_id());
+                const auto& input = map._get_sparse_operand(smm.get_tensor_id());
+
+                assert(input.num_rows() == df.gradient.num_rows() && 
+                       weights->num_cols().get() == df.gradient.num_cols() && "Sparse Matrix Multiply was invalid.");
+
+                std::vector<u_int64_t> touched;
+
+                Matrix::Operations::Sparse::accumulate_transpose_product(input, df.gradient, weights->sparse_grad(), touched);
+
+                weights->touch_grad_rows(touched);
+
+                return States::Invalidated{};
+            }
+
             OperationTransitioner::State OperationTransitioner::operator()(const States::NoOperation& nop, Events::Differentiate&) noexcept {
                 return nop;
             }
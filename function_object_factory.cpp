@@ -48,7 +48,7 @@ namespace NeuralNetwork {
             */
             FunctionObject FunctionObjectFactory::create(T _res) {
 
-                ComputationalGraphMap& map = ComputationalGraphMap::get();
+                ComputationalGraphMap& map = _res->get_context();
 
                 auto tensor_identification = _res->get_tensor_id();
 
@@ -76,7 +76,7 @@ namespace NeuralNetwork {
                 RegisteryType operation, T _res, 
                 TensorID _operand_id, TensorID _operand_id_two) {
 
-                ComputationalGraphMap& map = ComputationalGraphMap::get();
+                ComputationalGraphMap& map = _res->get_context();
 
                 auto res_tensor_id = _res->get_tensor_id();
                 
@@ -90,7 +90,7 @@ namespace NeuralNetwork {
                 auto instantiate_event = Events::Instantiate(operation, binaryRegistry);
 
                 
-                fn_object.process_event(instantiate_event);
+                fn_object.process_event(instantiate_event, map);
                 fn_object.stringify_type();
 
                 // transition _res default NOP state to unary-state 
@@ -107,7 +107,7 @@ namespace NeuralNetwork {
             FunctionObject FunctionObjectFactory::create(
                 RegisteryType operation, T _res, TensorID _operand_id) {
 
-                ComputationalGraphMap& map = ComputationalGraphMap::get();
+                ComputationalGraphMap& map = _res->get_context();
 
                 auto res_tensor_id = _res->get_tensor_id();
 
@@ -119,7 +119,7 @@ namespace NeuralNetwork {
 
                 auto instantiate_event = Events::Instantiate(operation, unaryRegistry);
 
-                fn_object.process_event(instantiate_event);
+                fn_object.process_event(instantiate_event, map);
                 fn_object.stringify_type();
 
                 // transition _res default NOP state to unary-state 
@@ -132,6 +132,62 @@ namespace NeuralNetwork {
             }
 
 
+            /*
+                Registers the output of a checkpointed segment, keeping
+                the segment around so the reverse pass can recompute it
+                from the operand.
+            */
+            FunctionObject FunctionObjectFactory::create(
+                Segment _segment, T _res, TensorID _operand_id) {
+
+                ComputationalGraphMap& map = _res->get_context();
+
+                auto res_tensor_id = _res->get_tensor_id();
+
+                auto fn_object = FunctionObject();
+
+                auto checkpoint_event = Events::Checkpoint(
+                            RegisteredUnaryOperation(res_tensor_id, _operand_id)
+                        );
+
+                fn_object.process_event(checkpoint_event, map);
+                fn_object.stringify_type();
+
+                map._register_operation(_res, fn_object);
+                map._register_segment(res_tensor_id, std::move(_segment));
+
+                return fn_object;
+            }
+
+
+            /*
+                Registers the product of a sparse input and a weight 
+                tensor. The input is kept by the context until the
+                output's id is recovered, for the weight gradient.
+            */
+            FunctionObject FunctionObjectFactory::create(
+                std::shared_ptr<const Matrix::SparseRepresentation> _sparse, T _res, TensorID _weights_id) {
+
+                ComputationalGraphMap& map = _res->get_context();
+
+                auto res_tensor_id = _res->get_tensor_id();
+
+                auto fn_object = FunctionObject();
+
+                auto sparse_event = Events::SparseMultiply(
+                            RegisteredUnaryOperation(res_tensor_id, _weights_id)
+                        );
+
+                fn_object.process_event(sparse_event, map);
+                fn_object.stringify_type();
+
+                map._register_operation(_res, fn_object);
+                map._register_sparse_operand(res_tensor_id, std::move(_sparse));
+
+                return fn_object;
+            }
+
+
             template FunctionObject FunctionObjectFactory::create<Matrix::Operations::Unary::ReLU>(
                 Matrix::Operations::Unary::ReLU operation,
                 T _res, 
@@ -172,6 +228,12 @@ namespace NeuralNetwork {
                 TensorID _operand_id, 
                 TensorID _operand_id_two);
 
+            template FunctionObject FunctionObjectFactory::create<Matrix::Operations::Binary::Subtraction::Std>(
+                Matrix::Operations::Binary::Subtraction::Std operation,
+                T _res, 
+                TensorID _operand_id, 
+                TensorID _operand_id_two);
+
             template FunctionObject FunctionObjectFactory::create<Matrix::Operations::Binary::OuterProduct::Naive>(
                 Matrix::Operations::Binary::OuterProduct::Naive operation,
                 T _res, 
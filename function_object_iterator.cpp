@@ -12,34 +12,44 @@ namespace NeuralNetwork {
         namespace Graph {
 
 
-                void ReadParameterPolicy::process_head(TensorID tid) {}
+                void ReadParameterPolicy::process_head(ComputationalGraphMap&, TensorID) {}
 
 
-                void ReadParameterPolicy::apply_to_children(std::stack<TensorID>& nodeStack, TensorID tid) {
+                void ReadParameterPolicy::apply_to_children(ComputationalGraphMap&, std::stack<TensorID>& nodeStack, TensorID tid) {
                     nodeStack.emplace(tid);
                 }
 
 
-                ReadParameterPolicy::ReturnType ReadParameterPolicy::dereference(TensorID tid) {
+                ReadParameterPolicy::ReturnType ReadParameterPolicy::dereference(ComputationalGraphMap& map, TensorID tid) {
 
-                    ComputationalGraphMap& map = ComputationalGraphMap::get();
                     return map._get_tensor(tid)->release_matrix();
                 }
 
 
-                ReadParameterPolicy::Matrix_t ReadParameterPolicy::grad(TensorID tid) {
+                ReadParameterPolicy::Matrix_t ReadParameterPolicy::grad(ComputationalGraphMap& map, TensorID tid) {
 
-                    ComputationalGraphMap& map = ComputationalGraphMap::get();
-                    auto gradient = Matrix_t{map._get_tensor(tid)->get_grad()};
+                    auto tensor = map._get_tensor(tid);
+
+                    // Tensors no gradient flowed into read as zeros.
+                    if (!tensor->has_grad()) {
+                        return Matrix_t{tensor->num_rows(), tensor->num_cols()};
+                    }
+
+                    auto gradient = Matrix_t{tensor->get_grad()};
                     return Matrix_t{gradient};
                 }
 
 
-                void ComputeGradientPolicy::process_head(TensorID tid) {
+                void ReadParameterPolicy::zero_grad(ComputationalGraphMap& map, TensorID tid) {
+
+                    map._get_tensor(tid)->zero_grad();
+                }
+
+
+                void ComputeGradientPolicy::process_head(ComputationalGraphMap& map, TensorID tid) {
 
                     // std::cout << "Backpropigating TID: " << _t.get() << std::endl;
 
-                    ComputationalGraphMap& map = ComputationalGraphMap::get();
                     auto operation = map._get_operation(tid);
 
                     // auto _r = map._get_tensor(current)->release_matrix().num_rows();
@@ -54,21 +64,38 @@ namespace NeuralNetwork {
                     // matrix = unit_gen(matrix);
 
                     // Events::Differentiate backpropigate_grad(matrix);
-                    Events::Differentiate backpropigate_grad(Matrix_t{});
+
+                    // Seeded with the head's own gradient if the caller 
+                    // wrote an upstream gradient into it, ones otherwise.
+                    auto head = map._get_tensor(tid);
+                    auto seed = Matrix_t{head->num_rows(), head->num_cols()};
+
+                    if (head->has_grad()) seed = head->get_grad();
+                    else {
+                        Matrix::Generation::Tester<1> unit_gen;
+                        seed = unit_gen(seed);
+                    }
+
+                    Events::Differentiate backpropigate_grad(seed);
                     
                     operation.stringify_type();
                     std::cout << "Computing Leaf Derivative" << std::endl;
-                    operation.process_event(backpropigate_grad);
+                    operation.process_event(backpropigate_grad, map);
                     operation.stringify_type();
                             
 
                  }
 
 
-                void ComputeGradientPolicy::apply_to_children(std::stack<TensorID>& nodeStack, TensorID tid) {
+                void ComputeGradientPolicy::apply_to_children(ComputationalGraphMap& map, std::stack<TensorID>& nodeStack, TensorID tid) {
                     
-                    ComputationalGraphMap& map = ComputationalGraphMap::get();
-                    auto df = Matrix_t{map._get_tensor(tid)->get_grad()};
+                    auto child = map._get_tensor(tid);
+
+                    // No gradient flows past an operand its consumer did 
+                    // not differentiate (e.g. the labels of a loss).
+                    if (!child->has_grad()) return;
+
+                    auto df = Matrix_t{child->get_grad()};
                     assert(df.num_rows() && df.num_cols() && "Invalid Derivative.");
                     std::cout << "Gradient DIM: [" << df.num_rows() << "," << df.num_cols() << "]" << std::endl;
                     
@@ -77,25 +104,24 @@ namespace NeuralNetwork {
                     
                     operation.stringify_type();
                     std::cout << "Processing event:" << std::endl;
-                    operation.process_event(backpropigate_grad);
+                    operation.process_event(backpropigate_grad, map);
                     operation.stringify_type();
                     nodeStack.emplace(tid);
                 }
 
 
-                ComputeGradientPolicy::ReturnType ComputeGradientPolicy::dereference(TensorID tid) {
+                ComputeGradientPolicy::ReturnType ComputeGradientPolicy::dereference(ComputationalGraphMap& map, TensorID tid) {
 
-                    ComputationalGraphMap& map = ComputationalGraphMap::get();
                     FunctionObject fn_obj = map._get_operation(tid);
                     return fn_obj;
                 }
 
                 template <TraversalPolicy TP>  
-                LevelOrderIterator<TP>::LevelOrderIterator(const TensorID _t) noexcept : current(_t) {
+                LevelOrderIterator<TP>::LevelOrderIterator(ComputationalGraphMap& _map, const TensorID _t) noexcept : map(_map), current(_t) {
                         
                         if (_t.get()) {
 
-                            TP::process_head(_t);
+                            TP::process_head(map, _t);
                             this->_stack_children();   
                         }
 
@@ -122,15 +148,14 @@ namespace NeuralNetwork {
                 template <TraversalPolicy TP>  
                 typename LevelOrderIterator<TP>::IterReturnType LevelOrderIterator<TP>::operator*() const noexcept {
                         
-                    return TP::dereference(current);
+                    return TP::dereference(map, current);
                 }
 
 
                 template <TraversalPolicy TP>  
                 void LevelOrderIterator<TP>::_stack_children(void) noexcept {
 
-                        ComputationalGraphMap& map = ComputationalGraphMap::get();
-                        FunctionObject fn_obj = map._get_operation(current);
+                            FunctionObject fn_obj = map._get_operation(current);
 
                         fn_obj.stringify_type();
 
@@ -142,7 +167,7 @@ namespace NeuralNetwork {
 
                                 if (i++) {
                                     
-                                    TP::apply_to_children(nodeStack, TensorID(tid->get()));
+                                    TP::apply_to_children(map, nodeStack, TensorID(tid->get()));
 
                                 }
                             }
@@ -74,4 +74,33 @@ int32_t Functions::Utility::ulpsDistance(const float a, const float b)
     return distance;
 }
 
-// --------------------------------------------------
\ No newline at end of file
+// --------------------------------------------------
+
+
+bool Functions::Utility::compare_float(double a, double b) {
+    
+    const double difference = fabs(a - b);
+    if (difference <= EPSILON) return true;
+
+    return Functions::Utility::ulpsDistance(a, b) <= ULPS_EPSILON;
+}
+
+
+int64_t Functions::Utility::ulpsDistance(const double a, const double b)
+{
+    if (a == b) return 0;
+
+    if (isnan(a) || isnan(b)) return INT64_MAX;
+
+    if (isinf(a) || isinf(b)) return INT64_MAX;
+
+    int64_t ia, ib;
+    memcpy(&ia, &a, sizeof(double));
+    memcpy(&ib, &b, sizeof(double));
+
+    if ((ia < 0) != (ib < 0)) return INT64_MAX;
+
+    int64_t distance = ia - ib;
+    if (distance < 0) distance = -distance;
+    return distance;
+}
@@ -0,0 +1,33 @@
+#include "grad_mode.h"
+#include "computational_graph_map.h"
+
+
+namespace NeuralNetwork {
+
+    namespace Computation {
+
+        namespace Graph {
+
+
+            bool GradMode::is_enabled() noexcept {
+                return ComputationalGraphMap::get().is_grad_enabled();
+            }
+
+            void GradMode::set_enabled(bool _enabled) noexcept {
+                ComputationalGraphMap::get().set_grad_enabled(_enabled);
+            }
+
+
+            NoGradGuard::NoGradGuard() noexcept : NoGradGuard(ComputationalGraphMap::get()) {}
+
+            NoGradGuard::NoGradGuard(ComputationalGraphMap& _map) noexcept : 
+                map(_map), previous(_map.is_grad_enabled()) { map.set_grad_enabled(false); }
+
+            NoGradGuard::~NoGradGuard() noexcept { map.set_grad_enabled(previous); }
+
+
+        }
+
+    }
+
+}
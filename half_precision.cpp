@@ -0,0 +1,480 @@
+#include "half_precision.h"
+
+#include <cilk/cilk.h>
+#include <algorithm>
+
+#if defined(__F16C__)
+#include <immintrin.h>
+#endif
+
+#include <assert.h>
+
+
+namespace Matrix {
+
+
+    namespace {
+
+        constexpr u_int64_t ROW_BLOCK    = 32;
+        constexpr u_int64_t COLUMN_BLOCK = 256;
+        constexpr u_int64_t GEMV_BLOCK   = 4096;
+        constexpr u_int64_t ELEMENT_BLOCK = 1 << 14;
+
+        constexpr u_int64_t blocks(u_int64_t n, u_int64_t block) noexcept {
+            return (n + block - 1) / block;
+        }
+
+
+        // Loads n elements of either format as fp32.
+        inline void load(const float* _src, float* _dst, u_int64_t _n) noexcept {
+            std::copy(_src, _src + _n, _dst);
+        }
+
+        template <HalfFloat T>
+        inline void load(const T* _src, float* _dst, u_int64_t _n) noexcept {
+            widen(_src, _dst, _n);
+        }
+
+        // y += a * x over n elements, widening x in registers.
+        inline void axpy(float _a, const float* __restrict _x, float* __restrict _y, u_int64_t _n) noexcept {
+            for (u_int64_t j = 0; j < _n; j++) _y[j] += _a * _x[j];
+        }
+
+        inline void axpy(float _a, const bfloat16* __restrict _x, float* __restrict _y, u_int64_t _n) noexcept {
+            const uint16_t* __restrict bits = reinterpret_cast<const uint16_t*>(_x);
+            for (u_int64_t j = 0; j < _n; j++) _y[j] += _a * std::bit_cast<float>(uint32_t(bits[j]) << 16);
+        }
+
+        inline void axpy(float _a, const float16* __restrict _x, float* __restrict _y, u_int64_t _n) noexcept {
+
+            u_int64_t j = 0;
+
+#if defined(__F16C__)
+            const __m256 a = _mm256_set1_ps(_a);
+
+            for (; j + 8 <= _n; j += 8) {
+                __m256 x = _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(_x + j)));
+                _mm256_storeu_ps(_y + j, _mm256_add_ps(_mm256_loadu_ps(_y + j), _mm256_mul_ps(a, x)));
+            }
+#endif
+
+            for (; j < _n; j++) _y[j] += _a * _x[j].to_float();
+        }
+
+        inline float value(const float& _x) noexcept { return _x; }
+
+        template <HalfFloat T>
+        inline float value(const T& _x) noexcept { return _x.to_float(); }
+
+
+        /*
+            c (m x n) = a (m x k) * b (k x n), b and c row major, a(i, p)
+            at a[i * a_row + p * a_column] so a transposed left operand
+            is read in place. Each task owns a ROW_BLOCK x COLUMN_BLOCK
+            tile of c; for every k it widens the tile's slice of row k
+            of b once and sweeps it across the tile's rows.
+
+            A single row (a GEMV) has nothing to reuse: it streams long
+            runs of every row of b and widens them in registers.
+        */
+        template <typename L, typename R>
+        void gemm(const L* a, const R* b, float* c, u_int64_t m, u_int64_t k, u_int64_t n,
+            u_int64_t a_row, u_int64_t a_column) noexcept {
+
+            if (m == 1) {
+
+                cilk_for (u_int64_t block = 0; block < blocks(n, GEMV_BLOCK); block++) {
+
+                    const u_int64_t j0 = block * GEMV_BLOCK;
+                    const u_int64_t width = std::min(n, j0 + GEMV_BLOCK) - j0;
+
+                    for (u_int64_t p = 0; p < k; p++) axpy(value(a[p * a_column]), b + p * n + j0, c + j0, width);
+                }
+                return;
+            }
+
+            const u_int64_t column_blocks = blocks(n, COLUMN_BLOCK);
+
+            cilk_for (u_int64_t tile = 0; tile < blocks(m, ROW_BLOCK) * column_blocks; tile++) {
+
+                const u_int64_t i0 = (tile / column_blocks) * ROW_BLOCK;
+                const u_int64_t j0 = (tile % column_blocks) * COLUMN_BLOCK;
+                const u_int64_t i1 = std::min(m, i0 + ROW_BLOCK);
+                const u_int64_t width = std::min(n, j0 + COLUMN_BLOCK) - j0;
+
+                alignas(64) float row[COLUMN_BLOCK];
+
+                for (u_int64_t p = 0; p < k; p++) {
+
+                    load(b + p * n + j0, row, width);
+
+                    for (u_int64_t i = i0; i < i1; i++) {
+
+                        const float scale = value(a[i * a_row + p * a_column]);
+                        float* __restrict out = c + i * n + j0;
+
+                        for (u_int64_t j = 0; j < width; j++) out[j] += scale * row[j];
+                    }
+                }
+            }
+        }
+
+
+        /*
+            c (m x n) = a (m x k) * b (n x k)ᵀ, all row major: every
+            entry is the dot product of a row of a and a row of b. Each
+            task owns a ROW_BLOCK x ROW_BLOCK tile of c and walks k in
+            COLUMN_BLOCK slices, widening the tile's rows of a once per
+            slice and each row of b once per tile.
+        */
+        template <typename L, typename R>
+        void gemm_transposed(const L* a, const R* b, float* c, u_int64_t m, u_int64_t k, u_int64_t n) noexcept {
+
+            const u_int64_t column_blocks = blocks(n, ROW_BLOCK);
+
+            cilk_for (u_int64_t tile = 0; tile < blocks(m, ROW_BLOCK) * column_blocks; tile++) {
+
+                const u_int64_t i0 = (tile / column_blocks) * ROW_BLOCK;
+                const u_int64_t j0 = (tile % column_blocks) * ROW_BLOCK;
+                const u_int64_t i1 = std::min(m, i0 + ROW_BLOCK);
+                const u_int64_t j1 = std::min(n, j0 + ROW_BLOCK);
+
+                alignas(64) float left[ROW_BLOCK * COLUMN_BLOCK];
+                alignas(64) float row[COLUMN_BLOCK];
+
+                for (u_int64_t p0 = 0; p0 < k; p0 += COLUMN_BLOCK) {
+
+                    const u_int64_t width = std::min(k, p0 + COLUMN_BLOCK) - p0;
+
+                    for (u_int64_t i = i0; i < i1; i++) load(a + i * k + p0, left + (i - i0) * COLUMN_BLOCK, width);
+
+                    for (u_int64_t j = j0; j < j1; j++) {
+
+                        load(b + j * k + p0, row, width);
+
+                        for (u_int64_t i = i0; i < i1; i++) {
+
+                            const float* __restrict x = left + (i - i0) * COLUMN_BLOCK;
+                            float sum = 0;
+
+                            for (u_int64_t q = 0; q < width; q++) sum += x[q] * row[q];
+
+                            c[i * n + j] += sum;
+                        }
+                    }
+                }
+            }
+        }
+
+
+        // l with the single row r broadcast over its rows, op applied in fp32.
+        template <typename L, typename Op>
+        Matrix::Representation broadcast_row(const L& l, const Matrix::Representation& r, Op op) noexcept {
+
+            assert(r.num_rows() == 1 && l.num_cols() == r.num_cols());
+
+            Matrix::Representation output = Matrix::Representation(Rows(l.num_rows()), Columns(l.num_cols()));
+
+            const u_int64_t n = l.num_cols();
+
+            cilk_for (u_int64_t i = 0; i < l.num_rows(); i++) {
+
+                alignas(64) float x[COLUMN_BLOCK];
+
+                for (u_int64_t s = 0; s < n; s += COLUMN_BLOCK) {
+
+                    const u_int64_t width = std::min(COLUMN_BLOCK, n - s);
+                    const float* __restrict y = r.constScanStart() + s;
+                    float* __restrict out = output.scanStart() + i * n + s;
+
+                    load(l.constScanStart() + i * n + s, x, width);
+
+                    for (u_int64_t j = 0; j < width; j++) out[j] = op(x[j], y[j]);
+                }
+            }
+
+            return Matrix::Representation{std::move(output)};
+        }
+
+
+        template <typename L, typename R, typename Op>
+        Matrix::Representation elementwise(const L& l, const R& r, Op op) noexcept {
+
+            assert(l.num_rows() == r.num_rows() && l.num_cols() == r.num_cols());
+
+            Matrix::Representation output = Matrix::Representation(Rows(l.num_rows()), Columns(l.num_cols()));
+
+            const u_int64_t n = output.size();
+
+            cilk_for (u_int64_t b = 0; b < blocks(n, ELEMENT_BLOCK); b++) {
+
+                const u_int64_t first = b * ELEMENT_BLOCK;
+                const u_int64_t count = std::min(n, first + ELEMENT_BLOCK) - first;
+
+                alignas(64) float x[COLUMN_BLOCK], y[COLUMN_BLOCK];
+
+                for (u_int64_t s = 0; s < count; s += COLUMN_BLOCK) {
+
+                    const u_int64_t width = std::min(COLUMN_BLOCK, count - s);
+                    float* __restrict out = output.scanStart() + first + s;
+
+                    load(l.constScanStart() + first + s, x, width);
+                    load(r.constScanStart() + first + s, y, width);
+
+                    for (u_int64_t j = 0; j < width; j++) out[j] = op(x[j], y[j]);
+                }
+            }
+
+            return Matrix::Representation{std::move(output)};
+        }
+
+    }
+
+
+    template <>
+    void widen(const bfloat16* _src, float* _dst, u_int64_t _n) noexcept {
+
+        const uint16_t* __restrict bits = reinterpret_cast<const uint16_t*>(_src);
+        uint32_t* __restrict out = reinterpret_cast<uint32_t*>(_dst);
+
+        for (u_int64_t i = 0; i < _n; i++) out[i] = uint32_t(bits[i]) << 16;
+    }
+
+
+    template <>
+    void narrow(const float* _src, bfloat16* _dst, u_int64_t _n) noexcept {
+        for (u_int64_t i = 0; i < _n; i++) _dst[i] = bfloat16::from_float(_src[i]);
+    }
+
+
+    template <>
+    void widen(const float16* _src, float* _dst, u_int64_t _n) noexcept {
+
+        u_int64_t i = 0;
+
+#if defined(__F16C__)
+        for (; i + 8 <= _n; i += 8) {
+            __m128i h = _mm_loadu_si128(reinterpret_cast<const __m128i*>(_src + i));
+            _mm256_storeu_ps(_dst + i, _mm256_cvtph_ps(h));
+        }
+#endif
+
+        for (; i < _n; i++) _dst[i] = _src[i].to_float();
+    }
+
+
+    template <>
+    void narrow(const float* _src, float16* _dst, u_int64_t _n) noexcept {
+
+        u_int64_t i = 0;
+
+#if defined(__F16C__)
+        for (; i + 8 <= _n; i += 8) {
+            __m128i h = _mm256_cvtps_ph(_mm256_loadu_ps(_src + i), _MM_FROUND_TO_NEAREST_INT);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(_dst + i), h);
+        }
+#endif
+
+        for (; i < _n; i++) _dst[i] = float16::from_float(_src[i]);
+    }
+
+
+    template <HalfFloat T>
+    BasicRepresentation<T> narrow(const Matrix::Representation& m) noexcept {
+
+        BasicRepresentation<T> output;
+        narrow(m, output);
+        return BasicRepresentation<T>{std::move(output)};
+    }
+
+
+    template <HalfFloat T>
+    void narrow(const Matrix::Representation& m, BasicRepresentation<T>& out) noexcept {
+
+        if (out.num_rows() != m.num_rows() || out.num_cols() != m.num_cols()) {
+            out = BasicRepresentation<T>(Rows(m.num_rows()), Columns(m.num_cols()));
+        }
+
+        const u_int64_t n = m.size();
+
+        cilk_for (u_int64_t b = 0; b < blocks(n, ELEMENT_BLOCK); b++) {
+            const u_int64_t first = b * ELEMENT_BLOCK;
+            narrow(m.constScanStart() + first, out.scanStart() + first, std::min(n, first + ELEMENT_BLOCK) - first);
+        }
+    }
+
+
+    template <HalfFloat T>
+    Matrix::Representation widen(const BasicRepresentation<T>& m) noexcept {
+
+        Matrix::Representation output = Matrix::Representation(Rows(m.num_rows()), Columns(m.num_cols()));
+
+        const u_int64_t n = m.size();
+
+        cilk_for (u_int64_t b = 0; b < blocks(n, ELEMENT_BLOCK); b++) {
+            const u_int64_t first = b * ELEMENT_BLOCK;
+            widen(m.constScanStart() + first, output.scanStart() + first, std::min(n, first + ELEMENT_BLOCK) - first);
+        }
+
+        return Matrix::Representation{std::move(output)};
+    }
+
+
+    template BasicRepresentation<bfloat16> narrow(const Matrix::Representation&) noexcept;
+    template BasicRepresentation<float16> narrow(const Matrix::Representation&) noexcept;
+    template void narrow(const Matrix::Representation&, BasicRepresentation<bfloat16>&) noexcept;
+    template void narrow(const Matrix::Representation&, BasicRepresentation<float16>&) noexcept;
+    template Matrix::Representation widen(const BasicRepresentation<bfloat16>&) noexcept;
+    template Matrix::Representation widen(const BasicRepresentation<float16>&) noexcept;
+
+
+    namespace Operations {
+
+        namespace LowPrecision {
+
+
+            template <HalfFloat T>
+            Matrix::Representation multiply(const Matrix::Representation& l, const BasicRepresentation<T>& r) noexcept {
+
+                assert(l.num_cols() == r.num_rows());
+
+                Matrix::Representation output = Matrix::Representation(Rows(l.num_rows()), Columns(r.num_cols()));
+                gemm(l.constScanStart(), r.constScanStart(), output.scanStart(), l.num_rows(), l.num_cols(), r.num_cols(), l.num_cols(), 1);
+                return Matrix::Representation{std::move(output)};
+            }
+
+
+            template <HalfFloat T>
+            Matrix::Representation multiply(const BasicRepresentation<T>& l, const BasicRepresentation<T>& r) noexcept {
+
+                assert(l.num_cols() == r.num_rows());
+
+                Matrix::Representation output = Matrix::Representation(Rows(l.num_rows()), Columns(r.num_cols()));
+                gemm(l.constScanStart(), r.constScanStart(), output.scanStart(), l.num_rows(), l.num_cols(), r.num_cols(), l.num_cols(), 1);
+                return Matrix::Representation{std::move(output)};
+            }
+
+
+            template <HalfFloat T>
+            Matrix::Representation multiply(const BasicRepresentation<T>& l, const Matrix::Representation& r) noexcept {
+
+                assert(l.num_cols() == r.num_rows());
+
+                Matrix::Representation output = Matrix::Representation(Rows(l.num_rows()), Columns(r.num_cols()));
+                gemm(l.constScanStart(), r.constScanStart(), output.scanStart(), l.num_rows(), l.num_cols(), r.num_cols(), l.num_cols(), 1);
+                return Matrix::Representation{std::move(output)};
+            }
+
+
+            template <HalfFloat T>
+            Matrix::Representation transpose_multiply(const BasicRepresentation<T>& l, const BasicRepresentation<T>& r) noexcept {
+
+                assert(l.num_rows() == r.num_rows());
+
+                Matrix::Representation output = Matrix::Representation(Rows(l.num_cols()), Columns(r.num_cols()));
+                gemm(l.constScanStart(), r.constScanStart(), output.scanStart(), l.num_cols(), l.num_rows(), r.num_cols(), 1, l.num_cols());
+                return Matrix::Representation{std::move(output)};
+            }
+
+
+            template <HalfFloat T>
+            Matrix::Representation multiply_transpose(const BasicRepresentation<T>& l, const BasicRepresentation<T>& r) noexcept {
+
+                assert(l.num_cols() == r.num_cols());
+
+                Matrix::Representation output = Matrix::Representation(Rows(l.num_rows()), Columns(r.num_rows()));
+                gemm_transposed(l.constScanStart(), r.constScanStart(), output.scanStart(), l.num_rows(), l.num_cols(), r.num_rows());
+                return Matrix::Representation{std::move(output)};
+            }
+
+
+            template <HalfFloat T>
+            Matrix::Representation add(const BasicRepresentation<T>& l, const Matrix::Representation& r) noexcept {
+
+                if (r.num_rows() == 1 && l.num_rows() != 1) return broadcast_row(l, r, [](float x, float y) { return x + y; });
+
+                return elementwise(l, r, [](float x, float y) { return x + y; });
+            }
+
+
+            template <HalfFloat T>
+            Matrix::Representation add(const BasicRepresentation<T>& l, const BasicRepresentation<T>& r) noexcept {
+                return elementwise(l, r, [](float x, float y) { return x + y; });
+            }
+
+
+            template <HalfFloat T>
+            Matrix::Representation hadamard(const BasicRepresentation<T>& l, const Matrix::Representation& r) noexcept {
+                return elementwise(l, r, [](float x, float y) { return x * y; });
+            }
+
+
+            template <HalfFloat T>
+            Matrix::Representation hadamard(const BasicRepresentation<T>& l, const BasicRepresentation<T>& r) noexcept {
+                return elementwise(l, r, [](float x, float y) { return x * y; });
+            }
+
+
+            template <HalfFloat T>
+            Matrix::Representation relu(const BasicRepresentation<T>& m) noexcept {
+                return elementwise(m, m, [](float x, float) { return std::max(x, 0.0f); });
+            }
+
+
+            template <HalfFloat T>
+            Matrix::Representation relu_gradient(const BasicRepresentation<T>& m, const BasicRepresentation<T>& g) noexcept {
+                return elementwise(m, g, [](float x, float y) { return x > 0 ? y : 0.0f; });
+            }
+
+
+            template <HalfFloat T>
+            Matrix::Representation sum_rows(const BasicRepresentation<T>& m) noexcept {
+
+                const u_int64_t n = m.num_cols();
+
+                Matrix::Representation output = Matrix::Representation(Rows(1), Columns(n));
+
+                cilk_for (u_int64_t b = 0; b < blocks(n, COLUMN_BLOCK); b++) {
+
+                    const u_int64_t j0 = b * COLUMN_BLOCK;
+                    const u_int64_t width = std::min(n, j0 + COLUMN_BLOCK) - j0;
+
+                    alignas(64) float row[COLUMN_BLOCK];
+                    float* __restrict out = output.scanStart() + j0;
+
+                    for (u_int64_t i = 0; i < m.num_rows(); i++) {
+
+                        load(m.constScanStart() + i * n + j0, row, width);
+
+                        for (u_int64_t j = 0; j < width; j++) out[j] += row[j];
+                    }
+                }
+
+                return Matrix::Representation{std::move(output)};
+            }
+
+
+#define LOW_PRECISION_KERNELS(T) \
+            template Matrix::Representation multiply(const Matrix::Representation&, const BasicRepresentation<T>&) noexcept; \
+            template Matrix::Representation multiply(const BasicRepresentation<T>&, const BasicRepresentation<T>&) noexcept; \
+            template Matrix::Representation multiply(const BasicRepresentation<T>&, const Matrix::Representation&) noexcept; \
+            template Matrix::Representation transpose_multiply(const BasicRepresentation<T>&, const BasicRepresentation<T>&) noexcept; \
+            template Matrix::Representation multiply_transpose(const BasicRepresentation<T>&, const BasicRepresentation<T>&) noexcept; \
+            template Matrix::Representation add(const BasicRepresentation<T>&, const Matrix::Representation&) noexcept; \
+            template Matrix::Representation add(const BasicRepresentation<T>&, const BasicRepresentation<T>&) noexcept; \
+            template Matrix::Representation hadamard(const BasicRepresentation<T>&, const Matrix::Representation&) noexcept; \
+            template Matrix::Representation hadamard(const BasicRepresentation<T>&, const BasicRepresentation<T>&) noexcept; \
+            template Matrix::Representation relu(const BasicRepresentation<T>&) noexcept; \
+            template Matrix::Representation relu_gradient(const BasicRepresentation<T>&, const BasicRepresentation<T>&) noexcept; \
+            template Matrix::Representation sum_rows(const BasicRepresentation<T>&) noexcept;
+
+            LOW_PRECISION_KERNELS(bfloat16)
+            LOW_PRECISION_KERNELS(float16)
+
+#undef LOW_PRECISION_KERNELS
+
+        }
+
+    }
+
+}
@@ -0,0 +1,115 @@
+#include "hogwild.h"
+#include "data_parallel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <numeric>
+#include <thread>
+
+#include <assert.h>
+
+
+namespace NeuralNetwork {
+
+    namespace Training {
+
+
+        namespace {
+
+            /*
+                Zero gradients are skipped, so a sparse update only
+                touches (and only contends on) the weights it changes.
+            */
+            void apply_racy(float* w, const float* __restrict g, size_t n, float lr) noexcept {
+                for (size_t i = 0; i < n; i++) {
+                    if (g[i] != 0) w[i] -= lr * g[i];
+                }
+            }
+
+            void apply_relaxed_atomic(float* w, const float* __restrict g, size_t n, float lr) noexcept {
+                for (size_t i = 0; i < n; i++) {
+                    if (g[i] != 0) std::atomic_ref<float>(w[i]).fetch_sub(lr * g[i], std::memory_order_relaxed);
+                }
+            }
+
+        }
+
+
+        Hogwild::Hogwild(Sequential& _master, const ModelBuilder& _build, size_t _threads,
+            float _learning_rate, UpdatePolicy _policy) noexcept :
+                learning_rate(_learning_rate), policy(_policy) {
+
+            assert(_threads > 0 && "Hogwild training needs at least one thread.");
+
+            master = _master.flat_parameters() ? _master.flat_parameters() : _master.flatten();
+
+            for (size_t t = 0; t < _threads; t++) {
+
+                auto replica = std::make_unique<Replica>();
+
+                {
+                    GraphContext::Bind bind(replica->context);
+                    _build(replica->model);
+                }
+
+                replica->flat = replica->model.flatten(*master);
+
+                replicas.push_back(std::move(replica));
+            }
+        }
+
+
+        float Hogwild::epoch(const Matrix::Representation& _inputs, const Matrix::Representation& _labels,
+            u_int64_t _batch_size) noexcept {
+
+            assert(_inputs.num_rows() == _labels.num_rows() && "Every sample needs a label.");
+            assert(_batch_size > 0 && "Batch size must be positive.");
+
+            const u_int64_t samples = _inputs.num_rows();
+            const u_int64_t threads = replicas.size();
+
+            std::vector<std::thread> workers;
+
+            for (u_int64_t t = 0; t < threads; t++) {
+                workers.emplace_back([this, &_inputs, &_labels, samples, threads, t, _batch_size]() {
+                    replicas[t]->loss = _train_shard(*replicas[t], _inputs, _labels,
+                        samples * t / threads, samples * (t + 1) / threads, _batch_size);
+                });
+            }
+
+            for (auto& worker: workers) worker.join();
+
+            return std::accumulate(replicas.begin(), replicas.end(), 0.0f,
+                [](float total, const std::unique_ptr<Replica>& replica) { return total + replica->loss; });
+        }
+
+
+        float Hogwild::_train_shard(Replica& _replica, const Matrix::Representation& _inputs,
+            const Matrix::Representation& _labels, u_int64_t _first, u_int64_t _last,
+            u_int64_t _batch_size) noexcept {
+
+            float total = 0;
+
+            for (u_int64_t first = _first; first < _last; first += _batch_size) {
+
+                u_int64_t last = std::min(_last, first + _batch_size);
+
+                _replica.flat->zero_grad();
+
+                total += train_rows(_replica.model, _replica.context, _inputs, _labels, first, last);
+
+                if (policy == UpdatePolicy::RELAXED_ATOMIC) {
+                    apply_relaxed_atomic(_replica.flat->weights(), _replica.flat->gradients(), _replica.flat->size(), learning_rate);
+                }
+                else {
+                    apply_racy(_replica.flat->weights(), _replica.flat->gradients(), _replica.flat->size(), learning_rate);
+                }
+            }
+
+            return total;
+        }
+
+
+    }
+
+}
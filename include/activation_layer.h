@@ -17,12 +17,16 @@ namespace NeuralNetwork {
 
             public:     
                 std::shared_ptr<Computation::Graph::Tensor> doForward(std::shared_ptr<Computation::Graph::Tensor> input) noexcept;
+                std::shared_ptr<Computation::Graph::Tensor> doForward(std::shared_ptr<Computation::Graph::Tensor> input, Computation::Graph::InferenceTag _tag) noexcept;
+                void collect_kernels(std::vector<KernelSpec>& _kernels) noexcept override { _kernels.push_back({KernelSpec::Op::RELU}); }
         };
 
         class SoftMax: public ComputationalStep<SoftMax> {
 
             public:     
                 std::shared_ptr<Computation::Graph::Tensor> doForward(std::shared_ptr<Computation::Graph::Tensor> input) noexcept;
+                std::shared_ptr<Computation::Graph::Tensor> doForward(std::shared_ptr<Computation::Graph::Tensor> input, Computation::Graph::InferenceTag _tag) noexcept;
+                void collect_kernels(std::vector<KernelSpec>& _kernels) noexcept override { _kernels.push_back({KernelSpec::Op::SOFTMAX}); }
         };
 
     }
@@ -0,0 +1,107 @@
+#ifndef ASYNC_CHECKPOINT_H
+#define ASYNC_CHECKPOINT_H
+
+#include "checkpoint.h"
+#include "parameter_buffer.h"
+#include "network_layer.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+namespace NeuralNetwork {
+
+    namespace Serialization {
+
+        using NeuralNetwork::Computation::Graph::ParameterBuffer;
+
+
+        /*
+
+        DESCRIPTION:
+
+            Checkpoints a model without pausing its training.
+
+            save() copies the model's flat weights into a free staging
+            buffer with a parallel memcpy and returns; a background
+            thread writes the staged snapshot out, fsyncs it and renames
+            it into place while training carries on. The copy is the
+            only cost on the training thread.
+
+            At most max_pending snapshots are staged at once. save()
+            blocks until a buffer frees up when the writer falls that
+            far behind, so memory stays bounded by max_pending copies of
+            the weights.
+
+            The model is flattened if it is not already, and must not be
+            re-flattened or reloaded while the checkpointer lives.
+
+        USAGE:
+
+            NeuralNetwork::Serialization::AsyncCheckpointer checkpointer(model);
+
+            for (int i = 0; i < TRAINING_EPOCS; i++) {
+                ...
+                sgd.step();
+                if (i % CHECKPOINT_EVERY == 0) checkpointer.save("model-" + std::to_string(i) + ".wrkc");
+            }
+
+            checkpointer.wait();
+
+        */
+        class AsyncCheckpointer {
+
+            public:
+                explicit AsyncCheckpointer(Sequential& _model, size_t _max_pending = 2) noexcept;
+                ~AsyncCheckpointer() noexcept;
+
+                AsyncCheckpointer(const AsyncCheckpointer&) = delete;
+                AsyncCheckpointer& operator=(const AsyncCheckpointer&) = delete;
+
+                // Snapshots the weights now, writes them to path in the background.
+                void save(const std::string& _path) noexcept;
+
+                // Blocks until every staged snapshot is on disk.
+                void wait() noexcept;
+
+                u_int64_t completed() const noexcept;
+                u_int64_t failed() const noexcept;
+
+            private:
+                struct Job {
+                    std::string path;
+                    size_t buffer;
+                };
+
+                void _write() noexcept;
+
+                std::shared_ptr<ParameterBuffer> flat;
+                std::vector<CheckpointEntry> entries;
+                u_int64_t modules;
+
+                std::vector<std::vector<float>> staging;
+                std::vector<size_t> free_buffers;
+                std::deque<Job> jobs;
+
+                mutable std::mutex lock;
+                std::condition_variable work;
+                std::condition_variable done;
+                u_int64_t writes = 0;
+                u_int64_t failures = 0;
+                bool stopping = false;
+                std::thread writer;
+        };
+
+
+    }
+
+}
+
+
+#endif // ASYNC_CHECKPOINT_H
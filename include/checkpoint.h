@@ -0,0 +1,113 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+
+namespace NeuralNetwork {
+
+    namespace Serialization {
+
+
+        /*
+            On-disk layout of a model checkpoint: this header, a table
+            of one entry per parameter, then at the 64 byte aligned
+            data_offset the weights of every parameter, each starting
+            on a 64 byte boundary. The weight region is laid out exactly
+            as a ParameterBuffer lays out its weight slab, so it can be
+            mapped in as one.
+        */
+        struct CheckpointHeader {
+            char magic[4];
+            uint32_t version;
+            uint64_t modules;
+            uint64_t parameters;
+            uint64_t data_offset;
+            uint64_t data_floats;
+        };
+
+        // A parameter: the module of the Sequential it belongs to, its shape and its offset (in floats).
+        struct CheckpointEntry {
+            uint64_t module;
+            uint64_t rows;
+            uint64_t columns;
+            uint64_t offset;
+
+            bool operator==(const CheckpointEntry&) const = default;
+        };
+
+        constexpr char CHECKPOINT_MAGIC[4] = {'W', 'R', 'K', 'C'};
+        constexpr uint32_t CHECKPOINT_VERSION = 1;
+        constexpr uint64_t CHECKPOINT_ALIGNMENT = 64;
+
+
+        // Fills in the entries' offsets, returns the floats the weight region spans.
+        u_int64_t assign_offsets(std::vector<CheckpointEntry>& entries) noexcept;
+
+
+        // Writes a checkpoint whose weight region is the data floats.
+        bool write_checkpoint(const std::string& path, u_int64_t modules,
+            const std::vector<CheckpointEntry>& entries, const float* data, u_int64_t floats) noexcept;
+
+
+        /*
+
+        DESCRIPTION:
+
+            A checkpoint file mapped into memory, validated against its
+            version and its own table.
+
+            The mapping is private and writable: weights read straight
+            from the page cache, and a page is only copied once a
+            training step writes to it, never reaching the file.
+            weights() shares ownership of the mapping, so views into it
+            keep the file mapped after the MappedCheckpoint is gone.
+
+            Sequential::save() writes a checkpoint, Sequential::load()
+            maps one into a model built the same way, layer for layer,
+            as the weights of its flat buffer: loading costs the same
+            for any model size. Load before creating the optimizers.
+
+        USAGE:
+
+            NeuralNetwork::Serialization::MappedCheckpoint checkpoint("model.wrkc");
+
+            if (checkpoint.is_open()) {
+                auto weights = checkpoint.weights();
+            }
+
+            model.save("model.wrkc");
+
+            NeuralNetwork::Sequential restored;
+            build(restored);
+            restored.load("model.wrkc");
+
+        */
+        class MappedCheckpoint {
+
+            public:
+                explicit MappedCheckpoint(const std::string& _path) noexcept;
+
+                bool is_open() const noexcept { return mapping != nullptr; }
+
+                u_int64_t modules() const noexcept { return header.modules; }
+                const std::vector<CheckpointEntry>& entries() const noexcept { return table; }
+
+                std::shared_ptr<void> weights() const noexcept;
+
+            private:
+                CheckpointHeader header = {};
+                std::vector<CheckpointEntry> table;
+                std::shared_ptr<void> mapping;
+        };
+
+
+    }
+
+}
+
+
+#endif // CHECKPOINT_H
@@ -1,14 +1,22 @@
 #ifndef COMPUTATIONAL_GRAPH_MAP_H
 #define COMPUTATIONAL_GRAPH_MAP_H
 
+#include <functional>
 #include <memory>
 #include <stack>
+#include <utility>
+#include <vector>
 
 #include "strong_types.h"
 #include "m_algorithms_register.h"
 #include "function_object.h"
 
 
+namespace Matrix {
+    class SparseRepresentation;
+}
+
+
 namespace NeuralNetwork {
 
     namespace Computation {
@@ -17,25 +25,76 @@ namespace NeuralNetwork {
         namespace Graph {
 
             class Tensor;
+            class MemoryPlan;
+
+            using Segment = std::function<std::shared_ptr<Tensor>(std::shared_ptr<Tensor>)>;
  
             /*
                 DESCRIPTION:
-                    Singleton Mediator that holds the edges between Tensors 
+                    Mediator that holds the edges between Tensors 
                     and their registered operations.
 
                     Organised as contiguous data structure, to avoid pointer 
                     chasing during runtime and help CPU's memory prefetcher 
                     load data before it's used.
 
+                    Each instance is an independent graph context with its
+                    own registries and TensorID counter. A context is not
+                    synchronised, so give every thread (or model) its own 
+                    and bind it with ComputationalGraphMap::Bind. Tensors 
+                    remember the context they were created in, and every 
+                    operation on them runs in that context. Code that never
+                    binds a context shares a process-wide default one.
+
+                USAGE:
+
+                    NeuralNetwork::Computation::Graph::GraphContext context;
+                    NeuralNetwork::Computation::Graph::GraphContext::Bind bind(context);
+
+                    NeuralNetwork::Sequential model;  // parameters live in context
+                    ...
+                    auto loss = CE(ground_truth, model.forward(ma));
+                    loss->backwards();
+
             */
             class ComputationalGraphMap {
 
 
                 public:
+                    /*
+                        Scoped binding of a context as the current
+                        one for the calling thread. Inside parallel code
+                        keep it around tensor creation only: past a
+                        cilk_sync the continuation may resume on another
+                        worker, whose binding the destructor would then
+                        restore instead.
+                    */
+                    class Bind {
+                        public:
+                            explicit Bind(ComputationalGraphMap& _map) noexcept : 
+                                previous(std::exchange(current, &_map)) {}
+                            ~Bind() noexcept { current = previous; }
+
+                            Bind(const Bind&) = delete;
+                            Bind& operator=(const Bind&) = delete;
+                        private:
+                            ComputationalGraphMap* previous;
+                    };
+
                     static ComputationalGraphMap& get(){
+                        if (current) return *current;
                         static ComputationalGraphMap map;
                         return map;
                     }
+
+                    ComputationalGraphMap() :
+                        op_registry(ENTRIES),
+                        tensor_registry(ENTRIES),
+                        segment_registry(ENTRIES),
+                        sparse_registry(ENTRIES),
+                        creation_registry(ENTRIES),
+                        recovered_tensor_id(),
+                        tensor_id(TensorID(0)) {}
                     ComputationalGraphMap(ComputationalGraphMap const&) = delete;
                     ComputationalGraphMap(ComputationalGraphMap&&) = delete;
                     ComputationalGraphMap& operator=(ComputationalGraphMap const&) = delete;
@@ -46,25 +105,65 @@ namespace NeuralNetwork {
                     FunctionObject _get_operation(TensorID my_tensor_id) noexcept;
                     TensorID _obtain_tensor_id() noexcept;
                     TensorID _register_operation(std::shared_ptr<Tensor> _t, FunctionObject& _node) noexcept;
+                    void _register_segment(TensorID my_tensor_id, Segment _segment) noexcept;
+                    Segment& _get_segment(TensorID my_tensor_id) noexcept;
+                    void _register_sparse_operand(TensorID my_tensor_id, std::shared_ptr<const Matrix::SparseRepresentation> _operand) noexcept;
+                    const Matrix::SparseRepresentation& _get_sparse_operand(TensorID my_tensor_id) noexcept;
+                    void _detach_subgraph(TensorID root, TensorID boundary) noexcept;
+
+                    /*
+                        Depth first post-order from root, every operand
+                        before the operations consuming it. The reverse
+                        pass runs it backwards and the MemoryPlanner
+                        plans against the same order.
+                    */
+                    std::vector<TensorID> _topological_order(TensorID root) noexcept;
+
+                    /*
+                        Whether operations on this context's tensors are
+                        recorded. Lives with the context rather than the
+                        thread, so it follows the tensors to whichever 
+                        worker resumes a stolen continuation. Toggled by
+                        NoGradGuard.
+                    */
+                    void set_grad_enabled(bool _enabled) noexcept { grad_enabled = _enabled; }
+                    bool is_grad_enabled() const noexcept { return grad_enabled; }
+
+                    /*
+                        Operation outputs are stamped in creation order, the
+                        order a MemoryPlan hands out slots in when a step is
+                        replayed against it. Any registration clears the
+                        stamp of a recycled ID.
+                    */
+                    void _stamp_creation(TensorID my_tensor_id) noexcept { creation_registry.at(my_tensor_id.get()) = ++created; }
+                    u_int64_t _creation_stamp(TensorID my_tensor_id) const noexcept { return creation_registry.at(my_tensor_id.get()); }
+                    void _replay(MemoryPlan* _plan) noexcept { replaying = _plan; }
+                    MemoryPlan* _replaying() const noexcept { return replaying; }
 
 
                 protected:
                     constexpr static uint16_t ENTRIES = 2000;
-                    ComputationalGraphMap() :
-                        op_registry(ENTRIES),
-                        tensor_registry(ENTRIES),
-                        recovered_tensor_id() {}
 
 
                 private:
                     std::vector<FunctionObject> op_registry;
                     std::vector<std::shared_ptr<Tensor>> tensor_registry;
+                    std::vector<Segment> segment_registry;
+                    std::vector<std::shared_ptr<const Matrix::SparseRepresentation>> sparse_registry;
+                    std::vector<u_int64_t> creation_registry;
                     std::stack<TensorID> recovered_tensor_id;
-                    static TensorID tensor_id;
+                    TensorID tensor_id;
+                    bool grad_enabled = true;
+                    u_int64_t created = 0;
+                    MemoryPlan* replaying = nullptr;
 
+                    static thread_local ComputationalGraphMap* current;
                 
             };
 
+
+            using GraphContext = ComputationalGraphMap;
+
  
  
         }
@@ -0,0 +1,104 @@
+#ifndef CSV_H
+#define CSV_H
+
+#include "matrix.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+
+namespace NeuralNetwork {
+
+    namespace Data {
+
+
+        /*
+
+        DESCRIPTION:
+
+            Parallel ingestion of a numeric CSV file (one sample per
+            line, the same number of fields on every line) straight into
+            a Representation.
+
+            The file is memory-mapped and split into byte ranges, each
+            moved forward to the next line break so no line straddles
+            two ranges. Opening counts the lines of every range
+            concurrently; a prefix sum over the counts gives each range
+            the row it starts at. read() then parses the ranges
+            concurrently with cilk_for, every range writing its own rows
+            of the output, with std::from_chars: no locale, no
+            allocation, no copy of the text.
+
+            Blank lines are skipped, a '\r' before the line break is
+            accepted, fields may be padded with spaces. read() fails on
+            a malformed field or a line with the wrong number of fields.
+
+        USAGE:
+
+            NeuralNetwork::Data::CSVReader csv("train.csv", ',', true);
+
+            Matrix::Representation samples = Matrix::Representation(
+                Matrix::Rows(csv.rows()), Matrix::Columns(csv.columns()));
+
+            if (csv.is_open() && csv.read(samples)) { ... }
+
+        */
+        class CSVReader {
+
+            public:
+                /*
+                    header skips the first line, ranges is how many byte
+                    ranges to split the file into (0 picks a few per worker).
+                */
+                explicit CSVReader(const std::string& _path, char _delimiter = ',', bool _header = false,
+                    size_t _ranges = 0) noexcept;
+
+                CSVReader(const CSVReader&) = delete;
+                CSVReader& operator=(const CSVReader&) = delete;
+
+                bool is_open() const noexcept { return mapping != nullptr; }
+
+                u_int64_t rows()    const noexcept { return total_rows; }
+                u_int64_t columns() const noexcept { return total_columns; }
+
+                // Parses into a rows() x columns() matrix, a view included.
+                bool read(Matrix::Representation& _into) const noexcept;
+
+                // Parses the leading fields of every line into head and the rest into tail.
+                bool read(Matrix::Representation& _head, Matrix::Representation& _tail) const noexcept;
+
+            private:
+                bool _read(float* _head, u_int64_t _split, float* _tail) const noexcept;
+
+                struct Range {
+                    const char* first;
+                    const char* last;
+                    u_int64_t row;
+                };
+
+                std::shared_ptr<void> mapping;
+                std::vector<Range> ranges;
+                char delimiter;
+                u_int64_t total_rows = 0;
+                u_int64_t total_columns = 0;
+        };
+
+
+        /*
+            Converts a CSV file to the MappedDataset format, the last
+            label_columns fields of every line being its labels. Lines
+            are parsed straight into a mapping of the output file, so 
+            the float data is never held in memory on top of the text.
+        */
+        bool csv_to_dataset(const std::string& csv_path, const std::string& dataset_path,
+            u_int64_t label_columns, char delimiter = ',', bool header = false) noexcept;
+
+
+    }
+
+}
+
+
+#endif // CSV_H
@@ -0,0 +1,131 @@
+#ifndef DATA_PARALLEL_H
+#define DATA_PARALLEL_H
+
+#include "computational_graph_map.h"
+#include "parameter_buffer.h"
+#include "network_layer.h"
+#include "dataset.h"
+#include "matrix.h"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+
+namespace NeuralNetwork {
+
+    namespace Training {
+
+        using NeuralNetwork::Computation::Graph::GraphContext;
+        using NeuralNetwork::Computation::Graph::ParameterBuffer;
+
+
+        // Copy of rows [first, last) of m, one shard of a minibatch.
+        Matrix::Representation slice_rows(const Matrix::Representation& m, u_int64_t first, u_int64_t last) noexcept;
+
+
+        /*
+            Forward and backward of rows [first, last) of a minibatch
+            through model, recorded in context, under cross-entropy.
+            The step's operations and its input and label tensors are
+            released back to the context afterwards, so a training loop
+            never exhausts the registry. Returns the summed loss.
+        */
+        float train_rows(Sequential& model, GraphContext& context,
+            const Matrix::Representation& inputs, const Matrix::Representation& labels,
+            u_int64_t first, u_int64_t last) noexcept;
+
+
+        /*
+            The same step on a batch of a BatchLoader, in the context
+            its tensors were registered in. The step's operations are
+            released, the batch's own tensors go with the Batch.
+        */
+        float train_batch(Sequential& model, const Data::Batch& batch) noexcept;
+
+
+        /*
+
+        DESCRIPTION:
+
+            Synchronous data-parallel training on one machine.
+
+            Builds one replica of the model per worker, each in its own
+            GraphContext with its own flat parameter buffer. A step
+            splits the minibatch into contiguous row shards, copies the
+            master weights into every replica, runs forward and backward
+            of the shards concurrently with cilk_for and tree all-reduces
+            the replica gradients (log2(workers) levels of pairwise
+            vectorized sums) into the master's flat gradient buffer.
+
+            The loss sums over the rows of a batch, so the reduced
+            gradient equals the gradient of the whole minibatch and the
+            master is stepped by any optimizer exactly as if it had run
+            the batch itself.
+
+            The builder must add the same layers, in the same order, as
+            the master model was built with.
+
+        USAGE:
+
+            auto build = [](NeuralNetwork::Sequential& model) {
+                model.add(std::make_unique<NeuralNetwork::Layer>(
+                        std::make_unique<NeuralNetwork::MatrixMultiplyStep>(Matrix::Rows(784), Matrix::Columns(128)),
+                        std::make_unique<NeuralNetwork::AddStep>(Matrix::Columns(128))));
+                model.add(std::make_unique<NeuralNetwork::ActivationFunctions::ReLU>());
+            };
+
+            NeuralNetwork::Sequential model;
+            build(model);
+
+            NeuralNetwork::Training::DataParallel trainer(model, build, __cilkrts_get_nworkers());
+            NeuralNetwork::Optimization::SGD sgd(model.flat_parameters(), LEARNING_RATE);
+
+            for (auto& [inputs, labels]: batches) {
+                trainer.step(inputs, labels);
+                sgd.step();
+            }
+
+        */
+        class DataParallel {
+
+            public:
+                using ModelBuilder = std::function<void(Sequential&)>;
+
+                explicit DataParallel(Sequential& _master, const ModelBuilder& _build, size_t _workers) noexcept;
+
+                DataParallel(const DataParallel&) = delete;
+                DataParallel& operator=(const DataParallel&) = delete;
+
+                /*
+                    Forward and backward of one minibatch, one sample per
+                    row. Leaves the summed gradient in the master's flat
+                    gradient buffer and returns the summed loss.
+                */
+                float step(const Matrix::Representation& _inputs, const Matrix::Representation& _labels) noexcept;
+
+                size_t workers() const noexcept { return replicas.size(); }
+
+            private:
+                struct Replica {
+                    GraphContext context;
+                    Sequential model;
+                    std::shared_ptr<ParameterBuffer> flat;
+                    float loss = 0;
+                };
+
+                void _broadcast() noexcept;
+                void _all_reduce() noexcept;
+
+                std::shared_ptr<ParameterBuffer> master;
+                std::vector<std::unique_ptr<Replica>> replicas;
+        };
+
+
+    }
+
+}
+
+
+#endif // DATA_PARALLEL_H
@@ -0,0 +1,236 @@
+#ifndef DATASET_H
+#define DATASET_H
+
+#include "tensor.h"
+#include "matrix.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+namespace NeuralNetwork {
+
+    namespace Data {
+
+
+        /*
+            On-disk layout of a dataset: this header, then the features
+            (samples x features, row-major float32) and the labels
+            (samples x label_columns) at 64 byte aligned offsets.
+        */
+        struct DatasetHeader {
+            char magic[4];
+            uint32_t version;
+            uint64_t samples;
+            uint64_t features;
+            uint64_t label_columns;
+            uint64_t features_offset;
+            uint64_t labels_offset;
+        };
+
+        constexpr char DATASET_MAGIC[4] = {'W', 'R', 'K', 'D'};
+        constexpr uint32_t DATASET_VERSION = 1;
+        constexpr uint64_t DATASET_ALIGNMENT = 64;
+
+
+        // Writes features and labels (one sample per row) in the dataset format.
+        bool write_dataset(const std::string& path, const Matrix::Representation& features,
+            const Matrix::Representation& labels) noexcept;
+
+        /*
+            Creates a samples-row dataset file and hands fill views of
+            its features and labels straight into a shared mapping of
+            it, so a dataset larger than memory can be written without
+            a buffer: dirty pages go back to the file as they are
+            evicted. The file is removed if fill returns false.
+        */
+        bool write_dataset(const std::string& path, u_int64_t samples, u_int64_t features, u_int64_t label_columns,
+            const std::function<bool(Matrix::Representation&, Matrix::Representation&)>& fill) noexcept;
+
+
+        /*
+
+        DESCRIPTION:
+
+            A dataset file mapped into memory. features() and labels()
+            hand out row ranges as views straight into the mapping, no
+            copy and no read() into a staging buffer; pages are faulted
+            in from the page cache on first touch.
+
+            The mapping is private and writable, so a view may be
+            written through (the kernels never do) without reaching the
+            file. Every view keeps the mapping alive, it outlives the
+            MappedDataset if need be.
+
+        USAGE:
+
+            NeuralNetwork::Data::MappedDataset data("mnist.wrkd");
+
+            if (data.is_open()) {
+                auto x = data.features(0, 32);
+                auto y = data.labels(0, 32);
+            }
+
+        */
+        class MappedDataset {
+
+            public:
+                explicit MappedDataset(const std::string& _path) noexcept;
+
+                MappedDataset(const MappedDataset&) = delete;
+                MappedDataset& operator=(const MappedDataset&) = delete;
+
+                bool is_open() const noexcept { return mapping != nullptr; }
+
+                u_int64_t samples()       const noexcept { return header.samples; }
+                u_int64_t features()      const noexcept { return header.features; }
+                u_int64_t label_columns() const noexcept { return header.label_columns; }
+
+                // Rows [first, last) as views into the mapping.
+                Matrix::Representation features(u_int64_t _first, u_int64_t _last) const noexcept;
+                Matrix::Representation labels(u_int64_t _first, u_int64_t _last) const noexcept;
+
+                const float* feature_row(u_int64_t _sample) const noexcept;
+                const float* label_row(u_int64_t _sample) const noexcept;
+
+                // Asks the kernel to start reading rows [first, last) in.
+                void will_need(u_int64_t _first, u_int64_t _last) const noexcept;
+
+            private:
+                DatasetHeader header = {};
+                std::shared_ptr<void> mapping;
+                char* base = nullptr;
+        };
+
+
+        enum class Shuffle : uint8_t {
+            NONE,
+            BATCHES,
+            SAMPLES,
+        };
+
+
+        /*
+            A minibatch as two leaf Tensors. The Batch owns their
+            registration on the graph and detaches both when it is
+            destroyed, do not detach them yourself.
+        */
+        struct Batch {
+            Batch(std::shared_ptr<Computation::Graph::Tensor> _inputs,
+                std::shared_ptr<Computation::Graph::Tensor> _labels) noexcept :
+                inputs(std::move(_inputs)), labels(std::move(_labels)) {}
+
+            ~Batch() noexcept;
+
+            Batch(Batch&&) noexcept = default;
+            Batch(const Batch&) = delete;
+            Batch& operator=(const Batch&) = delete;
+            Batch& operator=(Batch&&) = delete;
+
+            std::shared_ptr<Computation::Graph::Tensor> inputs;
+            std::shared_ptr<Computation::Graph::Tensor> labels;
+        };
+
+
+        /*
+
+        DESCRIPTION:
+
+            Streams minibatches of a MappedDataset, one epoch at a time,
+            while a background thread prepares the next ones.
+
+            The order is an index permutation, redrawn every epoch.
+            NONE and BATCHES keep each batch a contiguous run of rows, so
+            a batch is a pair of views into the mapping; BATCHES only
+            permutes the order the batches come in. SAMPLES permutes
+            individual samples, whose rows are no longer contiguous, so
+            the prefetcher gathers each batch into its own matrices.
+
+            Up to depth batches are kept ready. For views the prefetcher
+            touches every page of the next batches, so the page faults
+            are taken on its thread instead of in the training step.
+
+            next() wraps the batch into leaf Tensors registered in the
+            caller's current GraphContext, moving the views in rather
+            than copying them. Training::train_batch runs the step and
+            releases its operations, the Batch releases the two leaves,
+            so the loop below never exhausts the graph's registry.
+
+        USAGE:
+
+            auto data = std::make_shared<NeuralNetwork::Data::MappedDataset>("mnist.wrkd");
+            NeuralNetwork::Data::BatchLoader loader(data, BATCH_SIZE);
+
+            for (int i = 0; i < TRAINING_EPOCS; i++) {
+                while (auto batch = loader.next()) {
+                    NeuralNetwork::Training::train_batch(model, *batch);
+                    sgd.step();
+                }
+                loader.reset();
+            }
+
+        */
+        class BatchLoader {
+
+            public:
+                explicit BatchLoader(std::shared_ptr<const MappedDataset> _data, u_int64_t _batch_size,
+                    Shuffle _shuffle = Shuffle::BATCHES, u_int64_t _seed = 0, size_t _depth = 2) noexcept;
+
+                ~BatchLoader() noexcept;
+
+                BatchLoader(const BatchLoader&) = delete;
+                BatchLoader& operator=(const BatchLoader&) = delete;
+
+                // The next batch of the epoch, empty once it is exhausted.
+                std::optional<Batch> next() noexcept;
+
+                // Starts the next epoch under a fresh permutation.
+                void reset() noexcept;
+
+                u_int64_t batches() const noexcept { return (data->samples() + batch_size - 1) / batch_size; }
+                u_int64_t epoch()   const noexcept { return epochs; }
+
+            private:
+                struct Minibatch {
+                    Matrix::Representation inputs;
+                    Matrix::Representation labels;
+                };
+
+                void _start() noexcept;
+                void _stop() noexcept;
+                void _produce() noexcept;
+                Minibatch _load(u_int64_t _batch) const noexcept;
+
+                std::shared_ptr<const MappedDataset> data;
+                u_int64_t batch_size;
+                Shuffle shuffle;
+                u_int64_t seed;
+                size_t depth;
+
+                u_int64_t epochs = 0;
+                u_int64_t consumed = 0;
+                std::vector<u_int64_t> order;
+
+                std::mutex lock;
+                std::condition_variable ready;
+                std::condition_variable space;
+                std::deque<Minibatch> queue;
+                bool stopping = false;
+                std::thread prefetcher;
+        };
+
+
+    }
+
+}
+
+
+#endif // DATASET_H
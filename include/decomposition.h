@@ -0,0 +1,75 @@
+#ifndef DECOMPOSITION_H
+#define DECOMPOSITION_H
+
+#include <cstdint>
+#include <vector>
+
+#include "matrix.h"
+
+
+namespace Matrix {
+
+    namespace Operations {
+
+        /*
+
+        DESCRIPTION:
+
+            Matrix factorizations for compressing trained weights.
+
+            qr is a thin Householder QR of an m x k matrix, m >= k:
+            Q (m x k) has orthonormal columns and R (k x k) is upper
+            triangular with a = Q R. The reflectors are applied to the
+            columns in parallel, each a contiguous row of the transpose.
+
+            randomized_svd finds the leading `rank` singular triplets
+            of a (m x n), a ≈ U diag(S) V, after Halko, Martinsson and
+            Tropp. a times a Gaussian test matrix of rank + oversampling
+            columns, sharpened by power_iterations passes through a and
+            its transpose, is orthonormalized into Q, whose columns span
+            nearly all of a's leading range. The small matrix Qᵀ a is
+            factorized exactly, by one-sided Jacobi, and mapped back
+            through Q. Every pass over a is a ParallelDNC GEMM.
+
+            U (m x rank) has orthonormal columns, V (rank x n) has
+            orthonormal rows and S is in decreasing order. The seed
+            fixes the test matrix, so a factorization is reproducible.
+
+        USAGE:
+
+            auto [Q, R] = Matrix::Operations::Decomposition::qr(a);
+
+            auto svd = Matrix::Operations::Decomposition::randomized_svd(W, 32);
+
+            float error = Matrix::Operations::Decomposition::relative_error(W, svd.U, svd.V);   // with S folded into U
+
+        */
+        namespace Decomposition {
+
+            struct QR {
+                Matrix::Representation Q;
+                Matrix::Representation R;
+            };
+
+            struct SVD {
+                Matrix::Representation U;
+                std::vector<float> S;
+                Matrix::Representation V;
+            };
+
+            QR qr(const Matrix::Representation& a) noexcept;
+
+            SVD randomized_svd(const Matrix::Representation& a, u_int64_t rank,
+                u_int64_t oversampling = 10, u_int64_t power_iterations = 2, u_int64_t seed = 0) noexcept;
+
+            // ||a - l r||_F / ||a||_F.
+            float relative_error(const Matrix::Representation& a, const Matrix::Representation& l, const Matrix::Representation& r) noexcept;
+
+        }
+
+    }
+
+}
+
+
+#endif // DECOMPOSITION_H
@@ -13,6 +13,8 @@ namespace NeuralNetwork {
 
         namespace Graph {
 
+            class ComputationalGraphMap;
+
 
             namespace States {
 
@@ -139,6 +141,36 @@ namespace NeuralNetwork {
                 static_assert(BinaryRegistry<CrossEntropy>);
 
 
+                /*
+                    Output of a checkpointed segment of steps. Only the
+                    segment's input is kept alive, the interior is
+                    recomputed during the reverse pass.
+                */
+                struct Checkpoint : public UnaryRegistered {
+                    Checkpoint(UnaryRegistered other) : UnaryRegistered(other) {}
+                    Checkpoint(Checkpoint&) = default; 
+                    Checkpoint(Checkpoint&&) = default; 
+                    Checkpoint& operator=(const Checkpoint&) = default; 
+                    Checkpoint& operator=(Checkpoint&&) = default; 
+                };
+                static_assert(UnaryRegistry<Checkpoint>);
+
+
+                /*
+                    Product of a sparse input and a weight tensor, the
+                    operand registered. The input is held by the graph
+                    context, it is not a tensor.
+                */
+                struct SparseMatrixMultiply : public UnaryRegistered {
+                    SparseMatrixMultiply(UnaryRegistered other) : UnaryRegistered(other) {}
+                    SparseMatrixMultiply(SparseMatrixMultiply&) = default; 
+                    SparseMatrixMultiply(SparseMatrixMultiply&&) = default; 
+                    SparseMatrixMultiply& operator=(const SparseMatrixMultiply&) = default; 
+                    SparseMatrixMultiply& operator=(SparseMatrixMultiply&&) = default; 
+                };
+                static_assert(UnaryRegistry<SparseMatrixMultiply>);
+
+
             } // States
 
             namespace Events {
@@ -171,6 +203,18 @@ namespace NeuralNetwork {
                 };
                 
 
+                struct Checkpoint {
+                    explicit Checkpoint(RegisteredUnaryOperation _pl) : _payload(_pl) {}
+                    RegisteredUnaryOperation _payload;
+                };
+
+
+                struct SparseMultiply {
+                    explicit SparseMultiply(RegisteredUnaryOperation _pl) : _payload(_pl) {}
+                    RegisteredUnaryOperation _payload;
+                };
+                
+
                 struct Differentiate {
                     explicit Differentiate(const Matrix::Representation& _g) : gradient(_g) {}
                     Differentiate(Differentiate&) = default;
@@ -193,9 +237,12 @@ namespace NeuralNetwork {
                         NeuralNetwork::Computation::Graph::Events::Instantiate<Matrix::Operations::Binary::Multiplication::Naive>,
                         NeuralNetwork::Computation::Graph::Events::Instantiate<Matrix::Operations::Binary::Multiplication::Square>,
                         NeuralNetwork::Computation::Graph::Events::Instantiate<Matrix::Operations::Binary::Addition::Std>,
+                        NeuralNetwork::Computation::Graph::Events::Instantiate<Matrix::Operations::Binary::Subtraction::Std>,
                         NeuralNetwork::Computation::Graph::Events::Instantiate<Matrix::Operations::Binary::OuterProduct::Naive>,
                         NeuralNetwork::Computation::Graph::Events::Instantiate<Matrix::Operations::Metric::CrossEntropy>,
 
+                        NeuralNetwork::Computation::Graph::Events::Checkpoint,
+                        NeuralNetwork::Computation::Graph::Events::SparseMultiply,
                         NeuralNetwork::Computation::Graph::Events::Differentiate
                     >;
             };
@@ -216,24 +263,44 @@ namespace NeuralNetwork {
                         States::ReLU,
                         States::SoftMax,
                         // Metrics
-                        States::CrossEntropy
+                        States::CrossEntropy,
+                        // Recomputation
+                        States::Checkpoint,
+                        // Sparse Inputs
+                        States::SparseMatrixMultiply
                     >;
             };
 
 
+            /*
+                Backward rules read and write the tensors of the 
+                graph context the transitioner was created for.
+            */
             class OperationTransitioner {
 
                 using State = StateTrait::State;
 
                 public:
+                    explicit OperationTransitioner(ComputationalGraphMap& _map) noexcept : map(_map) {}
+
                     template <Matrix::Operations::MatrixOperatable RegisteryType>
                     State operator()(States::NoOperation nop, Events::Instantiate<RegisteryType> i) {
                         return on_event(nop, i);
                     }
+                    State operator()(States::NoOperation, Events::Checkpoint c) noexcept {
+                        return States::Checkpoint{c._payload};
+                    }
+                    State operator()(States::NoOperation, Events::SparseMultiply sm) noexcept {
+                        return States::SparseMatrixMultiply{sm._payload};
+                    }
                     State operator()(States::CrossEntropy ce, Events::Differentiate& df) noexcept;
                     State operator()(States::MatrixMultiply mm, Events::Differentiate& df) noexcept;
                     State operator()(States::Plus add, Events::Differentiate& df) noexcept;
+                    State operator()(States::Minus sub, Events::Differentiate& df) noexcept;
+                    State operator()(States::Hadamard hp, Events::Differentiate& df) noexcept;
                     State operator()(States::ReLU relu, Events::Differentiate& df) noexcept;
+                    State operator()(States::Checkpoint cp, Events::Differentiate& df) noexcept;
+                    State operator()(States::SparseMatrixMultiply smm, Events::Differentiate& df) noexcept;
                     State operator()(const States::NoOperation& nop, Events::Differentiate&) noexcept;
 
 
@@ -247,6 +314,8 @@ namespace NeuralNetwork {
 
                 private:   
 
+                    ComputationalGraphMap& map;
+
                     template <Matrix::Operations::BinaryMatrixOperatable RegisteryType>
                     requires Same_as<RegisteryType, Matrix::Operations::Binary::Multiplication::ParallelDNC> ||
                         Same_as<RegisteryType, Matrix::Operations::Binary::Multiplication::Naive> ||
@@ -340,6 +409,60 @@ namespace NeuralNetwork {
                     std::string_view operator()(States::OuterProduct){
                         return "States::OuterProduct";
                     }
+                    std::string_view operator()(States::Checkpoint){
+                        return "States::Checkpoint";
+                    }
+                    std::string_view operator()(States::SparseMatrixMultiply){
+                        return "States::SparseMatrixMultiply";
+                    }
+
+            };
+
+
+            /*
+                Which operand matrices a state's backward rule reads.
+                Used by the MemoryPlanner to decide how long an 
+                activation has to outlive its forward consumer.
+                Keep in sync with OperationTransitioner rules.
+            */
+            struct OperandUsage {
+                bool left_matrix;
+                bool right_matrix;
+            };
+
+
+            class FunctionObjectOperandUsage {
+
+                public:
+                    OperandUsage operator()(States::CrossEntropy){
+                        return {true, true};
+                    }
+                    OperandUsage operator()(States::MatrixMultiply){
+                        return {true, true};
+                    }
+                    OperandUsage operator()(States::Plus){
+                        return {false, false};
+                    }
+                    OperandUsage operator()(States::Minus){
+                        return {false, false};
+                    }
+                    OperandUsage operator()(States::Hadamard){
+                        return {true, true};
+                    }
+                    OperandUsage operator()(States::ReLU){
+                        return {true, false};
+                    }
+                    OperandUsage operator()(States::Checkpoint){
+                        return {true, false};
+                    }
+                    OperandUsage operator()(States::SparseMatrixMultiply){
+                        return {false, false};
+                    }
+
+                    template <IsStateFull UndefinedState>
+                    OperandUsage operator()(UndefinedState){
+                        return {false, false};
+                    }
 
             };
 
@@ -428,9 +551,9 @@ namespace NeuralNetwork {
                         return *this;
                     }
 
-                    void process_event(Event event) {
+                    void process_event(Event event, ComputationalGraphMap& map) {
                         state_ = std::visit(
-                            OperationTransitioner{},
+                            OperationTransitioner{map},
                             state_, 
                             event
                         );
@@ -452,6 +575,13 @@ namespace NeuralNetwork {
                         );
                         return data;
                     }
+
+                    OperandUsage operand_usage(void) {
+                        return std::visit(
+                            FunctionObjectOperandUsage{},
+                            state_
+                        );
+                    }
                 private:
                     State state_;
                 };
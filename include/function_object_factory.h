@@ -5,6 +5,7 @@
 #include "m_algorithms_register.h"
 #include "m_algorithms_concepts.h"
 #include "function_object.h"
+#include "computational_graph_map.h"
 
 #include <optional>
 
@@ -52,6 +53,12 @@ namespace NeuralNetwork {
                     static FunctionObject create(
                         RegisteryType operation, T _res, TensorID _operand_id);
 
+                    static FunctionObject create(
+                        Segment _segment, T _res, TensorID _operand_id);
+
+                    static FunctionObject create(
+                        std::shared_ptr<const Matrix::SparseRepresentation> _sparse, T _res, TensorID _weights_id);
+
             };
 
 
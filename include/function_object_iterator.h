@@ -30,9 +30,9 @@ namespace NeuralNetwork {
                     using Matrix_t   = BackPropigationMatrixTrait::Type;
                     using ReturnType = FunctionObject;
 
-                    static void process_head(TensorID tid);
-                    static void apply_to_children(std::stack<TensorID>& tid_stack, TensorID tid);
-                    static ReturnType dereference(TensorID tid);
+                    static void process_head(ComputationalGraphMap& map, TensorID tid);
+                    static void apply_to_children(ComputationalGraphMap& map, std::stack<TensorID>& tid_stack, TensorID tid);
+                    static ReturnType dereference(ComputationalGraphMap& map, TensorID tid);
            };
 
             class ReadParameterPolicy {
@@ -42,10 +42,11 @@ namespace NeuralNetwork {
                     using Matrix_t   = BackPropigationMatrixTrait::Type;
                     using ReturnType = BackPropigationMatrixTrait::Type&;
 
-                    static void process_head(TensorID tid);
-                    static void apply_to_children(std::stack<TensorID>& tid_stack, TensorID tid);
-                    static ReturnType dereference(TensorID tid);
-                    static Matrix_t grad(TensorID tid);
+                    static void process_head(ComputationalGraphMap& map, TensorID tid);
+                    static void apply_to_children(ComputationalGraphMap& map, std::stack<TensorID>& tid_stack, TensorID tid);
+                    static ReturnType dereference(ComputationalGraphMap& map, TensorID tid);
+                    static Matrix_t grad(ComputationalGraphMap& map, TensorID tid);
+                    static void zero_grad(ComputationalGraphMap& map, TensorID tid);
            };
 
         
@@ -66,7 +67,7 @@ namespace NeuralNetwork {
                 constexpr static size_t NoOpIdx = 0;
 
                 public:
-                    explicit LevelOrderIterator(const TensorID _t) noexcept;
+                    explicit LevelOrderIterator(ComputationalGraphMap& _map, const TensorID _t) noexcept;
 
                     // LevelOrderIterator(LevelOrderIterator&) = default; 
                     // LevelOrderIterator(LevelOrderIterator&&) = default; 
@@ -77,7 +78,12 @@ namespace NeuralNetwork {
                     
                     Matrix_t gradient() const noexcept 
                     requires Same_as<TP, ReadParameterPolicy> {
-                        return ReadParameterPolicy::grad(current);
+                        return ReadParameterPolicy::grad(map, current);
+                    }
+
+                    void zero_grad() const noexcept 
+                    requires Same_as<TP, ReadParameterPolicy> {
+                        ReadParameterPolicy::zero_grad(map, current);
                     }
 
                     IterReturnType operator*() const noexcept;
@@ -89,6 +95,7 @@ namespace NeuralNetwork {
                 private:
                     void _stack_children() noexcept;
 
+                    ComputationalGraphMap& map;
                     TensorID current;
                     std::stack<TensorID> nodeStack;
 
@@ -61,6 +61,9 @@ namespace Functions {
             bool compare_float(float a, float b);
             int32_t ulpsDistance(const float a, const float b);
 
+            bool compare_float(double a, double b);
+            int64_t ulpsDistance(const double a, const double b);
+
             }
 
 }
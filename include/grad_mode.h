@@ -0,0 +1,75 @@
+#ifndef GRAD_MODE_H
+#define GRAD_MODE_H
+
+
+namespace NeuralNetwork {
+
+    namespace Computation {
+
+        namespace Graph {
+
+            class ComputationalGraphMap;
+
+
+            /*
+                Switch for recording operations on the computational 
+                graph, of the context bound to the calling thread (or
+                the default one). TensorOp reads the flag of its 
+                operands' context instead, once per operation.
+            */
+            class GradMode {
+
+                public:
+                    static bool is_enabled() noexcept;
+                    static void set_enabled(bool _enabled) noexcept;
+            };
+
+
+            /*
+
+            DESCRIPTION:
+
+                RAII scope for inference. While alive, TensorOp runs the
+                kernel directly and wraps the result in a Tensor that is 
+                not registered on the ComputationalGraphMap and carries no
+                gradient, so no grad buffer, FunctionObject or TensorID 
+                is spent on outputs that are never differentiated.
+
+                Disables the context it is given, or the one bound when
+                it is constructed, and restores that same context. The
+                mode travels with the context's tensors, so a forward 
+                whose cilk_spawn continuations are stolen stays 
+                unrecorded on every worker.
+
+            USAGE:
+
+                {
+                    NeuralNetwork::Computation::Graph::NoGradGuard no_grad;
+                    auto prediction = model.forward(ma);
+                }
+
+            */
+            class NoGradGuard {
+
+                public:
+                    NoGradGuard() noexcept;
+                    explicit NoGradGuard(ComputationalGraphMap& _map) noexcept;
+                    ~NoGradGuard() noexcept;
+
+                    NoGradGuard(const NoGradGuard&) = delete;
+                    NoGradGuard& operator=(const NoGradGuard&) = delete;
+
+                private:
+                    ComputationalGraphMap& map;
+                    bool previous;
+            };
+
+
+        }
+
+    }
+
+}
+
+
+#endif // GRAD_MODE_H
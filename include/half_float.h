@@ -0,0 +1,152 @@
+#ifndef HALF_FLOAT_H
+#define HALF_FLOAT_H
+
+#include <bit>
+#include <concepts>
+#include <cstdint>
+
+
+namespace Matrix {
+
+
+    /*
+
+    DESCRIPTION:
+
+        16-bit element types for BasicRepresentation. Neither does
+        arithmetic of its own: a value widens to fp32 implicitly and
+        narrows, rounding to nearest even, only when asked to.
+
+        bfloat16 is the top half of an fp32, same exponent range with
+        8 bits of mantissa, so conversion is a shift.
+
+        float16 (IEEE binary16) has 11 bits of mantissa but tops out
+        at 65504, anything larger becomes infinity. Conversion is bit
+        manipulation, or F16C when the build targets it (NATIVE=1).
+        Without F16C the conversion costs more than the bandwidth it
+        saves, prefer bfloat16 there.
+
+    */
+    struct bfloat16 {
+
+        uint16_t bits = 0;
+
+        constexpr bfloat16() noexcept = default;
+
+        constexpr explicit bfloat16(float _value) noexcept : bits(round(_value)) {}
+
+        static constexpr bfloat16 from_bits(uint16_t _bits) noexcept {
+            bfloat16 output;
+            output.bits = _bits;
+            return output;
+        }
+
+        static constexpr bfloat16 from_float(float _value) noexcept { return bfloat16(_value); }
+
+        constexpr float to_float() const noexcept {
+            return std::bit_cast<float>(uint32_t(bits) << 16);
+        }
+
+        constexpr operator float() const noexcept { return to_float(); }
+
+        constexpr bfloat16& operator+=(float _other) noexcept { return *this = bfloat16(to_float() + _other); }
+
+        constexpr bool is_finite() const noexcept { return (bits & 0x7f80) != 0x7f80; }
+
+        private:
+
+            static constexpr uint16_t round(float _value) noexcept {
+
+                const uint32_t f = std::bit_cast<uint32_t>(_value);
+
+                // Quiet the NaN so rounding cannot carry it into infinity.
+                if ((f & 0x7fffffff) > 0x7f800000) return uint16_t((f >> 16) | 0x0040);
+
+                return uint16_t((f + 0x7fff + ((f >> 16) & 1)) >> 16);
+            }
+    };
+
+
+    struct float16 {
+
+        uint16_t bits = 0;
+
+        constexpr float16() noexcept = default;
+
+        constexpr explicit float16(float _value) noexcept : bits(round(_value)) {}
+
+        static constexpr float16 from_bits(uint16_t _bits) noexcept {
+            float16 output;
+            output.bits = _bits;
+            return output;
+        }
+
+        static constexpr float16 from_float(float _value) noexcept { return float16(_value); }
+
+        constexpr float to_float() const noexcept {
+
+            constexpr uint32_t EXPONENT = 0x7c00 << 13;
+            constexpr float SUBNORMAL = std::bit_cast<float>(uint32_t(113 << 23));
+
+            uint32_t f = uint32_t(bits & 0x7fff) << 13;
+            const uint32_t exponent = f & EXPONENT;
+
+            f += uint32_t(127 - 15) << 23;
+
+            if (exponent == EXPONENT) {
+                f += uint32_t(128 - 16) << 23;
+            }
+            else if (exponent == 0) {
+                f = std::bit_cast<uint32_t>(std::bit_cast<float>(f + (1 << 23)) - SUBNORMAL);
+            }
+
+            return std::bit_cast<float>(f | (uint32_t(bits & 0x8000) << 16));
+        }
+
+        constexpr operator float() const noexcept { return to_float(); }
+
+        constexpr float16& operator+=(float _other) noexcept { return *this = float16(to_float() + _other); }
+
+        constexpr bool is_finite() const noexcept { return (bits & 0x7c00) != 0x7c00; }
+
+        private:
+
+            static constexpr uint16_t round(float _value) noexcept {
+
+                constexpr uint32_t NOT_FINITE = 255 << 23;
+                constexpr uint32_t TOO_LARGE  = (127 + 16) << 23;
+                constexpr uint32_t SUBNORMAL  = 113 << 23;
+                constexpr uint32_t DENORM_MAGIC = ((127 - 15) + (23 - 10) + 1) << 23;
+
+                uint32_t f = std::bit_cast<uint32_t>(_value);
+
+                const uint32_t sign = f & 0x80000000;
+                f ^= sign;
+
+                uint16_t h;
+
+                if (f >= TOO_LARGE) {
+                    h = f > NOT_FINITE ? 0x7e00 : 0x7c00;
+                }
+                else if (f < SUBNORMAL) {
+                    // The fp32 add shifts the mantissa into place and rounds it.
+                    h = uint16_t(std::bit_cast<uint32_t>(std::bit_cast<float>(f) + std::bit_cast<float>(DENORM_MAGIC)) - DENORM_MAGIC);
+                }
+                else {
+                    const uint32_t odd = (f >> 13) & 1;
+                    f += (uint32_t(15 - 127) << 23) + 0xfff + odd;
+                    h = uint16_t(f >> 13);
+                }
+
+                return uint16_t(h | (sign >> 16));
+            }
+    };
+
+
+    template <typename T>
+    concept HalfFloat = (std::same_as<T, bfloat16> || std::same_as<T, float16>) && sizeof(T) == 2;
+
+}
+
+
+#endif // HALF_FLOAT_H
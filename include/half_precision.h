@@ -0,0 +1,138 @@
+#ifndef HALF_PRECISION_H
+#define HALF_PRECISION_H
+
+#include <cstdint>
+
+#include "matrix.h"
+
+
+namespace Matrix {
+
+
+    /*
+        Converts n elements a block at a time, the loops the kernels
+        below run over a row before they accumulate in fp32.
+    */
+    template <HalfFloat T>
+    void widen(const T* _src, float* _dst, u_int64_t _n) noexcept;
+
+    template <HalfFloat T>
+    void narrow(const float* _src, T* _dst, u_int64_t _n) noexcept;
+
+
+    /*
+
+    DESCRIPTION:
+
+        Matrices of 16-bit elements, half the bytes of a Representation
+        of the same shape. Meant for large weight matrices and
+        activations saved for the backward pass, the data the
+        memory-bound kernels spend their time streaming.
+
+        They are plain BasicRepresentations: views, copies and
+        element access work as for fp32. The fp32 kernels in
+        Matrix::Operations are not instantiated for them, the kernels
+        in Operations::LowPrecision take them instead and widen them
+        to fp32 as they load.
+
+        narrow and widen convert a whole matrix in parallel. The
+        two-argument narrow reuses the destination's storage (or the
+        memory it views) when the shape matches.
+
+    USAGE:
+
+        Matrix::BFloat16Representation W_bf16 = Matrix::narrow<Matrix::bfloat16>(W);
+
+        Matrix::Representation y = Matrix::Operations::LowPrecision::multiply(x, W_bf16);
+        Matrix::Representation W_back = Matrix::widen(W_bf16);
+
+    */
+    template <HalfFloat T>
+    BasicRepresentation<T> narrow(const Matrix::Representation& m) noexcept;
+
+    template <HalfFloat T>
+    void narrow(const Matrix::Representation& m, BasicRepresentation<T>& out) noexcept;
+
+    template <HalfFloat T>
+    Matrix::Representation widen(const BasicRepresentation<T>& m) noexcept;
+
+
+    namespace Operations {
+
+        /*
+
+        DESCRIPTION:
+
+            Kernels over mixed fp32 and 16-bit operands. Every operand
+            is read in its own format and widened to fp32 as it is
+            loaded; products are summed and results written in fp32.
+
+            multiply is a blocked GEMM, parallel over tiles of the
+            output, which widens each row slice of the right operand
+            once per tile and reuses it for every row of the left. With
+            a single left row it is the GEMV of an inference layer.
+
+            transpose_multiply (lᵀ·r) and multiply_transpose (l·rᵀ) are
+            the products of a linear layer's backward pass, the weight
+            gradient from the saved input and the input gradient from
+            the weights, without transposing either operand.
+
+            The elementwise kernels take operands of the same shape,
+            add also a single row on the right, broadcast to every row
+            of the left (a bias). sum_rows is its backward.
+
+        USAGE:
+
+            Matrix::Float16Representation W = Matrix::narrow<Matrix::float16>(weights);
+
+            Matrix::Representation y  = Matrix::Operations::LowPrecision::multiply(x, W);
+            Matrix::Representation dx = Matrix::Operations::LowPrecision::hadamard(saved, g);
+
+        */
+        namespace LowPrecision {
+
+            template <HalfFloat T>
+            Matrix::Representation multiply(const Matrix::Representation& l, const BasicRepresentation<T>& r) noexcept;
+
+            template <HalfFloat T>
+            Matrix::Representation multiply(const BasicRepresentation<T>& l, const BasicRepresentation<T>& r) noexcept;
+
+            template <HalfFloat T>
+            Matrix::Representation multiply(const BasicRepresentation<T>& l, const Matrix::Representation& r) noexcept;
+
+            template <HalfFloat T>
+            Matrix::Representation transpose_multiply(const BasicRepresentation<T>& l, const BasicRepresentation<T>& r) noexcept;
+
+            template <HalfFloat T>
+            Matrix::Representation multiply_transpose(const BasicRepresentation<T>& l, const BasicRepresentation<T>& r) noexcept;
+
+            template <HalfFloat T>
+            Matrix::Representation add(const BasicRepresentation<T>& l, const Matrix::Representation& r) noexcept;
+
+            template <HalfFloat T>
+            Matrix::Representation add(const BasicRepresentation<T>& l, const BasicRepresentation<T>& r) noexcept;
+
+            template <HalfFloat T>
+            Matrix::Representation hadamard(const BasicRepresentation<T>& l, const Matrix::Representation& r) noexcept;
+
+            template <HalfFloat T>
+            Matrix::Representation hadamard(const BasicRepresentation<T>& l, const BasicRepresentation<T>& r) noexcept;
+
+            template <HalfFloat T>
+            Matrix::Representation relu(const BasicRepresentation<T>& m) noexcept;
+
+            // g where the input m of a ReLU was positive, 0 elsewhere.
+            template <HalfFloat T>
+            Matrix::Representation relu_gradient(const BasicRepresentation<T>& m, const BasicRepresentation<T>& g) noexcept;
+
+            template <HalfFloat T>
+            Matrix::Representation sum_rows(const BasicRepresentation<T>& m) noexcept;
+
+        }
+
+    }
+
+}
+
+
+#endif // HALF_PRECISION_H
@@ -0,0 +1,111 @@
+#ifndef HOGWILD_H
+#define HOGWILD_H
+
+#include "computational_graph_map.h"
+#include "parameter_buffer.h"
+#include "network_layer.h"
+#include "matrix.h"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+
+namespace NeuralNetwork {
+
+    namespace Training {
+
+        using NeuralNetwork::Computation::Graph::GraphContext;
+        using NeuralNetwork::Computation::Graph::ParameterBuffer;
+
+
+        enum class UpdatePolicy : uint8_t {
+            RACY,
+            RELAXED_ATOMIC,
+        };
+
+
+        /*
+
+        DESCRIPTION:
+
+            Lock-free asynchronous SGD (Hogwild!, Niu et al. 2011).
+
+            Every thread trains its own replica of the model, in its
+            own GraphContext, on its own contiguous shard of the
+            samples. The replicas' weights are views into the master's
+            flat weight buffer, only their gradients are private, so
+            each thread's update lands straight in the shared weights
+            and is seen by the next forward of every other thread.
+
+            Updates do not synchronize. RACY applies them with plain
+            float stores (lost updates are tolerated by design, and
+            formally a data race), RELAXED_ATOMIC with relaxed atomic
+            read-modify-writes, which never loses an update but costs a
+            compare-exchange loop per weight. Both converge well when
+            gradients are sparse, i.e. when concurrent updates rarely
+            touch the same weights.
+
+            The builder must add the same layers, in the same order, as
+            the master model was built with.
+
+        USAGE:
+
+            NeuralNetwork::Sequential model;
+            build(model);
+
+            NeuralNetwork::Training::Hogwild trainer(model, build, 8, LEARNING_RATE);
+
+            for (int i = 0; i < TRAINING_EPOCS; i++) {
+                auto loss = trainer.epoch(inputs, labels, BATCH_SIZE);
+            }
+
+        */
+        class Hogwild {
+
+            public:
+                using ModelBuilder = std::function<void(Sequential&)>;
+
+                explicit Hogwild(Sequential& _master, const ModelBuilder& _build, size_t _threads,
+                    float _learning_rate, UpdatePolicy _policy = UpdatePolicy::RACY) noexcept;
+
+                Hogwild(const Hogwild&) = delete;
+                Hogwild& operator=(const Hogwild&) = delete;
+
+                /*
+                    One pass over the samples (one per row). Each thread
+                    walks its shard batch_size rows at a time, stepping
+                    the shared weights after every batch. Returns the
+                    summed loss.
+                */
+                float epoch(const Matrix::Representation& _inputs, const Matrix::Representation& _labels,
+                    u_int64_t _batch_size) noexcept;
+
+                size_t workers() const noexcept { return replicas.size(); }
+
+            private:
+                struct Replica {
+                    GraphContext context;
+                    Sequential model;
+                    std::shared_ptr<ParameterBuffer> flat;
+                    float loss = 0;
+                };
+
+                float _train_shard(Replica& _replica, const Matrix::Representation& _inputs,
+                    const Matrix::Representation& _labels, u_int64_t _first, u_int64_t _last,
+                    u_int64_t _batch_size) noexcept;
+
+                std::shared_ptr<ParameterBuffer> master;
+                std::vector<std::unique_ptr<Replica>> replicas;
+                float learning_rate;
+                UpdatePolicy policy;
+        };
+
+
+    }
+
+}
+
+
+#endif // HOGWILD_H
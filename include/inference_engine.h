@@ -0,0 +1,106 @@
+#ifndef INFERENCE_ENGINE_H
+#define INFERENCE_ENGINE_H
+
+#include "network_layer.h"
+#include "sparse.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+
+namespace NeuralNetwork {
+
+    namespace Inference {
+
+
+        /*
+
+        DESCRIPTION:
+
+            Single-sample inference without the graph.
+
+            Compiles a Sequential into a flat list of kernels whose
+            shapes are resolved once, at construction: a matrix multiply
+            followed by its bias (and a ReLU right after) is fused into
+            one affine kernel, ReLU and SoftMax otherwise run in place.
+            Activations alternate between two preallocated, 64 byte
+            aligned buffers sized for the widest layer, so run()
+            allocates nothing and touches no Tensor, shared_ptr or
+            ComputationalGraphMap.
+
+            The kernels read the model's weights in place: compile after
+            the model is final (trained, loaded or flattened) and do not
+            rebind its parameters while the engine lives. is_compiled()
+            is false for models with modules the engine cannot run.
+
+            Given block-sparse copies of the weights (prune_blocks), in
+            forward order, the affine kernels run on those instead and
+            read only the blocks pruning kept.
+
+        USAGE:
+
+            NeuralNetwork::Inference::InferenceEngine engine(model, 2000);
+
+            NeuralNetwork::Inference::InferenceEngine sparse_engine(model, 2000,
+                NeuralNetwork::Inference::prune_blocks(model, 0.9f));
+
+            const float* prediction = engine.run(sample);
+
+            for (u_int64_t c = 0; c < engine.output_width(); c++) { ... prediction[c] ... }
+
+        */
+        class InferenceEngine {
+
+            public:
+                explicit InferenceEngine(Sequential& _model, u_int64_t _input_width) noexcept;
+
+                explicit InferenceEngine(Sequential& _model, u_int64_t _input_width,
+                    std::vector<std::shared_ptr<const Matrix::BlockSparseRepresentation>> _sparse_weights) noexcept;
+
+                InferenceEngine(const InferenceEngine&) = delete;
+                InferenceEngine& operator=(const InferenceEngine&) = delete;
+
+                bool is_compiled() const noexcept { return compiled; }
+
+                /*
+                    Runs input_width floats through the model. The output
+                    stays valid until the next call.
+                */
+                const float* run(const float* _input) noexcept;
+
+                u_int64_t input_width()  const noexcept { return in_width; }
+                u_int64_t output_width() const noexcept { return out_width; }
+                size_t kernels()         const noexcept { return plan.size(); }
+
+            private:
+                struct Kernel {
+                    enum class Op : u_int8_t { AFFINE, RELU, SOFTMAX };
+
+                    Op op;
+                    const float* weights = nullptr;
+                    const float* bias = nullptr;
+                    u_int64_t in = 0;
+                    u_int64_t out = 0;
+                    bool relu = false;
+                    const Matrix::BlockSparseRepresentation* sparse = nullptr;
+                };
+
+                std::vector<Kernel> plan;
+                std::vector<std::shared_ptr<Tensor>> parameters;
+                std::vector<std::shared_ptr<const Matrix::BlockSparseRepresentation>> sparse_weights;
+                std::unique_ptr<float[], decltype(&std::free)> buffers;
+                u_int64_t stride = 0;
+                u_int64_t in_width;
+                u_int64_t out_width;
+                bool compiled = true;
+        };
+
+
+    }
+
+}
+
+
+#endif // INFERENCE_ENGINE_H
@@ -0,0 +1,140 @@
+#ifndef INFERENCE_SERVER_H
+#define INFERENCE_SERVER_H
+
+#include "mpmc_queue.h"
+#include "network_layer.h"
+#include "matrix.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+namespace NeuralNetwork {
+
+    namespace Serving {
+
+
+        /*
+
+        DESCRIPTION:
+
+            Serves a Sequential model over a Unix domain socket,
+            coalescing concurrent requests into minibatches.
+
+            Every connection gets a detached reader thread that pushes
+            its requests onto a lock-free MPMC queue and exits when the
+            client hangs up, so clients can come and go indefinitely. A single batcher
+            thread pops the oldest request, keeps popping until the
+            batch holds max_batch requests or the oldest has waited
+            max_delay, then runs one B x N InferenceTag forward, which
+            registers nothing on the graph and leaves the grad mode of
+            the model's context alone, and answers every request with
+            its row of the output. Under
+            load the batches fill up and the model runs the GEMM shaped
+            path instead of a 1 x N forward per request; when idle a
+            request waits at most max_delay before it runs alone.
+
+            Wire format, both directions: a uint32 float count followed
+            by that many native floats. A request must carry exactly
+            input_width floats, otherwise the connection is closed.
+            Responses come back in request order.
+
+            submit() enters the same queue from inside the process.
+
+            The server must be the only user of the model while it runs.
+
+        USAGE:
+
+            NeuralNetwork::Serving::InferenceServer server(model, 784, 64, std::chrono::microseconds(500));
+
+            server.listen("/tmp/model.sock");
+
+            auto prediction = server.submit(std::vector<float>(784, 0.0f));
+
+            server.stop();
+
+        */
+        class InferenceServer {
+
+            public:
+                using clock = std::chrono::steady_clock;
+
+                explicit InferenceServer(Sequential& _model, u_int64_t _input_width, u_int64_t _max_batch,
+                    std::chrono::microseconds _max_delay, size_t _queue_capacity = 1024) noexcept;
+
+                ~InferenceServer() noexcept;
+
+                InferenceServer(const InferenceServer&) = delete;
+                InferenceServer& operator=(const InferenceServer&) = delete;
+
+                // Starts accepting connections on a Unix domain socket at path.
+                bool listen(const std::string& _path) noexcept;
+
+                // Runs input (input_width floats) through the model with the other queued requests.
+                std::future<std::vector<float>> submit(std::vector<float> _input) noexcept;
+
+                // Stops accepting, closes every connection and answers what is still queued.
+                void stop() noexcept;
+
+                u_int64_t requests() const noexcept { return served.load(std::memory_order_relaxed); }
+                u_int64_t batches()  const noexcept { return forwards.load(std::memory_order_relaxed); }
+
+                // Connections whose reader thread is still running.
+                size_t clients() const noexcept {
+                    std::lock_guard<std::mutex> guard(connections_lock);
+                    return readers;
+                }
+
+            private:
+                struct Connection;
+
+                struct Request {
+                    std::vector<float> input;
+                    std::function<void(const float*, u_int64_t)> reply;
+                    clock::time_point arrival;
+                };
+
+                void _enqueue(Request&& _request) noexcept;
+                void _batch() noexcept;
+                void _run(std::vector<Request>& _batch) noexcept;
+                void _accept() noexcept;
+                void _read(std::shared_ptr<Connection> _connection) noexcept;
+
+                Sequential& model;
+                const u_int64_t input_width;
+                const u_int64_t max_batch;
+                const std::chrono::microseconds max_delay;
+
+                MPMCQueue<Request> queue;
+
+                std::atomic<bool> running = true;
+                std::atomic<u_int64_t> served = 0;
+                std::atomic<u_int64_t> forwards = 0;
+                std::thread batcher;
+
+                int listener = -1;
+                std::string socket_path;
+                std::thread acceptor;
+
+                mutable std::mutex connections_lock;
+                std::vector<std::shared_ptr<Connection>> connections;
+                size_t readers = 0;
+                std::condition_variable readers_done;
+        };
+
+
+    }
+
+}
+
+
+#endif // INFERENCE_SERVER_H
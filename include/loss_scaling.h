@@ -0,0 +1,156 @@
+#ifndef LOSS_SCALING_H
+#define LOSS_SCALING_H
+
+#include "parameter_buffer.h"
+#include "network_layer.h"
+#include "half_precision.h"
+#include "matrix.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+
+namespace NeuralNetwork {
+
+    namespace Training {
+
+        using NeuralNetwork::Computation::Graph::ParameterBuffer;
+
+
+        /*
+
+        DESCRIPTION:
+
+            Dynamic loss scale for 16-bit gradients.
+
+            The loss gradient is multiplied by scale() before the
+            reverse pass, lifting small gradients out of the range a
+            16-bit format flushes to zero. A step whose gradients
+            overflow is skipped and the scale multiplied by backoff;
+            after interval steps in a row without overflow the scale is
+            multiplied by growth, to find the largest scale that fits.
+
+        USAGE:
+
+            NeuralNetwork::Training::DynamicLossScaler scaler(65536.0f);
+
+            if (scaler.update(overflowed)) optimizer.step();
+
+        */
+        class DynamicLossScaler {
+
+            public:
+                explicit DynamicLossScaler(float _initial = 65536.0f, float _growth = 2.0f,
+                    float _backoff = 0.5f, u_int64_t _interval = 2000) noexcept :
+                        current(_initial), growth(_growth), backoff(_backoff), interval(_interval) {}
+
+                float scale() const noexcept { return current; }
+
+                // Records a step, returns whether its gradients may be applied.
+                bool update(bool _overflow) noexcept;
+
+                u_int64_t skipped() const noexcept { return skips; }
+
+            private:
+                float current;
+                float growth;
+                float backoff;
+                u_int64_t interval;
+                u_int64_t clean = 0;
+                u_int64_t skips = 0;
+        };
+
+
+        /*
+
+        DESCRIPTION:
+
+            Mixed-precision training of a Sequential of linear layers
+            and ReLUs: fp32 master weights, forward and backward in a
+            16-bit format T (bfloat16 or float16).
+
+            The model is compiled once into its kernels (as for
+            InferenceEngine). A step narrows the weight matrices to T,
+            then runs the LowPrecision kernels outside the graph: every
+            activation saved for the backward pass, and every gradient
+            passed from one kernel to the one before it, is stored in T
+            and widened to fp32 only as a kernel loads it. Biases stay
+            fp32, they are a row per layer.
+
+            The CrossEntropy gradient is multiplied by the loss scale
+            before it is narrowed. Weight and bias gradients are summed
+            in fp32 into the model's flat gradient buffer; an entry that
+            is not finite, or would not be once narrowed to T, skips
+            the step: the gradient is cleared, the scale backs off and
+            step returns false. Otherwise the gradient is divided by
+            the scale where it lies.
+
+            is_compiled() is false for models with modules the kernels
+            do not cover (a SoftMax, or a step with no KernelSpec).
+
+        USAGE:
+
+            NeuralNetwork::Training::LossScaledTraining<Matrix::float16> trainer(model);
+            NeuralNetwork::Optimization::SGD sgd(model.flat_parameters(), LEARNING_RATE);
+
+            for (auto& [inputs, labels]: batches) {
+                if (trainer.step(inputs, labels)) sgd.step();
+            }
+
+        */
+        template <Matrix::HalfFloat T>
+        class LossScaledTraining {
+
+            public:
+                explicit LossScaledTraining(Sequential& _model, DynamicLossScaler _scaler = DynamicLossScaler{}) noexcept;
+
+                LossScaledTraining(const LossScaledTraining&) = delete;
+                LossScaledTraining& operator=(const LossScaledTraining&) = delete;
+
+                bool is_compiled() const noexcept { return compiled; }
+
+                /*
+                    Forward and backward of one minibatch, one sample per
+                    row. Leaves the unscaled gradient in the model's flat
+                    gradient buffer and returns whether the optimizer
+                    should step.
+                */
+                bool step(const Matrix::Representation& _inputs, const Matrix::Representation& _labels) noexcept;
+
+                // Summed loss of the last step, unscaled.
+                float loss() const noexcept { return last_loss; }
+
+                const DynamicLossScaler& scaler() const noexcept { return loss_scaler; }
+
+                // Bytes of 16-bit weights and saved activations the last step kept.
+                u_int64_t stored_bytes() const noexcept;
+
+            private:
+                struct Kernel {
+                    KernelSpec::Op op;
+                    std::shared_ptr<Tensor> parameter;
+                    Matrix::BasicRepresentation<T> weights;
+                };
+
+                Matrix::Representation _forward(const Matrix::Representation& _inputs) noexcept;
+                void _backward(Matrix::BasicRepresentation<T>& _gradient) noexcept;
+                bool _unscale_gradients(float _scale) noexcept;
+
+                std::vector<Kernel> plan;
+
+                // The input of every kernel, in T.
+                std::vector<Matrix::BasicRepresentation<T>> activations;
+
+                std::shared_ptr<ParameterBuffer> flat;
+                DynamicLossScaler loss_scaler;
+                float last_loss = 0;
+                bool compiled = true;
+        };
+
+    }
+
+}
+
+
+#endif // LOSS_SCALING_H
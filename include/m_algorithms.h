@@ -20,7 +20,7 @@ namespace Matrix {
 
 
         enum class Code {
-            NOP, MULTIPLY, PLUS, ReLU, SoftMax, OUTER_PRODUCT, HADAMARD, CROSS_ENTROPY,        
+            NOP, MULTIPLY, PLUS, MINUS, ReLU, SoftMax, OUTER_PRODUCT, HADAMARD, CROSS_ENTROPY,        
         };
        
 
@@ -32,8 +32,9 @@ namespace Matrix {
             class UnaryAdapter {
 
                 public:
-                    Matrix::Representation operator()(
-                        const Matrix::Representation& l) const noexcept {
+                    template <ArithmeticElement T>
+                    BasicRepresentation<T> operator()(
+                        const BasicRepresentation<T>& l) const noexcept {
                         return Impl().operate(l); 
                         };
                     
@@ -50,15 +51,17 @@ namespace Matrix {
             class ReLU : public UnaryAdapter<ReLU> {
 
                 public:
-                    Matrix::Representation operate(
-                        const Matrix::Representation& m) const noexcept;
+                    template <ArithmeticElement T>
+                    BasicRepresentation<T> operate(
+                        const BasicRepresentation<T>& m) const noexcept;
             };
 
             class Sign : public UnaryAdapter<Sign> {
 
                 public:
-                    Matrix::Representation operate(
-                        const Matrix::Representation& m) const noexcept;
+                    template <ArithmeticElement T>
+                    BasicRepresentation<T> operate(
+                        const BasicRepresentation<T>& m) const noexcept;
             };
 
             static_assert(MatrixOperatable<Sign>);
@@ -67,8 +70,9 @@ namespace Matrix {
             class SoftMax : public UnaryAdapter<SoftMax> {
 
                 public:
-                    Matrix::Representation operate(
-                        const Matrix::Representation& m) const noexcept;
+                    template <ArithmeticElement T>
+                    BasicRepresentation<T> operate(
+                        const BasicRepresentation<T>& m) const noexcept;
             };
 
             static_assert(MatrixOperatable<SoftMax>);
@@ -77,16 +81,33 @@ namespace Matrix {
             class Transpose : public UnaryAdapter<Transpose> {
 
                 public:
-                    Matrix::Representation operate(
-                        const Matrix::Representation& m) const noexcept;
+                    template <ArithmeticElement T>
+                    BasicRepresentation<T> operate(
+                        const BasicRepresentation<T>& m) const noexcept;
             };
 
             static_assert(MatrixOperatable<Transpose>);
 
 
+            /*
+                Sums the rows of a matrix into a single row, B×N -> 1×N.
+                Reduces a gradient flowing into a row broadcast operand.
+            */
+            class SumRows : public UnaryAdapter<SumRows> {
+
+                public:
+                    template <ArithmeticElement T>
+                    BasicRepresentation<T> operate(
+                        const BasicRepresentation<T>& m) const noexcept;
+            };
+
+            static_assert(MatrixOperatable<SumRows>);
+
+
+            template <ArithmeticElement T>
             void transpose_helper(
-                std::vector<float>::const_iterator in, 
-                std::vector<float>::iterator       out, 
+                const T* in, 
+                T*       out, 
                 int rb, int re, int cb, int ce, int rows, int cols) noexcept;
 
         }
@@ -101,21 +122,21 @@ namespace Matrix {
                 public:
                     BaseOp() = default;
                     ~BaseOp() = default;
-                    Matrix::Representation operator()(
-                        const Matrix::Representation& l, 
-                        const Matrix::Representation& r) const noexcept { 
+                    template <ArithmeticElement T>
+                    BasicRepresentation<T> operator()(
+                        const BasicRepresentation<T>& l, 
+                        const BasicRepresentation<T>& r) const noexcept { 
                             
                             bool rows_compatable = l.num_rows() == r.num_rows();
                             bool cols_compatable = l.num_cols() == r.num_cols();
-                            bool is_vector = l.num_rows() == 1 || l.num_cols() == 1;
 
-                            assert(rows_compatable && cols_compatable && is_vector);
+                            assert(rows_compatable && cols_compatable);
                             
                             auto result = Impl().operate(l, r);
 
-                            assert(result.get_type() == Matrix::Representation::Type::SCALAR && "Metric Operation must return scalar.");
+                            assert(result.get_type() == BasicRepresentation<T>::Type::SCALAR && "Metric Operation must return scalar.");
 
-                            return Matrix::Representation{result};
+                            return BasicRepresentation<T>{result};
                         }
                 private:
                     Implementation& Impl() const noexcept { return *static_cast<Implementation*>(const_cast<BaseOp<Implementation>*>(this)); }
@@ -124,11 +145,16 @@ namespace Matrix {
             };
 
 
+            /*
+                A vector is a single sample. For a B×N matrix every row is
+                a sample and the loss is summed over the minibatch.
+            */
             class CrossEntropy : public BaseOp<CrossEntropy> {
                 public:
-                    Matrix::Representation operate(
-                        const Matrix::Representation& p, 
-                        const Matrix::Representation& q) const noexcept;
+                    template <ArithmeticElement T>
+                    BasicRepresentation<T> operate(
+                        const BasicRepresentation<T>& p, 
+                        const BasicRepresentation<T>& q) const noexcept;
             };
 
         
@@ -147,9 +173,10 @@ namespace Matrix {
                 public:
                     BaseOp() = default;
                     ~BaseOp() = default;
-                    Matrix::Representation operator()(
-                        const Matrix::Representation& l, 
-                        const Matrix::Representation& r) const noexcept { 
+                    template <ArithmeticElement T>
+                    BasicRepresentation<T> operator()(
+                        const BasicRepresentation<T>& l, 
+                        const BasicRepresentation<T>& r) const noexcept { 
                                                     
                             return Impl().operate(l, r);
                         };
@@ -164,14 +191,32 @@ namespace Matrix {
 
 
 
+            /*
+                Elementwise operators (Addition::Std, Subtraction::Std,
+                HadamardProduct::Std) broadcast NumPy-style: a dimension
+                of size 1 is stretched over the other operand's, covering
+                a row (1×N), a column (B×1) or a scalar (1×1) against a 
+                B×N matrix. The broadcast operand is walked with stride 0,
+                no expanded copy is made.
+
+                Usage:
+
+                    Matrix::Representation bias  = Matrix::Representation(Rows(1), Columns(100));
+                    Matrix::Representation batch = Matrix::Representation(Rows(64), Columns(100));
+
+                    Matrix::Operations::Binary::Addition::Std add;
+
+                    Matrix::Representation out = add(batch, bias);  // 64x100
+            */
             namespace Addition {
 
 
                 class Std : public BaseOp<Std> {
                     public:
-                        Matrix::Representation operate(
-                            const Matrix::Representation& l, 
-                            const Matrix::Representation& r) const noexcept;
+                        template <ArithmeticElement T>
+                        BasicRepresentation<T> operate(
+                            const BasicRepresentation<T>& l, 
+                            const BasicRepresentation<T>& r) const noexcept;
                 };
 
             }
@@ -183,9 +228,10 @@ namespace Matrix {
 
                 class Std : public BaseOp<Std> {
                     public:
-                        Matrix::Representation operate(
-                            const Matrix::Representation& l, 
-                            const Matrix::Representation& r) const noexcept;
+                        template <ArithmeticElement T>
+                        BasicRepresentation<T> operate(
+                            const BasicRepresentation<T>& l, 
+                            const BasicRepresentation<T>& r) const noexcept;
                 };
 
             }
@@ -193,15 +239,33 @@ namespace Matrix {
             static_assert(MatrixOperatable<Subtraction::Std>);
 
 
+            /*
+                Sums a gradient of the broadcast output shape back down to
+                the shape of the operand that was broadcast.
+            */
+            template <ArithmeticElement T>
+            BasicRepresentation<T> reduce_to_shape(
+                const BasicRepresentation<T>& g, Rows _l, Columns _w) noexcept;
+
+
+            /*
+                into += g in place, one parallel vectorized sweep with no
+                temporary. Shapes must match.
+            */
+            template <ArithmeticElement T>
+            void accumulate(BasicRepresentation<T>& into, const BasicRepresentation<T>& g) noexcept;
+
+
             namespace OuterProduct {
 
 
 
                 class Naive : public BaseOp<Naive> {
                     public:
-                        Matrix::Representation operate(
-                            const Matrix::Representation& l, 
-                            const Matrix::Representation& r) const noexcept;
+                        template <ArithmeticElement T>
+                        BasicRepresentation<T> operate(
+                            const BasicRepresentation<T>& l, 
+                            const BasicRepresentation<T>& r) const noexcept;
                 };
 
 
@@ -220,18 +284,20 @@ namespace Matrix {
                 class Naive : public BaseOp<Naive> {
 
                     public:
-                        Matrix::Representation operate(
-                            const Matrix::Representation& l, 
-                            const Matrix::Representation& r) const noexcept;
+                        template <ArithmeticElement T>
+                        BasicRepresentation<T> operate(
+                            const BasicRepresentation<T>& l, 
+                            const BasicRepresentation<T>& r) const noexcept;
                 };
 
 
-                class Std : public BaseOp<Naive> {
+                class Std : public BaseOp<Std> {
 
                     public:
-                        Matrix::Representation operate(
-                            const Matrix::Representation& l, 
-                            const Matrix::Representation& r) const noexcept;
+                        template <ArithmeticElement T>
+                        BasicRepresentation<T> operate(
+                            const BasicRepresentation<T>& l, 
+                            const BasicRepresentation<T>& r) const noexcept;
                 };
 
 
@@ -258,9 +324,10 @@ namespace Matrix {
                 class Naive : public BaseOp<Naive> {
 
                     public:
-                        Matrix::Representation operate(
-                            const Matrix::Representation& l, 
-                            const Matrix::Representation& r) const noexcept;
+                        template <ArithmeticElement T>
+                        BasicRepresentation<T> operate(
+                            const BasicRepresentation<T>& l, 
+                            const BasicRepresentation<T>& r) const noexcept;
 
                 };
 
@@ -268,22 +335,25 @@ namespace Matrix {
                 class Square : public BaseOp<Square> {
 
                         public:
-                            Matrix::Representation operate(
-                                const Matrix::Representation& l, 
-                                const Matrix::Representation& r) const noexcept;
+                            template <ArithmeticElement T>
+                            BasicRepresentation<T> operate(
+                                const BasicRepresentation<T>& l, 
+                                const BasicRepresentation<T>& r) const noexcept;
                 };
 
 
                 class ParallelDNC : public BaseOp<ParallelDNC> {
 
                                 public:
-                                    Matrix::Representation operate(
-                                        const Matrix::Representation& l, 
-                                        const Matrix::Representation& r) const noexcept;
+                                    template <ArithmeticElement T>
+                                    BasicRepresentation<T> operate(
+                                        const BasicRepresentation<T>& l, 
+                                        const BasicRepresentation<T>& r) const noexcept;
                 };
 
 
-                void add_matmul_rec(std::vector<float>::iterator c, std::vector<float>::iterator a, std::vector<float>::iterator b, 
+                template <ArithmeticElement T>
+                void add_matmul_rec(const T* a, const T* b, T* c, 
                         int m, int n, int p, int fdA, int fdB, int fdC) noexcept;
                     
 
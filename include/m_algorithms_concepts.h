@@ -22,19 +22,25 @@ concept Same_as = SameHelper<T, U> && SameHelper<U, T>;
 
 namespace Matrix {
 
+
     namespace Operations {
 
 
 
 
-        template <typename T>
-        concept UnaryMatrixOperatable = requires(T _op, Matrix::Representation mtx) {
+        /*
+            An operation on matrices of Element, returning the precision
+            it was given. The computational graph asks for fp32 only, an
+            operation need not be defined in every precision.
+        */
+        template <typename T, typename Element = float>
+        concept UnaryMatrixOperatable = ArithmeticElement<Element> && requires(T _op, Matrix::BasicRepresentation<Element> mtx) {
             _op.operate(mtx);
             { _op.operate(mtx) } -> Same_as<decltype(mtx)>;
         };
 
-        template <typename T>
-        concept BinaryMatrixOperatable = requires(T _op, Matrix::Representation mtx) {
+        template <typename T, typename Element = float>
+        concept BinaryMatrixOperatable = ArithmeticElement<Element> && requires(T _op, Matrix::BasicRepresentation<Element> mtx) {
             _op.operate(mtx, mtx);
             { _op.operate(mtx, mtx) } -> Same_as<decltype(mtx)>;
         };
@@ -44,8 +50,8 @@ namespace Matrix {
         //     {mtx.num_rows()} == 1;
         // };
 
-        template <typename T>
-        concept MatrixOperatable = BinaryMatrixOperatable<T> || UnaryMatrixOperatable<T>;
+        template <typename T, typename Element = float>
+        concept MatrixOperatable = BinaryMatrixOperatable<T, Element> || UnaryMatrixOperatable<T, Element>;
         
 
 
@@ -89,12 +95,14 @@ namespace NeuralNetwork {
             };
 
 
+            class ComputationalGraphMap;
+
             template <typename GraphIteratorPolicy>
-            concept TraversalPolicy = requires(GraphIteratorPolicy policy, std::stack<TensorID>& tid_stack, TensorID tid) {
+            concept TraversalPolicy = requires(GraphIteratorPolicy policy, ComputationalGraphMap& map, std::stack<TensorID>& tid_stack, TensorID tid) {
 
-                policy.process_head(tid);
-                policy.apply_to_children(tid_stack, tid);
-                policy.dereference(tid);
+                policy.process_head(map, tid);
+                policy.apply_to_children(map, tid_stack, tid);
+                policy.dereference(map, tid);
 
             };
 
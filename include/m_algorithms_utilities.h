@@ -61,6 +61,9 @@ namespace Matrix {
                             constexpr std::string_view operator()(
                                 const Binary::Addition::Std&) { 
                                     return "Addition"; }
+                            constexpr std::string_view operator()(
+                                const Binary::Subtraction::Std&) { 
+                                    return "Subtraction"; }
                             constexpr std::string_view operator()(
                                 const Binary::OuterProduct::Naive&) { 
                                     return "OuterProduct"; }
@@ -91,6 +94,9 @@ namespace Matrix {
                             constexpr Code operator()(
                                 const Binary::Addition::Std&)               
                                 { return Code::PLUS; }
+                            constexpr Code operator()(
+                                const Binary::Subtraction::Std&)            
+                                { return Code::MINUS; }
                             constexpr Code operator()(
                                 const Binary::OuterProduct::Naive&)         
                                 { return Code::OUTER_PRODUCT; }
@@ -7,9 +7,12 @@
 #include <string>
 #include <memory>
 #include <utility>
+#include <algorithm>
+#include <concepts>
 
 #include "assert.h"
 #include "strong_types.h"
+#include "half_float.h"
 
 
 
@@ -19,17 +22,69 @@ namespace Matrix {
     using Rows    = NamedType<u_int64_t, struct RowParameter>;
     using Columns = NamedType<u_int64_t, struct ColumnParameter>;
 
+
+    /*
+        Element types the Matrix::Operations kernels compute in. Each
+        has its own vectorized path, chosen at compile time.
+    */
+    template <typename T>
+    concept ArithmeticElement = std::same_as<T, float> || std::same_as<T, double>;
+
+
+    /*
+        Element types a BasicRepresentation holds. A 16-bit element is
+        storage only, the kernels that take it widen it to fp32.
+    */
+    template <typename T>
+    concept MatrixElement = ArithmeticElement<T> || HalfFloat<T>;
+
     
 
 
 
-    class Representation {
+    /*
+
+    DESCRIPTION:
+
+        Row-major matrix of T, owning its elements or viewing memory
+        owned elsewhere.
+
+        The element type is fixed at compile time. Matrix::Representation,
+        the fp32 matrix the computational graph runs on, is
+        BasicRepresentation<float>; Matrix::DoubleRepresentation is the
+        fp64 one for workloads that need the precision. The kernels in
+        Matrix::Operations are templated on the element type and picked
+        by overload resolution, so a precision costs no runtime dispatch.
+
+        Matrix::BFloat16Representation and Float16Representation hold
+        16-bit elements, for storage: the fp32 kernels are not
+        instantiated for them, the ones in half_precision.h read them
+        and widen to fp32.
+
+        fp64 stops at the kernels: Tensor, the computational graph, its
+        backward rules and the optimizers run on fp32 only, so there
+        are no fp64 gradients. Templating them is tracked separately,
+        as fp64 Training in REQUIREMENTS.md.
+
+    USAGE:
+
+        Matrix::DoubleRepresentation a = Matrix::DoubleRepresentation(Matrix::Rows(200), Matrix::Columns(100));
+        Matrix::DoubleRepresentation b = Matrix::DoubleRepresentation(Matrix::Rows(100), Matrix::Columns(300));
+
+        Matrix::Operations::Binary::Multiplication::ParallelDNC mul;
+
+        Matrix::DoubleRepresentation c = mul(a, b);
+
+    */
+    template <MatrixElement T>
+    class BasicRepresentation {
 
         public:
-            using matrix_iter = std::vector<float>::iterator;
-            using const_matrix_iter = std::vector<float>::const_iterator;
+            using value_type = T;
+            using matrix_iter = T*;
+            using const_matrix_iter = const T*;
             
-            ~Representation() noexcept {};
+            ~BasicRepresentation() noexcept {};
             
             enum class Type : uint8_t {
                 MATRIX,
@@ -39,35 +94,71 @@ namespace Matrix {
             };
 
 
-            Representation() noexcept : rows(0), columns(0) {}
+            BasicRepresentation() noexcept : rows(0), columns(0), view(nullptr) {}
             
             
-                explicit Representation(Rows _l, Columns _w) noexcept  : 
+                explicit BasicRepresentation(Rows _l, Columns _w) noexcept  : 
                 rows(_l.get()), 
                 columns(_w.get()), 
-                data(std::vector<float>(_l.get() * _w.get(), 0)) {}
+                data(std::vector<T>(_l.get() * _w.get(), T(0))),
+                view(nullptr) {}
 
             
-            explicit Representation(const Matrix::Representation& _other) noexcept : 
+            explicit BasicRepresentation(const BasicRepresentation& _other) noexcept : 
                 rows(_other.rows), 
                 columns(_other.columns), 
-                data(_other.data) {}
+                data(_other.constScanStart(), _other.constScanEnd()),
+                view(nullptr) {}
             
             
-            explicit Representation(Matrix::Representation&& _other) noexcept : 
+            explicit BasicRepresentation(BasicRepresentation&& _other) noexcept : 
                 rows(std::exchange(_other.rows, 0)), 
                 columns(std::exchange(_other.columns, 0)), 
-                data(std::move(_other.data)) {}
+                data(std::move(_other.data)),
+                view(std::exchange(_other.view, nullptr)),
+                owner(std::move(_other.owner)) {}
+
+
+            /*
+                DESCRIPTION:
+                    Non-owning Representation over memory managed elsewhere
+                    (a planner slab, a flat parameter buffer, a mapped file).
+                    
+                    owner keeps the backing allocation alive for as long as
+                    the view exists. Assigning a matrix of the same shape
+                    into a view writes through to the backing memory, so
+                    `tensor->get_grad() = djdW` fills the slot in place.
+            */
+            static BasicRepresentation view_of(Rows _l, Columns _w, T* _ptr, 
+                std::shared_ptr<void> _owner = nullptr) noexcept {
+                
+                BasicRepresentation output;
+                output.rows    = _l.get();
+                output.columns = _w.get();
+                output.view    = _ptr;
+                output.owner   = std::move(_owner);
+                return BasicRepresentation{std::move(output)};
+            }
             
 
-            Representation& operator=(const Matrix::Representation& _other) noexcept {
+            BasicRepresentation& operator=(const BasicRepresentation& _other) noexcept {
+
+                if (this == &_other) return *this;
+
+                if (is_view() && rows == _other.rows && columns == _other.columns) {
+                    std::copy(_other.constScanStart(), _other.constScanEnd(), scanStart());
+                    return *this;
+                }
+
                 rows    = _other.rows; 
                 columns = _other.columns; 
-                data    = _other.data;
+                data.assign(_other.constScanStart(), _other.constScanEnd());
+                view    = nullptr;
+                owner.reset();
                 return *this;
             }
 
-            Representation& operator+=(const Matrix::Representation& _other) noexcept {
+            BasicRepresentation& operator+=(const BasicRepresentation& _other) noexcept {
                 
                 assert(rows    == _other.rows); 
                 assert(columns == _other.columns);
@@ -80,47 +171,73 @@ namespace Matrix {
                 return *this;
             }
 
-            friend Representation operator*(double val, const Matrix::Representation& _other) noexcept {
+            friend BasicRepresentation operator*(double val, const BasicRepresentation& _other) noexcept {
                 
-                Representation output{_other};
+                BasicRepresentation output{_other};
 
                 for (auto it = output.scanStart(); it != output.scanEnd(); it++) {
-                    *it = val * *it;
+                    *it = T(val * *it);
                 }
 
-                return Representation{output};
+                return BasicRepresentation{output};
             }
 
 
-            Representation& operator=(Matrix::Representation&& _other) {
+            BasicRepresentation& operator=(BasicRepresentation&& _other) {
+
+                if (this == &_other) return *this;
+
+                if (is_view() && rows == _other.rows && columns == _other.columns) {
+                    std::copy(_other.constScanStart(), _other.constScanEnd(), scanStart());
+                    return *this;
+                }
+
                 rows = std::exchange(_other.rows, 0);
                 columns = std::exchange(_other.columns, 0); 
                 data = std::move(_other.data);
+                view = std::exchange(_other.view, nullptr);
+                owner = std::move(_other.owner);
                 return *this; 
             }
 
             Type get_type(void) const noexcept;
             std::string_view get_type_string(void) const noexcept;
 
-            bool operator==(const Matrix::Representation _other) noexcept;
-            bool operator!=(const Matrix::Representation _other) noexcept;
+            bool operator==(const BasicRepresentation _other) noexcept;
+            bool operator!=(const BasicRepresentation _other) noexcept;
 
             constexpr u_int64_t num_rows() const noexcept { return rows; }
             constexpr u_int64_t num_cols() const noexcept { return columns; }
+            constexpr u_int64_t size()     const noexcept { return rows * columns; }
+            constexpr u_int64_t bytes()    const noexcept { return size() * sizeof(T); }
             
+            constexpr bool is_view()       const noexcept { return view != nullptr; }
             
-            float get(u_int64_t r, u_int64_t c) const noexcept;
-            void put(u_int64_t r, u_int64_t c, float val) noexcept;
+            T get(u_int64_t r, u_int64_t c) const noexcept;
+            void put(u_int64_t r, u_int64_t c, T val) noexcept;
 
 
-            constexpr matrix_iter scanStart() { return data.begin(); }
-            constexpr matrix_iter scanEnd()   { return data.end(); }
+            constexpr matrix_iter scanStart() { return view ? view : data.data(); }
+            constexpr matrix_iter scanEnd()   { return scanStart() + size(); }
             
-            constexpr const_matrix_iter constScanStart() const { return data.cbegin(); }
-            constexpr const_matrix_iter constScanEnd() const { return data.cend(); }
+            constexpr const_matrix_iter constScanStart() const { return view ? view : data.data(); }
+            constexpr const_matrix_iter constScanEnd() const { return constScanStart() + size(); }
+
+
+            /*
+                Drops the matrix contents and returns its memory 
+                (or detaches from the backing slab for a view).
+            */
+            void release() noexcept {
+                rows    = 0;
+                columns = 0;
+                std::vector<T>{}.swap(data);
+                view    = nullptr;
+                owner.reset();
+            }
 
 
-            // friend void swap(Representation& left, Representation& right) noexcept {
+            // friend void swap(BasicRepresentation& left, BasicRepresentation& right) noexcept {
             //     std::swap(left.rows, right.rows);
             //     std::swap(left.columns, right.columns);
             //     std::swap(left.data, right.data);
@@ -129,10 +246,23 @@ namespace Matrix {
         private:
             u_int64_t rows;
             u_int64_t columns;
-            std::vector<float> data;
+            std::vector<T> data;
+            T* view;
+            std::shared_ptr<void> owner;
     };
 
 
+    using Representation         = BasicRepresentation<float>;
+    using DoubleRepresentation   = BasicRepresentation<double>;
+    using BFloat16Representation = BasicRepresentation<bfloat16>;
+    using Float16Representation  = BasicRepresentation<float16>;
+
+    extern template class BasicRepresentation<float>;
+    extern template class BasicRepresentation<double>;
+    extern template class BasicRepresentation<bfloat16>;
+    extern template class BasicRepresentation<float16>;
+
+
 
     // class Matrix : public Representation {
 
@@ -0,0 +1,181 @@
+#ifndef MEMORY_PLANNER_H
+#define MEMORY_PLANNER_H
+
+#include "computational_graph_map.h"
+#include "strong_types.h"
+#include "matrix.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+
+namespace NeuralNetwork {
+
+    namespace Computation {
+
+        namespace Graph {
+
+            class Tensor;
+
+
+            enum class BufferKind : uint8_t {
+                ACTIVATION,
+                GRADIENT,
+            };
+
+
+            /*
+                Live interval of one intermediate buffer on the training
+                timeline. Forward steps occupy [0, N), the reverse sweep
+                occupies [N, 2N) in reverse topological order.
+            */
+            struct BufferLifetime {
+                TensorID tensor;
+                BufferKind kind;
+                u_int64_t rows;
+                u_int64_t columns;
+                size_t bytes;
+                size_t first_use;
+                size_t last_use;
+                size_t slab;
+                size_t offset;
+            };
+
+
+            /*
+                Slots for the intermediates of a recorded step. While a
+                Replay is alive, every operation output the context
+                creates takes the next slot in creation order: its
+                activation is copied into it as soon as the kernel 
+                returns and its gradient slot is reserved. A step must
+                create the same operations in the same order as the 
+                recorded one; at the first output of another shape the
+                rest of the step allocates on its own. The tensors of a
+                replayed step are valid until the next replay.
+
+                planned_peak_bytes() is what a replayed step holds at 
+                most: the leaves, the root, the slabs and one kernel
+                result waiting to be copied. unplanned_peak_bytes() is
+                the peak of the same step without a plan, every 
+                activation alive until its rule in the reverse pass.
+            */
+            class MemoryPlan {
+
+                public:
+                    constexpr static size_t ALIGNMENT = 64;
+
+                    class Replay {
+                        public:
+                            explicit Replay(MemoryPlan& _plan) noexcept;
+                            ~Replay() noexcept;
+
+                            Replay(const Replay&) = delete;
+                            Replay& operator=(const Replay&) = delete;
+                        private:
+                            MemoryPlan& plan;
+                            MemoryPlan* previous;
+                    };
+
+                    void report() const noexcept;
+
+                    size_t planned_peak_bytes() const noexcept;
+                    size_t unplanned_peak_bytes() const noexcept;
+
+                    // Outputs of the last replay that landed in their slot.
+                    size_t placed() const noexcept { return taken; }
+
+                    const std::vector<BufferLifetime>& buffers() const noexcept { return lifetimes; }
+                    const std::vector<size_t>& slab_sizes() const noexcept { return slab_bytes; }
+
+                    bool _take(u_int64_t _rows, u_int64_t _columns,
+                        Matrix::Representation& _activation, Matrix::Representation& _gradient) noexcept;
+
+                private:
+                    friend class MemoryPlanner;
+
+                    constexpr static size_t UNPLANNED = SIZE_MAX;
+
+                    Matrix::Representation _slot(const BufferLifetime& _buffer) const noexcept;
+
+                    // Activation and gradient of intermediate j are lifetimes 2j and 2j + 1.
+                    std::vector<BufferLifetime> lifetimes;
+                    std::vector<size_t> slab_bytes;
+                    std::vector<std::shared_ptr<void>> slabs;
+
+                    // Per operation output of the step in creation order, its intermediate or UNPLANNED.
+                    std::vector<size_t> creation_order;
+                    size_t next  = 0;
+                    size_t taken = 0;
+                    bool diverged = false;
+
+                    size_t persistent_bytes = 0;
+                    ComputationalGraphMap* context = nullptr;
+            };
+
+
+            /*
+
+            DESCRIPTION:
+
+                Liveness analysis over the recorded computational graph.
+
+                Every intermediate Tensor holds an activation and a gradient
+                that are only needed for part of the training step: an activation
+                dies after its last forward consumer (or the backward rule that
+                re-reads it), a gradient is born when its consumer's backward rule
+                writes it and dies once its own rule has propagated it.
+
+                Buffers are packed into a small set of slabs greedily by size,
+                reusing offsets whose intervals do not overlap, much like a
+                register allocator reuses registers between disjoint live ranges.
+
+                Leaves (inputs and parameters) and the root are persistent and
+                never share memory, nor do outputs not made by a TensorOp
+                (a sparse product, a checkpoint boundary).
+
+                The plan is analysed on one recorded step and then replayed
+                by the following ones, whose forward outputs are allocated 
+                straight into their slots, so the forward peak drops too.
+
+            USAGE:
+
+                auto loss = CE(ground_truth, model.forward(ma));
+
+                NeuralNetwork::Computation::Graph::MemoryPlanner planner;
+                auto plan = planner.analyse(*loss);
+                loss->backwards();
+
+                plan.report();
+
+                for (int i = 0; i < TRAINING_EPOCS; i++) {
+                    NeuralNetwork::Computation::Graph::MemoryPlan::Replay replay(plan);
+
+                    auto loss = CE(ground_truth, model.forward(ma));
+                    loss->backwards();
+                }
+
+            */
+            class MemoryPlanner {
+
+                public:
+                    explicit MemoryPlanner(size_t _max_slab_bytes = 0) noexcept :
+                        max_slab_bytes(_max_slab_bytes) {}
+
+                    MemoryPlan analyse(Tensor& root) noexcept;
+
+                private:
+                    void _assign_offsets(MemoryPlan& plan) const noexcept;
+
+                    size_t max_slab_bytes;
+            };
+
+
+        }
+
+    }
+
+}
+
+
+#endif // MEMORY_PLANNER_H
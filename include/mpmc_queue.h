@@ -0,0 +1,135 @@
+#ifndef MPMC_QUEUE_H
+#define MPMC_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+
+#include <assert.h>
+
+
+namespace NeuralNetwork {
+
+    namespace Serving {
+
+
+        /*
+
+        DESCRIPTION:
+
+            Bounded lock-free multi-producer multi-consumer FIFO queue
+            (Vyukov's array queue).
+
+            Every cell carries a sequence number that tells producers
+            and consumers whose turn it is; a thread claims a position
+            with one compare-exchange on the head or tail counter, then
+            hands the cell over by publishing its sequence with release
+            ordering. No thread ever waits on another's critical section,
+            a full or empty queue is reported to the caller instead.
+
+            The head and tail counters live on their own cache lines so
+            producers and consumers do not false-share.
+
+        USAGE:
+
+            NeuralNetwork::Serving::MPMCQueue<Request> queue(1024);
+
+            if (!queue.try_push(std::move(request))) { ... full ... }
+
+            Request next;
+            if (queue.try_pop(next)) { ... }
+
+        */
+        template <typename T>
+        class MPMCQueue {
+
+            public:
+                // Capacity must be a power of two.
+                explicit MPMCQueue(size_t _capacity) noexcept :
+                    mask(_capacity - 1), cells(std::make_unique<Cell[]>(_capacity)) {
+
+                    assert(_capacity >= 2 && (_capacity & (_capacity - 1)) == 0 && "Capacity must be a power of two.");
+
+                    for (size_t i = 0; i < _capacity; i++) cells[i].sequence.store(i, std::memory_order_relaxed);
+                }
+
+                MPMCQueue(const MPMCQueue&) = delete;
+                MPMCQueue& operator=(const MPMCQueue&) = delete;
+
+                bool try_push(T&& _value) noexcept {
+
+                    size_t position = tail.load(std::memory_order_relaxed);
+
+                    while (true) {
+
+                        Cell& cell = cells[position & mask];
+                        size_t sequence = cell.sequence.load(std::memory_order_acquire);
+                        auto turn = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+
+                        if (turn == 0) {
+                            if (tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                                cell.value = std::move(_value);
+                                cell.sequence.store(position + 1, std::memory_order_release);
+                                return true;
+                            }
+                        }
+                        else if (turn < 0) {
+                            return false;
+                        }
+                        else {
+                            position = tail.load(std::memory_order_relaxed);
+                        }
+                    }
+                }
+
+                bool try_pop(T& _value) noexcept {
+
+                    size_t position = head.load(std::memory_order_relaxed);
+
+                    while (true) {
+
+                        Cell& cell = cells[position & mask];
+                        size_t sequence = cell.sequence.load(std::memory_order_acquire);
+                        auto turn = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position + 1);
+
+                        if (turn == 0) {
+                            if (head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                                _value = std::move(cell.value);
+                                cell.sequence.store(position + mask + 1, std::memory_order_release);
+                                return true;
+                            }
+                        }
+                        else if (turn < 0) {
+                            return false;
+                        }
+                        else {
+                            position = head.load(std::memory_order_relaxed);
+                        }
+                    }
+                }
+
+                size_t capacity() const noexcept { return mask + 1; }
+
+            private:
+                constexpr static size_t CACHE_LINE = 64;
+
+                struct Cell {
+                    std::atomic<size_t> sequence;
+                    T value;
+                };
+
+                const size_t mask;
+                std::unique_ptr<Cell[]> cells;
+
+                alignas(CACHE_LINE) std::atomic<size_t> tail = 0;
+                alignas(CACHE_LINE) std::atomic<size_t> head = 0;
+        };
+
+
+    }
+
+}
+
+
+#endif // MPMC_QUEUE_H
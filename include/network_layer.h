@@ -3,12 +3,14 @@
 
 #include "tensor.h"
 #include "tensor_factory.h"
+#include "tensor_forward_wrapper.h"
 #include "m_algorithms_utilities.h"
 
 #include <cstdint>
 #include <memory>
 #include <functional>
 #include <map>
+#include <string>
 #include <vector>
 
 #include <iostream>
@@ -16,9 +18,24 @@
 
     
 
+namespace Matrix {
+    class SparseRepresentation;
+}
+
 
 namespace NeuralNetwork {
 
+    namespace Computation {
+        namespace Graph {
+            class ParameterBuffer;
+        }
+    }
+
+    namespace Serialization {
+        struct CheckpointEntry;
+    }
+
+
     constexpr u_int8_t FLAT = 1;
 
 
@@ -41,11 +58,38 @@ namespace NeuralNetwork {
 
 
 
+    /*
+        What a module computes, listed in forward order, so a model can
+        be compiled into kernels that run outside the graph.
+    */
+    struct KernelSpec {
+        enum class Op : u_int8_t { MATRIX_MULTIPLY, ADD, RELU, SOFTMAX, UNSUPPORTED };
+
+        Op op;
+        std::shared_ptr<Tensor> parameter = nullptr;
+    };
+
+
     class StepInterface {
 
         public:
             virtual ~StepInterface() = default;
             virtual std::shared_ptr<Tensor> forward(std::shared_ptr<Tensor> input) = 0;
+
+            /*
+                Inference forward: every operation runs the InferenceTag
+                strategy, the grad mode of the context is never read. 
+                Nothing is registered on the graph.
+            */
+            virtual std::shared_ptr<Tensor> forward(std::shared_ptr<Tensor> input, InferenceTag _tag) noexcept = 0;
+
+            /*
+                Forward of a sparse minibatch. Steps that cannot use the
+                sparsity run forward on the densified input.
+            */
+            virtual std::shared_ptr<Tensor> forward_sparse(std::shared_ptr<const Matrix::SparseRepresentation> input) noexcept;
+            virtual void collect_parameters(std::vector<std::shared_ptr<Tensor>>&) noexcept {}
+            virtual void collect_kernels(std::vector<KernelSpec>& _kernels) noexcept { _kernels.push_back({KernelSpec::Op::UNSUPPORTED}); }
             };
 
 
@@ -70,6 +114,13 @@ namespace NeuralNetwork {
                 return out;
             }
 
+            std::shared_ptr<Tensor> forward(std::shared_ptr<Tensor> input, InferenceTag _tag) noexcept override{ 
+ 
+                assert(input != nullptr && "Tensor has no data (pointing to null).");
+
+                return Impl().doForward(input, _tag); 
+            }
+
             ~ComputationalStep() {}
         private:
             Implementation& Impl() { return *static_cast<Implementation*>(this); }
@@ -93,6 +144,8 @@ namespace NeuralNetwork {
             BinaryOperationStep(Matrix::Rows _l, Matrix::Columns _w) noexcept : 
                 matrix(NeuralNetwork::Computation::Graph::TensorConstructor::create(_l, _w, Computation::Graph::IsTrackable(true), Computation::Graph::IsLeaf(true))) {}
             std::shared_ptr<Tensor> doForward(std::shared_ptr<Tensor> input) noexcept { return Impl()._doForward(input);}
+            std::shared_ptr<Tensor> doForward(std::shared_ptr<Tensor> input, InferenceTag _tag) noexcept { return Impl()._doForward(input, _tag);}
+            void collect_parameters(std::vector<std::shared_ptr<Tensor>>& _params) noexcept override { _params.push_back(matrix); }
         protected:
             std::shared_ptr<Tensor> matrix;
         private:
@@ -108,14 +161,62 @@ namespace NeuralNetwork {
             MatrixMultiplyStep(Matrix::Rows _l, Matrix::Columns _w) noexcept : 
                 BinaryOperationStep<MatrixMultiplyStep>(_l, _w) {}
             std::shared_ptr<Tensor> _doForward(std::shared_ptr<Tensor> input) noexcept;
+            std::shared_ptr<Tensor> _doForward(std::shared_ptr<Tensor> input, InferenceTag _tag) noexcept;
+            std::shared_ptr<Tensor> forward_sparse(std::shared_ptr<const Matrix::SparseRepresentation> input) noexcept override;
+            void collect_kernels(std::vector<KernelSpec>& _kernels) noexcept override { _kernels.push_back({KernelSpec::Op::MATRIX_MULTIPLY, matrix}); }
     };
-    
-    
+
+
+    /*
+
+        DESCRIPTION:
+
+            A trained m x n weight W replaced by a rank r factorization,
+            W ≈ left (m x r) · right (r x n), from a randomized SVD with
+            the singular values folded into left. The forward is two
+            skinny GEMMs, (x · left) · right, so for r ≪ min(m, n) the
+            FLOPs and the weight memory drop to r(m + n) / (m n) of the
+            dense step. Both factors are parameters and keep training.
+
+            The relative Frobenius error of the factorization is kept,
+            so the rank can be chosen against how much of W is lost.
+
+        USAGE:
+
+            auto low_rank = std::make_unique<NeuralNetwork::LowRankLinearStep>(W, 32);
+            std::cout << low_rank->reconstruction_error() << std::endl;
+
+            model.add(std::make_unique<NeuralNetwork::Layer>(std::move(low_rank),
+                std::make_unique<NeuralNetwork::AddStep>(Matrix::Columns(W.num_cols()))));
+
+    */
+    class LowRankLinearStep: public ComputationalStep<LowRankLinearStep> {
+
+        public:
+            LowRankLinearStep(const Matrix::Representation& _weights, u_int64_t _rank) noexcept;
+
+            std::shared_ptr<Tensor> doForward(std::shared_ptr<Tensor> input) noexcept;
+            std::shared_ptr<Tensor> doForward(std::shared_ptr<Tensor> input, InferenceTag _tag) noexcept;
+            void collect_parameters(std::vector<std::shared_ptr<Tensor>>& _params) noexcept override;
+            void collect_kernels(std::vector<KernelSpec>& _kernels) noexcept override;
+
+            u_int64_t rank() noexcept { return left->release_matrix().num_cols(); }
+            u_int64_t weight_count() noexcept { return left->release_matrix().size() + right->release_matrix().size(); }
+            float reconstruction_error() const noexcept { return error; }
+
+        private:
+            std::shared_ptr<Tensor> left;
+            std::shared_ptr<Tensor> right;
+            float error;
+    };
+
+
     /*
 
         DESCRIPTION:
 
             Wrapper for bias term that is added during a perceptron.
+            The 1×N bias is broadcast over every row of a B×N minibatch.
     */
 
     class AddStep: public BinaryOperationStep<AddStep> {
@@ -124,6 +225,8 @@ namespace NeuralNetwork {
             AddStep(Matrix::Columns _w) noexcept : 
                 BinaryOperationStep<AddStep>(Matrix::Rows(FLAT), _w) {}
             std::shared_ptr<Tensor> _doForward(std::shared_ptr<Tensor> input) noexcept;
+            std::shared_ptr<Tensor> _doForward(std::shared_ptr<Tensor> input, InferenceTag _tag) noexcept;
+            void collect_kernels(std::vector<KernelSpec>& _kernels) noexcept override { _kernels.push_back({KernelSpec::Op::ADD, matrix}); }
     };
 
     /*
@@ -155,7 +258,11 @@ namespace NeuralNetwork {
                 weights(std::move(_w)), bias(std::move(_b)) {}
                 
             std::shared_ptr<Tensor> doForward(std::shared_ptr<Tensor> input) noexcept;
+            std::shared_ptr<Tensor> doForward(std::shared_ptr<Tensor> input, InferenceTag _tag) noexcept;
+            std::shared_ptr<Tensor> forward_sparse(std::shared_ptr<const Matrix::SparseRepresentation> input) noexcept override;
             void _add(std::unique_ptr<StepInterface> layer) noexcept;
+            void collect_parameters(std::vector<std::shared_ptr<Tensor>>& _params) noexcept override;
+            void collect_kernels(std::vector<KernelSpec>& _kernels) noexcept override;
             
         private:
             std::unique_ptr<StepInterface> weights;
@@ -197,9 +304,44 @@ namespace NeuralNetwork {
     class Sequential: public ComputationalStep<Sequential>, public ComposedStep<Sequential> {
         public:
             std::shared_ptr<Tensor> doForward(std::shared_ptr<Tensor> input) noexcept;
+            std::shared_ptr<Tensor> doForward(std::shared_ptr<Tensor> input, InferenceTag _tag) noexcept;
+            std::shared_ptr<Tensor> forward_sparse(std::shared_ptr<const Matrix::SparseRepresentation> input) noexcept override;
             void _add(std::unique_ptr<StepInterface> layer) noexcept;
+            void collect_parameters(std::vector<std::shared_ptr<Tensor>>& _params) noexcept override;
+            void collect_kernels(std::vector<KernelSpec>& _kernels) noexcept override;
+
+            /*
+                Keeps only the activations at every _segment_size modules
+                and recomputes each segment in the reverse pass. Inner
+                parameters are then unreachable from the loss, iterate
+                parameters() instead.
+            */
+            void checkpoint(size_t _segment_size) noexcept { segment_size = _segment_size; }
+            std::vector<std::shared_ptr<Tensor>> parameters() noexcept;
+
+            // Moves every parameter into one ParameterBuffer, call once the model is built.
+            std::shared_ptr<ParameterBuffer> flatten() noexcept;
+            std::shared_ptr<ParameterBuffer> flatten(const ParameterBuffer& _shared_weights) noexcept;
+            std::shared_ptr<ParameterBuffer> flat_parameters() const noexcept { return flat; }
+
+            // Backward passes sum into the gradients until zero_grad(), for micro-batches.
+            void accumulate_gradients(bool _accumulate) noexcept;
+            void zero_grad() noexcept;
+
+            // Checkpoint files, see MappedCheckpoint. load() replaces the flat buffer.
+            bool save(const std::string& _path) noexcept;
+            bool load(const std::string& _path) noexcept;
+
+            // The checkpoint table of this model, one entry per parameter.
+            std::vector<Serialization::CheckpointEntry> describe() noexcept;
+            size_t modules() const noexcept { return _modules.size(); }
         private:
+            std::shared_ptr<Tensor> _forward_from(std::shared_ptr<Tensor> input, size_t first) noexcept;
+            std::shared_ptr<Tensor> _forward_segment(std::shared_ptr<Tensor> input, size_t first, size_t last) noexcept;
+
             std::vector<std::unique_ptr<StepInterface>> _modules;
+            size_t segment_size = 0;
+            std::shared_ptr<ParameterBuffer> flat;
 
     };
 
@@ -0,0 +1,277 @@
+#ifndef OPTIMIZER_H
+#define OPTIMIZER_H
+
+#include "tensor.h"
+#include "matrix.h"
+#include "parameter_buffer.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <assert.h>
+
+
+namespace NeuralNetwork {
+
+    namespace Optimization {
+
+        using NeuralNetwork::Computation::Graph::Tensor;
+        using NeuralNetwork::Computation::Graph::ParameterBuffer;
+
+
+        /*
+            Fused single-pass update kernels over raw spans. Each reads the
+            gradient once and read-modify-writes the weights and the
+            optimizer state in the same sweep. Split across workers with
+            cilk_for, the inner loop over a block is branch free so it
+            vectorizes.
+        */
+        namespace Kernels {
+
+            struct SGDParameters {
+                float learning_rate;
+                float momentum;
+                float weight_decay;
+                bool nesterov;
+            };
+
+            struct AdamParameters {
+                float learning_rate;
+                float beta1;
+                float beta2;
+                float epsilon;
+                float weight_decay;
+                bool decoupled_weight_decay;
+            };
+
+            void sgd(float* __restrict w, const float* __restrict g, size_t n,
+                const SGDParameters& p) noexcept;
+
+            void sgd_momentum(float* __restrict w, const float* __restrict g, float* __restrict velocity,
+                size_t n, const SGDParameters& p) noexcept;
+
+            void adam(float* __restrict w, const float* __restrict g, float* __restrict m, float* __restrict v,
+                size_t n, const AdamParameters& p, u_int64_t step) noexcept;
+
+        }
+
+
+        /*
+            Optimizer state kept next to the parameter it updates,
+            allocated on the first step the parameter has a gradient.
+            steps counts the updates the parameter itself has had, which
+            bias correction runs on. A flattened model keeps a single 
+            state spanning its buffer.
+        */
+        struct ParameterState {
+            std::shared_ptr<Tensor> parameter;
+            Matrix::Representation first_moment;
+            Matrix::Representation second_moment;
+            u_int64_t steps = 0;
+        };
+
+
+        /*
+
+        DESCRIPTION:
+
+            Base for in-place optimizers. Holds the parameters and
+            their state, and dispatches each parameter with a gradient
+            to the Implementation's fused kernel. Parameters no
+            gradient flowed into are left untouched.
+
+            Constructed from a ParameterBuffer, a step is one kernel
+            launch over the whole flat buffer instead.
+
+        */
+        template <class Implementation>
+        class Optimizer {
+
+            public:
+                explicit Optimizer(std::vector<std::shared_ptr<Tensor>> _parameters) noexcept {
+                    states.reserve(_parameters.size());
+                    for (auto& _p: _parameters) states.push_back(ParameterState{_p, {}, {}, 0});
+                }
+
+                explicit Optimizer(std::shared_ptr<ParameterBuffer> _flat) noexcept : flat(std::move(_flat)) {
+                    states.push_back(ParameterState{nullptr, {}, {}, 0});
+                }
+
+                void step() noexcept {
+
+                    ++steps;
+
+                    if (flat) {
+                        ++states.front().steps;
+                        Impl()._update(flat->weights(), flat->gradients(), flat->size(), states.front());
+                        return;
+                    }
+
+                    for (auto& state: states) {
+
+                        if (!state.parameter->has_grad()) continue;
+
+                        auto& weights  = state.parameter->release_matrix();
+                        auto& gradient = state.parameter->get_grad();
+
+                        assert(weights.size() == gradient.size() && "Gradient does not match parameter.");
+
+                        ++state.steps;
+                        Impl()._update(weights.scanStart(), gradient.constScanStart(), weights.size(), state);
+                    }
+                }
+
+                void zero_grad() noexcept {
+
+                    if (flat) {
+                        flat->zero_grad();
+                        return;
+                    }
+
+                    for (auto& state: states) state.parameter->zero_grad();
+                }
+
+                u_int64_t step_count() const noexcept { return steps; }
+
+            protected:
+                static float* _allocate(Matrix::Representation& buffer, size_t n) noexcept {
+                    if (buffer.size() != n) {
+                        buffer = Matrix::Representation{Matrix::Rows(1), Matrix::Columns(n)};
+                    }
+                    return buffer.scanStart();
+                }
+
+                std::vector<ParameterState> states;
+                std::shared_ptr<ParameterBuffer> flat;
+                u_int64_t steps = 0;
+
+            private:
+                Implementation& Impl() noexcept { return *static_cast<Implementation*>(this); }
+        };
+
+
+        /*
+
+        DESCRIPTION:
+
+            Stochastic gradient descent with optional heavy-ball or
+            Nesterov momentum and L2 weight decay.
+
+                g' = g + λw
+                v  = μv + g'
+                w -= η(g' + μv)     Nesterov
+                w -= ηv             otherwise
+
+        USAGE:
+
+            NeuralNetwork::Optimization::SGD sgd(model.parameters(), 0.01f, 0.9f);
+
+            for (int i = 0; i < TRAINING_EPOCS; i++) {
+                auto loss = CE(ground_truth, model.forward(ma));
+                loss->backwards();
+                sgd.step();
+            }
+
+        */
+        class SGD: public Optimizer<SGD> {
+
+            public:
+                explicit SGD(std::vector<std::shared_ptr<Tensor>> _parameters,
+                    float _learning_rate,
+                    float _momentum     = 0,
+                    bool _nesterov      = false,
+                    float _weight_decay = 0) noexcept :
+                        Optimizer<SGD>(std::move(_parameters)),
+                        parameters{_learning_rate, _momentum, _weight_decay, _nesterov} {}
+
+                explicit SGD(std::shared_ptr<ParameterBuffer> _flat,
+                    float _learning_rate,
+                    float _momentum     = 0,
+                    bool _nesterov      = false,
+                    float _weight_decay = 0) noexcept :
+                        Optimizer<SGD>(std::move(_flat)),
+                        parameters{_learning_rate, _momentum, _weight_decay, _nesterov} {}
+
+                void _update(float* w, const float* g, size_t n, ParameterState& state) noexcept;
+
+            private:
+                Kernels::SGDParameters parameters;
+        };
+
+
+        /*
+
+        DESCRIPTION:
+
+            Adam with bias correction. Weight decay is either folded
+            into the gradient (L2, as in the original paper) or
+            applied to the weights directly (AdamW).
+
+                m = β1m + (1 - β1)g
+                v = β2v + (1 - β2)g²
+                w -= η(m / (1 - β1ᵗ)) / (sqrt(v / (1 - β2ᵗ)) + ε)
+
+        USAGE:
+
+            NeuralNetwork::Optimization::Adam adam(model.parameters(), 0.001f);
+            NeuralNetwork::Optimization::AdamW adamw(model.parameters(), 0.001f, 0.01f);
+
+        */
+        class Adam: public Optimizer<Adam> {
+
+            public:
+                explicit Adam(std::vector<std::shared_ptr<Tensor>> _parameters,
+                    float _learning_rate = 0.001f,
+                    float _beta1         = 0.9f,
+                    float _beta2         = 0.999f,
+                    float _epsilon       = 1e-8f,
+                    float _weight_decay  = 0,
+                    bool _decoupled      = false) noexcept :
+                        Optimizer<Adam>(std::move(_parameters)),
+                        parameters{_learning_rate, _beta1, _beta2, _epsilon, _weight_decay, _decoupled} {}
+
+                explicit Adam(std::shared_ptr<ParameterBuffer> _flat,
+                    float _learning_rate = 0.001f,
+                    float _beta1         = 0.9f,
+                    float _beta2         = 0.999f,
+                    float _epsilon       = 1e-8f,
+                    float _weight_decay  = 0,
+                    bool _decoupled      = false) noexcept :
+                        Optimizer<Adam>(std::move(_flat)),
+                        parameters{_learning_rate, _beta1, _beta2, _epsilon, _weight_decay, _decoupled} {}
+
+                void _update(float* w, const float* g, size_t n, ParameterState& state) noexcept;
+
+            private:
+                Kernels::AdamParameters parameters;
+        };
+
+
+        class AdamW: public Adam {
+
+            public:
+                explicit AdamW(std::vector<std::shared_ptr<Tensor>> _parameters,
+                    float _learning_rate = 0.001f,
+                    float _weight_decay  = 0.01f,
+                    float _beta1         = 0.9f,
+                    float _beta2         = 0.999f,
+                    float _epsilon       = 1e-8f) noexcept :
+                        Adam(std::move(_parameters), _learning_rate, _beta1, _beta2, _epsilon, _weight_decay, true) {}
+
+                explicit AdamW(std::shared_ptr<ParameterBuffer> _flat,
+                    float _learning_rate = 0.001f,
+                    float _weight_decay  = 0.01f,
+                    float _beta1         = 0.9f,
+                    float _beta2         = 0.999f,
+                    float _epsilon       = 1e-8f) noexcept :
+                        Adam(std::move(_flat), _learning_rate, _beta1, _beta2, _epsilon, _weight_decay, true) {}
+        };
+
+
+    }
+
+}
+
+
+#endif // OPTIMIZER_H
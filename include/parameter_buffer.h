@@ -0,0 +1,121 @@
+#ifndef PARAMETER_BUFFER_H
+#define PARAMETER_BUFFER_H
+
+#include "strong_types.h"
+#include "matrix.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+
+namespace NeuralNetwork {
+
+    namespace Computation {
+
+        namespace Graph {
+
+            class Tensor;
+
+
+            /*
+
+            DESCRIPTION:
+
+                Lays the weights of a set of parameters, and separately
+                their gradients, out in two contiguous 64 byte aligned
+                slabs. Each parameter's matrix and grad are rebound to
+                views into the slabs, so kernels and backward rules keep
+                working on them unchanged while whole-model operations
+                (optimizer steps, zeroing, snapshots) become a single
+                sweep over one span.
+
+                Every parameter starts on an aligned offset. The padding
+                between them is zero in both slabs and stays zero under
+                the optimizers' updates.
+
+                Gradients are allocated up front, so has_grad() is always
+                true for a flattened parameter: a parameter no gradient
+                flowed into reads as zeros.
+
+                Built with shared_weights, the weights become views into
+                that buffer's weight slab instead (the models must match
+                layer for layer) while the gradients stay private, so
+                several replicas train one set of weights in place.
+
+                Built over adopted weights, the parameters become views
+                into that memory as is, which is how a checkpoint is
+                loaded without reading it.
+
+            USAGE:
+
+                auto flat = model.flatten();
+
+                NeuralNetwork::Optimization::Adam adam(flat);
+
+                loss->backwards();
+                adam.step();
+                flat->zero_grad();
+
+            */
+            class ParameterBuffer {
+
+                public:
+                    constexpr static size_t ALIGNMENT = 64;
+
+                    explicit ParameterBuffer(std::vector<std::shared_ptr<Tensor>> _parameters) noexcept;
+                    explicit ParameterBuffer(std::vector<std::shared_ptr<Tensor>> _parameters,
+                        const ParameterBuffer& _shared_weights) noexcept;
+
+                    /*
+                        Adopts weights already laid out the way this buffer
+                        lays them out (a mapped checkpoint); owner keeps
+                        that memory alive.
+                    */
+                    explicit ParameterBuffer(std::vector<std::shared_ptr<Tensor>> _parameters,
+                        std::shared_ptr<void> _weights) noexcept;
+
+                    ParameterBuffer(const ParameterBuffer&) = delete;
+                    ParameterBuffer& operator=(const ParameterBuffer&) = delete;
+
+                    float* weights() noexcept { return static_cast<float*>(weight_slab.get()); }
+                    const float* weights() const noexcept { return static_cast<const float*>(weight_slab.get()); }
+
+                    float* gradients() noexcept { return static_cast<float*>(gradient_slab.get()); }
+                    const float* gradients() const noexcept { return static_cast<const float*>(gradient_slab.get()); }
+
+                    // Floats per slab, padding included.
+                    size_t size() const noexcept { return total; }
+                    size_t bytes() const noexcept { return total * sizeof(float); }
+
+                    size_t offset_of(size_t _parameter) const noexcept { return offsets[_parameter]; }
+                    const std::vector<std::shared_ptr<Tensor>>& parameters() const noexcept { return params; }
+
+                    void zero_grad() noexcept;
+
+                    // After writing gradients() directly, see Tensor::sparse_grad().
+                    void forget_grad_rows() noexcept;
+
+                    void snapshot(float* _destination) const noexcept;
+                    void restore(const float* _source) noexcept;
+
+                private:
+                    void _layout() noexcept;
+                    void _bind(bool _copy_weights) noexcept;
+
+                    std::vector<std::shared_ptr<Tensor>> params;
+                    std::vector<size_t> offsets;
+                    size_t total = 0;
+                    std::shared_ptr<void> weight_slab;
+                    std::shared_ptr<void> gradient_slab;
+            };
+
+
+        }
+
+    }
+
+}
+
+
+#endif // PARAMETER_BUFFER_H
@@ -0,0 +1,54 @@
+#ifndef PRUNING_H
+#define PRUNING_H
+
+#include "network_layer.h"
+#include "sparse.h"
+#include "matrix.h"
+
+#include <memory>
+#include <vector>
+
+
+namespace NeuralNetwork {
+
+    namespace Inference {
+
+        using PrunedWeights = std::vector<std::shared_ptr<const Matrix::BlockSparseRepresentation>>;
+
+
+        /*
+
+        DESCRIPTION:
+
+            Block magnitude pruning of trained weights.
+
+            The weight matrix is cut into the 4 x 8 blocks of a
+            BlockSparseRepresentation and every block scored by its sum
+            of squares. The lowest scoring `sparsity` fraction of the
+            blocks is set to zero in place, so the dense model computes
+            exactly what the pruned one does and can be fine-tuned from
+            there. Returns the pruned weights in block-sparse form.
+
+            The Sequential overload prunes the weights of every
+            MatrixMultiplyStep, biases are left alone, and returns them
+            in forward order: what the InferenceEngine takes to run the
+            affine layers on the block-sparse kernel.
+
+        USAGE:
+
+            auto pruned = NeuralNetwork::Inference::prune_blocks(model, 0.9f);
+
+            NeuralNetwork::Inference::InferenceEngine engine(model, 2000, pruned);
+
+        */
+        std::shared_ptr<const Matrix::BlockSparseRepresentation> prune_blocks(Matrix::Representation& _weights, float _sparsity) noexcept;
+
+        PrunedWeights prune_blocks(Sequential& _model, float _sparsity) noexcept;
+
+
+    }
+
+}
+
+
+#endif // PRUNING_H
@@ -0,0 +1,146 @@
+#ifndef QUANTIZATION_H
+#define QUANTIZATION_H
+
+#include "network_layer.h"
+#include "matrix.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+
+namespace NeuralNetwork {
+
+    namespace Inference {
+
+
+        /*
+            Activations are quantized to [0, 127] rather than the full
+            unsigned byte, so a pair of u8 x s8 products summed by
+            vpmaddubsw (at most 2 x 127 x 127) can never saturate its
+            int16 lanes. Inputs that can go negative are stored with a
+            zero point of 64.
+        */
+        constexpr int32_t ACTIVATION_MAX = 127;
+        constexpr int32_t SIGNED_ZERO_POINT = 64;
+        constexpr int32_t WEIGHT_MAX = 127;
+
+
+        /*
+
+        DESCRIPTION:
+
+            A matrix multiply of a MatrixMultiplyStep (in x out, row
+            major) quantized to int8 with one scale per output channel:
+            column j is stored as the contiguous row j of an out x in
+            int8 matrix, q = round(w / scale[j]) with
+            scale[j] = max|W[:, j]| / 127.
+
+            Rows are padded with zeros to a multiple of 32 so the dot
+            product kernel needs no remainder loop. row_sums caches the
+            sum of every quantized row, which folds the activations'
+            zero point out of the integer dot product.
+
+        */
+        struct QuantizedMatrix {
+
+            explicit QuantizedMatrix(const Matrix::Representation& _weights) noexcept;
+
+            u_int64_t in;
+            u_int64_t out;
+            u_int64_t stride;
+            std::unique_ptr<int8_t[], decltype(&std::free)> weights;
+            std::vector<float> scales;
+            std::vector<int32_t> row_sums;
+        };
+
+
+        // int32 dot product of a u8 activation row and an s8 weight row, n a multiple of 32.
+        int32_t dot_u8s8(const uint8_t* __restrict x, const int8_t* __restrict w, u_int64_t n) noexcept;
+
+
+        /*
+
+        DESCRIPTION:
+
+            Post-training int8 inference.
+
+            Compiles a Sequential the way InferenceEngine does, then
+            quantizes the weights of every matrix multiply per output
+            channel and calibrates one scale per layer input on sample
+            data: the largest magnitude the input takes over the samples
+            (run through the fp32 model) maps to 127.
+
+            Every affine layer runs as an int8 x int8 -> int32 dot
+            product per output (vpmaddubsw / vpmaddwd on AVX2, a scalar
+            loop otherwise), then dequantizes, adds the bias, applies the
+            fused ReLU and, when another affine layer follows, requantizes
+            straight into that layer's u8 input, all in one pass over the
+            accumulators. Activations ping-pong between two u8 and two
+            fp32 buffers; SoftMax and unfused ReLUs run in fp32.
+
+            The weights take a quarter of the fp32 bytes, which is where
+            the speedup on bandwidth-bound layers comes from.
+
+        USAGE:
+
+            NeuralNetwork::Inference::QuantizedInferenceEngine engine(model, 2000, calibration_samples);
+
+            const float* prediction = engine.run(sample);
+
+        */
+        class QuantizedInferenceEngine {
+
+            public:
+                explicit QuantizedInferenceEngine(Sequential& _model, u_int64_t _input_width,
+                    const Matrix::Representation& _calibration) noexcept;
+
+                QuantizedInferenceEngine(const QuantizedInferenceEngine&) = delete;
+                QuantizedInferenceEngine& operator=(const QuantizedInferenceEngine&) = delete;
+
+                bool is_compiled() const noexcept { return compiled; }
+
+                // Runs input_width floats through the model, valid until the next call.
+                const float* run(const float* _input) noexcept;
+
+                u_int64_t input_width()  const noexcept { return in_width; }
+                u_int64_t output_width() const noexcept { return out_width; }
+
+                // Bytes of quantized weights, padding included.
+                u_int64_t weight_bytes() const noexcept;
+
+            private:
+                struct Kernel {
+                    enum class Op : u_int8_t { AFFINE, RELU, SOFTMAX };
+
+                    Op op;
+                    u_int64_t width;
+                    std::unique_ptr<QuantizedMatrix> matrix = nullptr;
+                    const float* bias = nullptr;
+                    bool relu = false;
+                    float input_scale = 1;
+                    int32_t input_zero_point = 0;
+                };
+
+                void _calibrate(const Matrix::Representation& _calibration) noexcept;
+                void _quantize(const float* _x, const Kernel& _kernel, uint8_t* _q) const noexcept;
+                void _affine(const uint8_t* _x, const Kernel& _kernel, const Kernel* _next,
+                    float* _y, uint8_t* _q) const noexcept;
+
+                std::vector<Kernel> plan;
+                std::vector<std::shared_ptr<Tensor>> parameters;
+                std::vector<float> reals[2];
+                std::vector<uint8_t> quants[2];
+                u_int64_t in_width;
+                u_int64_t out_width;
+                bool compiled = true;
+        };
+
+
+    }
+
+}
+
+
+#endif // QUANTIZATION_H
@@ -0,0 +1,223 @@
+#ifndef SPARSE_H
+#define SPARSE_H
+
+#include <cstdint>
+#include <vector>
+
+#include "matrix.h"
+
+
+namespace Matrix {
+
+
+    /*
+
+    DESCRIPTION:
+
+        A row-major matrix in compressed sparse row (CSR) form, for
+        inputs that are almost all zeros: bag-of-words counts, one-hot
+        and multi-hot features.
+
+        Row r holds the nonzeros values()[p], in the columns
+        column_indices()[p], for p in [row_offsets()[r], row_offsets()[r + 1]).
+        Columns are in ascending order within a row. Storage is
+        proportional to the nonzeros, not to rows × columns.
+
+        Built by compressing a dense Representation, or directly from
+        the three CSR arrays when the features arrive as indices.
+
+        Sequential::forward_sparse() takes one as a minibatch. A first
+        layer whose weights are a MatrixMultiplyStep multiplies it
+        without densifying, its weight gradient costs in proportion to
+        the nonzeros rather than the width.
+
+    USAGE:
+
+        Matrix::SparseRepresentation x(dense_inputs);
+
+        Matrix::SparseRepresentation y(Matrix::Rows(2), Matrix::Columns(50000),
+            {0, 2, 3}, {7, 4096, 12}, {1.0f, 3.0f, 1.0f});
+
+        Matrix::Representation z = Matrix::Operations::Sparse::multiply(x, W);
+
+        auto loss = CE(ground_truth, model.forward_sparse(
+            std::make_shared<const Matrix::SparseRepresentation>(bag_of_words)));
+
+    */
+    class SparseRepresentation {
+
+        public:
+            using index_type = u_int32_t;
+
+            SparseRepresentation() noexcept : rows(0), columns(0), offsets(1, 0) {}
+
+            // An all zero matrix.
+            explicit SparseRepresentation(Rows _l, Columns _w) noexcept :
+                rows(_l.get()), columns(_w.get()), offsets(_l.get() + 1, 0) {}
+
+            explicit SparseRepresentation(const Matrix::Representation& _dense) noexcept;
+
+            explicit SparseRepresentation(Rows _l, Columns _w,
+                std::vector<u_int64_t> _row_offsets,
+                std::vector<index_type> _column_indices,
+                std::vector<float> _values) noexcept;
+
+            Matrix::Representation to_dense() const noexcept;
+
+            // The (columns × rows) transpose, equivalently this matrix in CSC form.
+            SparseRepresentation transpose() const noexcept;
+
+            const std::vector<u_int64_t>&  row_offsets()    const noexcept { return offsets; }
+            const std::vector<index_type>& column_indices() const noexcept { return indices; }
+            const std::vector<float>&      values()         const noexcept { return data; }
+
+            u_int64_t row_nonzeros(u_int64_t r) const noexcept { return offsets[r + 1] - offsets[r]; }
+
+            u_int64_t num_rows() const noexcept { return rows; }
+            u_int64_t num_cols() const noexcept { return columns; }
+            u_int64_t nonzeros() const noexcept { return data.size(); }
+            u_int64_t size()     const noexcept { return rows * columns; }
+            double    density()  const noexcept { return size() ? double(nonzeros()) / double(size()) : 0; }
+
+            u_int64_t bytes() const noexcept {
+                return offsets.size() * sizeof(u_int64_t) + indices.size() * sizeof(index_type) + data.size() * sizeof(float);
+            }
+
+        private:
+            u_int64_t rows;
+            u_int64_t columns;
+            std::vector<u_int64_t> offsets;
+            std::vector<index_type> indices;
+            std::vector<float> data;
+    };
+
+
+    /*
+
+    DESCRIPTION:
+
+        A weight matrix in block compressed sparse form, for weights
+        pruned a block at a time. Blocks are BLOCK_ROWS x BLOCK_COLUMNS
+        (4 x 8): eight fp32 columns are one AVX2 register, so a block
+        is four broadcast multiply-adds into one accumulator, and a
+        whole block is two cache lines.
+
+        Blocks are grouped by block column, the eight output columns
+        they produce, and sorted by block row within a group. Each
+        block is stored row major; blocks on the right and bottom edge
+        are padded with zeros. Only blocks holding a nonzero are kept.
+
+    USAGE:
+
+        Matrix::BlockSparseRepresentation W_sparse(pruned_weights);
+
+        Matrix::Representation y = Matrix::Operations::Sparse::multiply(x, W_sparse);
+
+    */
+    class BlockSparseRepresentation {
+
+        public:
+            using index_type = u_int32_t;
+
+            static constexpr u_int64_t BLOCK_ROWS    = 4;
+            static constexpr u_int64_t BLOCK_COLUMNS = 8;
+            static constexpr u_int64_t BLOCK_SIZE    = BLOCK_ROWS * BLOCK_COLUMNS;
+
+            BlockSparseRepresentation() noexcept : rows(0), columns(0), offsets(1, 0) {}
+
+            explicit BlockSparseRepresentation(const Matrix::Representation& _dense) noexcept;
+
+            Matrix::Representation to_dense() const noexcept;
+
+            // Blocks of block column c are [column_offsets()[c], column_offsets()[c + 1]).
+            const std::vector<u_int64_t>&  column_offsets()    const noexcept { return offsets; }
+            const std::vector<index_type>& block_row_indices() const noexcept { return indices; }
+            const float* block(u_int64_t p) const noexcept { return data.data() + p * BLOCK_SIZE; }
+
+            u_int64_t num_rows()      const noexcept { return rows; }
+            u_int64_t num_cols()      const noexcept { return columns; }
+            u_int64_t block_rows()    const noexcept { return (rows + BLOCK_ROWS - 1) / BLOCK_ROWS; }
+            u_int64_t block_columns() const noexcept { return (columns + BLOCK_COLUMNS - 1) / BLOCK_COLUMNS; }
+            u_int64_t blocks()        const noexcept { return indices.size(); }
+
+            // Fraction of blocks kept.
+            double density() const noexcept {
+                const u_int64_t total = block_rows() * block_columns();
+                return total ? double(blocks()) / double(total) : 0;
+            }
+
+            u_int64_t bytes() const noexcept {
+                return offsets.size() * sizeof(u_int64_t) + indices.size() * sizeof(index_type) + data.size() * sizeof(float);
+            }
+
+        private:
+            u_int64_t rows;
+            u_int64_t columns;
+            std::vector<u_int64_t> offsets;
+            std::vector<index_type> indices;
+            std::vector<float> data;
+    };
+
+
+    namespace Operations {
+
+        /*
+
+        DESCRIPTION:
+
+            Kernels with a CSR left operand and a dense right one, the
+            forward and weight gradient of a layer fed sparse inputs,
+            and the inference product with block-sparse weights.
+            Work is proportional to nonzeros × r.num_cols(), independent
+            of the sparse operand's width.
+
+            multiply computes x · W, parallel over the rows of x. Each
+            nonzero x[i, k] adds x[i, k] · W[k, :] to row i of the result,
+            so rows of W no sample touches are never read.
+
+            accumulate_transpose_product adds xᵀ · g to dW. Only the rows
+            of dW matching a column x has a nonzero in are written; they
+            are parallel over those columns, each summed from the samples
+            that touch it, so no two tasks write the same row. The
+            nonzeros are grouped by column with a sort, O(nnz log nnz),
+            never a pass over the width. Returns
+            the number of rows written, or fills touched with them in
+            ascending order.
+
+        USAGE:
+
+            Matrix::Representation z = Matrix::Operations::Sparse::multiply(x, W);
+
+            u_int64_t touched = Matrix::Operations::Sparse::accumulate_transpose_product(x, dz, dW);
+
+        */
+        namespace Sparse {
+
+            Matrix::Representation multiply(const SparseRepresentation& x, const Matrix::Representation& w) noexcept;
+
+            u_int64_t accumulate_transpose_product(const SparseRepresentation& x, const Matrix::Representation& g,
+                Matrix::Representation& dw) noexcept;
+
+            void accumulate_transpose_product(const SparseRepresentation& x, const Matrix::Representation& g,
+                Matrix::Representation& dw, std::vector<u_int64_t>& touched) noexcept;
+
+
+            /*
+                x · W for a dense x and a block-sparse W, parallel over
+                block columns and tiles of rows of x; only the kept
+                blocks are read. The pointer form takes x as n rows of
+                w.num_rows() floats and overwrites y, n rows of
+                w.num_cols(), allocating nothing.
+            */
+            Matrix::Representation multiply(const Matrix::Representation& x, const BlockSparseRepresentation& w) noexcept;
+
+            void multiply(const float* x, u_int64_t n, const BlockSparseRepresentation& w, float* y) noexcept;
+
+        }
+
+    }
+
+}
+
+
+#endif // SPARSE_H
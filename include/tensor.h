@@ -15,6 +15,7 @@
 #include <optional>
 #include <memory>
 #include <stack>
+#include <vector>
 
 namespace NeuralNetwork {
 
@@ -28,16 +29,21 @@ namespace NeuralNetwork {
                 using iterator = LevelOrderIterator<ReadParameterPolicy>; 
 
                 public:
-                    explicit MatrixParameter(TensorID _tid) : id(_tid) {}
+                    explicit MatrixParameter(ComputationalGraphMap& _map, TensorID _tid) : map(_map), id(_tid) {}
 
                     iterator begin() noexcept {
-                            return iterator{id}; 
+                            return iterator{map, id}; 
                         }
 
                     iterator end() noexcept {
-                        return iterator{TensorID(0)}; 
+                        return iterator{map, TensorID(0)}; 
+                    }
+
+                    void zero_grad() noexcept {
+                        for (auto it = begin(); it != end(); ++it) it.zero_grad();
                     }
                 private:
+                    ComputationalGraphMap& map;
                     TensorID id;
                 
 
@@ -100,6 +106,26 @@ namespace NeuralNetwork {
                         IsLeaf _f       = IsLeaf(true),
                         IsRecordable _r = IsRecordable(true)) noexcept;
 
+                    // Takes ownership of the matrix, so a view stays a view.
+                    explicit Tensor(Matrix::Representation&& _m, 
+                        IsTrackable _t, 
+                        IsLeaf _f,
+                        IsRecordable _r) noexcept;
+
+                    // As above, in the given context instead of the bound one.
+                    explicit Tensor(ComputationalGraphMap& _context,
+                        const Matrix::Representation& _m, 
+                        IsTrackable _t, 
+                        IsLeaf _f,
+                        IsRecordable _r) noexcept;
+
+                    /*
+                        Inference tensor: takes ownership of the matrix, 
+                        is never registered on the graph and has no grad.
+                    */
+                    explicit Tensor(Matrix::Representation&& _m) noexcept;
+                    explicit Tensor(ComputationalGraphMap& _context, Matrix::Representation&& _m) noexcept;
+
                     explicit Tensor(const Tensor& other) noexcept;
 
                     Tensor& operator=(const Tensor& other) noexcept;
@@ -115,7 +141,47 @@ namespace NeuralNetwork {
                     void become_parent() noexcept;
 
                     matrix_t& release_matrix() noexcept;
+
+                    /*
+                        Allocated lazily, empty until a backward rule 
+                        first writes to it.
+                    */
                     matrix_t& get_grad() noexcept;
+                    bool has_grad() const noexcept;
+
+                    /*
+                        Backward rules write gradients through here. Sums
+                        into the existing gradient in accumulate mode,
+                        overwrites otherwise. zero_grad drops a lazily
+                        allocated gradient and zero fills a view.
+                    */
+                    void write_grad(const matrix_t& _g) noexcept;
+                    void write_grad(matrix_t&& _g) noexcept;
+                    void zero_grad() noexcept;
+
+                    /*
+                        Storage the first gradient write lands in instead
+                        of a fresh allocation, a MemoryPlan slot. Until that
+                        write the gradient stays empty.
+                    */
+                    void reserve_grad(matrix_t&& _slot) noexcept { grad_slot = std::move(_slot); grad_rows.reset(); }
+
+                    /*
+                        For rules that write only some rows of the gradient
+                        (a sparse input's weights). sparse_grad() returns the
+                        gradient to sum those rows into, zeroed first in
+                        overwrite mode, and touch_grad_rows() records them.
+                        While the gradient is known zero outside the recorded
+                        rows, zero_grad clears just those and keeps the
+                        buffer for the next write. A dense write_grad, or
+                        forget_grad_rows() after writing the memory directly,
+                        drops the record.
+                    */
+                    matrix_t& sparse_grad() noexcept;
+                    void touch_grad_rows(const std::vector<u_int64_t>& _rows) noexcept;
+                    void forget_grad_rows() noexcept { grad_rows.reset(); }
+                    void set_accumulate_grad(bool _accumulate) noexcept { accumulate_grad = _accumulate; }
+                    bool is_accumulating_grad() const noexcept { return accumulate_grad; }
 
                     Matrix::Rows num_rows(void) const noexcept;
                     Matrix::Columns num_cols(void) const noexcept;
@@ -124,27 +190,32 @@ namespace NeuralNetwork {
 
                     FunctionObject get_operation() noexcept;
                     TensorID get_tensor_id() const noexcept { return my_tensor_id; }
+                    ComputationalGraphMap& get_context() const noexcept { return *context; }
                     void detatch_from_computational_graph() noexcept;
 
                     iterator begin() noexcept {
-                        return iterator{my_tensor_id}; 
+                        return iterator{*context, my_tensor_id}; 
                     }
 
                     iterator end() noexcept {
-                        return iterator{TensorID(0)}; 
+                        return iterator{*context, TensorID(0)}; 
                     }
 
                     MatrixParameter parameters() noexcept {
-                        return MatrixParameter{my_tensor_id}; 
+                        return MatrixParameter{*context, my_tensor_id}; 
                     }
 
                 private:
+                    ComputationalGraphMap* context;
                     matrix_t matrix;
                     matrix_t grad;
+                    matrix_t grad_slot;
+                    std::optional<std::vector<u_int64_t>> grad_rows;
                     TensorID my_tensor_id;
                     bool is_leaf;
                     bool requires_grad;
                     bool record_statistics;
+                    bool accumulate_grad = false;
 
             };
 
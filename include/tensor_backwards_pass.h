@@ -16,8 +16,8 @@ namespace NeuralNetwork {
             class ReversePass {
 
                 public:
-                    ReversePass() :
-                        map(ComputationalGraphMap::get()) {}
+                    explicit ReversePass(ComputationalGraphMap& _map) :
+                        map(_map) {}
 
                     void backwards(
                         Tensor& _t, 
@@ -25,9 +25,37 @@ namespace NeuralNetwork {
                         IsLeaf _f       = IsLeaf(true),
                         IsRecordable _r = IsRecordable(true));
 
+                    static std::shared_ptr<Tensor> create(
+                        const Matrix::Representation& _m,
+                        IsTrackable _t  = IsTrackable(true), 
+                        IsLeaf _f       = IsLeaf(true),
+                        IsRecordable _r = IsRecordable(true));
+
+                    // Moves the matrix in instead of copying it, views included.
+                    static std::shared_ptr<Tensor> create(
+                        Matrix::Representation&& _m,
+                        IsTrackable _t  = IsTrackable(true), 
+                        IsLeaf _f       = IsLeaf(true),
+                        IsRecordable _r = IsRecordable(true));
+
+                    static std::shared_ptr<Tensor> create(
+                        Segment _segment,
+                        const Matrix::Representation& _m,
+                        TensorID _op,
+                        IsRecordable _r = IsRecordable(true));
+
+                    // Output of a sparse input times the weight tensor _weights.
+                    static std::shared_ptr<Tensor> create(
+                        std::shared_ptr<const Matrix::SparseRepresentation> _sparse,
+                        Matrix::Representation&& _m,
+                        TensorID _weights,
+                        IsRecordable _r = IsRecordable(true));
+
 
+                // Output of _operator, registered in the operands' context _context.
                 template <Matrix::Operations::MatrixOperatable Operator>
                     static std::shared_ptr<Tensor> create(
+                        ComputationalGraphMap& _context,
                         Operator _operator,
                         const Matrix::Representation& _m,
                         TensorID _op  = TensorID(0), 
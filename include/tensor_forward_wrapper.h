@@ -3,6 +3,7 @@
 
 
 #include "tensor.h"
+#include "grad_mode.h"
 #include "matrix.h"
 #include "m_algorithms.h"
 #include "m_algorithms_register.h"
@@ -22,40 +23,6 @@ namespace NeuralNetwork {
         namespace Graph {
 
 
-            /*
-
-            DESCRIPTION:
-
-                Functor follows 'Strategy' behavioral pattern for defining a family
-                of functions on the permutations of either benchmarking (or not) an
-                operation as well as the operation being binary (or unary).
-
-
-            USAGE:
-
-                TensorOp mm(std::make_unique<
-                Matrix::Operations::Binary::Multiplication::ParallelDNC>());
-
-                auto out = mm(input, this->matrix);
-
-
-            */
-
-            
-            template <Matrix::Operations::MatrixOperatable Operator>
-            class TensorOp {
-
-                public:
-                    TensorOp(const Operator& _op) : op_type(_op) {}
-
-                    std::shared_ptr<Tensor> operator()(
-                        const std::shared_ptr<Tensor> l, 
-                        const std::shared_ptr<Tensor> r = nullptr);
-                private:
-                    Operator op_type; 
-            };
-
-
             /*
 
             DESCRIPTION:
@@ -99,9 +66,13 @@ namespace NeuralNetwork {
                         public:
                             RecordTag() = default;
                     };
+                    class InferenceTag : public StrategyTag<InferenceTag> {
+                        public:
+                            InferenceTag() = default;
+                    };
 
-                    PerformTensorStrategy() : 
-                        map(ComputationalGraphMap::get()) {}
+                    explicit PerformTensorStrategy(ComputationalGraphMap& _map) : 
+                        map(_map) {}
 
                     template <Matrix::Operations::MatrixOperatable Operator>
                     std::shared_ptr<Tensor> compute(
@@ -116,10 +87,64 @@ namespace NeuralNetwork {
                         const std::shared_ptr<Tensor> l,
                         const std::shared_ptr<Tensor> r, 
                         RecordTag _);
+
+                    template <Matrix::Operations::MatrixOperatable Operator>
+                    std::shared_ptr<Tensor> compute(
+                        Operator _op, 
+                        const std::shared_ptr<Tensor> l,
+                        const std::shared_ptr<Tensor> r, 
+                        InferenceTag _);
                 private:
                     ComputationalGraphMap& map;
 
             };
+
+
+            using InferenceTag = PerformTensorStrategy::InferenceTag;
+
+
+            /*
+
+            DESCRIPTION:
+
+                Functor follows 'Strategy' behavioral pattern for defining a family
+                of functions on the permutations of either benchmarking (or not) an
+                operation as well as the operation being binary (or unary).
+
+
+            USAGE:
+
+                TensorOp mm(std::make_unique<
+                Matrix::Operations::Binary::Multiplication::ParallelDNC>());
+
+                auto out = mm(input, this->matrix);
+
+                The InferenceTag overload always runs the inference
+                strategy, whatever the grad mode of the context:
+
+                auto prediction = mm(InferenceTag{}, input, this->matrix);
+
+
+            */
+
+            
+            template <Matrix::Operations::MatrixOperatable Operator>
+            class TensorOp {
+
+                public:
+                    TensorOp(const Operator& _op) : op_type(_op) {}
+
+                    std::shared_ptr<Tensor> operator()(
+                        const std::shared_ptr<Tensor> l, 
+                        const std::shared_ptr<Tensor> r = nullptr);
+
+                    std::shared_ptr<Tensor> operator()(
+                        PerformTensorStrategy::InferenceTag _tag,
+                        const std::shared_ptr<Tensor> l, 
+                        const std::shared_ptr<Tensor> r = nullptr);
+                private:
+                    Operator op_type; 
+            };
             
 
             
@@ -0,0 +1,236 @@
+#include "inference_engine.h"
+#include "tensor.h"
+
+#include <cilk/cilk.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+
+#include <assert.h>
+
+
+namespace NeuralNetwork {
+
+    namespace Inference {
+
+
+        namespace {
+
+            constexpr u_int64_t ALIGNMENT = 64;
+            constexpr u_int64_t FLOATS_PER_LINE = ALIGNMENT / sizeof(float);
+
+            /*
+                Below this many multiply-adds a layer runs on the calling
+                thread, spawning would cost more than it saves.
+            */
+            constexpr u_int64_t PARALLEL_WORK = 1 << 18;
+            constexpr u_int64_t COLUMN_BLOCK  = 256;
+
+            constexpr u_int64_t align_up(u_int64_t floats) noexcept {
+                return (floats + FLOATS_PER_LINE - 1) / FLOATS_PER_LINE * FLOATS_PER_LINE;
+            }
+
+            /*
+                y[first, last) = x W[:, first, last) + b, x a row vector
+                and W row-major. Walks W row by row so the inner loop is
+                a contiguous axpy, and skips the rows a zero activation
+                (a ReLU output) would multiply.
+            */
+            void affine_columns(const float* __restrict x, const float* __restrict W, const float* __restrict b,
+                float* __restrict y, u_int64_t in, u_int64_t out, u_int64_t first, u_int64_t last, bool relu) noexcept {
+
+                if (b) std::copy(b + first, b + last, y + first);
+                else   std::fill(y + first, y + last, 0.0f);
+
+                for (u_int64_t i = 0; i < in; i++) {
+
+                    const float xi = x[i];
+                    if (xi == 0) continue;
+
+                    const float* __restrict row = W + i * out;
+
+                    for (u_int64_t j = first; j < last; j++) y[j] += xi * row[j];
+                }
+
+                if (relu) {
+                    for (u_int64_t j = first; j < last; j++) y[j] = std::max(y[j], 0.0f);
+                }
+            }
+
+            void affine(const float* __restrict x, const float* __restrict W, const float* __restrict b,
+                float* __restrict y, u_int64_t in, u_int64_t out, bool relu) noexcept {
+
+                if (in * out < PARALLEL_WORK) {
+                    affine_columns(x, W, b, y, in, out, 0, out, relu);
+                    return;
+                }
+
+                cilk_for (u_int64_t block = 0; block < (out + COLUMN_BLOCK - 1) / COLUMN_BLOCK; block++) {
+                    affine_columns(x, W, b, y, in, out, block * COLUMN_BLOCK,
+                        std::min(out, (block + 1) * COLUMN_BLOCK), relu);
+                }
+            }
+
+            // The same affine layer with block-sparse weights.
+            void affine(const float* __restrict x, const Matrix::BlockSparseRepresentation& W, const float* __restrict b,
+                float* __restrict y, bool relu) noexcept {
+
+                const u_int64_t out = W.num_cols();
+
+                Matrix::Operations::Sparse::multiply(x, 1, W, y);
+
+                if (b) {
+                    for (u_int64_t j = 0; j < out; j++) y[j] += b[j];
+                }
+
+                if (relu) {
+                    for (u_int64_t j = 0; j < out; j++) y[j] = std::max(y[j], 0.0f);
+                }
+            }
+
+            void relu(float* y, u_int64_t n) noexcept {
+                for (u_int64_t j = 0; j < n; j++) y[j] = std::max(y[j], 0.0f);
+            }
+
+            // Same reduction as Unary::SoftMax on a single sample.
+            void softmax(float* y, u_int64_t n) noexcept {
+
+                const float max = *std::max_element(y, y + n);
+
+                std::transform(y, y + n, y, [max](float val) { return std::exp(val - max); });
+
+                const double sum = std::accumulate(y, y + n, 0.0);
+
+                std::transform(y, y + n, y, [sum](float val) { return val / sum; });
+            }
+
+        }
+
+
+        InferenceEngine::InferenceEngine(Sequential& _model, u_int64_t _input_width) noexcept :
+            buffers(nullptr, std::free), in_width(_input_width), out_width(_input_width) {
+
+            std::vector<KernelSpec> specs;
+            _model.collect_kernels(specs);
+
+            u_int64_t width = in_width;
+            u_int64_t widest = in_width;
+
+            for (size_t i = 0; i < specs.size() && compiled; i++) {
+
+                switch (specs[i].op) {
+
+                    case KernelSpec::Op::MATRIX_MULTIPLY: {
+
+                        auto& W = specs[i].parameter->release_matrix();
+
+                        if (W.num_rows() != width) {
+                            compiled = false;
+                            break;
+                        }
+
+                        Kernel kernel = {Kernel::Op::AFFINE, W.constScanStart(), nullptr, W.num_rows(), W.num_cols()};
+                        parameters.push_back(specs[i].parameter);
+
+                        if (i + 1 < specs.size() && specs[i + 1].op == KernelSpec::Op::ADD &&
+                            specs[i + 1].parameter->release_matrix().size() == kernel.out) {
+                            kernel.bias = specs[++i].parameter->release_matrix().constScanStart();
+                            parameters.push_back(specs[i].parameter);
+                        }
+
+                        if (i + 1 < specs.size() && specs[i + 1].op == KernelSpec::Op::RELU) {
+                            kernel.relu = true;
+                            i++;
+                        }
+
+                        plan.push_back(kernel);
+                        width  = kernel.out;
+                        widest = std::max(widest, width);
+                        break;
+                    }
+
+                    case KernelSpec::Op::RELU:
+                        plan.push_back({Kernel::Op::RELU, nullptr, nullptr, width, width});
+                        break;
+
+                    case KernelSpec::Op::SOFTMAX:
+                        plan.push_back({Kernel::Op::SOFTMAX, nullptr, nullptr, width, width});
+                        break;
+
+                    // A bias without a multiply in front of it, or a module the engine does not know.
+                    default:
+                        compiled = false;
+                }
+            }
+
+            out_width = width;
+            stride    = align_up(widest);
+
+            buffers.reset(static_cast<float*>(std::aligned_alloc(ALIGNMENT, 2 * stride * sizeof(float))));
+
+            assert(buffers && "Activation buffer allocation failed.");
+        }
+
+
+        InferenceEngine::InferenceEngine(Sequential& _model, u_int64_t _input_width,
+            std::vector<std::shared_ptr<const Matrix::BlockSparseRepresentation>> _sparse_weights) noexcept :
+                InferenceEngine(_model, _input_width) {
+
+            sparse_weights = std::move(_sparse_weights);
+
+            auto next = sparse_weights.begin();
+
+            for (auto& kernel: plan) {
+
+                if (kernel.op != Kernel::Op::AFFINE) continue;
+
+                if (next == sparse_weights.end() || (*next)->num_rows() != kernel.in || (*next)->num_cols() != kernel.out) {
+                    compiled = false;
+                    return;
+                }
+
+                kernel.sparse = (next++)->get();
+            }
+        }
+
+
+        const float* InferenceEngine::run(const float* _input) noexcept {
+
+            assert(compiled && "Model has modules the engine cannot run.");
+
+            float* ping = buffers.get();
+            float* pong = buffers.get() + stride;
+
+            const float* x = _input;
+
+            for (const auto& kernel: plan) {
+
+                if (kernel.op == Kernel::Op::AFFINE) {
+                    if (kernel.sparse) affine(x, *kernel.sparse, kernel.bias, ping, kernel.relu);
+                    else affine(x, kernel.weights, kernel.bias, ping, kernel.in, kernel.out, kernel.relu);
+                    x = ping;
+                    std::swap(ping, pong);
+                    continue;
+                }
+
+                // Elementwise kernels run in place, on a copy if x is still the caller's input.
+                if (x == _input) {
+                    std::copy(_input, _input + kernel.in, ping);
+                    x = ping;
+                    std::swap(ping, pong);
+                }
+
+                float* y = const_cast<float*>(x);
+
+                if (kernel.op == Kernel::Op::RELU) relu(y, kernel.out);
+                else softmax(y, kernel.out);
+            }
+
+            return x;
+        }
+
+
+    }
+
+}
@@ -0,0 +1,289 @@
+#include "inference_server.h"
+#include "tensor_forward_wrapper.h"
+#include "tensor.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include <assert.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+
+namespace NeuralNetwork {
+
+    namespace Serving {
+
+
+        namespace {
+
+            constexpr int BACKLOG = 128;
+            constexpr u_int64_t SPINS_BEFORE_SLEEP = 64;
+            constexpr auto IDLE_SLEEP = std::chrono::microseconds(50);
+
+            // Yields while work is likely to arrive soon, then backs off to sleeping.
+            void idle(u_int64_t& spins) noexcept {
+                if (spins++ < SPINS_BEFORE_SLEEP) std::this_thread::yield();
+                else std::this_thread::sleep_for(IDLE_SLEEP);
+            }
+
+            bool read_full(int fd, void* data, size_t bytes) noexcept {
+
+                char* p = static_cast<char*>(data);
+
+                while (bytes > 0) {
+                    ssize_t n = ::recv(fd, p, bytes, 0);
+                    if (n < 0 && errno == EINTR) continue;
+                    if (n <= 0) return false;
+                    p += n;
+                    bytes -= n;
+                }
+
+                return true;
+            }
+
+            bool write_full(int fd, const void* data, size_t bytes) noexcept {
+
+                const char* p = static_cast<const char*>(data);
+
+                while (bytes > 0) {
+                    ssize_t n = ::send(fd, p, bytes, MSG_NOSIGNAL);
+                    if (n < 0 && errno == EINTR) continue;
+                    if (n <= 0) return false;
+                    p += n;
+                    bytes -= n;
+                }
+
+                return true;
+            }
+
+        }
+
+
+        // Closes the socket once neither its reader nor a queued request needs it.
+        struct InferenceServer::Connection {
+            int fd;
+            explicit Connection(int _fd) noexcept : fd(_fd) {}
+            ~Connection() noexcept { ::close(fd); }
+        };
+
+
+        InferenceServer::InferenceServer(Sequential& _model, u_int64_t _input_width, u_int64_t _max_batch,
+            std::chrono::microseconds _max_delay, size_t _queue_capacity) noexcept :
+                model(_model), input_width(_input_width), max_batch(_max_batch), max_delay(_max_delay),
+                queue(_queue_capacity) {
+
+            assert(input_width > 0 && max_batch > 0 && "Requests and batches cannot be empty.");
+
+            batcher = std::thread(&InferenceServer::_batch, this);
+        }
+
+
+        InferenceServer::~InferenceServer() noexcept {
+            stop();
+        }
+
+
+        bool InferenceServer::listen(const std::string& _path) noexcept {
+
+            assert(listener < 0 && "Server is already listening.");
+
+            sockaddr_un address = {};
+            address.sun_family = AF_UNIX;
+
+            if (_path.size() >= sizeof(address.sun_path)) return false;
+            std::strcpy(address.sun_path, _path.c_str());
+
+            int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+            if (fd < 0) return false;
+
+            ::unlink(_path.c_str());
+
+            if (::bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || ::listen(fd, BACKLOG) != 0) {
+                ::close(fd);
+                return false;
+            }
+
+            listener    = fd;
+            socket_path = _path;
+            acceptor    = std::thread(&InferenceServer::_accept, this);
+
+            return true;
+        }
+
+
+        std::future<std::vector<float>> InferenceServer::submit(std::vector<float> _input) noexcept {
+
+            assert(_input.size() == input_width && "Request does not match the model's input.");
+            assert(running.load() && "Server has been stopped.");
+
+            auto promise = std::make_shared<std::promise<std::vector<float>>>();
+            auto result  = promise->get_future();
+
+            _enqueue(Request {
+                std::move(_input),
+                [promise](const float* y, u_int64_t n) { promise->set_value(std::vector<float>(y, y + n)); },
+                clock::now()
+            });
+
+            return result;
+        }
+
+
+        void InferenceServer::stop() noexcept {
+
+            if (!batcher.joinable()) return;
+
+            if (listener >= 0) {
+                ::shutdown(listener, SHUT_RDWR);
+                acceptor.join();
+                ::close(listener);
+                ::unlink(socket_path.c_str());
+                listener = -1;
+            }
+
+            {
+                std::unique_lock<std::mutex> guard(connections_lock);
+                for (auto& connection: connections) ::shutdown(connection->fd, SHUT_RD);
+
+                readers_done.wait(guard, [this]() { return readers == 0; });
+            }
+
+            running.store(false);
+            batcher.join();
+        }
+
+
+        void InferenceServer::_enqueue(Request&& _request) noexcept {
+
+            u_int64_t spins = 0;
+
+            // A full queue pushes back on the producer instead of dropping requests.
+            while (!queue.try_push(std::move(_request))) idle(spins);
+        }
+
+
+        void InferenceServer::_batch() noexcept {
+
+            std::vector<Request> batch;
+            batch.reserve(max_batch);
+
+            while (true) {
+
+                Request next;
+                u_int64_t spins = 0;
+
+                while (!queue.try_pop(next)) {
+
+                    // Once stopped, whatever is still queued is answered before exiting.
+                    if (!running.load()) {
+                        if (queue.try_pop(next)) break;
+                        return;
+                    }
+
+                    idle(spins);
+                }
+
+                batch.push_back(std::move(next));
+
+                const auto deadline = batch.front().arrival + max_delay;
+
+                while (batch.size() < max_batch) {
+
+                    if (queue.try_pop(next)) {
+                        batch.push_back(std::move(next));
+                        continue;
+                    }
+
+                    if (clock::now() >= deadline || !running.load(std::memory_order_relaxed)) break;
+
+                    std::this_thread::yield();
+                }
+
+                _run(batch);
+                batch.clear();
+            }
+        }
+
+
+        void InferenceServer::_run(std::vector<Request>& _batch) noexcept {
+
+            Matrix::Representation inputs = Matrix::Representation(
+                Matrix::Rows(_batch.size()), Matrix::Columns(input_width));
+
+            for (size_t i = 0; i < _batch.size(); i++) {
+                std::copy(_batch[i].input.begin(), _batch[i].input.end(), inputs.scanStart() + i * input_width);
+            }
+
+            auto out = model.forward(std::make_shared<Computation::Graph::Tensor>(std::move(inputs)), Computation::Graph::InferenceTag{});
+            auto& outputs = out->release_matrix();
+
+            for (size_t i = 0; i < _batch.size(); i++) {
+                _batch[i].reply(outputs.constScanStart() + i * outputs.num_cols(), outputs.num_cols());
+            }
+
+            served.fetch_add(_batch.size(), std::memory_order_relaxed);
+            forwards.fetch_add(1, std::memory_order_relaxed);
+        }
+
+
+        void InferenceServer::_accept() noexcept {
+
+            while (true) {
+
+                int fd = ::accept(listener, nullptr, nullptr);
+
+                if (fd < 0) {
+                    if (errno == EINTR || errno == ECONNABORTED) continue;
+                    return;
+                }
+
+                auto connection = std::make_shared<Connection>(fd);
+
+                std::lock_guard<std::mutex> guard(connections_lock);
+                connections.push_back(connection);
+                ++readers;
+
+                std::thread(&InferenceServer::_read, this, std::move(connection)).detach();
+            }
+        }
+
+
+        void InferenceServer::_read(std::shared_ptr<Connection> _connection) noexcept {
+
+            while (true) {
+
+                uint32_t count = 0;
+
+                if (!read_full(_connection->fd, &count, sizeof(count)) || count != input_width) break;
+
+                std::vector<float> input(count);
+
+                if (!read_full(_connection->fd, input.data(), count * sizeof(float))) break;
+
+                _enqueue(Request {
+                    std::move(input),
+                    [_connection](const float* y, u_int64_t n) {
+                        uint32_t count = n;
+                        if (write_full(_connection->fd, &count, sizeof(count))) {
+                            write_full(_connection->fd, y, n * sizeof(float));
+                        }
+                    },
+                    clock::now()
+                });
+            }
+
+            std::lock_guard<std::mutex> guard(connections_lock);
+            connections.erase(std::remove(connections.begin(), connections.end(), _connection), connections.end());
+
+            // Last touch of the server, stop() may return once this is released.
+            --readers;
+            readers_done.notify_all();
+        }
+
+
+    }
+
+}
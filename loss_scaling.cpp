@@ -0,0 +1,227 @@
+#include "loss_scaling.h"
+#include "m_algorithms.h"
+#include "tensor.h"
+
+#include <cilk/cilk.h>
+#include <algorithm>
+#include <vector>
+
+#include <assert.h>
+
+
+namespace NeuralNetwork {
+
+    namespace Training {
+
+
+        namespace {
+
+            constexpr u_int64_t BLOCK = 1 << 14;
+
+            constexpr u_int64_t blocks(u_int64_t n) noexcept {
+                return (n + BLOCK - 1) / BLOCK;
+            }
+
+        }
+
+
+        bool DynamicLossScaler::update(bool _overflow) noexcept {
+
+            if (_overflow) {
+                current *= backoff;
+                clean = 0;
+                skips++;
+                return false;
+            }
+
+            if (++clean == interval) {
+                current *= growth;
+                clean = 0;
+            }
+
+            return true;
+        }
+
+
+        template <Matrix::HalfFloat T>
+        LossScaledTraining<T>::LossScaledTraining(Sequential& _model, DynamicLossScaler _scaler) noexcept :
+            loss_scaler(_scaler) {
+
+            assert(!_model.parameters().empty() && "Loss scaled training needs a model with parameters.");
+
+            flat = _model.flat_parameters() ? _model.flat_parameters() : _model.flatten();
+
+            std::vector<KernelSpec> specs;
+            _model.collect_kernels(specs);
+
+            for (auto& spec: specs) {
+
+                switch (spec.op) {
+
+                    case KernelSpec::Op::MATRIX_MULTIPLY:
+                    case KernelSpec::Op::ADD:
+                    case KernelSpec::Op::RELU:
+                        plan.push_back({spec.op, spec.parameter, Matrix::BasicRepresentation<T>{}});
+                        break;
+
+                    default:
+                        compiled = false;
+                }
+            }
+
+            activations.resize(plan.size());
+        }
+
+
+        template <Matrix::HalfFloat T>
+        bool LossScaledTraining<T>::step(const Matrix::Representation& _inputs, const Matrix::Representation& _labels) noexcept {
+
+            assert(compiled && "The model has modules loss scaled training cannot run.");
+
+            Matrix::Operations::Metric::CrossEntropy cross_entropy;
+            Matrix::Operations::Unary::SoftMax softmax;
+            Matrix::Operations::Binary::Subtraction::Std subtract;
+
+            const float scale = loss_scaler.scale();
+
+            flat->zero_grad();
+
+            Matrix::Representation logits = _forward(_inputs);
+
+            last_loss = cross_entropy(_labels, logits).get(0, 0);
+
+            Matrix::BasicRepresentation<T> gradient = Matrix::narrow<T>(scale * subtract(softmax(logits), _labels));
+
+            _backward(gradient);
+
+            const bool applied = loss_scaler.update(!_unscale_gradients(scale));
+
+            if (!applied) flat->zero_grad();
+
+            return applied;
+        }
+
+
+        template <Matrix::HalfFloat T>
+        u_int64_t LossScaledTraining<T>::stored_bytes() const noexcept {
+
+            u_int64_t total = 0;
+
+            for (auto& kernel: plan) total += kernel.weights.bytes();
+            for (auto& activation: activations) total += activation.bytes();
+
+            return total;
+        }
+
+
+        /*
+            Narrows the weights, then runs the kernels in order. Each
+            kernel's input is kept in T for the backward pass; the
+            last kernel's fp32 output, the logits, is returned.
+        */
+        template <Matrix::HalfFloat T>
+        Matrix::Representation LossScaledTraining<T>::_forward(const Matrix::Representation& _inputs) noexcept {
+
+            Matrix::narrow(_inputs, activations[0]);
+
+            Matrix::Representation output;
+
+            for (size_t i = 0; i < plan.size(); i++) {
+
+                Kernel& kernel = plan[i];
+
+                switch (kernel.op) {
+
+                    case KernelSpec::Op::MATRIX_MULTIPLY:
+                        Matrix::narrow(kernel.parameter->release_matrix(), kernel.weights);
+                        output = Matrix::Operations::LowPrecision::multiply(activations[i], kernel.weights);
+                        break;
+
+                    case KernelSpec::Op::ADD:
+                        output = Matrix::Operations::LowPrecision::add(activations[i], kernel.parameter->release_matrix());
+                        break;
+
+                    default:
+                        output = Matrix::Operations::LowPrecision::relu(activations[i]);
+                }
+
+                if (i + 1 < plan.size()) Matrix::narrow(output, activations[i + 1]);
+            }
+
+            return Matrix::Representation{std::move(output)};
+        }
+
+
+        /*
+            Walks the kernels in reverse. _gradient, the gradient with
+            respect to the current kernel's output, is narrowed back to
+            T after every kernel that changes it. Parameter gradients
+            are summed in fp32 into the flat gradient buffer.
+        */
+        template <Matrix::HalfFloat T>
+        void LossScaledTraining<T>::_backward(Matrix::BasicRepresentation<T>& _gradient) noexcept {
+
+            for (size_t i = plan.size(); i-- > 0;) {
+
+                Kernel& kernel = plan[i];
+
+                switch (kernel.op) {
+
+                    case KernelSpec::Op::MATRIX_MULTIPLY:
+                        Matrix::Operations::Binary::accumulate(kernel.parameter->get_grad(),
+                            Matrix::Operations::LowPrecision::transpose_multiply(activations[i], _gradient));
+
+                        if (i > 0) Matrix::narrow(Matrix::Operations::LowPrecision::multiply_transpose(_gradient, kernel.weights), _gradient);
+                        break;
+
+                    case KernelSpec::Op::ADD:
+                        Matrix::Operations::Binary::accumulate(kernel.parameter->get_grad(),
+                            Matrix::Operations::LowPrecision::sum_rows(_gradient));
+                        break;
+
+                    default:
+                        Matrix::narrow(Matrix::Operations::LowPrecision::relu_gradient(activations[i], _gradient), _gradient);
+                }
+            }
+
+            flat->forget_grad_rows();
+        }
+
+
+        /*
+            Divides the gradient by the scale it was computed under.
+            Returns false, and leaves it as it is, if any entry does
+            not survive narrowing to T.
+        */
+        template <Matrix::HalfFloat T>
+        bool LossScaledTraining<T>::_unscale_gradients(float _scale) noexcept {
+
+            const u_int64_t n = flat->size();
+            float* g = flat->gradients();
+
+            std::vector<uint8_t> finite(blocks(n), 1);
+
+            cilk_for (u_int64_t b = 0; b < blocks(n); b++) {
+                finite[b] = std::all_of(g + b * BLOCK, g + std::min(n, (b + 1) * BLOCK), [](float x) { return T::from_float(x).is_finite(); });
+            }
+
+            if (!std::all_of(finite.begin(), finite.end(), [](uint8_t f) { return f; })) return false;
+
+            const float inverse = 1.0f / _scale;
+
+            cilk_for (u_int64_t b = 0; b < blocks(n); b++) {
+                const u_int64_t last = std::min(n, (b + 1) * BLOCK);
+                for (u_int64_t i = b * BLOCK; i < last; i++) g[i] *= inverse;
+            }
+
+            return true;
+        }
+
+
+        template class LossScaledTraining<Matrix::bfloat16>;
+        template class LossScaledTraining<Matrix::float16>;
+
+
+    }
+
+}
@@ -3,11 +3,16 @@
 #include "matrix_printer.h"
 
 #include <cilk/cilk.h>
+#include <algorithm>
 #include <iostream>
 #include <math.h>
 #include <numeric>
 #include <assert.h>
 
+#if defined(__AVX2__) && defined(__FMA__)
+#include <immintrin.h>
+#endif
+
 
 namespace Matrix {
 
@@ -17,32 +22,34 @@ namespace Matrix {
         namespace Unary {
 
    
-            Matrix::Representation ReLU::operate(
-                        const Matrix::Representation& m) const noexcept{
+            template <ArithmeticElement T>
+            BasicRepresentation<T> ReLU::operate(
+                        const BasicRepresentation<T>& m) const noexcept{
 
-                Matrix::Representation output = Matrix::Representation{
+                BasicRepresentation<T> output = BasicRepresentation<T>{
                             Matrix::Rows(m.num_rows()), 
                             Matrix::Columns(m.num_cols())
                 };
                 
 
                 std::replace_copy_if(m.constScanStart(), m.constScanEnd(), output.scanStart(), 
-                    [](float z){ return z < 0;}, 0);
+                    [](T z){ return z < 0;}, 0);
 
-                return Matrix::Representation{output};
+                return BasicRepresentation<T>{output};
             }
 
-            Matrix::Representation Sign::operate(
-                        const Matrix::Representation& m) const noexcept{
+            template <ArithmeticElement T>
+            BasicRepresentation<T> Sign::operate(
+                        const BasicRepresentation<T>& m) const noexcept{
 
-                Matrix::Representation output = Matrix::Representation(
+                BasicRepresentation<T> output = BasicRepresentation<T>(
                             Matrix::Rows(m.num_rows()), 
                             Matrix::Columns(m.num_cols())
                     );
                 
                 std::transform(m.constScanStart(), m.constScanEnd(), output.scanStart(), [](const auto val) { return val >= 0 ? 1 : 0;}); 
 
-                return Matrix::Representation{output};
+                return BasicRepresentation<T>{output};
             }
 
 
@@ -56,34 +63,50 @@ namespace Matrix {
 
                 https://cs231n.github.io/linear-classify/#softmax
 
+                Vectors are normalised as a whole, a matrix is a minibatch
+                and each row is normalised on its own.
+
             */
-            Matrix::Representation SoftMax::operate(
-                        const Matrix::Representation& m) const noexcept{
+            template <ArithmeticElement T>
+            BasicRepresentation<T> SoftMax::operate(
+                        const BasicRepresentation<T>& m) const noexcept{
 
                 
-                Matrix::Representation output = Matrix::Representation(
+                BasicRepresentation<T> output = BasicRepresentation<T>(
                             Matrix::Rows(m.num_rows()), 
                             Matrix::Columns(m.num_cols())
                     );
+
+                bool is_batch = m.get_type() == BasicRepresentation<T>::Type::MATRIX;
+
+                u_int64_t samples = is_batch ? m.num_rows() : 1;
+                u_int64_t width   = is_batch ? m.num_cols() : m.size();
                 
 
-                auto max = std::max(m.constScanStart(), m.constScanEnd());
+                cilk_for (u_int64_t i = 0; i < samples; i++) {
 
-                std::transform(m.constScanStart(), m.constScanEnd(), output.scanStart(), [max](auto val) { return exp(val - *max); });
+                    auto in  = m.constScanStart() + i * width;
+                    auto out = output.scanStart() + i * width;
 
-                double sum = std::accumulate(output.constScanStart(), output.constScanEnd(), 0.0);
-        
-                std::transform(output.constScanStart(), output.constScanEnd(), output.scanStart(), 
-                    [sum](auto val) { return val / sum; }
-                ); 
+                    auto max = *std::max_element(in, in + width);
+
+                    std::transform(in, in + width, out, [max](auto val) { return exp(val - max); });
 
-                return Matrix::Representation{output};
+                    double sum = std::accumulate(out, out + width, 0.0);
+            
+                    std::transform(out, out + width, out, 
+                        [sum](auto val) { return val / sum; }
+                    ); 
+                }
+
+                return BasicRepresentation<T>{output};
             }
 
-            Matrix::Representation Transpose::operate(
-                        const Matrix::Representation& m) const noexcept {
+            template <ArithmeticElement T>
+            BasicRepresentation<T> Transpose::operate(
+                        const BasicRepresentation<T>& m) const noexcept {
 
-                Matrix::Representation output = Matrix::Representation{
+                BasicRepresentation<T> output = BasicRepresentation<T>{
                             Matrix::Rows(m.num_cols()), 
                             Matrix::Columns(m.num_rows())
                 };
@@ -95,12 +118,34 @@ namespace Matrix {
                     0, m.num_cols(), 
                     m.num_rows(), m.num_cols());
 
-                return Matrix::Representation{output};
+                return BasicRepresentation<T>{output};
             }
 
+            template <ArithmeticElement T>
+            BasicRepresentation<T> SumRows::operate(
+                        const BasicRepresentation<T>& m) const noexcept {
+
+                BasicRepresentation<T> output = BasicRepresentation<T>{
+                            Matrix::Rows(1), 
+                            Matrix::Columns(m.num_cols())
+                };
+
+                auto out = output.scanStart();
+
+                for (u_int64_t i = 0; i < m.num_rows(); i++) {
+
+                    auto row = m.constScanStart() + i * m.num_cols();
+
+                    std::transform(row, row + m.num_cols(), out, out, std::plus<T>());
+                }
+
+                return BasicRepresentation<T>{output};
+            }
+
+            template <ArithmeticElement T>
             void transpose_helper(
-                std::vector<float>::const_iterator in, 
-                std::vector<float>::iterator out, 
+                const T* in, 
+                T* out, 
                 int rb, int re, int cb, int ce, int rows, int cols) noexcept {
                 
                 int r = re - rb, c = ce - cb;
@@ -143,18 +188,20 @@ namespace Matrix {
         namespace Metric {
 
 
-            Matrix::Representation CrossEntropy::operate(
-                        const Matrix::Representation& p, 
-                        const Matrix::Representation& q) const noexcept {
+            template <ArithmeticElement T>
+            BasicRepresentation<T> CrossEntropy::operate(
+                        const BasicRepresentation<T>& p, 
+                        const BasicRepresentation<T>& q) const noexcept {
                 
-                Matrix::Representation output = Matrix::Representation(
+                BasicRepresentation<T> output = BasicRepresentation<T>(
                             Matrix::Rows(1), 
                             Matrix::Columns(1)
                     );
                 Matrix::Operations::Unary::SoftMax softmax;
 
-                Matrix::Representation theta = softmax(q); 
+                BasicRepresentation<T> theta = softmax(q); 
                 
+                // Summed over every row of a minibatch.
                 double entropy = 0;
 
                 for (auto p_i = p.constScanStart(), q_i = theta.constScanStart(); q_i != theta.constScanEnd(); p_i++, q_i++) {
@@ -163,7 +210,7 @@ namespace Matrix {
 
                 output.put(0, 0, entropy);
 
-                return Matrix::Representation{output};
+                return BasicRepresentation<T>{output};
             }
 
         }
@@ -172,48 +219,137 @@ namespace Matrix {
         namespace Binary {
 
 
+            namespace {
 
-            namespace Addition {
+                /*
+                    Strides of an operand broadcast to the output shape,
+                    a broadcast dimension is walked with stride 0.
+                */
+                struct BroadcastStride {
+                    u_int64_t row;
+                    u_int64_t col;
+                };
 
-                Matrix::Representation Std::operate(
-                        const Matrix::Representation& l, 
-                        const Matrix::Representation& r) const noexcept {
+                template <ArithmeticElement T>
+                constexpr BroadcastStride broadcast_stride(const BasicRepresentation<T>& m) noexcept {
+                    return { m.num_rows() == 1 ? 0 : m.num_cols(), m.num_cols() == 1 ? u_int64_t{0} : 1 };
+                }
 
+                constexpr bool is_broadcastable(u_int64_t a, u_int64_t b) noexcept {
+                    return a == b || a == 1 || b == 1;
+                }
 
-#if DEBUG
-                    if ((l.num_rows() != r.num_rows()) && (l.num_cols() != r.num_cols()))
-                        std::cout << Utility::debug_message_2(l, r) << endl;
-#endif
-                    assert((l.num_rows() == r.num_rows()) && (l.num_cols() == r.num_cols()));
 
+                /*
+                    NumPy-style elementwise kernel over row, column and 
+                    scalar broadcasts, without materialising the expanded
+                    operand. Rows of the output are processed in parallel.
+                */
+                template <ArithmeticElement T, class BinaryFunction>
+                BasicRepresentation<T> broadcast_apply(
+                        const BasicRepresentation<T>& l, 
+                        const BasicRepresentation<T>& r,
+                        BinaryFunction fn) noexcept {
 
-                        
-                    auto output = Matrix::Representation(Rows(l.num_rows()), Columns(r.num_cols()));
+                    assert(is_broadcastable(l.num_rows(), r.num_rows()) && 
+                           is_broadcastable(l.num_cols(), r.num_cols()) && "Operands cannot be broadcast.");
+
+                    u_int64_t rows = std::max(l.num_rows(), r.num_rows());
+                    u_int64_t cols = std::max(l.num_cols(), r.num_cols());
+
+                    auto output = BasicRepresentation<T>(Rows(rows), Columns(cols));
+
+                    if (l.num_rows() == r.num_rows() && l.num_cols() == r.num_cols()) {
+                        std::transform(l.constScanStart(), l.constScanEnd(), r.constScanStart(), output.scanStart(), fn);
+                        return BasicRepresentation<T>{output};
+                    }
+
+                    auto ls = broadcast_stride(l);
+                    auto rs = broadcast_stride(r);
 
-                    std::transform(l.constScanStart(), l.constScanEnd(), r.constScanStart(), output.scanStart(), std::plus<float>());
+                    cilk_for (u_int64_t i = 0; i < rows; i++) {
 
-                    return Matrix::Representation{output};
+                        auto li  = l.constScanStart() + i * ls.row;
+                        auto ri  = r.constScanStart() + i * rs.row;
+                        auto out = output.scanStart() + i * cols;
+
+                        for (u_int64_t j = 0; j < cols; j++) {
+                            out[j] = fn(li[j * ls.col], ri[j * rs.col]);
+                        }
+                    }
+
+                    return BasicRepresentation<T>{output};
                 }
+
             }
 
-            namespace Subtraction {
 
-                Matrix::Representation Std::operate(
-                        const Matrix::Representation& l, 
-                        const Matrix::Representation& r) const noexcept {
+            template <ArithmeticElement T>
+            BasicRepresentation<T> reduce_to_shape(
+                    const BasicRepresentation<T>& g, Rows _l, Columns _w) noexcept {
 
-#if DEBUG
-                    if ((l.num_rows() != r.num_rows()) && (l.num_cols() != r.num_cols()))
-                        std::cout << Utility::debug_message_2(l, r) << endl;
-#endif
-                    assert((l.num_rows() == r.num_rows()) && (l.num_cols() == r.num_cols()));
+                assert(is_broadcastable(g.num_rows(), _l.get()) && 
+                       is_broadcastable(g.num_cols(), _w.get()) && "Gradient cannot be reduced to shape.");
+
+                if (g.num_rows() == _l.get() && g.num_cols() == _w.get()) return BasicRepresentation<T>{g};
+
+                auto output = BasicRepresentation<T>(_l, _w);
+                auto os = broadcast_stride(output);
+
+                for (u_int64_t i = 0; i < g.num_rows(); i++) {
+
+                    auto gi  = g.constScanStart() + i * g.num_cols();
+                    auto out = output.scanStart() + i * os.row;
+
+                    for (u_int64_t j = 0; j < g.num_cols(); j++) {
+                        out[j * os.col] += gi[j];
+                    }
+                }
+
+                return BasicRepresentation<T>{output};
+            }
 
-                        
-                    auto output = Matrix::Representation(Rows(l.num_rows()), Columns(r.num_cols()));
 
-                    std::transform(l.constScanStart(), l.constScanEnd(), r.constScanStart(), output.scanStart(), std::minus<float>());
+            template <ArithmeticElement T>
+            void accumulate(BasicRepresentation<T>& into, const BasicRepresentation<T>& g) noexcept {
 
-                    return Matrix::Representation{output};
+                assert(into.num_rows() == g.num_rows() && into.num_cols() == g.num_cols() && "Cannot accumulate mismatched shapes.");
+
+                constexpr u_int64_t BLOCK = 4096;
+
+                const u_int64_t n = into.size();
+                T* __restrict out      = into.scanStart();
+                const T* __restrict in = g.constScanStart();
+
+                cilk_for (u_int64_t b = 0; b < (n + BLOCK - 1) / BLOCK; b++) {
+
+                    const u_int64_t end = std::min(n, (b + 1) * BLOCK);
+
+                    for (u_int64_t i = b * BLOCK; i < end; i++) out[i] += in[i];
+                }
+            }
+
+
+
+            namespace Addition {
+
+                template <ArithmeticElement T>
+                BasicRepresentation<T> Std::operate(
+                        const BasicRepresentation<T>& l, 
+                        const BasicRepresentation<T>& r) const noexcept {
+
+                    return broadcast_apply(l, r, std::plus<T>());
+                }
+            }
+
+            namespace Subtraction {
+
+                template <ArithmeticElement T>
+                BasicRepresentation<T> Std::operate(
+                        const BasicRepresentation<T>& l, 
+                        const BasicRepresentation<T>& r) const noexcept {
+
+                    return broadcast_apply(l, r, std::minus<T>());
                 }
             }
 
@@ -221,32 +357,33 @@ namespace Matrix {
             namespace OuterProduct {
 
 
-                Matrix::Representation Naive::operate(
-                        const Matrix::Representation& l, 
-                        const Matrix::Representation& r) const noexcept {
+                template <ArithmeticElement T>
+                BasicRepresentation<T> Naive::operate(
+                        const BasicRepresentation<T>& l, 
+                        const BasicRepresentation<T>& r) const noexcept {
 
 
 
 #if DEBUG
                     if ( 
-                        l.get_type() =! Matrix::Representation::Type::COLUMN_VECTOR && 
-                        l.get_type() =! Matrix::Representation::Type::ROW_VECTOR ||
-                        r.get_type() =! Matrix::Representation::Type::COLUMN_VECTOR && 
-                        r.get_type() =! Matrix::Representation::Type::ROW_VECTOR
+                        l.get_type() =! BasicRepresentation<T>::Type::COLUMN_VECTOR && 
+                        l.get_type() =! BasicRepresentation<T>::Type::ROW_VECTOR ||
+                        r.get_type() =! BasicRepresentation<T>::Type::COLUMN_VECTOR && 
+                        r.get_type() =! BasicRepresentation<T>::Type::ROW_VECTOR
                     )
                         std::cout << Utility::debug_message_2(l, r) << endl;
 #endif
                     assert(
-                        l.get_type() == Matrix::Representation::Type::COLUMN_VECTOR || 
-                        l.get_type() == Matrix::Representation::Type::ROW_VECTOR &&
-                        r.get_type() == Matrix::Representation::Type::COLUMN_VECTOR || 
-                        r.get_type() == Matrix::Representation::Type::ROW_VECTOR &&
+                        l.get_type() == BasicRepresentation<T>::Type::COLUMN_VECTOR || 
+                        l.get_type() == BasicRepresentation<T>::Type::ROW_VECTOR &&
+                        r.get_type() == BasicRepresentation<T>::Type::COLUMN_VECTOR || 
+                        r.get_type() == BasicRepresentation<T>::Type::ROW_VECTOR &&
                         "Operands are not Vectors.");
                     
                     u_int64_t x_dimension = l.num_rows() > r.num_rows() ? l.num_rows() : r.num_rows(); 
                     u_int64_t y_dimension = r.num_cols() > l.num_cols() ? r.num_cols() : l.num_cols();
 
-                    auto output = Matrix::Representation(Rows(x_dimension), Columns(y_dimension));
+                    auto output = BasicRepresentation<T>(Rows(x_dimension), Columns(y_dimension));
 
                     auto li = l.constScanStart();
 
@@ -254,12 +391,12 @@ namespace Matrix {
                         auto ri = r.constScanStart();
                         
                         for (int j = 0; ri != r.constScanEnd(); ri++, j++) {
-                            float val = *li * *ri;
+                            T val = *li * *ri;
                             output.put(i, j, val);
                         }
                     }
                     
-                    return Matrix::Representation{output};
+                    return BasicRepresentation<T>{output};
                 }
 
                 
@@ -269,39 +406,34 @@ namespace Matrix {
 
             namespace HadamardProduct {
 
-                Matrix::Representation Std::operate(
-                        const Matrix::Representation& l, 
-                        const Matrix::Representation& r) const noexcept {
-
-                        auto output = Matrix::Representation(
-                                Rows(l.num_rows()), 
-                                Columns(r.num_cols()));
+                template <ArithmeticElement T>
+                BasicRepresentation<T> Std::operate(
+                        const BasicRepresentation<T>& l, 
+                        const BasicRepresentation<T>& r) const noexcept {
 
-                        
-                        std::transform(l.constScanStart(), l.constScanEnd(), r.constScanStart(), output.scanStart(), std::multiplies<float>()); 
-                        
-                    return Matrix::Representation{output};
+                    return broadcast_apply(l, r, std::multiplies<T>());
                 }
 
 
-                Matrix::Representation Naive::operate(
-                        const Matrix::Representation& l, 
-                        const Matrix::Representation& r) const noexcept {
+                template <ArithmeticElement T>
+                BasicRepresentation<T> Naive::operate(
+                        const BasicRepresentation<T>& l, 
+                        const BasicRepresentation<T>& r) const noexcept {
 
 
 
 #if DEBUG
                     if (l.get_type() != r.get_type() || 
-                        l.get_type() =! Matrix::Representation::Type::COLUMN_VECTOR && 
-                        l.get_type() =! Matrix::Representation::Type::ROW_VECTOR)
+                        l.get_type() =! BasicRepresentation<T>::Type::COLUMN_VECTOR && 
+                        l.get_type() =! BasicRepresentation<T>::Type::ROW_VECTOR)
                         std::cout << Utility::debug_message_2(l, r) << endl;
 #endif
                     assert(l.get_type() == r.get_type() && 
-                        l.get_type() == Matrix::Representation::Type::COLUMN_VECTOR || 
-                        l.get_type() == Matrix::Representation::Type::ROW_VECTOR &&
+                        l.get_type() == BasicRepresentation<T>::Type::COLUMN_VECTOR || 
+                        l.get_type() == BasicRepresentation<T>::Type::ROW_VECTOR &&
                         "Operands are not Vectors.");
 
-                    Matrix::Representation output = Matrix::Representation(Rows(l.num_rows()), Columns(r.num_cols()));
+                    BasicRepresentation<T> output = BasicRepresentation<T>(Rows(l.num_rows()), Columns(r.num_cols()));
 
 
                     for (u_int64_t i = 0; i < l.num_rows(); i++) {
@@ -309,7 +441,7 @@ namespace Matrix {
                         for (u_int64_t j = 0; j < r.num_cols(); j++) {
 
 
-                            float val = l.get(i, j) * r.get(i, j);
+                            T val = l.get(i, j) * r.get(i, j);
 
                             output.put(i, j, val);
 
@@ -318,16 +450,17 @@ namespace Matrix {
                     }
 
 
-                    return Matrix::Representation{output};
+                    return BasicRepresentation<T>{output};
                 }
             } 
 
 
             namespace Multiplication {
 
-                Matrix::Representation Naive::operate(
-                        const Matrix::Representation& l, 
-                        const Matrix::Representation& r) const noexcept {
+                template <ArithmeticElement T>
+                BasicRepresentation<T> Naive::operate(
+                        const BasicRepresentation<T>& l, 
+                        const BasicRepresentation<T>& r) const noexcept {
 
 
 #if DEBUG
@@ -341,7 +474,7 @@ namespace Matrix {
 
                     // }
 
-                    Matrix::Representation output = Matrix::Representation(Rows(l.num_rows()), Columns(r.num_cols()));
+                    BasicRepresentation<T> output = BasicRepresentation<T>(Rows(l.num_rows()), Columns(r.num_cols()));
 
 
                     for (u_int64_t i = 0; i < l.num_rows(); i++) {
@@ -349,7 +482,7 @@ namespace Matrix {
                         for (u_int64_t j = 0; j < r.num_cols(); j++) {
 
 
-                            float val = 0;
+                            T val = 0;
 
                             for (u_int64_t k = 0; k < l.num_cols(); k++) {
                                 val += l.get(i, k) * r.get(k, j);
@@ -363,7 +496,51 @@ namespace Matrix {
 
 
 
-                    return Matrix::Representation{output};
+                    return BasicRepresentation<T>{output};
+                }
+
+
+                namespace {
+
+                    /*
+                        y += a * x over n elements. float and double have
+                        explicit AVX2 / FMA paths when the build targets
+                        them (NATIVE=1), picked by overload at compile
+                        time; any other build vectorizes the plain loop.
+                    */
+                    template <ArithmeticElement T>
+                    inline void axpy(T a, const T* __restrict x, T* __restrict y, int n) noexcept {
+                        for (int i = 0; i < n; i++) y[i] += a * x[i];
+                    }
+
+#if defined(__AVX2__) && defined(__FMA__)
+                    template <>
+                    inline void axpy(float a, const float* __restrict x, float* __restrict y, int n) noexcept {
+
+                        const __m256 va = _mm256_set1_ps(a);
+                        int i = 0;
+
+                        for (; i + 8 <= n; i += 8) {
+                            _mm256_storeu_ps(y + i, _mm256_fmadd_ps(va, _mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i)));
+                        }
+
+                        for (; i < n; i++) y[i] += a * x[i];
+                    }
+
+                    template <>
+                    inline void axpy(double a, const double* __restrict x, double* __restrict y, int n) noexcept {
+
+                        const __m256d va = _mm256_set1_pd(a);
+                        int i = 0;
+
+                        for (; i + 4 <= n; i += 4) {
+                            _mm256_storeu_pd(y + i, _mm256_fmadd_pd(va, _mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i)));
+                        }
+
+                        for (; i < n; i++) y[i] += a * x[i];
+                    }
+#endif
+
                 }
 
                 
@@ -372,19 +549,16 @@ namespace Matrix {
                     
                     We need to divide the data until it fits into lowest cache.
                     */
-                    void add_matmul_rec(std::vector<float>::const_iterator a, std::vector<float>::const_iterator b, std::vector<float>::iterator c, 
+                    template <ArithmeticElement T>
+                    void add_matmul_rec(const T* a, const T* b, T* c, 
                         int m, int n, int p, int fdA, int fdB, int fdC) noexcept {
                         
                         if (m + n + p <= 48) {  
-                            int i, j, k;
                             
-                            for (i = 0; i < m; ++i) {
-                                for (k = 0; k < p; ++k) { 
-                                    float sum = 0;
-                                    for (j = 0; j < n; ++j)
-                                        sum += *(a + (i * fdA + j)) * *(b + (j * fdB + k));
-                                    *(c + (i * fdC + k)) += sum;
-                        
+                            // Rows of c accumulate rows of b, contiguous runs the SIMD path streams.
+                            for (int i = 0; i < m; ++i) {
+                                for (int j = 0; j < n; ++j) {
+                                    axpy(*(a + (i * fdA + j)), b + j * fdB, c + i * fdC, p);
                                 }
                             }
                         }
@@ -406,9 +580,10 @@ namespace Matrix {
                     }
 
 
-                Matrix::Representation ParallelDNC::operate(
-                        const Matrix::Representation& l, 
-                        const Matrix::Representation& r) const noexcept {
+                template <ArithmeticElement T>
+                BasicRepresentation<T> ParallelDNC::operate(
+                        const BasicRepresentation<T>& l, 
+                        const BasicRepresentation<T>& r) const noexcept {
 
                     
 #if DEBUG
@@ -418,17 +593,18 @@ namespace Matrix {
                     assert(l.num_cols() == r.num_rows());
 
 
-                    Matrix::Representation output = Matrix::Representation(Rows(l.num_rows()), Columns(r.num_cols()));
+                    BasicRepresentation<T> output = BasicRepresentation<T>(Rows(l.num_rows()), Columns(r.num_cols()));
 
                     add_matmul_rec(l.constScanStart(), r.constScanStart(), output.scanStart(), l.num_rows(), l.num_cols(), r.num_cols(), l.num_cols(), r.num_cols(), r.num_cols());
 
-                    return Matrix::Representation{output};
+                    return BasicRepresentation<T>{output};
                 }
         
         
-                Matrix::Representation Square::operate(
-                        const Matrix::Representation& l, 
-                        const Matrix::Representation& r) const noexcept {
+                template <ArithmeticElement T>
+                BasicRepresentation<T> Square::operate(
+                        const BasicRepresentation<T>& l, 
+                        const BasicRepresentation<T>& r) const noexcept {
 
                     
 
@@ -439,7 +615,7 @@ namespace Matrix {
                     assert(l.num_cols() == r.num_rows());
 
 
-                    Matrix::Representation output = Matrix::Representation(Rows(l.num_rows()), Columns(r.num_cols()));
+                    BasicRepresentation<T> output = BasicRepresentation<T>(Rows(l.num_rows()), Columns(r.num_cols()));
 
 
                     cilk_for (u_int64_t i = 0; i < l.num_rows(); i++) {
@@ -447,7 +623,7 @@ namespace Matrix {
                         for (u_int64_t j = 0; j < r.num_cols(); j++) {
 
 
-                            float val = 0;
+                            T val = 0;
 
                             for (u_int64_t k = 0; k < l.num_cols(); k++) {
                                 val += l.get(i, k) * r.get(k, j);
@@ -461,7 +637,7 @@ namespace Matrix {
 
 
 
-                    return Matrix::Representation{output};
+                    return BasicRepresentation<T>{output};
                 }
         
             } // namespace Multiplication
@@ -472,3 +648,40 @@ namespace Matrix {
 
 } // namespace Matrix
 
+
+/*
+    Every operation is compiled once per element type, a precision
+    is a different overload rather than a branch inside the kernel.
+*/
+#define MATRIX_OPERATIONS(T) \
+    template BasicRepresentation<T> Unary::ReLU::operate(const BasicRepresentation<T>&) const noexcept; \
+    template BasicRepresentation<T> Unary::Sign::operate(const BasicRepresentation<T>&) const noexcept; \
+    template BasicRepresentation<T> Unary::SoftMax::operate(const BasicRepresentation<T>&) const noexcept; \
+    template BasicRepresentation<T> Unary::Transpose::operate(const BasicRepresentation<T>&) const noexcept; \
+    template BasicRepresentation<T> Unary::SumRows::operate(const BasicRepresentation<T>&) const noexcept; \
+    template void Unary::transpose_helper(const T*, T*, int, int, int, int, int, int) noexcept; \
+    template BasicRepresentation<T> Metric::CrossEntropy::operate(const BasicRepresentation<T>&, const BasicRepresentation<T>&) const noexcept; \
+    template BasicRepresentation<T> Binary::reduce_to_shape(const BasicRepresentation<T>&, Rows, Columns) noexcept; \
+    template void Binary::accumulate(BasicRepresentation<T>&, const BasicRepresentation<T>&) noexcept; \
+    template BasicRepresentation<T> Binary::Addition::Std::operate(const BasicRepresentation<T>&, const BasicRepresentation<T>&) const noexcept; \
+    template BasicRepresentation<T> Binary::Subtraction::Std::operate(const BasicRepresentation<T>&, const BasicRepresentation<T>&) const noexcept; \
+    template BasicRepresentation<T> Binary::OuterProduct::Naive::operate(const BasicRepresentation<T>&, const BasicRepresentation<T>&) const noexcept; \
+    template BasicRepresentation<T> Binary::HadamardProduct::Naive::operate(const BasicRepresentation<T>&, const BasicRepresentation<T>&) const noexcept; \
+    template BasicRepresentation<T> Binary::HadamardProduct::Std::operate(const BasicRepresentation<T>&, const BasicRepresentation<T>&) const noexcept; \
+    template BasicRepresentation<T> Binary::Multiplication::Naive::operate(const BasicRepresentation<T>&, const BasicRepresentation<T>&) const noexcept; \
+    template BasicRepresentation<T> Binary::Multiplication::Square::operate(const BasicRepresentation<T>&, const BasicRepresentation<T>&) const noexcept; \
+    template BasicRepresentation<T> Binary::Multiplication::ParallelDNC::operate(const BasicRepresentation<T>&, const BasicRepresentation<T>&) const noexcept; \
+    template void Binary::Multiplication::add_matmul_rec(const T*, const T*, T*, int, int, int, int, int, int) noexcept;
+
+namespace Matrix {
+
+    namespace Operations {
+
+        MATRIX_OPERATIONS(float)
+        MATRIX_OPERATIONS(double)
+
+    }
+
+}
+
+#undef MATRIX_OPERATIONS
@@ -6,53 +6,68 @@
 #include "functions.h"
 
 
-bool Matrix::Representation::operator==(const Matrix::Representation _other) noexcept {
+template <Matrix::MatrixElement T>
+bool Matrix::BasicRepresentation<T>::operator==(const Matrix::BasicRepresentation<T> _other) noexcept {
 
 
-    bool isEqual = this->data.size() == _other.data.size();
+    bool isEqual = this->size() == _other.size();
     
-    for (size_t i = 0; isEqual && i < this->data.size(); i++) {
-        isEqual = Functions::Utility::compare_float(this->data.at(i), _other.data.at(i));
+    auto l = this->constScanStart();
+    auto r = _other.constScanStart();
+
+    for (size_t i = 0; isEqual && i < this->size(); i++) {
+        isEqual = Functions::Utility::compare_float(*(l + i), *(r + i));
     }
 
     return isEqual;
 }
 
 
-bool Matrix::Representation::operator!=(const Matrix::Representation _other) noexcept {
+template <Matrix::MatrixElement T>
+bool Matrix::BasicRepresentation<T>::operator!=(const Matrix::BasicRepresentation<T> _other) noexcept {
     
-    bool isEqual = this->data.size() == _other.data.size();    
+    bool isEqual = this->size() == _other.size();    
+
+    auto l = this->constScanStart();
+    auto r = _other.constScanStart();
 
-    for (size_t i = 0; isEqual && i < this->data.size(); i++) {
-        isEqual = Functions::Utility::compare_float(this->data.at(i), _other.data.at(i));
+    for (size_t i = 0; isEqual && i < this->size(); i++) {
+        isEqual = Functions::Utility::compare_float(*(l + i), *(r + i));
     }
 
     return !isEqual;
 }
 
-float Matrix::Representation::get(u_int64_t r, u_int64_t c) const noexcept {
+template <Matrix::MatrixElement T>
+T Matrix::BasicRepresentation<T>::get(u_int64_t r, u_int64_t c) const noexcept {
 
     assert(r <= rows && c <= columns && "Invalid Matrix Index.");
 
     uint64_t calculated_index = c + r * columns; 
 
-    return data.at(calculated_index);
+    assert(calculated_index < size());
+
+    return *(constScanStart() + calculated_index);
 
 }
 
 
-void Matrix::Representation::put(u_int64_t r, u_int64_t c, float val) noexcept {
+template <Matrix::MatrixElement T>
+void Matrix::BasicRepresentation<T>::put(u_int64_t r, u_int64_t c, T val) noexcept {
 
     assert(r <= rows && c <= columns && "Invalid Matrix Index.");
 
     uint64_t calculated_index = c + r * columns; 
 
-    data.at(calculated_index) = val;
+    assert(calculated_index < size());
+
+    *(scanStart() + calculated_index) = val;
 
 }
 
 
-Matrix::Representation::Type Matrix::Representation::get_type(void) const noexcept {
+template <Matrix::MatrixElement T>
+typename Matrix::BasicRepresentation<T>::Type Matrix::BasicRepresentation<T>::get_type(void) const noexcept {
     bool is_row_vector    = rows    == 1; 
     bool is_column_vector = columns == 1;
     bool is_scalar        = is_row_vector && is_column_vector;
@@ -69,7 +84,8 @@ Matrix::Representation::Type Matrix::Representation::get_type(void) const noexce
 }
 
 
-std::string_view Matrix::Representation::get_type_string(void) const noexcept {
+template <Matrix::MatrixElement T>
+std::string_view Matrix::BasicRepresentation<T>::get_type_string(void) const noexcept {
     bool is_row_vector    = rows    == 1; 
     bool is_column_vector = columns == 1;
     bool is_scalar        = is_row_vector && is_column_vector;
@@ -86,6 +102,7 @@ std::string_view Matrix::Representation::get_type_string(void) const noexcept {
 }
 
 
-
-
-
+template class Matrix::BasicRepresentation<float>;
+template class Matrix::BasicRepresentation<double>;
+template class Matrix::BasicRepresentation<Matrix::bfloat16>;
+template class Matrix::BasicRepresentation<Matrix::float16>;
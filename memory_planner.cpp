@@ -0,0 +1,296 @@
+#include "memory_planner.h"
+#include "tensor.h"
+#include "function_object.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <numeric>
+#include <unordered_map>
+#include <unordered_set>
+
+#include <assert.h>
+
+
+namespace NeuralNetwork {
+
+    namespace Computation {
+
+        namespace Graph {
+
+
+            namespace {
+
+                constexpr size_t align_up(size_t bytes, size_t alignment) noexcept {
+                    return (bytes + alignment - 1) / alignment * alignment;
+                }
+
+                constexpr bool overlaps(const BufferLifetime& a, const BufferLifetime& b) noexcept {
+                    return a.first_use <= b.last_use && b.first_use <= a.last_use;
+                }
+
+            }
+
+
+            MemoryPlan MemoryPlanner::analyse(Tensor& root) noexcept {
+
+                ComputationalGraphMap& map = root.get_context();
+
+                MemoryPlan plan;
+                plan.context = &map;
+
+                auto order = map._topological_order(root.get_tensor_id());
+                const size_t N = order.size();
+
+                std::unordered_map<u_int16_t, size_t> position;
+                for (size_t i = 0; i < N; i++) position[order[i].get()] = i;
+
+                auto backward_step = [N](size_t forward_position) {
+                    return N + (N - 1 - forward_position);
+                };
+
+                /*
+                    For every tensor, its consumers and whether each
+                    consumer's backward rule re-reads its matrix.
+                */
+                std::unordered_map<u_int16_t, std::vector<std::pair<size_t, bool>>> consumers;
+                std::unordered_set<u_int16_t> leaves;
+
+                for (size_t i = 0; i < N; i++) {
+
+                    auto operation = map._get_operation(order[i]);
+                    auto operands  = operation.serialize();
+                    auto usage     = operation.operand_usage();
+
+                    if (!operands[1] && !operands[2]) leaves.insert(order[i].get());
+
+                    if (operands[1]) consumers[operands[1]->get()].emplace_back(i, usage.left_matrix);
+                    if (operands[2]) consumers[operands[2]->get()].emplace_back(i, usage.right_matrix);
+                }
+
+
+                // Creation stamp of every operation output, and the intermediate it plans if any.
+                std::vector<std::pair<u_int64_t, size_t>> created;
+
+                for (size_t i = 0; i < N; i++) {
+
+                    TensorID tid = order[i];
+                    auto tensor  = map._get_tensor(tid);
+                    auto& matrix = tensor->release_matrix();
+                    size_t bytes = matrix.bytes();
+
+                    bool is_root  = tid == root.get_tensor_id();
+                    bool is_leaf  = leaves.contains(tid.get());
+                    u_int64_t stamp = map._creation_stamp(tid);
+
+                    if (is_root || is_leaf || !stamp) {
+                        if (stamp) created.emplace_back(stamp, MemoryPlan::UNPLANNED);
+                        plan.persistent_bytes += is_root ? bytes : 2 * bytes;
+                        continue;
+                    }
+
+                    created.emplace_back(stamp, plan.lifetimes.size() / 2);
+
+                    BufferLifetime activation{tid, BufferKind::ACTIVATION,
+                        matrix.num_rows(), matrix.num_cols(), bytes, i, i, 0, 0};
+                    BufferLifetime gradient{tid, BufferKind::GRADIENT,
+                        matrix.num_rows(), matrix.num_cols(), bytes, 2 * N, backward_step(i), 0, 0};
+
+                    for (auto [consumer, reads_matrix]: consumers[tid.get()]) {
+                        activation.last_use = std::max(activation.last_use,
+                            reads_matrix ? backward_step(consumer) : consumer);
+                        gradient.first_use  = std::min(gradient.first_use, backward_step(consumer));
+                    }
+
+                    assert(gradient.first_use <= gradient.last_use && "Gradient consumed before written.");
+
+                    plan.lifetimes.push_back(activation);
+                    plan.lifetimes.push_back(gradient);
+                }
+
+                std::sort(created.begin(), created.end());
+                for (auto [stamp, intermediate]: created) plan.creation_order.push_back(intermediate);
+
+                _assign_offsets(plan);
+
+                return plan;
+            }
+
+
+            /*
+                Greedy by size: place the largest buffers first at the
+                lowest offset that does not collide with any already placed
+                buffer whose live interval overlaps.
+            */
+            void MemoryPlanner::_assign_offsets(MemoryPlan& plan) const noexcept {
+
+                auto& lifetimes = plan.lifetimes;
+
+                std::vector<size_t> by_size(lifetimes.size());
+                std::iota(by_size.begin(), by_size.end(), 0);
+                std::stable_sort(by_size.begin(), by_size.end(), [&lifetimes](size_t a, size_t b) {
+                    return lifetimes[a].bytes > lifetimes[b].bytes;
+                });
+
+                std::vector<std::vector<size_t>> placed;
+
+                for (size_t idx: by_size) {
+
+                    auto& buffer   = lifetimes[idx];
+                    size_t aligned = align_up(buffer.bytes, MemoryPlan::ALIGNMENT);
+                    bool assigned  = false;
+
+                    for (size_t s = 0; s < placed.size() && !assigned; s++) {
+
+                        std::vector<size_t> conflicts;
+                        std::copy_if(placed[s].begin(), placed[s].end(), std::back_inserter(conflicts),
+                            [&](size_t other) { return overlaps(buffer, lifetimes[other]); });
+                        std::sort(conflicts.begin(), conflicts.end(), [&lifetimes](size_t a, size_t b) {
+                            return lifetimes[a].offset < lifetimes[b].offset;
+                        });
+
+                        size_t candidate = 0;
+                        for (size_t other: conflicts) {
+                            if (candidate + aligned <= lifetimes[other].offset) break;
+                            candidate = std::max(candidate,
+                                align_up(lifetimes[other].offset + lifetimes[other].bytes, MemoryPlan::ALIGNMENT));
+                        }
+
+                        if (max_slab_bytes && candidate + aligned > max_slab_bytes) continue;
+
+                        buffer.slab   = s;
+                        buffer.offset = candidate;
+                        placed[s].push_back(idx);
+                        plan.slab_bytes[s] = std::max(plan.slab_bytes[s], candidate + aligned);
+                        assigned = true;
+                    }
+
+                    if (!assigned) {
+                        buffer.slab   = placed.size();
+                        buffer.offset = 0;
+                        placed.push_back({idx});
+                        plan.slab_bytes.push_back(aligned);
+                    }
+                }
+            }
+
+
+            MemoryPlan::Replay::Replay(MemoryPlan& _plan) noexcept : plan(_plan) {
+
+                assert(plan.context && "Plan was not produced by MemoryPlanner::analyse.");
+
+                // Allocated before the first replayed forward, while nothing else of the step is alive.
+                if (plan.slabs.empty()) {
+                    for (size_t bytes: plan.slab_bytes) {
+                        plan.slabs.emplace_back(std::aligned_alloc(ALIGNMENT, align_up(bytes, ALIGNMENT)), std::free);
+                    }
+                }
+
+                plan.next     = 0;
+                plan.taken    = 0;
+                plan.diverged = false;
+
+                previous = plan.context->_replaying();
+                plan.context->_replay(&plan);
+            }
+
+
+            MemoryPlan::Replay::~Replay() noexcept {
+                plan.context->_replay(previous);
+            }
+
+
+            Matrix::Representation MemoryPlan::_slot(const BufferLifetime& _buffer) const noexcept {
+
+                float* base = reinterpret_cast<float*>(static_cast<char*>(slabs[_buffer.slab].get()) + _buffer.offset);
+
+                return Matrix::Representation::view_of(
+                    Matrix::Rows(_buffer.rows), Matrix::Columns(_buffer.columns), base, slabs[_buffer.slab]);
+            }
+
+
+            bool MemoryPlan::_take(u_int64_t _rows, u_int64_t _columns,
+                Matrix::Representation& _activation, Matrix::Representation& _gradient) noexcept {
+
+                if (diverged || next >= creation_order.size()) return false;
+
+                const size_t intermediate = creation_order[next++];
+
+                if (intermediate == UNPLANNED) return false;
+
+                const auto& activation = lifetimes[2 * intermediate];
+
+                if (activation.rows != _rows || activation.columns != _columns) {
+                    diverged = true;
+                    return false;
+                }
+
+                _activation = _slot(activation);
+                _gradient   = _slot(lifetimes[2 * intermediate + 1]);
+                taken++;
+
+                return true;
+            }
+
+
+            size_t MemoryPlan::planned_peak_bytes() const noexcept {
+
+                size_t largest = 0;
+                for (const auto& buffer: lifetimes) largest = std::max(largest, buffer.bytes);
+
+                return persistent_bytes + largest + std::accumulate(slab_bytes.begin(), slab_bytes.end(), size_t{0});
+            }
+
+
+            /*
+                Sweeps the step's timeline: unplanned, an activation lives
+                from its forward step until its own backward rule releases
+                it, the same step its gradient dies.
+            */
+            size_t MemoryPlan::unplanned_peak_bytes() const noexcept {
+
+                std::vector<std::pair<size_t, long long>> events;
+
+                for (size_t j = 0; 2 * j + 1 < lifetimes.size(); j++) {
+
+                    const auto& activation = lifetimes[2 * j];
+                    const auto& gradient   = lifetimes[2 * j + 1];
+
+                    events.emplace_back(activation.first_use, (long long) activation.bytes);
+                    events.emplace_back(gradient.last_use + 1, -(long long) activation.bytes);
+                    events.emplace_back(gradient.first_use, (long long) gradient.bytes);
+                    events.emplace_back(gradient.last_use + 1, -(long long) gradient.bytes);
+                }
+
+                // Releases first at a step, so a buffer freed as another is born is not counted twice.
+                std::sort(events.begin(), events.end());
+
+                long long live = 0, peak = 0;
+                for (auto [step, delta]: events) {
+                    live += delta;
+                    peak = std::max(peak, live);
+                }
+
+                return persistent_bytes + size_t(peak);
+            }
+
+
+            void MemoryPlan::report() const noexcept {
+
+                auto unplanned = unplanned_peak_bytes();
+                auto planned   = planned_peak_bytes();
+
+                std::cout << "Memory Plan: " << lifetimes.size() << " buffers in "
+                          << slab_bytes.size() << " slabs" << std::endl;
+                std::cout << "\t Peak without the plan (bytes): "  << unplanned << std::endl;
+                std::cout << "\t Peak of a replayed step (bytes): " << planned   << std::endl;
+                std::cout << "\t Peak reduction (%): "
+                          << (unplanned > planned ? 100.0 * (unplanned - planned) / unplanned : 0.0) << std::endl;
+            }
+
+
+        }
+
+    }
+
+}
@@ -5,6 +5,10 @@
 #include "tensor_forward_wrapper.h"
 #include "network_layer.h" 
 #include "m_algorithms.h"
+#include "parameter_buffer.h"
+#include "checkpoint.h"
+#include "sparse.h"
+#include "decomposition.h"
 // #include "matrix_printer.h"
 #include "matrix_benchmark.h"
 #include "config.h"
@@ -30,6 +34,90 @@ namespace NeuralNetwork {
     }
 
 
+    std::shared_ptr<Tensor> MatrixMultiplyStep::_doForward(std::shared_ptr<Tensor> input, InferenceTag _tag) noexcept {
+
+        TensorOp mm(Matrix::Operations::Binary::Multiplication::ParallelDNC{});
+
+        return mm(_tag, input, this->matrix);
+    }
+
+
+
+    std::shared_ptr<Tensor> StepInterface::forward_sparse(std::shared_ptr<const Matrix::SparseRepresentation> input) noexcept {
+        return this->forward(TensorConstructor::create(input->to_dense()));
+    }
+
+
+    /*
+        The sparse input is not a tensor, the output is recorded with
+        the input held by the weight's graph context until the reverse
+        pass has used it.
+    */
+    std::shared_ptr<Tensor> MatrixMultiplyStep::forward_sparse(std::shared_ptr<const Matrix::SparseRepresentation> input) noexcept {
+
+        assert(input != nullptr && "Sparse input has no data (pointing to null).");
+
+        auto out_matrix = Matrix::Operations::Sparse::multiply(*input, this->matrix->release_matrix());
+
+        ComputationalGraphMap& map = this->matrix->get_context();
+
+        if (!map.is_grad_enabled()) {
+            return std::make_shared<Tensor>(map, std::move(out_matrix));
+        }
+
+        ComputationalGraphMap::Bind bind(map);
+
+        auto out = TensorConstructor::create(std::move(input), std::move(out_matrix),
+            this->matrix->get_tensor_id(), IsRecordable(this->matrix->is_recorded()));
+        this->matrix->become_parent();
+
+        return out;
+    }
+
+
+    LowRankLinearStep::LowRankLinearStep(const Matrix::Representation& _weights, u_int64_t _rank) noexcept {
+
+        auto svd = Matrix::Operations::Decomposition::randomized_svd(_weights, _rank);
+
+        for (u_int64_t i = 0; i < svd.U.num_rows(); i++) {
+            for (u_int64_t r = 0; r < _rank; r++) svd.U.put(i, r, svd.U.get(i, r) * svd.S[r]);
+        }
+
+        error = Matrix::Operations::Decomposition::relative_error(_weights, svd.U, svd.V);
+
+        left  = TensorConstructor::create(std::move(svd.U), IsTrackable(true), IsLeaf(true));
+        right = TensorConstructor::create(std::move(svd.V), IsTrackable(true), IsLeaf(true));
+    }
+
+
+    std::shared_ptr<Tensor> LowRankLinearStep::doForward(std::shared_ptr<Tensor> input) noexcept {
+
+        TensorOp mm(Matrix::Operations::Binary::Multiplication::ParallelDNC{});
+
+        return mm(mm(input, left), right);
+    }
+
+
+    std::shared_ptr<Tensor> LowRankLinearStep::doForward(std::shared_ptr<Tensor> input, InferenceTag _tag) noexcept {
+
+        TensorOp mm(Matrix::Operations::Binary::Multiplication::ParallelDNC{});
+
+        return mm(_tag, mm(_tag, input, left), right);
+    }
+
+
+    void LowRankLinearStep::collect_parameters(std::vector<std::shared_ptr<Tensor>>& _params) noexcept {
+        _params.push_back(left);
+        _params.push_back(right);
+    }
+
+
+    // Two MATRIX_MULTIPLY kernels, the engine runs the factors as consecutive skinny products.
+    void LowRankLinearStep::collect_kernels(std::vector<KernelSpec>& _kernels) noexcept {
+        _kernels.push_back({KernelSpec::Op::MATRIX_MULTIPLY, left});
+        _kernels.push_back({KernelSpec::Op::MATRIX_MULTIPLY, right});
+    }
+
 
     std::shared_ptr<Tensor> AddStep::_doForward(std::shared_ptr<Tensor> input) noexcept {
 
@@ -48,6 +136,14 @@ namespace NeuralNetwork {
     }
 
 
+    std::shared_ptr<Tensor> AddStep::_doForward(std::shared_ptr<Tensor> input, InferenceTag _tag) noexcept {
+
+        TensorOp add(Matrix::Operations::Binary::Addition::Std{});
+
+        return add(_tag, this->matrix, input);
+    }
+
+
     std::shared_ptr<Tensor> Layer::doForward(std::shared_ptr<Tensor> input) noexcept {
 
 
@@ -60,6 +156,16 @@ namespace NeuralNetwork {
     }
 
 
+    std::shared_ptr<Tensor> Layer::doForward(std::shared_ptr<Tensor> input, InferenceTag _tag) noexcept {
+        return this->bias->forward(this->weights->forward(input, _tag), _tag);
+    }
+
+
+    std::shared_ptr<Tensor> Layer::forward_sparse(std::shared_ptr<const Matrix::SparseRepresentation> input) noexcept {
+        return this->bias->forward(this->weights->forward_sparse(std::move(input)));
+    }
+
+
     void Layer::_add(std::unique_ptr<StepInterface> matrix) noexcept {
 
 
@@ -73,11 +179,88 @@ namespace NeuralNetwork {
     }
 
 
+    void Layer::collect_parameters(std::vector<std::shared_ptr<Tensor>>& _params) noexcept {
+        this->weights->collect_parameters(_params);
+        this->bias->collect_parameters(_params);
+    }
+
+
+    void Layer::collect_kernels(std::vector<KernelSpec>& _kernels) noexcept {
+        this->weights->collect_kernels(_kernels);
+        this->bias->collect_kernels(_kernels);
+    }
+
+
     std::shared_ptr<Tensor> Sequential::doForward(std::shared_ptr<Tensor> input) noexcept {
+        return this->_forward_from(input, 0);
+    }
+
+
+    // No segments, checkpointing only matters to a recorded forward.
+    std::shared_ptr<Tensor> Sequential::doForward(std::shared_ptr<Tensor> input, InferenceTag _tag) noexcept {
 
         std::shared_ptr<Tensor> current_value = input;
 
-        std::for_each(this->_modules.begin(), this->_modules.end(), 
+        for (auto& _layer: this->_modules) current_value = _layer->forward(current_value, _tag);
+
+        return current_value;
+    }
+
+
+    /*
+        Only the first module sees the sparse input, it is never
+        part of a checkpointed segment.
+    */
+    std::shared_ptr<Tensor> Sequential::forward_sparse(std::shared_ptr<const Matrix::SparseRepresentation> input) noexcept {
+
+        assert(!this->_modules.empty() && "Model has no modules.");
+
+        return this->_forward_from(this->_modules.front()->forward_sparse(std::move(input)), 1);
+    }
+
+
+    std::shared_ptr<Tensor> Sequential::_forward_from(std::shared_ptr<Tensor> input, size_t begin) noexcept {
+
+        if (this->segment_size == 0 || !input->get_context().is_grad_enabled()) {
+            return this->_forward_segment(input, begin, this->_modules.size());
+        }
+
+        std::shared_ptr<Tensor> current_value = input;
+
+        for (size_t first = begin; first < this->_modules.size(); first += this->segment_size) {
+
+            size_t last = std::min(first + this->segment_size, this->_modules.size());
+
+            auto segment = [this, first, last](std::shared_ptr<Tensor> _input) {
+                return this->_forward_segment(_input, first, last);
+            };
+
+            auto out = segment(current_value);
+
+            ComputationalGraphMap::Bind bind(current_value->get_context());
+
+            auto boundary = TensorConstructor::create(
+                std::move(segment), 
+                out->release_matrix(), 
+                current_value->get_tensor_id(), 
+                IsRecordable(current_value->is_recorded()));
+            current_value->become_parent();
+
+            current_value->get_context()._detach_subgraph(
+                out->get_tensor_id(), current_value->get_tensor_id());
+
+            current_value = boundary;
+        }
+
+        return current_value;
+    }
+
+
+    std::shared_ptr<Tensor> Sequential::_forward_segment(std::shared_ptr<Tensor> input, size_t first, size_t last) noexcept {
+
+        std::shared_ptr<Tensor> current_value = input;
+
+        std::for_each(this->_modules.begin() + first, this->_modules.begin() + last, 
             [&current_value](std::unique_ptr<StepInterface>& _layer){
 
                 current_value = _layer->forward(current_value);
@@ -92,4 +275,104 @@ namespace NeuralNetwork {
         this->_modules.emplace_back(std::move(layer));
     }
 
-}
\ No newline at end of file
+
+    void Sequential::collect_parameters(std::vector<std::shared_ptr<Tensor>>& _params) noexcept {
+        for (auto& _layer: this->_modules) _layer->collect_parameters(_params);
+    }
+
+
+    void Sequential::collect_kernels(std::vector<KernelSpec>& _kernels) noexcept {
+        for (auto& _layer: this->_modules) _layer->collect_kernels(_kernels);
+    }
+
+
+    std::vector<std::shared_ptr<Tensor>> Sequential::parameters() noexcept {
+        std::vector<std::shared_ptr<Tensor>> _params;
+        this->collect_parameters(_params);
+        return _params;
+    }
+
+
+    std::shared_ptr<ParameterBuffer> Sequential::flatten() noexcept {
+        this->flat = std::make_shared<ParameterBuffer>(this->parameters());
+        return this->flat;
+    }
+
+
+    void Sequential::accumulate_gradients(bool _accumulate) noexcept {
+        for (auto& param: this->parameters()) param->set_accumulate_grad(_accumulate);
+    }
+
+
+    void Sequential::zero_grad() noexcept {
+
+        if (this->flat) {
+            this->flat->zero_grad();
+            return;
+        }
+
+        for (auto& param: this->parameters()) param->zero_grad();
+    }
+
+
+    std::shared_ptr<ParameterBuffer> Sequential::flatten(const ParameterBuffer& _shared_weights) noexcept {
+        this->flat = std::make_shared<ParameterBuffer>(this->parameters(), _shared_weights);
+        return this->flat;
+    }
+
+
+
+    std::vector<Serialization::CheckpointEntry> Sequential::describe() noexcept {
+
+        std::vector<Serialization::CheckpointEntry> entries;
+
+        for (size_t m = 0; m < this->_modules.size(); m++) {
+
+            std::vector<std::shared_ptr<Tensor>> _params;
+            this->_modules[m]->collect_parameters(_params);
+
+            for (auto& param: _params) {
+                auto& matrix = param->release_matrix();
+                entries.push_back({m, matrix.num_rows(), matrix.num_cols(), 0});
+            }
+        }
+
+        Serialization::assign_offsets(entries);
+        return entries;
+    }
+
+
+    bool Sequential::save(const std::string& _path) noexcept {
+
+        auto entries = this->describe();
+
+        if (this->flat) {
+            return Serialization::write_checkpoint(_path, this->_modules.size(), entries,
+                this->flat->weights(), this->flat->size());
+        }
+
+        auto params = this->parameters();
+        std::vector<float> image(Serialization::assign_offsets(entries), 0);
+
+        for (size_t i = 0; i < params.size(); i++) {
+            auto& matrix = params[i]->release_matrix();
+            std::copy(matrix.constScanStart(), matrix.constScanEnd(), image.begin() + entries[i].offset);
+        }
+
+        return Serialization::write_checkpoint(_path, this->_modules.size(), entries, image.data(), image.size());
+    }
+
+
+    bool Sequential::load(const std::string& _path) noexcept {
+
+        Serialization::MappedCheckpoint checkpoint(_path);
+
+        if (!checkpoint.is_open() ||
+            checkpoint.modules() != this->_modules.size() ||
+            checkpoint.entries() != this->describe()) return false;
+
+        this->flat = std::make_shared<ParameterBuffer>(this->parameters(), checkpoint.weights());
+        return true;
+    }
+
+}
@@ -0,0 +1,125 @@
+#include "optimizer.h"
+
+#include <cilk/cilk.h>
+#include <algorithm>
+#include <math.h>
+
+
+namespace NeuralNetwork {
+
+    namespace Optimization {
+
+        namespace Kernels {
+
+            namespace {
+
+                /*
+                    Elements per cilk_for iteration. Large enough to amortize
+                    the spawn and let the inner loop vectorize, small enough
+                    to load balance layers of a few thousand weights.
+                */
+                constexpr size_t BLOCK = 2048;
+
+                constexpr size_t blocks(size_t n) noexcept { return (n + BLOCK - 1) / BLOCK; }
+
+            }
+
+
+            void sgd(float* __restrict w, const float* __restrict g, size_t n,
+                const SGDParameters& p) noexcept {
+
+                const float lr = p.learning_rate;
+                const float wd = p.weight_decay;
+
+                cilk_for (size_t b = 0; b < blocks(n); b++) {
+
+                    const size_t end = std::min(n, (b + 1) * BLOCK);
+
+                    for (size_t i = b * BLOCK; i < end; i++) {
+                        w[i] -= lr * (g[i] + wd * w[i]);
+                    }
+                }
+            }
+
+
+            void sgd_momentum(float* __restrict w, const float* __restrict g, float* __restrict velocity,
+                size_t n, const SGDParameters& p) noexcept {
+
+                const float lr = p.learning_rate;
+                const float mu = p.momentum;
+                const float wd = p.weight_decay;
+
+                // Nesterov steps along g' + μv, heavy ball along v.
+                const float grad_coefficient     = p.nesterov ? 1 : 0;
+                const float velocity_coefficient = p.nesterov ? mu : 1;
+
+                cilk_for (size_t b = 0; b < blocks(n); b++) {
+
+                    const size_t end = std::min(n, (b + 1) * BLOCK);
+
+                    for (size_t i = b * BLOCK; i < end; i++) {
+                        float grad  = g[i] + wd * w[i];
+                        float v     = mu * velocity[i] + grad;
+                        velocity[i] = v;
+                        w[i] -= lr * (grad_coefficient * grad + velocity_coefficient * v);
+                    }
+                }
+            }
+
+
+            void adam(float* __restrict w, const float* __restrict g, float* __restrict m, float* __restrict v,
+                size_t n, const AdamParameters& p, u_int64_t step) noexcept {
+
+                assert(step > 0 && "Adam step count starts at one.");
+
+                const float b1 = p.beta1;
+                const float b2 = p.beta2;
+                const float eps = p.epsilon;
+
+                // Bias corrections folded into the step size and epsilon.
+                const float correction1 = 1 - powf(b1, static_cast<float>(step));
+                const float correction2 = 1 - powf(b2, static_cast<float>(step));
+                const float step_size   = p.learning_rate * sqrtf(correction2) / correction1;
+                const float eps_hat     = eps * sqrtf(correction2);
+
+                const float l2    = p.decoupled_weight_decay ? 0 : p.weight_decay;
+                const float decay = p.decoupled_weight_decay ? 1 - p.learning_rate * p.weight_decay : 1;
+
+                cilk_for (size_t b = 0; b < blocks(n); b++) {
+
+                    const size_t end = std::min(n, (b + 1) * BLOCK);
+
+                    for (size_t i = b * BLOCK; i < end; i++) {
+                        float grad = g[i] + l2 * w[i];
+                        float mi   = b1 * m[i] + (1 - b1) * grad;
+                        float vi   = b2 * v[i] + (1 - b2) * grad * grad;
+                        m[i] = mi;
+                        v[i] = vi;
+                        w[i] = decay * w[i] - step_size * mi / (sqrtf(vi) + eps_hat);
+                    }
+                }
+            }
+
+        }
+
+
+        void SGD::_update(float* w, const float* g, size_t n, ParameterState& state) noexcept {
+
+            if (parameters.momentum == 0) {
+                Kernels::sgd(w, g, n, parameters);
+                return;
+            }
+
+            Kernels::sgd_momentum(w, g, _allocate(state.first_moment, n), n, parameters);
+        }
+
+
+        void Adam::_update(float* w, const float* g, size_t n, ParameterState& state) noexcept {
+
+            Kernels::adam(w, g, _allocate(state.first_moment, n), _allocate(state.second_moment, n),
+                n, parameters, state.steps);
+        }
+
+    }
+
+}
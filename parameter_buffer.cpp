@@ -0,0 +1,178 @@
+#include "parameter_buffer.h"
+#include "tensor.h"
+
+#include <cilk/cilk.h>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#include <assert.h>
+#include <sys/mman.h>
+
+
+namespace NeuralNetwork {
+
+    namespace Computation {
+
+        namespace Graph {
+
+
+            namespace {
+
+                constexpr size_t FLOATS_PER_LINE = ParameterBuffer::ALIGNMENT / sizeof(float);
+
+                constexpr size_t align_up(size_t floats) noexcept {
+                    return (floats + FLOATS_PER_LINE - 1) / FLOATS_PER_LINE * FLOATS_PER_LINE;
+                }
+
+                // Past this, slabs come zeroed from the kernel a page at a time instead of being memset up front.
+                constexpr size_t MAPPED_SLAB_BYTES = 1 << 20;
+
+                std::shared_ptr<void> allocate_slab(size_t floats) noexcept {
+
+                    size_t bytes = std::max(floats, FLOATS_PER_LINE) * sizeof(float);
+
+                    if (bytes >= MAPPED_SLAB_BYTES) {
+
+                        void* address = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+                        assert(address != MAP_FAILED && "Parameter slab allocation failed.");
+
+                        return std::shared_ptr<void>(address, [bytes](void* a) { ::munmap(a, bytes); });
+                    }
+
+                    std::shared_ptr<void> slab(std::aligned_alloc(ParameterBuffer::ALIGNMENT, bytes), std::free);
+
+                    assert(slab && "Parameter slab allocation failed.");
+
+                    std::memset(slab.get(), 0, bytes);
+                    return slab;
+                }
+
+                // A single core cannot saturate memory bandwidth, large copies are split across workers.
+                constexpr size_t COPY_BLOCK = (1 << 20) / sizeof(float);
+
+                void parallel_copy(float* __restrict to, const float* __restrict from, size_t n) noexcept {
+
+                    cilk_for (size_t b = 0; b < (n + COPY_BLOCK - 1) / COPY_BLOCK; b++) {
+
+                        const size_t first = b * COPY_BLOCK;
+                        std::memcpy(to + first, from + first, (std::min(n, first + COPY_BLOCK) - first) * sizeof(float));
+                    }
+                }
+
+                /*
+                    Rebinds target onto the slot. Released first so a target
+                    that is already a view is rebound rather than written
+                    through.
+                */
+                void rebind(Matrix::Representation& target, Matrix::Representation&& slot) noexcept {
+                    target.release();
+                    target = std::move(slot);
+                }
+
+            }
+
+
+            ParameterBuffer::ParameterBuffer(std::vector<std::shared_ptr<Tensor>> _parameters) noexcept :
+                params(std::move(_parameters)) {
+
+                _layout();
+
+                weight_slab   = allocate_slab(total);
+                gradient_slab = allocate_slab(total);
+
+                _bind(true);
+            }
+
+
+            ParameterBuffer::ParameterBuffer(std::vector<std::shared_ptr<Tensor>> _parameters,
+                std::shared_ptr<void> _weights) noexcept :
+                params(std::move(_parameters)) {
+
+                assert(reinterpret_cast<uintptr_t>(_weights.get()) % ALIGNMENT == 0 && "Adopted weights must be aligned.");
+
+                _layout();
+
+                weight_slab   = std::move(_weights);
+                gradient_slab = allocate_slab(total);
+
+                _bind(false);
+            }
+
+
+            ParameterBuffer::ParameterBuffer(std::vector<std::shared_ptr<Tensor>> _parameters,
+                const ParameterBuffer& _shared_weights) noexcept :
+                params(std::move(_parameters)) {
+
+                _layout();
+
+                assert(offsets == _shared_weights.offsets && "Models sharing weights must match layer for layer.");
+
+                weight_slab   = _shared_weights.weight_slab;
+                gradient_slab = allocate_slab(total);
+
+                _bind(false);
+            }
+
+
+            void ParameterBuffer::_layout() noexcept {
+
+                offsets.reserve(params.size());
+
+                for (auto& param: params) {
+                    offsets.push_back(total);
+                    total += align_up(param->release_matrix().size());
+                }
+            }
+
+
+            void ParameterBuffer::_bind(bool _copy_weights) noexcept {
+
+                for (size_t i = 0; i < params.size(); i++) {
+
+                    auto& matrix = params[i]->release_matrix();
+                    auto& grad   = params[i]->get_grad();
+
+                    Matrix::Rows rows(matrix.num_rows());
+                    Matrix::Columns columns(matrix.num_cols());
+
+                    if (_copy_weights) {
+                        std::copy(matrix.constScanStart(), matrix.constScanEnd(), weights() + offsets[i]);
+                    }
+
+                    if (grad.size() == matrix.size()) {
+                        std::copy(grad.constScanStart(), grad.constScanEnd(), gradients() + offsets[i]);
+                    }
+
+                    rebind(matrix, Matrix::Representation::view_of(rows, columns, weights() + offsets[i], weight_slab));
+                    rebind(grad, Matrix::Representation::view_of(rows, columns, gradients() + offsets[i], gradient_slab));
+                }
+            }
+
+
+            void ParameterBuffer::zero_grad() noexcept {
+                std::memset(gradients(), 0, bytes());
+            }
+
+
+            void ParameterBuffer::forget_grad_rows() noexcept {
+                for (auto& param: params) param->forget_grad_rows();
+            }
+
+
+            void ParameterBuffer::snapshot(float* _destination) const noexcept {
+                parallel_copy(_destination, weights(), total);
+            }
+
+
+            void ParameterBuffer::restore(const float* _source) noexcept {
+                parallel_copy(weights(), _source, total);
+            }
+
+
+        }
+
+    }
+
+}
@@ -0,0 +1,87 @@
+#include "pruning.h"
+#include "tensor.h"
+
+#include <cilk/cilk.h>
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+#include <assert.h>
+
+
+namespace NeuralNetwork {
+
+    namespace Inference {
+
+
+        using Block = Matrix::BlockSparseRepresentation;
+
+
+        std::shared_ptr<const Matrix::BlockSparseRepresentation> prune_blocks(Matrix::Representation& _weights, float _sparsity) noexcept {
+
+            assert(_sparsity >= 0 && _sparsity <= 1 && "Sparsity is a fraction of the blocks.");
+
+            const u_int64_t rows    = _weights.num_rows();
+            const u_int64_t columns = _weights.num_cols();
+            const u_int64_t block_rows    = (rows + Block::BLOCK_ROWS - 1) / Block::BLOCK_ROWS;
+            const u_int64_t block_columns = (columns + Block::BLOCK_COLUMNS - 1) / Block::BLOCK_COLUMNS;
+            const u_int64_t total = block_rows * block_columns;
+
+            float* W = _weights.scanStart();
+
+            // Visits the elements of block b, row-major blocks of the block grid.
+            auto for_block = [=](u_int64_t b, auto&& visit) {
+
+                const u_int64_t first_row = (b / block_columns) * Block::BLOCK_ROWS;
+                const u_int64_t first_col = (b % block_columns) * Block::BLOCK_COLUMNS;
+
+                for (u_int64_t i = first_row; i < std::min(rows, first_row + Block::BLOCK_ROWS); i++) {
+                    for (u_int64_t j = first_col; j < std::min(columns, first_col + Block::BLOCK_COLUMNS); j++) visit(W[i * columns + j]);
+                }
+            };
+
+            std::vector<float> scores(total);
+
+            cilk_for (u_int64_t b = 0; b < total; b++) {
+                float sum = 0;
+                for_block(b, [&sum](float w) { sum += w * w; });
+                scores[b] = sum;
+            }
+
+            const u_int64_t pruned = std::min<u_int64_t>(total, std::llround(_sparsity * double(total)));
+
+            // Ties go by position, so exactly `pruned` blocks are cut.
+            std::vector<u_int64_t> order(total);
+            std::iota(order.begin(), order.end(), 0);
+            std::nth_element(order.begin(), order.begin() + pruned, order.end(), [&scores](u_int64_t a, u_int64_t b) {
+                return scores[a] < scores[b] || (scores[a] == scores[b] && a < b);
+            });
+
+            cilk_for (u_int64_t k = 0; k < pruned; k++) {
+                for_block(order[k], [](float& w) { w = 0; });
+            }
+
+            return std::make_shared<const Matrix::BlockSparseRepresentation>(_weights);
+        }
+
+
+        PrunedWeights prune_blocks(Sequential& _model, float _sparsity) noexcept {
+
+            std::vector<KernelSpec> specs;
+            _model.collect_kernels(specs);
+
+            PrunedWeights pruned;
+
+            for (auto& spec: specs) {
+                if (spec.op == KernelSpec::Op::MATRIX_MULTIPLY) {
+                    pruned.push_back(prune_blocks(spec.parameter->release_matrix(), _sparsity));
+                }
+            }
+
+            return pruned;
+        }
+
+
+    }
+
+}
@@ -0,0 +1,366 @@
+#include "quantization.h"
+#include "tensor.h"
+
+#include <cilk/cilk.h>
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include <assert.h>
+
+
+namespace NeuralNetwork {
+
+    namespace Inference {
+
+
+        namespace {
+
+            constexpr u_int64_t LANE = 32;
+            constexpr u_int64_t PARALLEL_WORK = 1 << 18;
+            constexpr u_int64_t OUTPUT_BLOCK  = 64;
+
+            constexpr u_int64_t pad(u_int64_t n) noexcept {
+                return (n + LANE - 1) / LANE * LANE;
+            }
+
+            int32_t clamp_activation(float value) noexcept {
+                return std::clamp<int32_t>(std::lrint(value), 0, ACTIVATION_MAX);
+            }
+
+            // fp32 reference of an affine layer, used to calibrate.
+            void affine_fp32(const float* x, const float* W, const float* b, float* y,
+                u_int64_t in, u_int64_t out, bool relu) noexcept {
+
+                if (b) std::copy(b, b + out, y);
+                else   std::fill(y, y + out, 0.0f);
+
+                for (u_int64_t i = 0; i < in; i++) {
+                    for (u_int64_t j = 0; j < out; j++) y[j] += x[i] * W[i * out + j];
+                }
+
+                if (relu) for (u_int64_t j = 0; j < out; j++) y[j] = std::max(y[j], 0.0f);
+            }
+
+            void softmax(float* y, u_int64_t n) noexcept {
+
+                const float max = *std::max_element(y, y + n);
+
+                std::transform(y, y + n, y, [max](float val) { return std::exp(val - max); });
+
+                const double sum = std::accumulate(y, y + n, 0.0);
+
+                std::transform(y, y + n, y, [sum](float val) { return val / sum; });
+            }
+
+        }
+
+
+        QuantizedMatrix::QuantizedMatrix(const Matrix::Representation& _weights) noexcept :
+            in(_weights.num_rows()), out(_weights.num_cols()), stride(pad(_weights.num_rows())),
+            weights(static_cast<int8_t*>(std::aligned_alloc(LANE, std::max<u_int64_t>(out * stride, LANE))), std::free),
+            scales(out), row_sums(out) {
+
+            assert(weights && "Quantized weight allocation failed.");
+
+            std::fill(weights.get(), weights.get() + out * stride, 0);
+
+            const float* W = _weights.constScanStart();
+
+            cilk_for (u_int64_t j = 0; j < out; j++) {
+
+                float max = 0;
+                for (u_int64_t i = 0; i < in; i++) max = std::max(max, std::abs(W[i * out + j]));
+
+                const float scale = max > 0 ? max / WEIGHT_MAX : 1.0f;
+                int8_t* row = weights.get() + j * stride;
+                int32_t sum = 0;
+
+                for (u_int64_t i = 0; i < in; i++) {
+                    row[i] = std::clamp<int32_t>(std::lrint(W[i * out + j] / scale), -WEIGHT_MAX, WEIGHT_MAX);
+                    sum += row[i];
+                }
+
+                scales[j]   = scale;
+                row_sums[j] = sum;
+            }
+        }
+
+
+        int32_t dot_u8s8(const uint8_t* __restrict x, const int8_t* __restrict w, u_int64_t n) noexcept {
+
+#if defined(__AVX2__)
+            const __m256i ones = _mm256_set1_epi16(1);
+            __m256i acc = _mm256_setzero_si256();
+
+            for (u_int64_t i = 0; i < n; i += LANE) {
+
+                __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(x + i));
+                __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(w + i));
+
+                // 32 u8 x s8 products, summed in pairs to int16, then in pairs to int32.
+                acc = _mm256_add_epi32(acc, _mm256_madd_epi16(_mm256_maddubs_epi16(a, b), ones));
+            }
+
+            __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+            sum = _mm_hadd_epi32(sum, sum);
+            sum = _mm_hadd_epi32(sum, sum);
+
+            return _mm_cvtsi128_si32(sum);
+#else
+            int32_t acc = 0;
+
+            for (u_int64_t i = 0; i < n; i++) acc += int32_t(x[i]) * int32_t(w[i]);
+
+            return acc;
+#endif
+        }
+
+
+        QuantizedInferenceEngine::QuantizedInferenceEngine(Sequential& _model, u_int64_t _input_width,
+            const Matrix::Representation& _calibration) noexcept :
+                in_width(_input_width), out_width(_input_width) {
+
+            std::vector<KernelSpec> specs;
+            _model.collect_kernels(specs);
+
+            u_int64_t width  = in_width;
+            u_int64_t widest = pad(in_width);
+
+            for (size_t i = 0; i < specs.size() && compiled; i++) {
+
+                switch (specs[i].op) {
+
+                    case KernelSpec::Op::MATRIX_MULTIPLY: {
+
+                        auto& W = specs[i].parameter->release_matrix();
+
+                        if (W.num_rows() != width) {
+                            compiled = false;
+                            break;
+                        }
+
+                        Kernel kernel = {Kernel::Op::AFFINE, W.num_cols(), std::make_unique<QuantizedMatrix>(W)};
+                        parameters.push_back(specs[i].parameter);
+
+                        if (i + 1 < specs.size() && specs[i + 1].op == KernelSpec::Op::ADD &&
+                            specs[i + 1].parameter->release_matrix().size() == kernel.width) {
+                            kernel.bias = specs[++i].parameter->release_matrix().constScanStart();
+                            parameters.push_back(specs[i].parameter);
+                        }
+
+                        if (i + 1 < specs.size() && specs[i + 1].op == KernelSpec::Op::RELU) {
+                            kernel.relu = true;
+                            i++;
+                        }
+
+                        width  = kernel.width;
+                        widest = std::max(widest, pad(width));
+                        plan.push_back(std::move(kernel));
+                        break;
+                    }
+
+                    case KernelSpec::Op::RELU:
+                        plan.push_back({Kernel::Op::RELU, width});
+                        break;
+
+                    case KernelSpec::Op::SOFTMAX:
+                        plan.push_back({Kernel::Op::SOFTMAX, width});
+                        break;
+
+                    default:
+                        compiled = false;
+                }
+            }
+
+            out_width = width;
+
+            for (int b = 0; b < 2; b++) {
+                reals[b].assign(widest, 0.0f);
+                quants[b].assign(widest, 0);
+            }
+
+            if (compiled) _calibrate(_calibration);
+        }
+
+
+        u_int64_t QuantizedInferenceEngine::weight_bytes() const noexcept {
+
+            u_int64_t bytes = 0;
+
+            for (const auto& kernel: plan) {
+                if (kernel.matrix) bytes += kernel.matrix->out * kernel.matrix->stride;
+            }
+
+            return bytes;
+        }
+
+
+        /*
+            Runs the samples through the fp32 weights (still those of
+            the model's parameters) and records the range every affine
+            layer's input takes.
+        */
+        void QuantizedInferenceEngine::_calibrate(const Matrix::Representation& _calibration) noexcept {
+
+            assert(_calibration.num_cols() == in_width && "Calibration samples do not match the model's input.");
+
+            std::vector<float> minimum(plan.size(), 0.0f), magnitude(plan.size(), 0.0f);
+            std::vector<float> x(reals[0].size()), y(reals[0].size());
+
+            for (u_int64_t s = 0; s < _calibration.num_rows(); s++) {
+
+                std::copy(_calibration.constScanStart() + s * in_width,
+                          _calibration.constScanStart() + (s + 1) * in_width, x.begin());
+
+                u_int64_t width = in_width;
+                size_t parameter = 0;
+
+                for (size_t k = 0; k < plan.size(); k++) {
+
+                    auto& kernel = plan[k];
+
+                    if (kernel.op == Kernel::Op::AFFINE) {
+
+                        for (u_int64_t i = 0; i < width; i++) {
+                            minimum[k]   = std::min(minimum[k], x[i]);
+                            magnitude[k] = std::max(magnitude[k], std::abs(x[i]));
+                        }
+
+                        const float* W = parameters[parameter++]->release_matrix().constScanStart();
+                        if (kernel.bias) parameter++;
+
+                        affine_fp32(x.data(), W, kernel.bias, y.data(), width, kernel.width, kernel.relu);
+                        std::swap(x, y);
+                        width = kernel.width;
+                    }
+                    else if (kernel.op == Kernel::Op::RELU) {
+                        for (u_int64_t i = 0; i < width; i++) x[i] = std::max(x[i], 0.0f);
+                    }
+                    else {
+                        softmax(x.data(), width);
+                    }
+                }
+            }
+
+            for (size_t k = 0; k < plan.size(); k++) {
+
+                if (plan[k].op != Kernel::Op::AFFINE) continue;
+
+                const bool is_signed = minimum[k] < 0;
+                const int32_t levels = is_signed ? ACTIVATION_MAX - SIGNED_ZERO_POINT : ACTIVATION_MAX;
+
+                plan[k].input_zero_point = is_signed ? SIGNED_ZERO_POINT : 0;
+                plan[k].input_scale      = magnitude[k] > 0 ? magnitude[k] / levels : 1.0f;
+            }
+        }
+
+
+        void QuantizedInferenceEngine::_quantize(const float* _x, const Kernel& _kernel, uint8_t* _q) const noexcept {
+
+            const float inverse = 1.0f / _kernel.input_scale;
+
+            for (u_int64_t i = 0; i < _kernel.matrix->in; i++) {
+                _q[i] = clamp_activation(_x[i] * inverse + _kernel.input_zero_point);
+            }
+        }
+
+
+        /*
+            One int32 dot product per output, then in the same pass:
+            dequantize, bias, ReLU and either the fp32 result or, when
+            an affine layer follows, its requantized u8 input.
+        */
+        void QuantizedInferenceEngine::_affine(const uint8_t* _x, const Kernel& _kernel, const Kernel* _next,
+            float* _y, uint8_t* _q) const noexcept {
+
+            const QuantizedMatrix& m = *_kernel.matrix;
+
+            const float next_inverse = _next ? 1.0f / _next->input_scale : 0.0f;
+            const int32_t next_zero_point = _next ? _next->input_zero_point : 0;
+
+            auto outputs = [&](u_int64_t first, u_int64_t last) {
+
+                for (u_int64_t j = first; j < last; j++) {
+
+                    int32_t acc = dot_u8s8(_x, m.weights.get() + j * m.stride, m.stride);
+
+                    float y = (acc - _kernel.input_zero_point * m.row_sums[j]) * (_kernel.input_scale * m.scales[j]);
+
+                    if (_kernel.bias) y += _kernel.bias[j];
+                    if (_kernel.relu) y = std::max(y, 0.0f);
+
+                    if (_next) _q[j] = clamp_activation(y * next_inverse + next_zero_point);
+                    else       _y[j] = y;
+                }
+            };
+
+            if (m.in * m.out < PARALLEL_WORK) {
+                outputs(0, m.out);
+                return;
+            }
+
+            cilk_for (u_int64_t block = 0; block < (m.out + OUTPUT_BLOCK - 1) / OUTPUT_BLOCK; block++) {
+                outputs(block * OUTPUT_BLOCK, std::min(m.out, (block + 1) * OUTPUT_BLOCK));
+            }
+        }
+
+
+        const float* QuantizedInferenceEngine::run(const float* _input) noexcept {
+
+            assert(compiled && "Model has modules the engine cannot run.");
+
+            int real = 0, quant = 0;
+
+            const float* x = _input;
+            bool quantized = false;
+
+            for (size_t k = 0; k < plan.size(); k++) {
+
+                const Kernel& kernel = plan[k];
+
+                if (kernel.op == Kernel::Op::AFFINE) {
+
+                    if (!quantized) {
+                        _quantize(x, kernel, quants[quant].data());
+                        quantized = true;
+                    }
+
+                    const Kernel* next = k + 1 < plan.size() && plan[k + 1].op == Kernel::Op::AFFINE ? &plan[k + 1] : nullptr;
+
+                    _affine(quants[quant].data(), kernel, next, reals[real].data(), quants[quant ^ 1].data());
+
+                    quant ^= 1;
+
+                    if (!next) {
+                        x = reals[real].data();
+                        real ^= 1;
+                        quantized = false;
+                    }
+                    continue;
+                }
+
+                // Elementwise kernels run in place in fp32, on a copy if x is still the caller's input.
+                if (x == _input) {
+                    std::copy(_input, _input + kernel.width, reals[real].data());
+                    x = reals[real].data();
+                    real ^= 1;
+                }
+
+                float* y = const_cast<float*>(x);
+
+                if (kernel.op == Kernel::Op::RELU) for (u_int64_t i = 0; i < kernel.width; i++) y[i] = std::max(y[i], 0.0f);
+                else softmax(y, kernel.width);
+            }
+
+            return x;
+        }
+
+
+    }
+
+}
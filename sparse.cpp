@@ -0,0 +1,421 @@
+#include "sparse.h"
+
+#include <cilk/cilk.h>
+#include <algorithm>
+
+#if defined(__AVX2__) && defined(__FMA__)
+#include <immintrin.h>
+#endif
+
+#include <assert.h>
+
+
+namespace Matrix {
+
+
+    namespace {
+
+        // y += a * x over n elements.
+        inline void axpy(float _a, const float* __restrict _x, float* __restrict _y, u_int64_t _n) noexcept {
+            for (u_int64_t j = 0; j < _n; j++) _y[j] += _a * _x[j];
+        }
+
+
+        using Block = BlockSparseRepresentation;
+
+        // Rows of x that share every load of a block.
+        constexpr u_int64_t SAMPLE_TILE = 4;
+
+        // Rows of x per task of a parallel product.
+        constexpr u_int64_t ROW_TILE = 16 * SAMPLE_TILE;
+
+        // Below this many block multiply-adds a product runs on the calling thread.
+        constexpr u_int64_t PARALLEL_BLOCKS = 1 << 12;
+
+
+        /*
+            Adds the products of S rows of x with the full blocks
+            [first, last) of one block column into acc. Each block is
+            loaded once for all S rows, and the accumulators stay in
+            registers across the whole column.
+        */
+        template <u_int64_t S>
+        inline void block_column(const float* __restrict x, u_int64_t in, const Block& w,
+            u_int64_t first, u_int64_t last, float (&acc)[S][Block::BLOCK_COLUMNS]) noexcept {
+
+            const Block::index_type* rows = w.block_row_indices().data();
+
+#if defined(__AVX2__) && defined(__FMA__)
+            __m256 sum[S];
+            for (u_int64_t s = 0; s < S; s++) sum[s] = _mm256_loadu_ps(acc[s]);
+
+            for (u_int64_t p = first; p < last; p++) {
+
+                const float* b = w.block(p);
+                const float* xs = x + rows[p] * Block::BLOCK_ROWS;
+
+                const __m256 b0 = _mm256_loadu_ps(b);
+                const __m256 b1 = _mm256_loadu_ps(b + 8);
+                const __m256 b2 = _mm256_loadu_ps(b + 16);
+                const __m256 b3 = _mm256_loadu_ps(b + 24);
+
+                for (u_int64_t s = 0; s < S; s++) {
+                    const float* xr = xs + s * in;
+                    sum[s] = _mm256_fmadd_ps(_mm256_set1_ps(xr[0]), b0, sum[s]);
+                    sum[s] = _mm256_fmadd_ps(_mm256_set1_ps(xr[1]), b1, sum[s]);
+                    sum[s] = _mm256_fmadd_ps(_mm256_set1_ps(xr[2]), b2, sum[s]);
+                    sum[s] = _mm256_fmadd_ps(_mm256_set1_ps(xr[3]), b3, sum[s]);
+                }
+            }
+
+            for (u_int64_t s = 0; s < S; s++) _mm256_storeu_ps(acc[s], sum[s]);
+#else
+            for (u_int64_t p = first; p < last; p++) {
+
+                const float* b = w.block(p);
+                const float* xs = x + rows[p] * Block::BLOCK_ROWS;
+
+                for (u_int64_t s = 0; s < S; s++) {
+
+                    const float* xr = xs + s * in;
+
+                    for (u_int64_t j = 0; j < Block::BLOCK_COLUMNS; j++) {
+                        acc[s][j] += xr[0] * b[j] + xr[1] * b[8 + j] + xr[2] * b[16 + j] + xr[3] * b[24 + j];
+                    }
+                }
+            }
+#endif
+        }
+
+
+        /*
+            y[i, 8c, 8c + 8) for the S rows of x from sample i. A block
+            on the bottom edge reads only the rows x has, it is the last
+            of its column if present.
+        */
+        template <u_int64_t S>
+        inline void block_tile(const float* __restrict x, u_int64_t i, const Block& w, u_int64_t c, float* __restrict y) noexcept {
+
+            const u_int64_t in  = w.num_rows();
+            const u_int64_t out = w.num_cols();
+
+            const u_int64_t first = w.column_offsets()[c];
+            const u_int64_t last  = w.column_offsets()[c + 1];
+
+            const bool partial = last > first && (w.block_row_indices()[last - 1] + 1) * Block::BLOCK_ROWS > in;
+
+            float acc[S][Block::BLOCK_COLUMNS] = {};
+
+            block_column<S>(x + i * in, in, w, first, partial ? last - 1 : last, acc);
+
+            if (partial) {
+
+                const u_int64_t base = w.block_row_indices()[last - 1] * Block::BLOCK_ROWS;
+                const float* b = w.block(last - 1);
+
+                for (u_int64_t s = 0; s < S; s++) {
+                    for (u_int64_t r = 0; base + r < in; r++) {
+                        axpy(x[(i + s) * in + base + r], b + r * Block::BLOCK_COLUMNS, acc[s], Block::BLOCK_COLUMNS);
+                    }
+                }
+            }
+
+            const u_int64_t column = c * Block::BLOCK_COLUMNS;
+            const u_int64_t width  = std::min(Block::BLOCK_COLUMNS, out - column);
+
+            for (u_int64_t s = 0; s < S; s++) std::copy(acc[s], acc[s] + width, y + (i + s) * out + column);
+        }
+
+
+        void block_rows(const float* x, u_int64_t first, u_int64_t last, const Block& w, u_int64_t c, float* y) noexcept {
+
+            u_int64_t i = first;
+
+            for (; i + SAMPLE_TILE <= last; i += SAMPLE_TILE) block_tile<SAMPLE_TILE>(x, i, w, c, y);
+            for (; i < last; i++) block_tile<1>(x, i, w, c, y);
+        }
+
+    }
+
+
+    SparseRepresentation::SparseRepresentation(const Matrix::Representation& _dense) noexcept :
+        rows(_dense.num_rows()), columns(_dense.num_cols()), offsets(_dense.num_rows() + 1, 0) {
+
+        assert(columns <= u_int64_t(UINT32_MAX) + 1 && "Too many columns for 32-bit column indices.");
+
+        const float* in = _dense.constScanStart();
+
+        for (u_int64_t r = 0; r < rows; r++) {
+
+            for (u_int64_t c = 0; c < columns; c++) {
+
+                const float value = in[r * columns + c];
+
+                if (value == 0) continue;
+
+                indices.push_back(index_type(c));
+                data.push_back(value);
+            }
+
+            offsets[r + 1] = data.size();
+        }
+    }
+
+
+    SparseRepresentation::SparseRepresentation(Rows _l, Columns _w,
+        std::vector<u_int64_t> _row_offsets,
+        std::vector<index_type> _column_indices,
+        std::vector<float> _values) noexcept :
+            rows(_l.get()), columns(_w.get()),
+            offsets(std::move(_row_offsets)), indices(std::move(_column_indices)), data(std::move(_values)) {
+
+        assert(offsets.size() == rows + 1 && "Expected one offset per row, and the end.");
+        assert(offsets.front() == 0 && offsets.back() == data.size() && "Offsets do not span the values.");
+        assert(indices.size() == data.size() && "Expected one column index per value.");
+        assert(std::is_sorted(offsets.begin(), offsets.end()) && "Row offsets must not decrease.");
+        assert(std::all_of(indices.begin(), indices.end(), [this](index_type c) { return c < columns; }) &&
+            "Column index out of range.");
+    }
+
+
+    Matrix::Representation SparseRepresentation::to_dense() const noexcept {
+
+        Matrix::Representation dense = Matrix::Representation(Rows(rows), Columns(columns));
+        float* out = dense.scanStart();
+
+        cilk_for (u_int64_t r = 0; r < rows; r++) {
+            for (u_int64_t p = offsets[r]; p < offsets[r + 1]; p++) out[r * columns + indices[p]] = data[p];
+        }
+
+        return Matrix::Representation{std::move(dense)};
+    }
+
+
+    /*
+        Counting sort of the nonzeros by column. Visiting the rows in
+        order keeps every column of the result sorted by row.
+    */
+    SparseRepresentation SparseRepresentation::transpose() const noexcept {
+
+        assert(rows <= u_int64_t(UINT32_MAX) + 1 && "Too many rows for 32-bit column indices.");
+
+        std::vector<u_int64_t> t_offsets(columns + 1, 0);
+        std::vector<index_type> t_indices(nonzeros());
+        std::vector<float> t_data(nonzeros());
+
+        for (index_type c: indices) t_offsets[c + 1]++;
+        for (u_int64_t c = 0; c < columns; c++) t_offsets[c + 1] += t_offsets[c];
+
+        std::vector<u_int64_t> next(t_offsets.begin(), t_offsets.end() - 1);
+
+        for (u_int64_t r = 0; r < rows; r++) {
+            for (u_int64_t p = offsets[r]; p < offsets[r + 1]; p++) {
+                const u_int64_t q = next[indices[p]]++;
+                t_indices[q] = index_type(r);
+                t_data[q] = data[p];
+            }
+        }
+
+        return SparseRepresentation(Rows(columns), Columns(rows), std::move(t_offsets), std::move(t_indices), std::move(t_data));
+    }
+
+
+    BlockSparseRepresentation::BlockSparseRepresentation(const Matrix::Representation& _dense) noexcept :
+        rows(_dense.num_rows()), columns(_dense.num_cols()), offsets(1, 0) {
+
+        assert(block_rows() <= u_int64_t(UINT32_MAX) + 1 && "Too many block rows for 32-bit indices.");
+
+        const float* in = _dense.constScanStart();
+
+        offsets.reserve(block_columns() + 1);
+
+        for (u_int64_t c = 0; c < block_columns(); c++) {
+
+            const u_int64_t first_col = c * BLOCK_COLUMNS;
+            const u_int64_t last_col  = std::min(columns, first_col + BLOCK_COLUMNS);
+
+            for (u_int64_t r = 0; r < block_rows(); r++) {
+
+                const u_int64_t first_row = r * BLOCK_ROWS;
+                const u_int64_t last_row  = std::min(rows, first_row + BLOCK_ROWS);
+
+                bool nonzero = false;
+
+                for (u_int64_t i = first_row; i < last_row && !nonzero; i++) {
+                    nonzero = std::any_of(in + i * columns + first_col, in + i * columns + last_col, [](float v) { return v != 0; });
+                }
+
+                if (!nonzero) continue;
+
+                indices.push_back(index_type(r));
+                data.resize(data.size() + BLOCK_SIZE, 0.0f);
+
+                float* block = data.data() + data.size() - BLOCK_SIZE;
+
+                for (u_int64_t i = first_row; i < last_row; i++) {
+                    std::copy(in + i * columns + first_col, in + i * columns + last_col, block + (i - first_row) * BLOCK_COLUMNS);
+                }
+            }
+
+            offsets.push_back(indices.size());
+        }
+    }
+
+
+    Matrix::Representation BlockSparseRepresentation::to_dense() const noexcept {
+
+        Matrix::Representation dense = Matrix::Representation(Rows(rows), Columns(columns));
+        float* out = dense.scanStart();
+
+        cilk_for (u_int64_t c = 0; c < block_columns(); c++) {
+
+            const u_int64_t first_col = c * BLOCK_COLUMNS;
+            const u_int64_t width     = std::min(columns - first_col, BLOCK_COLUMNS);
+
+            for (u_int64_t p = offsets[c]; p < offsets[c + 1]; p++) {
+
+                const u_int64_t first_row = indices[p] * BLOCK_ROWS;
+
+                for (u_int64_t i = first_row; i < std::min(rows, first_row + BLOCK_ROWS); i++) {
+                    std::copy(block(p) + (i - first_row) * BLOCK_COLUMNS, block(p) + (i - first_row) * BLOCK_COLUMNS + width,
+                        out + i * columns + first_col);
+                }
+            }
+        }
+
+        return Matrix::Representation{std::move(dense)};
+    }
+
+
+    namespace Operations {
+
+        namespace Sparse {
+
+
+            Matrix::Representation multiply(const SparseRepresentation& x, const Matrix::Representation& w) noexcept {
+
+                assert(x.num_cols() == w.num_rows() && "Sparse multiply dimension mismatch.");
+
+                const u_int64_t n = w.num_cols();
+
+                Matrix::Representation out = Matrix::Representation(Rows(x.num_rows()), Columns(n));
+
+                const u_int64_t* offsets = x.row_offsets().data();
+                const SparseRepresentation::index_type* indices = x.column_indices().data();
+                const float* values = x.values().data();
+                const float* weights = w.constScanStart();
+                float* y = out.scanStart();
+
+                cilk_for (u_int64_t i = 0; i < x.num_rows(); i++) {
+                    for (u_int64_t p = offsets[i]; p < offsets[i + 1]; p++) {
+                        axpy(values[p], weights + indices[p] * n, y + i * n, n);
+                    }
+                }
+
+                return Matrix::Representation{std::move(out)};
+            }
+
+
+            u_int64_t accumulate_transpose_product(const SparseRepresentation& x, const Matrix::Representation& g,
+                Matrix::Representation& dw) noexcept {
+
+                std::vector<u_int64_t> touched;
+                accumulate_transpose_product(x, g, dw, touched);
+
+                return touched.size();
+            }
+
+
+            void accumulate_transpose_product(const SparseRepresentation& x, const Matrix::Representation& g,
+                Matrix::Representation& dw, std::vector<u_int64_t>& touched) noexcept {
+
+                assert(x.num_rows() == g.num_rows() && "Sparse gradient needs one gradient row per sample.");
+                assert(dw.num_rows() == x.num_cols() && dw.num_cols() == g.num_cols() && "Weight gradient has the wrong shape.");
+
+                const u_int64_t n = g.num_cols();
+                const u_int64_t nnz = x.nonzeros();
+
+                const u_int64_t* offsets = x.row_offsets().data();
+                const SparseRepresentation::index_type* columns = x.column_indices().data();
+                const float* values = x.values().data();
+
+                // The nonzeros grouped by column, a sort over the nonzeros rather than a pass over the width.
+                std::vector<u_int64_t> order(nnz);
+                std::vector<u_int64_t> sample(nnz);
+
+                for (u_int64_t i = 0; i < x.num_rows(); i++) {
+                    for (u_int64_t p = offsets[i]; p < offsets[i + 1]; p++) {
+                        order[p] = p;
+                        sample[p] = i;
+                    }
+                }
+
+                std::stable_sort(order.begin(), order.end(), [columns](u_int64_t a, u_int64_t b) { return columns[a] < columns[b]; });
+
+                touched.clear();
+                std::vector<u_int64_t> runs;
+
+                for (u_int64_t q = 0; q < nnz; q++) {
+                    if (q == 0 || columns[order[q]] != columns[order[q - 1]]) {
+                        touched.push_back(columns[order[q]]);
+                        runs.push_back(q);
+                    }
+                }
+                runs.push_back(nnz);
+
+                const float* gradient = g.constScanStart();
+                float* out = dw.scanStart();
+
+                cilk_for (u_int64_t t = 0; t < touched.size(); t++) {
+
+                    float* row = out + touched[t] * n;
+
+                    for (u_int64_t q = runs[t]; q < runs[t + 1]; q++) {
+                        axpy(values[order[q]], gradient + sample[order[q]] * n, row, n);
+                    }
+                }
+            }
+
+
+            Matrix::Representation multiply(const Matrix::Representation& x, const BlockSparseRepresentation& w) noexcept {
+
+                assert(x.num_cols() == w.num_rows() && "Block sparse multiply dimension mismatch.");
+
+                Matrix::Representation out = Matrix::Representation(Rows(x.num_rows()), Columns(w.num_cols()));
+
+                multiply(x.constScanStart(), x.num_rows(), w, out.scanStart());
+
+                return Matrix::Representation{std::move(out)};
+            }
+
+
+            /*
+                Every task owns one block column of y for a tile of rows,
+                so tasks never share an output. A column with no kept
+                blocks still writes its zeros.
+            */
+            void multiply(const float* x, u_int64_t n, const BlockSparseRepresentation& w, float* y) noexcept {
+
+                const u_int64_t columns = w.block_columns();
+
+                if (n * w.blocks() < PARALLEL_BLOCKS) {
+                    for (u_int64_t c = 0; c < columns; c++) block_rows(x, 0, n, w, c, y);
+                    return;
+                }
+
+                const u_int64_t tiles = (n + ROW_TILE - 1) / ROW_TILE;
+
+                cilk_for (u_int64_t task = 0; task < tiles * columns; task++) {
+
+                    const u_int64_t first = (task / columns) * ROW_TILE;
+
+                    block_rows(x, first, std::min(n, first + ROW_TILE), w, task % columns, y);
+                }
+            }
+
+
+        }
+
+    }
+
+}
@@ -5,6 +5,8 @@
 #include "tensor_backwards_pass.h"
 
 #include "m_algorithms_utilities.h"
+#include <algorithm>
+#include <iterator>
 #include <variant>
 
 #include <memory>
@@ -21,65 +23,90 @@ namespace NeuralNetwork {
             Tensor::Tensor(Matrix::Rows _l, Matrix::Columns _w, 
                     IsTrackable _t, IsLeaf _f, IsRecordable _r) noexcept: 
                     stats({}),
+                    context(&ComputationalGraphMap::get()),
                     matrix(Matrix::Representation(_l, _w)), 
-                    grad(Matrix::Representation(_l, _w)), 
-                    my_tensor_id(ComputationalGraphMap::get()._obtain_tensor_id()),  
+                    grad(), 
+                    my_tensor_id(context->_obtain_tensor_id()),  
                     is_leaf(_f.get()),
                     requires_grad(_t.get()), record_statistics(_r.get()) {
 
                 Matrix::Generation::Normal<0, 1> normal_distribution_init;                    
                 matrix = normal_distribution_init(matrix);
-
-                Matrix::Generation::Tester<1> unit_gen;
-                grad = unit_gen(grad);
-
                                             
             }
 
 
             Tensor::Tensor(const Matrix::Representation& _m, 
+                    IsTrackable _t, IsLeaf _f, IsRecordable _r) noexcept: 
+                    Tensor(ComputationalGraphMap::get(), _m, _t, _f, _r) {}
+
+            Tensor::Tensor(ComputationalGraphMap& _context, const Matrix::Representation& _m, 
                     IsTrackable _t, IsLeaf _f, IsRecordable _r) noexcept: 
                     stats({}),
+                    context(&_context),
                     matrix(_m), 
-                    grad(Matrix::Representation(
-                        Matrix::Rows(_m.num_rows()), 
-                        Matrix::Columns(_m.num_cols()))), 
-                    my_tensor_id(ComputationalGraphMap::get()._obtain_tensor_id()),  
+                    grad(), 
+                    my_tensor_id(context->_obtain_tensor_id()),  
                     is_leaf(_f.get()), 
-                    requires_grad(_t.get()), record_statistics(_r.get()) {
+                    requires_grad(_t.get()), record_statistics(_r.get()) {}
+
+            Tensor::Tensor(Matrix::Representation&& _m, 
+                    IsTrackable _t, IsLeaf _f, IsRecordable _r) noexcept: 
+                    stats({}),
+                    context(&ComputationalGraphMap::get()),
+                    matrix(std::move(_m)), 
+                    grad(), 
+                    my_tensor_id(context->_obtain_tensor_id()),  
+                    is_leaf(_f.get()), 
+                    requires_grad(_t.get()), record_statistics(_r.get()) {}
+
+            Tensor::Tensor(Matrix::Representation&& _m) noexcept: 
+                    Tensor(ComputationalGraphMap::get(), std::move(_m)) {}
+
+            Tensor::Tensor(ComputationalGraphMap& _context, Matrix::Representation&& _m) noexcept: 
+                    stats({}),
+                    context(&_context),
+                    matrix(std::move(_m)), 
+                    grad(), 
+                    my_tensor_id(TensorID(0)),  
+                    is_leaf(true), 
+                    requires_grad(false), record_statistics(false) {}
 
-                Matrix::Generation::Tester<1> unit_gen;
-                grad = unit_gen(grad);
-            }
 
             Tensor::Tensor(const Tensor& other) noexcept: 
                     // stats(other.stats),
+                    context(other.context),
                     matrix(other.matrix), 
                     grad(other.grad), 
+                    grad_rows(other.grad_rows),
                     my_tensor_id(other.my_tensor_id),  
                     is_leaf(other.is_leaf),
                     requires_grad(other.requires_grad), 
-                    record_statistics(other.record_statistics) {}
+                    record_statistics(other.record_statistics),
+                    accumulate_grad(other.accumulate_grad) {}
 
 
             Tensor& Tensor::operator=(const Tensor& other) noexcept {
+                context       = other.context;
                 my_tensor_id  = other.my_tensor_id;  
                 is_leaf       = other.is_leaf; 
                 requires_grad = other.requires_grad;
+                accumulate_grad = other.accumulate_grad;
                 // stats = other.stats;
                 matrix        = other.matrix; 
                 grad          = other.grad; 
+                grad_rows     = other.grad_rows;
                 return *this;
             }
 
 
             void Tensor::detatch_from_computational_graph() noexcept {
-                ComputationalGraphMap::get()._recover_tensor_id(my_tensor_id);
+                context->_recover_tensor_id(my_tensor_id);
             }
 
 
             FunctionObject Tensor::get_operation() noexcept { 
-                return ComputationalGraphMap::get()._get_operation(my_tensor_id);
+                return context->_get_operation(my_tensor_id);
             }
 
 
@@ -107,6 +134,98 @@ namespace NeuralNetwork {
             Tensor::matrix_t& Tensor::get_grad() noexcept {   
                 return grad; 
             }
+
+            bool Tensor::has_grad() const noexcept {   
+                return grad.size() != 0; 
+            }
+
+            void Tensor::write_grad(const matrix_t& _g) noexcept {
+
+                grad_rows.reset();
+
+                if (accumulate_grad && has_grad()) {
+                    Matrix::Operations::Binary::accumulate(grad, _g);
+                    return;
+                }
+
+                if (!has_grad() && grad_slot.size()) grad = std::move(grad_slot);
+
+                grad = _g;
+            }
+
+            void Tensor::write_grad(matrix_t&& _g) noexcept {
+
+                grad_rows.reset();
+
+                if (accumulate_grad && has_grad()) {
+                    Matrix::Operations::Binary::accumulate(grad, _g);
+                    return;
+                }
+
+                if (!has_grad() && grad_slot.size()) grad = std::move(grad_slot);
+
+                grad = std::move(_g);
+            }
+
+            void Tensor::zero_grad() noexcept {
+
+                if (!has_grad()) return;
+
+                if (grad_rows) {
+
+                    const u_int64_t n = grad.num_cols();
+
+                    for (auto row: *grad_rows) std::fill_n(grad.scanStart() + row * n, n, 0.0f);
+
+                    grad_rows->clear();
+
+                    // Zeroed, it is the slot the next write lands in.
+                    if (!grad.is_view()) {
+                        grad_slot = std::move(grad);
+                        grad.release();
+                    }
+
+                    return;
+                }
+
+                if (grad.is_view()) {
+                    std::fill(grad.scanStart(), grad.scanEnd(), 0.0f);
+                    grad_rows.emplace();
+                }
+                else {
+                    grad.release();
+                    grad_rows.reset();
+                }
+            }
+
+            Tensor::matrix_t& Tensor::sparse_grad() noexcept {
+
+                if (has_grad() && !accumulate_grad) zero_grad();
+
+                if (has_grad()) return grad;
+
+                if (grad_slot.size() && grad_rows && grad_rows->empty()) {
+                    grad = std::move(grad_slot);
+                    return grad;
+                }
+
+                grad = matrix_t(num_rows(), num_cols());
+                grad_rows.emplace();
+
+                return grad;
+            }
+
+            void Tensor::touch_grad_rows(const std::vector<u_int64_t>& _rows) noexcept {
+
+                if (!grad_rows) return;
+
+                std::vector<u_int64_t> merged;
+                merged.reserve(grad_rows->size() + _rows.size());
+
+                std::set_union(grad_rows->begin(), grad_rows->end(), _rows.begin(), _rows.end(), std::back_inserter(merged));
+
+                grad_rows = std::move(merged);
+            }
             
             Matrix::Rows Tensor::num_rows(void) const noexcept {
                 return Matrix::Rows(matrix.num_rows());
@@ -118,9 +237,9 @@ namespace NeuralNetwork {
 
             void Tensor::backwards() noexcept {
 
-                ReversePass reverse;
+                ReversePass reverse(*context);
 
-                reverse.backwards(*this, PrintTag{});
+                reverse.backwards(*this, GradientTag{});
 
             }
 
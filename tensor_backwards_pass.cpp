@@ -6,7 +6,7 @@
 
 #include <variant>
 #include <utility>
-#include <stack>
+#include <vector>
 
 
 namespace NeuralNetwork {
@@ -27,6 +27,64 @@ namespace NeuralNetwork {
                 }
 
 
+            /*
+                Reverse sweep over the graph's topological order run
+                backwards, so a node's rule runs once, after every 
+                consumer, with the sum of their gradients. Within a pass 
+                every tensor accumulates; those in overwrite mode drop the
+                previous pass's gradient first and overwrite again after.
+                An intermediate's matrix and gradient are returned as soon
+                as its own rule has run, its consumers having read them 
+                already. Leaves and the root keep theirs. The MemoryPlanner
+                plans buffer lifetimes against this same order.
+            */
+            void ReversePass::backwards(Tensor& _t, 
+                GradientTag _ ) {
+
+                    const auto root  = _t.get_tensor_id();
+                    const auto order = map._topological_order(root);
+
+                    std::vector<std::shared_ptr<Tensor>> overwriting;
+
+                    for (auto tid: order) {
+
+                        auto tensor = map._get_tensor(tid);
+
+                        if (tid == root || tensor->is_accumulating_grad()) continue;
+
+                        tensor->zero_grad();
+                        tensor->set_accumulate_grad(true);
+                        overwriting.push_back(tensor);
+                    }
+
+                    for (auto it = order.rbegin(); it != order.rend(); ++it) {
+
+                        auto tid       = *it;
+                        auto tensor    = map._get_tensor(tid);
+                        auto operation = map._get_operation(tid);
+
+                        const bool is_intermediate = tid != root && operation.serialize()[1].has_value();
+
+                        // No gradient flows past a tensor its consumers did 
+                        // not differentiate (e.g. the labels of a loss).
+                        if (tid == root) ComputeGradientPolicy::process_head(map, tid);
+                        else if (tensor->has_grad()) {
+                            Events::Differentiate backpropigate_grad(tensor->get_grad());
+                            operation.process_event(backpropigate_grad, map);
+                        }
+
+                        if (!is_intermediate) continue;
+
+                        tensor->release_matrix().release();
+                        tensor->get_grad().release();
+                    }
+
+                    for (auto& tensor: overwriting) tensor->set_accumulate_grad(false);
+                }
+
+
+
+
          
                 
  
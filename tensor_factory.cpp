@@ -2,6 +2,9 @@
 #include "tensor_factory.h"
 #include "function_object_factory.h"
 #include "m_algorithms_concepts.h"
+#include "memory_planner.h"
+
+#include <algorithm>
 
 
 namespace NeuralNetwork {
@@ -27,8 +30,71 @@ namespace NeuralNetwork {
             }
 
 
+            std::shared_ptr<Tensor> TensorConstructor::create(
+                const Matrix::Representation& _m,
+                IsTrackable _t, 
+                IsLeaf _f,
+                IsRecordable _r) {
+                
+                auto tensor = std::make_shared<Tensor>(
+                        _m, _t, _f, _r);
+                
+                FunctionObjectFactory::create(tensor);
+                
+                return tensor;
+            }
+
+
+            std::shared_ptr<Tensor> TensorConstructor::create(
+                Matrix::Representation&& _m,
+                IsTrackable _t, 
+                IsLeaf _f,
+                IsRecordable _r) {
+                
+                auto tensor = std::make_shared<Tensor>(
+                        std::move(_m), _t, _f, _r);
+                
+                FunctionObjectFactory::create(tensor);
+                
+                return tensor;
+            }
+
+
+            std::shared_ptr<Tensor> TensorConstructor::create(
+                Segment _segment,
+                const Matrix::Representation& _m,
+                TensorID _op,
+                IsRecordable _r) {
+
+                auto tensor = std::make_shared<Tensor>(
+                        _m, IsTrackable(true), IsLeaf(true), _r);
+
+                FunctionObjectFactory::create(
+                    std::move(_segment), tensor, _op);
+
+                return tensor;
+            }
+
+
+            std::shared_ptr<Tensor> TensorConstructor::create(
+                std::shared_ptr<const Matrix::SparseRepresentation> _sparse,
+                Matrix::Representation&& _m,
+                TensorID _weights,
+                IsRecordable _r) {
+
+                auto tensor = std::make_shared<Tensor>(
+                        std::move(_m), IsTrackable(true), IsLeaf(true), _r);
+
+                FunctionObjectFactory::create(
+                    std::move(_sparse), tensor, _weights);
+
+                return tensor;
+            }
+
+
             template <Matrix::Operations::MatrixOperatable Operator>
             std::shared_ptr<Tensor> TensorConstructor::create(
+                ComputationalGraphMap& _context,
                 Operator _operator,
                 const Matrix::Representation& _m,
                 TensorID _op, 
@@ -37,9 +103,24 @@ namespace NeuralNetwork {
                 IsLeaf _f,
                 IsRecordable _r) {
                 
+                std::shared_ptr<Tensor> tensor;
 
-                auto tensor = std::make_shared<Tensor>(
-                        _m, _t, _f, _r);
+                Matrix::Representation activation, gradient;
+                MemoryPlan* plan = _context._replaying();
+
+                // A replayed step lands the output in its planned slot, the kernel's result is dropped right after.
+                if (plan && plan->_take(_m.num_rows(), _m.num_cols(), activation, gradient)) {
+                    std::copy(_m.constScanStart(), _m.constScanEnd(), activation.scanStart());
+
+                    tensor = std::make_shared<Tensor>(
+                            _context, Matrix::Representation{}, _t, _f, _r);
+                    tensor->release_matrix() = std::move(activation);
+                    tensor->reserve_grad(std::move(gradient));
+                }
+                else {
+                    tensor = std::make_shared<Tensor>(
+                            _context, _m, _t, _f, _r);
+                }
 
                 if constexpr (Matrix::Operations::UnaryMatrixOperatable<Operator>) {
                     FunctionObjectFactory::create(
@@ -49,6 +130,8 @@ namespace NeuralNetwork {
                     FunctionObjectFactory::create(
                         _operator, tensor, _op, _op2);
                 }
+
+                _context._stamp_creation(tensor->get_tensor_id());
  
                 return tensor;
             }
@@ -56,6 +139,7 @@ namespace NeuralNetwork {
 
             
             template std::shared_ptr<Tensor> TensorConstructor::create<Matrix::Operations::Unary::ReLU>(
+                ComputationalGraphMap& _context,
                 Matrix::Operations::Unary::ReLU _operator,
                 const Matrix::Representation& _m,
                 TensorID _op, 
@@ -65,6 +149,7 @@ namespace NeuralNetwork {
                 IsRecordable _r);
 
             template std::shared_ptr<Tensor> TensorConstructor::create<Matrix::Operations::Unary::SoftMax>(
+                ComputationalGraphMap& _context,
                 Matrix::Operations::Unary::SoftMax _operator,
                 const Matrix::Representation& _m,
                 TensorID _op, 
@@ -74,6 +159,7 @@ namespace NeuralNetwork {
                 IsRecordable _r);
 
             template std::shared_ptr<Tensor> TensorConstructor::create<Matrix::Operations::Binary::HadamardProduct::Std>(
+                ComputationalGraphMap& _context,
                 Matrix::Operations::Binary::HadamardProduct::Std _operator,
                 const Matrix::Representation& _m,
                 TensorID _op, 
@@ -83,6 +169,7 @@ namespace NeuralNetwork {
                 IsRecordable _r);
 
             template std::shared_ptr<Tensor> TensorConstructor::create<Matrix::Operations::Binary::Multiplication::ParallelDNC>(
+                ComputationalGraphMap& _context,
                 Matrix::Operations::Binary::Multiplication::ParallelDNC _operator,
                 const Matrix::Representation& _m,
                 TensorID _op, 
@@ -92,6 +179,7 @@ namespace NeuralNetwork {
                 IsRecordable _r);
 
             template std::shared_ptr<Tensor> TensorConstructor::create<Matrix::Operations::Binary::Multiplication::Naive>(
+                ComputationalGraphMap& _context,
                 Matrix::Operations::Binary::Multiplication::Naive _operator,
                 const Matrix::Representation& _m,
                 TensorID _op, 
@@ -101,6 +189,7 @@ namespace NeuralNetwork {
                 IsRecordable _r);
 
             template std::shared_ptr<Tensor> TensorConstructor::create<Matrix::Operations::Binary::Multiplication::Square>(
+                ComputationalGraphMap& _context,
                 Matrix::Operations::Binary::Multiplication::Square _operator,
                 const Matrix::Representation& _m,
                 TensorID _op, 
@@ -110,6 +199,7 @@ namespace NeuralNetwork {
                 IsRecordable _r);
 
             template std::shared_ptr<Tensor> TensorConstructor::create<Matrix::Operations::Binary::Addition::Std>(
+                ComputationalGraphMap& _context,
                 Matrix::Operations::Binary::Addition::Std _operator,
                 const Matrix::Representation& _m,
                 TensorID _op, 
@@ -118,7 +208,18 @@ namespace NeuralNetwork {
                 IsLeaf _f,
                 IsRecordable _r);
 
+            template std::shared_ptr<Tensor> TensorConstructor::create<Matrix::Operations::Binary::Subtraction::Std>(
+                ComputationalGraphMap& _context,
+                Matrix::Operations::Binary::Subtraction::Std _operator,
+                const Matrix::Representation& _m,
+                TensorID _op, 
+                TensorID _op2,  
+                IsTrackable _t, 
+                IsLeaf _f,
+                IsRecordable _r);
+
             template std::shared_ptr<Tensor> TensorConstructor::create<Matrix::Operations::Binary::OuterProduct::Naive>(
+                ComputationalGraphMap& _context,
                 Matrix::Operations::Binary::OuterProduct::Naive _operator,
                 const Matrix::Representation& _m,
                 TensorID _op, 
@@ -128,6 +229,7 @@ namespace NeuralNetwork {
                 IsRecordable _r);
 
             template std::shared_ptr<Tensor> TensorConstructor::create<Matrix::Operations::Metric::CrossEntropy>(
+                ComputationalGraphMap& _context,
                 Matrix::Operations::Metric::CrossEntropy _operator,
                 const Matrix::Representation& _m,
                 TensorID _op, 
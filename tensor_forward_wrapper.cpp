@@ -16,6 +16,8 @@
 #include <memory>
 #include <variant>
 
+#include <assert.h>
+
 
 
 
@@ -31,9 +33,27 @@ namespace NeuralNetwork {
                 const std::shared_ptr<Tensor> l, 
                 const std::shared_ptr<Tensor> r) {
 
-                    bool recordTensorOperation = l->is_recorded() || r->is_recorded();
-                    
-                    PerformTensorStrategy implementation;
+                    /*
+                        Operations run in the graph context of their operands.
+                        The context and its grad mode are read once, here, and
+                        handed to the strategy, the kernel's parallel regions 
+                        may resume the rest of the call on another worker.
+                    */
+                    ComputationalGraphMap& map = l->get_context();
+                    assert((!r || &r->get_context() == &map) && "Operands belong to different graph contexts.");
+
+                    const bool grad_enabled = map.is_grad_enabled();
+
+                    PerformTensorStrategy implementation(map);
+
+                    if (!grad_enabled) {
+
+                        PerformTensorStrategy::InferenceTag _;
+
+                        return _.compute_tensor(op_type, l, r, implementation);
+                    }
+
+                    bool recordTensorOperation = l->is_recorded() || (r && r->is_recorded());
 
                     if (recordTensorOperation) {
                         
@@ -48,6 +68,21 @@ namespace NeuralNetwork {
                 
                 }
 
+
+            template <Matrix::Operations::MatrixOperatable Operator>
+            std::shared_ptr<Tensor> TensorOp<Operator>::operator()(
+                PerformTensorStrategy::InferenceTag _tag,
+                const std::shared_ptr<Tensor> l, 
+                const std::shared_ptr<Tensor> r) {
+
+                    ComputationalGraphMap& map = l->get_context();
+                    assert((!r || &r->get_context() == &map) && "Operands belong to different graph contexts.");
+
+                    PerformTensorStrategy implementation(map);
+
+                    return _tag.compute_tensor(op_type, l, r, implementation);
+                }
+
             /*
                 templates explicit instantiation
             */
@@ -59,6 +94,7 @@ namespace NeuralNetwork {
             template class TensorOp<Matrix::Operations::Binary::Multiplication::Naive>;
             template class TensorOp<Matrix::Operations::Binary::Multiplication::Square>;
             template class TensorOp<Matrix::Operations::Binary::Addition::Std>;
+            template class TensorOp<Matrix::Operations::Binary::Subtraction::Std>;
             template class TensorOp<Matrix::Operations::Binary::OuterProduct::Naive>;
             template class TensorOp<Matrix::Operations::Metric::CrossEntropy>;
 
@@ -89,7 +125,7 @@ namespace NeuralNetwork {
 
                     if constexpr (Matrix::Operations::UnaryMatrixOperatable<Operator>) {
 
-                        out_tensor = TensorConstructor::create(_op,
+                        out_tensor = TensorConstructor::create(map, _op,
                             std::move(out_matrix),  
                             l->get_tensor_id(),
                             TensorID(0),
@@ -100,7 +136,7 @@ namespace NeuralNetwork {
                     }
                     else if constexpr (Matrix::Operations::BinaryMatrixOperatable<Operator>) {
                         
-                        out_tensor = TensorConstructor::create(_op,
+                        out_tensor = TensorConstructor::create(map, _op,
                             std::move(out_matrix),  
                             l->get_tensor_id(),
                             r->get_tensor_id(),
@@ -155,7 +191,7 @@ namespace NeuralNetwork {
                         
                     if constexpr (Matrix::Operations::UnaryMatrixOperatable<Operator>) {
                     
-                        out_tensor = TensorConstructor::create(_op,
+                        out_tensor = TensorConstructor::create(map, _op,
                                 std::move(out_matrix),  
                                 l->get_tensor_id(),
                                 TensorID(0),
@@ -167,7 +203,7 @@ namespace NeuralNetwork {
                     }
                     else if constexpr (Matrix::Operations::BinaryMatrixOperatable<Operator>) {
                         
-                        out_tensor = TensorConstructor::create(_op,
+                        out_tensor = TensorConstructor::create(map, _op,
                                 std::move(out_matrix),  
                                 l->get_tensor_id(),
                                 r->get_tensor_id(),
@@ -187,6 +223,30 @@ namespace NeuralNetwork {
                     }
 
 
+
+                /*
+                    Runs the kernel and wraps the result without recording
+                    it on the ComputationalGraphMap. Operands are left as 
+                    they are, they do not become parents of the output.
+                */
+                template <Matrix::Operations::MatrixOperatable Operator>
+                std::shared_ptr<Tensor> PerformTensorStrategy::compute(
+                    Operator _op,
+                    const std::shared_ptr<Tensor> l, 
+                    const std::shared_ptr<Tensor> r, 
+                    InferenceTag _) {
+
+                    if constexpr (Matrix::Operations::UnaryMatrixOperatable<Operator>) {
+                        return std::make_shared<Tensor>(map,
+                            _op(l->release_matrix()));
+                    }
+                    else if constexpr (Matrix::Operations::BinaryMatrixOperatable<Operator>) {
+                        return std::make_shared<Tensor>(map,
+                            _op(l->release_matrix(), r->release_matrix()));
+                    }
+                    }
+
+
         }
 
     }
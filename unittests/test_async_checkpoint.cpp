@@ -0,0 +1,99 @@
+#include "../deps/doctest.h"
+
+#include "../include/matrix.h"
+#include "../include/tensor.h"
+#include "../include/network_layer.h"
+#include "../include/activation_layer.h"
+#include "../include/async_checkpoint.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+
+TEST_CASE("Asynchronous Checkpointing")
+{
+
+    constexpr int CHECKPOINTS = 6;
+
+    auto build = [](NeuralNetwork::Sequential& model) {
+        model.add(std::make_unique<NeuralNetwork::Layer>(
+            std::make_unique<NeuralNetwork::MatrixMultiplyStep>(Matrix::Rows(12), Matrix::Columns(9)),
+            std::make_unique<NeuralNetwork::AddStep>(Matrix::Columns(9))));
+        model.add(std::make_unique<NeuralNetwork::ActivationFunctions::ReLU>());
+        model.add(std::make_unique<NeuralNetwork::Layer>(
+            std::make_unique<NeuralNetwork::MatrixMultiplyStep>(Matrix::Rows(9), Matrix::Columns(2)),
+            std::make_unique<NeuralNetwork::AddStep>(Matrix::Columns(2))));
+    };
+
+    auto path = [](int i) {
+        return (std::filesystem::temp_directory_path() / ("wirikuta_test_async_" + std::to_string(i) + ".wrkc")).string();
+    };
+
+    // Stands in for an optimizer step: every weight of checkpoint i is i.
+    auto train = [](NeuralNetwork::Sequential& model, float value) {
+        for (auto& param: model.parameters()) {
+            auto& matrix = param->release_matrix();
+            std::fill(matrix.scanStart(), matrix.scanEnd(), value);
+        }
+    };
+
+    NeuralNetwork::Sequential model;
+    build(model);
+
+
+    SUBCASE("Every Snapshot Holds The Weights At Save Time")
+    {
+        for (size_t pending: {1, 2, 4}) {
+            {
+                NeuralNetwork::Serialization::AsyncCheckpointer checkpointer(model, pending);
+
+                for (int i = 0; i < CHECKPOINTS; i++) {
+                    train(model, i);
+                    checkpointer.save(path(i));
+                }
+
+                // Training keeps going while the writes drain.
+                train(model, -1);
+                checkpointer.wait();
+
+                CHECK(checkpointer.completed() == CHECKPOINTS);
+                CHECK(checkpointer.failed() == 0);
+            }
+
+            for (int i = 0; i < CHECKPOINTS; i++) {
+
+                NeuralNetwork::Sequential restored;
+                build(restored);
+                REQUIRE(restored.load(path(i)));
+
+                bool matches = true;
+                for (auto& param: restored.parameters()) {
+                    auto& matrix = param->release_matrix();
+                    matches = matches && std::all_of(matrix.constScanStart(), matrix.constScanEnd(),
+                        [i](float w) { return w == i; });
+                }
+                CHECK(matches);
+
+                std::remove(path(i).c_str());
+            }
+        }
+    }
+
+
+    SUBCASE("Failed Writes Are Counted")
+    {
+        NeuralNetwork::Serialization::AsyncCheckpointer checkpointer(model);
+
+        checkpointer.save("/nonexistent-directory/model.wrkc");
+        checkpointer.save(path(0));
+        checkpointer.wait();
+
+        CHECK(checkpointer.failed() == 1);
+        CHECK(checkpointer.completed() == 1);
+
+        std::remove(path(0).c_str());
+    }
+}
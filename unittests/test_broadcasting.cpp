@@ -0,0 +1,149 @@
+#include "../deps/doctest.h"
+
+#include "../include/matrix.h"
+#include "../include/generator.h"
+#include "../include/m_algorithms.h"
+#include "../include/tensor.h"
+#include "../include/tensor_factory.h"
+#include "../include/tensor_forward_wrapper.h"
+
+#include <cmath>
+
+
+namespace {
+
+    bool close(const Matrix::Representation& a, const Matrix::Representation& b) {
+
+        if (a.num_rows() != b.num_rows() || a.num_cols() != b.num_cols()) return false;
+
+        for (auto l = a.constScanStart(), r = b.constScanStart(); l != a.constScanEnd(); l++, r++) {
+            if (std::fabs(*l - *r) > 1e-4 * (1 + std::fabs(*r))) return false;
+        }
+        return true;
+    }
+
+}
+
+
+TEST_CASE("Broadcasting Binary Operators")
+{
+
+    constexpr u_int64_t M = 5;
+    constexpr u_int64_t N = 7;
+
+    Matrix::Generation::Normal<0, 1> normal_distribution_init;
+
+    Matrix::Representation full = Matrix::Representation(Matrix::Rows(M), Matrix::Columns(N));
+    Matrix::Representation row  = Matrix::Representation(Matrix::Rows(1), Matrix::Columns(N));
+    Matrix::Representation col  = Matrix::Representation(Matrix::Rows(M), Matrix::Columns(1));
+    Matrix::Representation one  = Matrix::Representation(Matrix::Rows(1), Matrix::Columns(1));
+
+    full = normal_distribution_init(full);
+    row  = normal_distribution_init(row);
+    col  = normal_distribution_init(col);
+    one  = normal_distribution_init(one);
+
+    Matrix::Operations::Binary::Addition::Std add;
+    Matrix::Operations::Binary::Subtraction::Std subtract;
+    Matrix::Operations::Binary::HadamardProduct::Std hadamard;
+
+
+    SUBCASE("Row, Column And Scalar Forward")
+    {
+        auto by_row = add(full, row);
+        auto by_col = subtract(full, col);
+        auto by_one = hadamard(one, full);
+
+        REQUIRE(by_row.num_rows() == M);
+        REQUIRE(by_col.num_cols() == N);
+        REQUIRE(by_one.num_rows() == M);
+
+        for (u_int64_t i = 0; i < M; i++) {
+            for (u_int64_t j = 0; j < N; j++) {
+                CHECK(by_row.get(i, j) == doctest::Approx(full.get(i, j) + row.get(0, j)));
+                CHECK(by_col.get(i, j) == doctest::Approx(full.get(i, j) - col.get(i, 0)));
+                CHECK(by_one.get(i, j) == doctest::Approx(one.get(0, 0) * full.get(i, j)));
+            }
+        }
+    }
+
+
+    SUBCASE("Row Against Column Expands Both")
+    {
+        auto outer = add(col, row);
+
+        REQUIRE(outer.num_rows() == M);
+        REQUIRE(outer.num_cols() == N);
+
+        for (u_int64_t i = 0; i < M; i++) {
+            for (u_int64_t j = 0; j < N; j++) {
+                CHECK(outer.get(i, j) == doctest::Approx(col.get(i, 0) + row.get(0, j)));
+            }
+        }
+    }
+
+
+    SUBCASE("Reduce To Shape")
+    {
+        auto rows = Matrix::Operations::Binary::reduce_to_shape(full, Matrix::Rows(1), Matrix::Columns(N));
+        auto cols = Matrix::Operations::Binary::reduce_to_shape(full, Matrix::Rows(M), Matrix::Columns(1));
+        auto all  = Matrix::Operations::Binary::reduce_to_shape(full, Matrix::Rows(1), Matrix::Columns(1));
+        auto same = Matrix::Operations::Binary::reduce_to_shape(full, Matrix::Rows(M), Matrix::Columns(N));
+
+        float total = 0;
+        for (u_int64_t i = 0; i < M; i++) {
+            float row_sum = 0;
+            for (u_int64_t j = 0; j < N; j++) row_sum += full.get(i, j);
+            CHECK(cols.get(i, 0) == doctest::Approx(row_sum));
+            total += row_sum;
+        }
+        for (u_int64_t j = 0; j < N; j++) {
+            float col_sum = 0;
+            for (u_int64_t i = 0; i < M; i++) col_sum += full.get(i, j);
+            CHECK(rows.get(0, j) == doctest::Approx(col_sum));
+        }
+
+        CHECK(all.get(0, 0) == doctest::Approx(total));
+        CHECK(close(same, full));
+    }
+
+
+    SUBCASE("Backward Reduces Over Broadcast Axes")
+    {
+        auto x = NeuralNetwork::Computation::Graph::TensorConstructor::create(full);
+        auto b = NeuralNetwork::Computation::Graph::TensorConstructor::create(row);
+        auto s = NeuralNetwork::Computation::Graph::TensorConstructor::create(col);
+
+        NeuralNetwork::Computation::Graph::TensorOp sub(Matrix::Operations::Binary::Subtraction::Std{});
+        NeuralNetwork::Computation::Graph::TensorOp mul(Matrix::Operations::Binary::HadamardProduct::Std{});
+
+        auto out = mul(sub(x, b), s);
+        out->backwards();
+
+        /*
+            out = (x - b) ⊙ s seeded with ones:
+                d/dx = s broadcast over columns
+                d/db = -sum over rows of s
+                d/ds = row sums of (x - b)
+        */
+        float s_total = 0;
+        for (u_int64_t i = 0; i < M; i++) s_total += col.get(i, 0);
+
+        REQUIRE(x->has_grad());
+        REQUIRE(b->has_grad());
+        REQUIRE(s->has_grad());
+
+        for (u_int64_t i = 0; i < M; i++) {
+            float row_sum = 0;
+            for (u_int64_t j = 0; j < N; j++) {
+                CHECK(x->get_grad().get(i, j) == doctest::Approx(col.get(i, 0)));
+                row_sum += full.get(i, j) - row.get(0, j);
+            }
+            CHECK(s->get_grad().get(i, 0) == doctest::Approx(row_sum).epsilon(1e-4));
+        }
+        for (u_int64_t j = 0; j < N; j++) {
+            CHECK(b->get_grad().get(0, j) == doctest::Approx(-s_total).epsilon(1e-4));
+        }
+    }
+
+}
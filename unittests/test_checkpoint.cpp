@@ -0,0 +1,71 @@
+#include "../deps/doctest.h"
+
+#include "../include/matrix.h"
+#include "../include/tensor.h"
+#include "../include/tensor_factory.h"
+#include "../include/tensor_forward_wrapper.h"
+#include "../include/network_layer.h"
+#include "../include/activation_layer.h"
+
+#include <vector>
+
+
+TEST_CASE("Gradient Checkpointing")
+{
+
+    auto ma = NeuralNetwork::Computation::Graph::TensorConstructor::create(
+        Matrix::Rows(1), Matrix::Columns(40));
+    auto ground_truth = NeuralNetwork::Computation::Graph::TensorConstructor::create(
+        Matrix::Rows(1), Matrix::Columns(10));
+
+    NeuralNetwork::Sequential model;
+
+    for (int i = 0; i < 3; i++) {
+        model.add(std::make_unique<NeuralNetwork::Layer>(
+            std::make_unique<NeuralNetwork::MatrixMultiplyStep>(Matrix::Rows(40), Matrix::Columns(40)),
+            std::make_unique<NeuralNetwork::AddStep>(Matrix::Columns(40))));
+        model.add(std::make_unique<NeuralNetwork::ActivationFunctions::ReLU>());
+    }
+    model.add(std::make_unique<NeuralNetwork::Layer>(
+        std::make_unique<NeuralNetwork::MatrixMultiplyStep>(Matrix::Rows(40), Matrix::Columns(10)),
+        std::make_unique<NeuralNetwork::AddStep>(Matrix::Columns(10))));
+
+    NeuralNetwork::Computation::Graph::TensorOp CE(Matrix::Operations::Metric::CrossEntropy{});
+
+    std::vector<Matrix::Representation> expected;
+    Matrix::Representation expected_loss;
+    {
+        auto out  = model.forward(ma);
+        auto loss = CE(ground_truth, out);
+        loss->backwards();
+
+        expected_loss = loss->release_matrix();
+        for (auto& param: model.parameters()) expected.emplace_back(param->get_grad());
+    }
+
+
+    SUBCASE("Recomputed Segments Match Full Graph")
+    {
+        for (size_t segment_size: {1, 2, 3}) {
+
+            model.checkpoint(segment_size);
+
+            auto out  = model.forward(ma);
+            auto loss = CE(ground_truth, out);
+            loss->backwards();
+
+            CHECK((loss->release_matrix() == Matrix::Representation{expected_loss}) == true);
+
+            auto params = model.parameters();
+            REQUIRE(params.size() == expected.size());
+
+            for (size_t i = 0; i < params.size(); i++) {
+                CHECK((params[i]->get_grad() == Matrix::Representation{expected[i]}) == true);
+            }
+        }
+
+        model.checkpoint(0);
+    }
+
+
+}
@@ -0,0 +1,133 @@
+#include "../deps/doctest.h"
+
+#include "../include/matrix.h"
+#include "../include/csv.h"
+#include "../include/dataset.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+
+TEST_CASE("Parallel CSV Ingestion")
+{
+
+    const std::string path = (std::filesystem::temp_directory_path() / "wirikuta_test.csv").string();
+
+    auto write = [&path](const std::string& text) {
+        std::ofstream(path, std::ios::binary) << text;
+    };
+
+
+    SUBCASE("Small File")
+    {
+        write("a,b,c\n1,2.5,-3\n\n 4e2 , +5,  .25\r\n-0.5,0,7");
+
+        NeuralNetwork::Data::CSVReader csv(path, ',', true);
+
+        REQUIRE(csv.is_open());
+        CHECK(csv.rows() == 3);
+        CHECK(csv.columns() == 3);
+
+        Matrix::Representation m = Matrix::Representation(Matrix::Rows(csv.rows()), Matrix::Columns(csv.columns()));
+        REQUIRE(csv.read(m));
+
+        CHECK(m.get(0, 0) == 1.0f);   CHECK(m.get(0, 1) == 2.5f);  CHECK(m.get(0, 2) == -3.0f);
+        CHECK(m.get(1, 0) == 400.0f); CHECK(m.get(1, 1) == 5.0f);  CHECK(m.get(1, 2) == 0.25f);
+        CHECK(m.get(2, 0) == -0.5f);  CHECK(m.get(2, 1) == 0.0f);  CHECK(m.get(2, 2) == 7.0f);
+    }
+
+
+    SUBCASE("Ranges Split Mid Line")
+    {
+        constexpr u_int64_t ROWS = 997;
+
+        std::string text;
+        for (u_int64_t i = 0; i < ROWS; i++) {
+            text += std::to_string(i) + ";" + std::to_string(i * 0.5) + ";" + std::to_string(-float(i)) + "\n";
+        }
+        write(text);
+
+        for (size_t ranges: {1, 2, 7, 64, 5000}) {
+
+            NeuralNetwork::Data::CSVReader csv(path, ';', false, ranges);
+
+            REQUIRE(csv.rows() == ROWS);
+            REQUIRE(csv.columns() == 3);
+
+            Matrix::Representation m = Matrix::Representation(Matrix::Rows(ROWS), Matrix::Columns(3));
+            REQUIRE(csv.read(m));
+
+            bool ordered = true;
+            for (u_int64_t i = 0; i < ROWS; i++) {
+                ordered = ordered && m.get(i, 0) == i && m.get(i, 1) == i * 0.5f && m.get(i, 2) == -float(i);
+            }
+            CHECK(ordered);
+        }
+    }
+
+
+    SUBCASE("Split Into Features And Labels")
+    {
+        write("1,2,3\n4,5,6\n");
+
+        NeuralNetwork::Data::CSVReader csv(path);
+
+        Matrix::Representation x = Matrix::Representation(Matrix::Rows(2), Matrix::Columns(2));
+        Matrix::Representation y = Matrix::Representation(Matrix::Rows(2), Matrix::Columns(1));
+        REQUIRE(csv.read(x, y));
+
+        CHECK(x.get(0, 0) == 1.0f); CHECK(x.get(0, 1) == 2.0f); CHECK(y.get(0, 0) == 3.0f);
+        CHECK(x.get(1, 0) == 4.0f); CHECK(x.get(1, 1) == 5.0f); CHECK(y.get(1, 0) == 6.0f);
+    }
+
+
+    SUBCASE("Malformed Lines")
+    {
+        write("1,2,3\n4,x,6\n");
+
+        NeuralNetwork::Data::CSVReader bad_field(path);
+        Matrix::Representation m = Matrix::Representation(Matrix::Rows(2), Matrix::Columns(3));
+        CHECK(!bad_field.read(m));
+
+        write("1,2,3\n4,5\n");
+
+        NeuralNetwork::Data::CSVReader short_line(path);
+        CHECK(!short_line.read(m));
+
+        CHECK(!NeuralNetwork::Data::CSVReader(path + ".missing").is_open());
+    }
+
+
+    SUBCASE("Conversion To A Mapped Dataset")
+    {
+        write("0.5,1.5,0,1\n2.5,3.5,1,0\n4.5,5.5,0,1\n");
+
+        const std::string dataset = path + ".wrkd";
+
+        REQUIRE(NeuralNetwork::Data::csv_to_dataset(path, dataset, 2));
+
+        NeuralNetwork::Data::MappedDataset data(dataset);
+
+        REQUIRE(data.is_open());
+        CHECK(data.samples() == 3);
+        CHECK(data.features() == 2);
+        CHECK(data.label_columns() == 2);
+
+        auto x = data.features(0, 3);
+        auto y = data.labels(0, 3);
+
+        CHECK(x.get(1, 0) == 2.5f);
+        CHECK(x.get(2, 1) == 5.5f);
+        CHECK(y.get(0, 1) == 1.0f);
+        CHECK(y.get(1, 0) == 1.0f);
+
+        write("0.5,1.5,0,1\n2.5,x,1,0\n");
+
+        CHECK(!NeuralNetwork::Data::csv_to_dataset(path, dataset, 2));
+        CHECK(!std::filesystem::exists(dataset));
+    }
+
+    std::remove(path.c_str());
+}
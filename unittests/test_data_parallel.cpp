@@ -0,0 +1,115 @@
+#include "../deps/doctest.h"
+
+#include "../include/matrix.h"
+#include "../include/generator.h"
+#include "../include/tensor.h"
+#include "../include/tensor_factory.h"
+#include "../include/tensor_forward_wrapper.h"
+#include "../include/network_layer.h"
+#include "../include/activation_layer.h"
+#include "../include/data_parallel.h"
+
+#include <cilk/cilk.h>
+#include <vector>
+
+
+TEST_CASE("Data Parallel Training")
+{
+
+    constexpr u_int64_t BATCH = 7;
+
+    Matrix::Generation::Normal<0, 1> normal_distribution_init;
+
+    auto build = [](NeuralNetwork::Sequential& model) {
+        model.add(std::make_unique<NeuralNetwork::Layer>(
+            std::make_unique<NeuralNetwork::MatrixMultiplyStep>(Matrix::Rows(12), Matrix::Columns(9)),
+            std::make_unique<NeuralNetwork::AddStep>(Matrix::Columns(9))));
+        model.add(std::make_unique<NeuralNetwork::ActivationFunctions::ReLU>());
+        model.add(std::make_unique<NeuralNetwork::Layer>(
+            std::make_unique<NeuralNetwork::MatrixMultiplyStep>(Matrix::Rows(9), Matrix::Columns(4)),
+            std::make_unique<NeuralNetwork::AddStep>(Matrix::Columns(4))));
+    };
+
+    NeuralNetwork::Sequential model;
+    build(model);
+
+    for (auto& param: model.parameters()) param->release_matrix() = normal_distribution_init(param->release_matrix());
+
+    Matrix::Representation inputs = Matrix::Representation(Matrix::Rows(BATCH), Matrix::Columns(12));
+    Matrix::Representation labels = Matrix::Representation(Matrix::Rows(BATCH), Matrix::Columns(4));
+    inputs = normal_distribution_init(inputs);
+    for (u_int64_t i = 0; i < BATCH; i++) labels.put(i, i % 4, 1);
+
+    auto flat = model.flatten();
+
+    NeuralNetwork::Computation::Graph::TensorOp CE(Matrix::Operations::Metric::CrossEntropy{});
+
+    auto loss = CE(
+        NeuralNetwork::Computation::Graph::TensorConstructor::create(labels),
+        model.forward(NeuralNetwork::Computation::Graph::TensorConstructor::create(inputs)));
+    loss->backwards();
+
+    float expected_loss = 0;
+    for (auto it = loss->release_matrix().constScanStart(); it != loss->release_matrix().constScanEnd(); it++) expected_loss += *it;
+
+    std::vector<float> expected(flat->gradients(), flat->gradients() + flat->size());
+
+
+    SUBCASE("Reduced Shard Gradients Match The Full Batch")
+    {
+        for (size_t workers: {1, 2, 3, 8}) {
+
+            flat->zero_grad();
+
+            NeuralNetwork::Training::DataParallel trainer(model, build, workers);
+            REQUIRE(trainer.workers() == workers);
+
+            float total = trainer.step(inputs, labels);
+
+            CHECK(total == doctest::Approx(expected_loss).epsilon(1e-4));
+
+            for (size_t k = 0; k < flat->size(); k++) {
+                CHECK(flat->gradients()[k] == doctest::Approx(expected[k]).epsilon(1e-4));
+            }
+        }
+    }
+
+
+    SUBCASE("No Replica Context Stays Bound")
+    {
+        auto& outer = NeuralNetwork::Computation::Graph::ComputationalGraphMap::get();
+
+        // Wide enough that the kernels spawn, so continuations migrate.
+        auto wide = [](NeuralNetwork::Sequential& model) {
+            model.add(std::make_unique<NeuralNetwork::Layer>(
+                std::make_unique<NeuralNetwork::MatrixMultiplyStep>(Matrix::Rows(256), Matrix::Columns(256)),
+                std::make_unique<NeuralNetwork::AddStep>(Matrix::Columns(256))));
+            model.add(std::make_unique<NeuralNetwork::ActivationFunctions::ReLU>());
+            model.add(std::make_unique<NeuralNetwork::Layer>(
+                std::make_unique<NeuralNetwork::MatrixMultiplyStep>(Matrix::Rows(256), Matrix::Columns(4)),
+                std::make_unique<NeuralNetwork::AddStep>(Matrix::Columns(4))));
+        };
+
+        NeuralNetwork::Sequential master;
+        wide(master);
+
+        Matrix::Representation x = Matrix::Representation(Matrix::Rows(512), Matrix::Columns(256));
+        Matrix::Representation y = Matrix::Representation(Matrix::Rows(512), Matrix::Columns(4));
+        x = normal_distribution_init(x);
+        for (u_int64_t i = 0; i < 512; i++) y.put(i, i % 4, 1);
+
+        NeuralNetwork::Training::DataParallel trainer(master, wide, 8);
+
+        for (int s = 0; s < 8; s++) trainer.step(x, y);
+
+        std::vector<char> unbound(64, false);
+
+        cilk_for (size_t w = 0; w < unbound.size(); w++) {
+            unbound[w] = &NeuralNetwork::Computation::Graph::ComputationalGraphMap::get() == &outer;
+        }
+
+        CHECK(&NeuralNetwork::Computation::Graph::ComputationalGraphMap::get() == &outer);
+        for (auto ok: unbound) CHECK(ok);
+    }
+
+}
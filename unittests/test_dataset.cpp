@@ -0,0 +1,194 @@
+#include "../deps/doctest.h"
+
+#include "../include/matrix.h"
+#include "../include/tensor.h"
+#include "../include/computational_graph_map.h"
+#include "../include/tensor_factory.h"
+#include "../include/network_layer.h"
+#include "../include/data_parallel.h"
+#include "../include/dataset.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <set>
+#include <string>
+
+
+TEST_CASE("Memory Mapped Dataset")
+{
+
+    constexpr u_int64_t SAMPLES  = 50;
+    constexpr u_int64_t FEATURES = 7;
+    constexpr u_int64_t BATCH    = 8;
+
+    // Sample i is identified by its first feature, its label is 2i.
+    Matrix::Representation features = Matrix::Representation(Matrix::Rows(SAMPLES), Matrix::Columns(FEATURES));
+    Matrix::Representation labels   = Matrix::Representation(Matrix::Rows(SAMPLES), Matrix::Columns(2));
+
+    for (u_int64_t i = 0; i < SAMPLES; i++) {
+        for (u_int64_t c = 0; c < FEATURES; c++) features.put(i, c, i + c / 10.0f);
+        labels.put(i, 0, 2.0f * i);
+        labels.put(i, 1, -1.0f);
+    }
+
+    const std::string path = (std::filesystem::temp_directory_path() / "wirikuta_test_dataset.wrkd").string();
+
+    REQUIRE(NeuralNetwork::Data::write_dataset(path, features, labels));
+
+    auto data = std::make_shared<NeuralNetwork::Data::MappedDataset>(path);
+    REQUIRE(data->is_open());
+
+    NeuralNetwork::Computation::Graph::GraphContext context;
+    NeuralNetwork::Computation::Graph::GraphContext::Bind bind(context);
+
+    // Walks one epoch, checking every batch pairs features with their labels.
+    auto drain = [](NeuralNetwork::Data::BatchLoader& loader, std::vector<u_int64_t>& seen, bool& views) {
+        while (auto batch = loader.next()) {
+            auto& x = batch->inputs->release_matrix();
+            auto& y = batch->labels->release_matrix();
+
+            CHECK(x.num_rows() == y.num_rows());
+            views = views && x.is_view() && y.is_view();
+
+            for (u_int64_t r = 0; r < x.num_rows(); r++) {
+                seen.push_back(x.get(r, 0));
+                CHECK(y.get(r, 0) == 2 * x.get(r, 0));
+            }
+        }
+    };
+
+
+    SUBCASE("Header And Zero Copy Views")
+    {
+        CHECK(data->samples() == SAMPLES);
+        CHECK(data->features() == FEATURES);
+        CHECK(data->label_columns() == 2);
+
+        auto rows = data->features(10, 13);
+
+        CHECK(rows.is_view());
+        CHECK(rows.num_rows() == 3);
+        CHECK(rows.constScanStart() == data->feature_row(10));
+        CHECK(reinterpret_cast<uintptr_t>(data->feature_row(0)) % NeuralNetwork::Data::DATASET_ALIGNMENT == 0);
+        CHECK(rows == Matrix::Representation{
+            Matrix::Representation::view_of(Matrix::Rows(3), Matrix::Columns(FEATURES), features.scanStart() + 10 * FEATURES)});
+    }
+
+
+    SUBCASE("Views Outlive The Dataset")
+    {
+        auto scoped = std::make_shared<NeuralNetwork::Data::MappedDataset>(path);
+        auto rows = scoped->labels(SAMPLES - 1, SAMPLES);
+        scoped.reset();
+
+        CHECK(rows.get(0, 0) == 2.0f * (SAMPLES - 1));
+    }
+
+
+    SUBCASE("Sequential Order")
+    {
+        NeuralNetwork::Data::BatchLoader loader(data, BATCH, NeuralNetwork::Data::Shuffle::NONE);
+
+        std::vector<u_int64_t> seen;
+        bool views = true;
+        drain(loader, seen, views);
+
+        CHECK(views);
+        REQUIRE(seen.size() == SAMPLES);
+        for (u_int64_t i = 0; i < SAMPLES; i++) CHECK(seen[i] == i);
+        CHECK(!loader.next());
+    }
+
+
+    SUBCASE("Shuffled Batches Stay Views")
+    {
+        NeuralNetwork::Data::BatchLoader loader(data, BATCH, NeuralNetwork::Data::Shuffle::BATCHES, 7);
+
+        std::vector<u_int64_t> first, second;
+        bool views = true;
+
+        drain(loader, first, views);
+        loader.reset();
+        drain(loader, second, views);
+
+        CHECK(views);
+        CHECK(loader.epoch() == 1);
+        CHECK(std::set<u_int64_t>(first.begin(), first.end()).size() == SAMPLES);
+        CHECK(std::set<u_int64_t>(second.begin(), second.end()).size() == SAMPLES);
+        CHECK(first != second);
+    }
+
+
+    SUBCASE("Shuffled Samples Are Gathered")
+    {
+        NeuralNetwork::Data::BatchLoader loader(data, BATCH, NeuralNetwork::Data::Shuffle::SAMPLES, 3, 4);
+
+        std::vector<u_int64_t> seen;
+        bool views = true;
+        drain(loader, seen, views);
+
+        CHECK(!views);
+        CHECK(seen.size() == SAMPLES);
+        CHECK(std::set<u_int64_t>(seen.begin(), seen.end()).size() == SAMPLES);
+    }
+
+
+    SUBCASE("Reset Mid Epoch")
+    {
+        NeuralNetwork::Data::BatchLoader loader(data, BATCH, NeuralNetwork::Data::Shuffle::BATCHES, 11, 1);
+
+        REQUIRE(loader.next().has_value());
+
+        loader.reset();
+
+        std::vector<u_int64_t> seen;
+        bool views = true;
+        drain(loader, seen, views);
+
+        CHECK(seen.size() == SAMPLES);
+    }
+
+
+    SUBCASE("Training Loop Releases Every Step")
+    {
+        constexpr int EPOCHS = 80;
+
+        NeuralNetwork::Sequential model;
+        model.add(std::make_unique<NeuralNetwork::Layer>(
+            std::make_unique<NeuralNetwork::MatrixMultiplyStep>(Matrix::Rows(FEATURES), Matrix::Columns(2)),
+            std::make_unique<NeuralNetwork::AddStep>(Matrix::Columns(2))));
+
+        NeuralNetwork::Data::BatchLoader loader(data, BATCH);
+
+        // Five registrations a step, far more over all epochs than the registry holds.
+        int steps = 0;
+        for (int epoch = 0; epoch < EPOCHS; epoch++) {
+            while (auto batch = loader.next()) {
+                NeuralNetwork::Training::train_batch(model, *batch);
+                steps++;
+            }
+            loader.reset();
+        }
+
+        CHECK(steps * 5 > 2000);
+
+        auto probe = NeuralNetwork::Computation::Graph::TensorConstructor::create(Matrix::Rows(1), Matrix::Columns(1));
+        CHECK(probe->get_tensor_id().get() <= 8);
+    }
+
+
+    SUBCASE("Rejects Other Files")
+    {
+        const std::string other = path + ".bad";
+        std::ofstream(other) << "not a dataset, just some text long enough to hold a header.";
+
+        CHECK(!NeuralNetwork::Data::MappedDataset(other).is_open());
+        CHECK(!NeuralNetwork::Data::MappedDataset(path + ".missing").is_open());
+
+        std::remove(other.c_str());
+    }
+
+    std::remove(path.c_str());
+}
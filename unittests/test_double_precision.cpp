@@ -0,0 +1,114 @@
+#include "../deps/doctest.h"
+
+#include "../include/matrix.h"
+#include "../include/generator.h"
+#include "../include/m_algorithms.h"
+#include "../include/m_algorithms_concepts.h"
+
+#include <cmath>
+#include <type_traits>
+
+
+namespace {
+
+    // Defined in fp32 only, still an operation the graph can run.
+    struct SinglePrecisionOnly {
+        Matrix::Representation operate(const Matrix::Representation& m) noexcept { return Matrix::Representation{m}; }
+    };
+
+}
+
+
+TEST_CASE("Double Precision Kernels")
+{
+
+    static_assert(Matrix::Operations::UnaryMatrixOperatable<SinglePrecisionOnly>);
+    static_assert(!Matrix::Operations::UnaryMatrixOperatable<SinglePrecisionOnly, double>);
+    static_assert(Matrix::Operations::UnaryMatrixOperatable<Matrix::Operations::Unary::ReLU, double>);
+    static_assert(Matrix::Operations::BinaryMatrixOperatable<Matrix::Operations::Binary::Multiplication::ParallelDNC, double>);
+
+    Matrix::Operations::Binary::Multiplication::Naive naive;
+    Matrix::Operations::Binary::Multiplication::ParallelDNC mul;
+
+    static_assert(std::is_same_v<decltype(mul(std::declval<Matrix::DoubleRepresentation>(), std::declval<Matrix::DoubleRepresentation>())),
+                                 Matrix::DoubleRepresentation>);
+    static_assert(std::is_same_v<decltype(mul(std::declval<Matrix::Representation>(), std::declval<Matrix::Representation>())),
+                                 Matrix::Representation>);
+
+    SUBCASE("Multiplication Matches The Naive Kernel")
+    {
+        Matrix::DoubleRepresentation a = Matrix::DoubleRepresentation(Matrix::Rows(67), Matrix::Columns(45));
+        Matrix::DoubleRepresentation b = Matrix::DoubleRepresentation(Matrix::Rows(45), Matrix::Columns(83));
+
+        for (u_int64_t i = 0; i < a.size(); i++) a.scanStart()[i] = std::sin(double(i));
+        for (u_int64_t i = 0; i < b.size(); i++) b.scanStart()[i] = std::cos(double(i));
+
+        Matrix::DoubleRepresentation expected = naive(a, b);
+        Matrix::DoubleRepresentation c = mul(a, b);
+
+        CHECK(c.bytes() == c.size() * sizeof(double));
+
+        for (u_int64_t i = 0; i < c.size(); i++) {
+            CHECK(std::abs(c.constScanStart()[i] - expected.constScanStart()[i]) < 1e-12);
+        }
+    }
+
+
+    SUBCASE("Keeps Digits fp32 Loses")
+    {
+        // 1 + 1e-9 is 1 in fp32, a dot product over it cancels to 0 there.
+        Matrix::DoubleRepresentation a = Matrix::DoubleRepresentation(Matrix::Rows(1), Matrix::Columns(2));
+        Matrix::DoubleRepresentation b = Matrix::DoubleRepresentation(Matrix::Rows(2), Matrix::Columns(1));
+        a.put(0, 0, 1 + 1e-9); a.put(0, 1, -1);
+        b.put(0, 0, 1);        b.put(1, 0, 1);
+
+        CHECK(mul(a, b).get(0, 0) == doctest::Approx(1e-9).epsilon(1e-6));
+
+        Matrix::Representation af = Matrix::Representation(Matrix::Rows(1), Matrix::Columns(2));
+        Matrix::Representation bf = Matrix::Representation(Matrix::Rows(2), Matrix::Columns(1));
+        af.put(0, 0, 1 + 1e-9); af.put(0, 1, -1);
+        bf.put(0, 0, 1);        bf.put(1, 0, 1);
+
+        CHECK(mul(af, bf).get(0, 0) == 0.0f);
+    }
+
+
+    SUBCASE("Elementwise, Broadcast And Unary")
+    {
+        Matrix::DoubleRepresentation batch = Matrix::DoubleRepresentation(Matrix::Rows(3), Matrix::Columns(4));
+        Matrix::DoubleRepresentation bias  = Matrix::DoubleRepresentation(Matrix::Rows(1), Matrix::Columns(4));
+
+        for (u_int64_t i = 0; i < batch.size(); i++) batch.scanStart()[i] = double(i) - 5.5;
+        for (u_int64_t j = 0; j < 4; j++) bias.put(0, j, 0.25 * j);
+
+        Matrix::Operations::Binary::Addition::Std add;
+        Matrix::Operations::Unary::ReLU relu;
+        Matrix::Operations::Unary::Transpose transpose;
+        Matrix::Operations::Unary::SoftMax softmax;
+
+        Matrix::DoubleRepresentation sum = add(batch, bias);
+        Matrix::DoubleRepresentation positive = relu(batch);
+        Matrix::DoubleRepresentation t = transpose(batch);
+        Matrix::DoubleRepresentation p = softmax(batch);
+
+        for (u_int64_t i = 0; i < 3; i++) {
+
+            double row = 0;
+
+            for (u_int64_t j = 0; j < 4; j++) {
+                CHECK(sum.get(i, j) == batch.get(i, j) + 0.25 * j);
+                CHECK(positive.get(i, j) == std::max(batch.get(i, j), 0.0));
+                CHECK(t.get(j, i) == batch.get(i, j));
+                row += p.get(i, j);
+            }
+
+            CHECK(row == doctest::Approx(1.0).epsilon(1e-12));
+        }
+
+        Matrix::DoubleRepresentation reduced = Matrix::Operations::Binary::reduce_to_shape(sum, Matrix::Rows(1), Matrix::Columns(4));
+        CHECK(reduced.get(0, 1) == doctest::Approx(sum.get(0, 1) + sum.get(1, 1) + sum.get(2, 1)));
+
+        CHECK((Matrix::DoubleRepresentation{t} == Matrix::DoubleRepresentation{t}) == true);
+    }
+
+}
@@ -0,0 +1,116 @@
+#include "../deps/doctest.h"
+
+#include "../include/matrix.h"
+#include "../include/generator.h"
+#include "../include/tensor.h"
+#include "../include/tensor_factory.h"
+#include "../include/tensor_forward_wrapper.h"
+#include "../include/network_layer.h"
+#include "../include/activation_layer.h"
+#include "../include/data_parallel.h"
+
+#include <vector>
+
+
+TEST_CASE("Gradient Accumulation")
+{
+
+    constexpr u_int64_t BATCH = 8;
+    constexpr u_int64_t MICRO = 2;
+
+    Matrix::Generation::Normal<0, 1> normal_distribution_init;
+
+    NeuralNetwork::Sequential model;
+    model.add(std::make_unique<NeuralNetwork::Layer>(
+        std::make_unique<NeuralNetwork::MatrixMultiplyStep>(Matrix::Rows(6), Matrix::Columns(5)),
+        std::make_unique<NeuralNetwork::AddStep>(Matrix::Columns(5))));
+    model.add(std::make_unique<NeuralNetwork::ActivationFunctions::ReLU>());
+    model.add(std::make_unique<NeuralNetwork::Layer>(
+        std::make_unique<NeuralNetwork::MatrixMultiplyStep>(Matrix::Rows(5), Matrix::Columns(3)),
+        std::make_unique<NeuralNetwork::AddStep>(Matrix::Columns(3))));
+
+    for (auto& param: model.parameters()) param->release_matrix() = normal_distribution_init(param->release_matrix());
+
+    Matrix::Representation inputs = Matrix::Representation(Matrix::Rows(BATCH), Matrix::Columns(6));
+    Matrix::Representation labels = Matrix::Representation(Matrix::Rows(BATCH), Matrix::Columns(3));
+    inputs = normal_distribution_init(inputs);
+    for (u_int64_t i = 0; i < BATCH; i++) labels.put(i, i % 3, 1);
+
+    auto& context = NeuralNetwork::Computation::Graph::GraphContext::get();
+
+    NeuralNetwork::Training::train_rows(model, context, inputs, labels, 0, BATCH);
+
+    std::vector<Matrix::Representation> expected;
+    for (auto& param: model.parameters()) expected.emplace_back(param->get_grad());
+
+    auto check_matches_full_batch = [&]() {
+        auto params = model.parameters();
+        for (size_t i = 0; i < params.size(); i++) {
+            for (u_int64_t k = 0; k < expected[i].size(); k++) {
+                CHECK(params[i]->get_grad().constScanStart()[k] ==
+                    doctest::Approx(expected[i].constScanStart()[k]).epsilon(1e-4));
+            }
+        }
+    };
+
+
+    SUBCASE("Overwrite Mode Keeps Only The Last Micro-Batch")
+    {
+        for (u_int64_t first = 0; first < BATCH; first += MICRO) {
+            NeuralNetwork::Training::train_rows(model, context, inputs, labels, first, first + MICRO);
+        }
+
+        auto params = model.parameters();
+        CHECK((params.front()->get_grad() == Matrix::Representation{expected.front()}) == false);
+    }
+
+
+    SUBCASE("Micro-Batches Sum To The Full Batch")
+    {
+        model.accumulate_gradients(true);
+        model.zero_grad();
+
+        for (auto& param: model.parameters()) CHECK(param->has_grad() == false);
+
+        for (u_int64_t first = 0; first < BATCH; first += MICRO) {
+            NeuralNetwork::Training::train_rows(model, context, inputs, labels, first, first + MICRO);
+        }
+
+        check_matches_full_batch();
+    }
+
+
+    SUBCASE("Flat Buffer Accumulates In Place")
+    {
+        auto flat = model.flatten();
+
+        model.accumulate_gradients(true);
+        model.zero_grad();
+
+        for (size_t k = 0; k < flat->size(); k++) REQUIRE(flat->gradients()[k] == 0);
+
+        for (u_int64_t first = 0; first < BATCH; first += MICRO) {
+            NeuralNetwork::Training::train_rows(model, context, inputs, labels, first, first + MICRO);
+        }
+
+        check_matches_full_batch();
+    }
+
+
+    SUBCASE("Zero Grad Over MatrixParameter")
+    {
+        NeuralNetwork::Computation::Graph::TensorOp CE(Matrix::Operations::Metric::CrossEntropy{});
+
+        auto loss = CE(
+            NeuralNetwork::Computation::Graph::TensorConstructor::create(labels),
+            model.forward(NeuralNetwork::Computation::Graph::TensorConstructor::create(inputs)));
+        loss->backwards();
+
+        for (auto& param: model.parameters()) REQUIRE(param->has_grad() == true);
+
+        loss->parameters().zero_grad();
+
+        for (auto& param: model.parameters()) CHECK(param->has_grad() == false);
+    }
+
+}
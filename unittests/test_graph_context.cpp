@@ -0,0 +1,102 @@
+#include "../deps/doctest.h"
+
+#include "../include/matrix.h"
+#include "../include/tensor.h"
+#include "../include/tensor_factory.h"
+#include "../include/tensor_forward_wrapper.h"
+#include "../include/computational_graph_map.h"
+#include "../include/network_layer.h"
+#include "../include/activation_layer.h"
+
+#include <thread>
+#include <vector>
+
+
+namespace {
+
+    bool train_in_context(int steps) {
+
+        NeuralNetwork::Computation::Graph::GraphContext context;
+        NeuralNetwork::Computation::Graph::GraphContext::Bind bind(context);
+
+        auto ma = NeuralNetwork::Computation::Graph::TensorConstructor::create(
+            Matrix::Rows(1), Matrix::Columns(20));
+        auto ground_truth = NeuralNetwork::Computation::Graph::TensorConstructor::create(
+            Matrix::Rows(1), Matrix::Columns(5));
+
+        NeuralNetwork::Sequential model;
+
+        model.add(std::make_unique<NeuralNetwork::Layer>(
+            std::make_unique<NeuralNetwork::MatrixMultiplyStep>(Matrix::Rows(20), Matrix::Columns(10)),
+            std::make_unique<NeuralNetwork::AddStep>(Matrix::Columns(10))));
+        model.add(std::make_unique<NeuralNetwork::ActivationFunctions::ReLU>());
+        model.add(std::make_unique<NeuralNetwork::Layer>(
+            std::make_unique<NeuralNetwork::MatrixMultiplyStep>(Matrix::Rows(10), Matrix::Columns(5)),
+            std::make_unique<NeuralNetwork::AddStep>(Matrix::Columns(5))));
+
+        NeuralNetwork::Computation::Graph::TensorOp CE(Matrix::Operations::Metric::CrossEntropy{});
+
+        bool ok = true;
+
+        for (int i = 0; i < steps; i++) {
+
+            auto out  = model.forward(ma);
+            auto loss = CE(ground_truth, out);
+            loss->backwards();
+
+            ok = ok && &loss->get_context() == &context;
+
+            for (auto& param: model.parameters()) {
+                ok = ok && param->has_grad();
+            }
+        }
+
+        return ok;
+    }
+
+}
+
+
+TEST_CASE("Graph Context")
+{
+
+    SUBCASE("Fresh Context Starts Its Own Registry")
+    {
+        NeuralNetwork::Computation::Graph::GraphContext context;
+        NeuralNetwork::Computation::Graph::GraphContext::Bind bind(context);
+
+        auto ma = NeuralNetwork::Computation::Graph::TensorConstructor::create(
+            Matrix::Rows(1), Matrix::Columns(4));
+
+        CHECK(ma->get_tensor_id() == NeuralNetwork::Computation::Graph::TensorID(1));
+        CHECK(&NeuralNetwork::Computation::Graph::ComputationalGraphMap::get() == &context);
+    }
+
+    SUBCASE("Binding Is Restored On Scope Exit")
+    {
+        auto& outer = NeuralNetwork::Computation::Graph::ComputationalGraphMap::get();
+        {
+            NeuralNetwork::Computation::Graph::GraphContext context;
+            NeuralNetwork::Computation::Graph::GraphContext::Bind bind(context);
+            CHECK(&NeuralNetwork::Computation::Graph::ComputationalGraphMap::get() != &outer);
+        }
+        CHECK(&NeuralNetwork::Computation::Graph::ComputationalGraphMap::get() == &outer);
+    }
+
+    SUBCASE("Independent Training Threads")
+    {
+        constexpr int THREADS = 4;
+
+        std::vector<char> results(THREADS, false);
+        std::vector<std::thread> workers;
+
+        for (int t = 0; t < THREADS; t++) {
+            workers.emplace_back([&results, t]() { results[t] = train_in_context(5); });
+        }
+        for (auto& worker: workers) worker.join();
+
+        for (auto result: results) CHECK(result == true);
+    }
+
+
+}
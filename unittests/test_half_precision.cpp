@@ -0,0 +1,212 @@
+#include "../deps/doctest.h"
+
+#include "../include/config.h"
+#include "../include/matrix.h"
+#include "../include/generator.h"
+#include "../include/m_algorithms.h"
+#include "../include/half_precision.h"
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+
+TEST_CASE("Half Precision Storage")
+{
+
+    SUBCASE("bfloat16 Rounds To Nearest Even")
+    {
+        CHECK(Matrix::bfloat16::from_float(1.0f).bits == 0x3f80);
+        CHECK(Matrix::bfloat16::from_float(-2.0f).bits == 0xc000);
+
+        // 1 + 2^-8 is halfway between 1 and 1 + 2^-7: ties to the even mantissa.
+        CHECK(Matrix::bfloat16::from_float(1.00390625f).to_float() == 1.0f);
+        CHECK(Matrix::bfloat16::from_float(1.01171875f).to_float() == 1.015625f);
+
+        CHECK(std::isinf(Matrix::bfloat16::from_float(std::numeric_limits<float>::infinity()).to_float()));
+        CHECK(std::isnan(Matrix::bfloat16::from_float(std::numeric_limits<float>::quiet_NaN()).to_float()));
+    }
+
+
+    SUBCASE("float16 Range")
+    {
+        CHECK(Matrix::float16::from_float(1.0f).bits == 0x3c00);
+        CHECK(Matrix::float16::from_float(-0.5f).bits == 0xb800);
+        CHECK(Matrix::float16::from_float(65504.0f).to_float() == 65504.0f);
+
+        // Past the largest finite value, and rounding up into it.
+        CHECK(std::isinf(Matrix::float16::from_float(65520.0f).to_float()));
+        CHECK(std::isinf(Matrix::float16::from_float(1e6f).to_float()));
+
+        // Smallest subnormal, 2^-24, and a value that rounds to it.
+        CHECK(Matrix::float16::from_float(std::ldexp(1.0f, -24)).bits == 0x0001);
+        CHECK(Matrix::float16::from_bits(0x0001).to_float() == std::ldexp(1.0f, -24));
+        CHECK(Matrix::float16::from_float(std::ldexp(1.0f, -26)).bits == 0x0000);
+
+        CHECK(std::isnan(Matrix::float16::from_float(std::numeric_limits<float>::quiet_NaN()).to_float()));
+    }
+
+
+    SUBCASE("Round Trip Halves The Bytes")
+    {
+        Matrix::Generation::Normal<0, 1> normal_distribution_init;
+        Matrix::Representation m = Matrix::Representation(Matrix::Rows(37), Matrix::Columns(53));
+        m = normal_distribution_init(m);
+
+        Matrix::BFloat16Representation b = Matrix::narrow<Matrix::bfloat16>(m);
+        Matrix::Float16Representation  h = Matrix::narrow<Matrix::float16>(m);
+
+        CHECK(b.bytes() * 2 == m.bytes());
+        CHECK(h.bytes() * 2 == m.bytes());
+
+        Matrix::Representation rb = Matrix::widen(b);
+        Matrix::Representation rh = Matrix::widen(h);
+
+        for (u_int64_t i = 0; i < m.size(); i++) {
+            const float x = m.constScanStart()[i];
+            CHECK(std::abs(rb.constScanStart()[i] - x) <= std::abs(x) * 0x1p-8f);
+            CHECK(std::abs(rh.constScanStart()[i] - x) <= std::abs(x) * 0x1p-11f + 0x1p-25f);
+        }
+    }
+
+
+    SUBCASE("16-bit Matrices Are Representations")
+    {
+        Matrix::Representation m = Matrix::Representation(Matrix::Rows(3), Matrix::Columns(4));
+        for (u_int64_t i = 0; i < m.size(); i++) m.scanStart()[i] = float(i) - 5.5f;
+
+        Matrix::BFloat16Representation b = Matrix::BFloat16Representation(Matrix::Rows(3), Matrix::Columns(4));
+        CHECK(b.get(2, 3) == 0.0f);
+
+        b.put(1, 2, Matrix::bfloat16(0.75f));
+        CHECK(b.get(1, 2) == 0.75f);
+
+        // Narrowing into a view of the right shape writes through to the memory it views.
+        std::vector<Matrix::bfloat16> slab(m.size());
+        Matrix::BFloat16Representation view = Matrix::BFloat16Representation::view_of(Matrix::Rows(3), Matrix::Columns(4), slab.data());
+
+        Matrix::narrow(m, view);
+
+        CHECK(view.is_view());
+        CHECK(slab[7].to_float() == 1.5f);
+
+        Matrix::BFloat16Representation copy{view};
+        CHECK(!copy.is_view());
+        CHECK(copy == view);
+    }
+
+}
+
+
+TEST_CASE("Low Precision Kernels")
+{
+
+    Matrix::Generation::Normal<0, 1> normal_distribution_init;
+
+    Matrix::Representation a = Matrix::Representation(Matrix::Rows(45), Matrix::Columns(70));
+    Matrix::Representation b = Matrix::Representation(Matrix::Rows(70), Matrix::Columns(300));
+    a = (1 / DAMPEN) * normal_distribution_init(a);
+    b = (1 / DAMPEN) * normal_distribution_init(b);
+
+    Matrix::Operations::Binary::Multiplication::ParallelDNC mul;
+
+    auto close = [](const Matrix::Representation& x, const Matrix::Representation& y) {
+        REQUIRE(x.num_rows() == y.num_rows());
+        REQUIRE(x.num_cols() == y.num_cols());
+        for (u_int64_t i = 0; i < x.size(); i++) {
+            if (std::abs(x.constScanStart()[i] - y.constScanStart()[i]) > 1e-3f * (1 + std::abs(y.constScanStart()[i]))) return false;
+        }
+        return true;
+    };
+
+
+    SUBCASE("GEMM Accumulates In fp32")
+    {
+        Matrix::BFloat16Representation a16 = Matrix::narrow<Matrix::bfloat16>(a);
+        Matrix::BFloat16Representation b16 = Matrix::narrow<Matrix::bfloat16>(b);
+
+        // Against fp32 GEMM on the same (rounded) values, only summation order differs.
+        Matrix::Representation expected = mul(a, Matrix::widen(b16));
+        CHECK(close(Matrix::Operations::LowPrecision::multiply(a, b16), expected));
+
+        expected = mul(Matrix::widen(a16), Matrix::widen(b16));
+        CHECK(close(Matrix::Operations::LowPrecision::multiply(a16, b16), expected));
+
+        expected = mul(Matrix::widen(a16), b);
+        CHECK(close(Matrix::Operations::LowPrecision::multiply(a16, b), expected));
+    }
+
+
+    SUBCASE("GEMV")
+    {
+        Matrix::Float16Representation b16 = Matrix::narrow<Matrix::float16>(b);
+
+        Matrix::Representation x = Matrix::Representation(Matrix::Rows(1), Matrix::Columns(70));
+        x = (1 / DAMPEN) * normal_distribution_init(x);
+
+        CHECK(close(Matrix::Operations::LowPrecision::multiply(x, b16), mul(x, Matrix::widen(b16))));
+    }
+
+
+    SUBCASE("Backward Products")
+    {
+        Matrix::Representation g = Matrix::Representation(Matrix::Rows(45), Matrix::Columns(300));
+        g = (1 / DAMPEN) * normal_distribution_init(g);
+
+        Matrix::Operations::Unary::Transpose transpose;
+
+        Matrix::BFloat16Representation a16 = Matrix::narrow<Matrix::bfloat16>(a);
+        Matrix::BFloat16Representation b16 = Matrix::narrow<Matrix::bfloat16>(b);
+        Matrix::BFloat16Representation g16 = Matrix::narrow<Matrix::bfloat16>(g);
+
+        // aᵀ·g, the weight gradient, and g·bᵀ, the input gradient.
+        CHECK(close(Matrix::Operations::LowPrecision::transpose_multiply(a16, g16), mul(transpose(Matrix::widen(a16)), Matrix::widen(g16))));
+        CHECK(close(Matrix::Operations::LowPrecision::multiply_transpose(g16, b16), mul(Matrix::widen(g16), transpose(Matrix::widen(b16)))));
+    }
+
+
+    SUBCASE("Bias")
+    {
+        Matrix::Representation bias = Matrix::Representation(Matrix::Rows(1), Matrix::Columns(70));
+        bias = normal_distribution_init(bias);
+
+        Matrix::Float16Representation a16 = Matrix::narrow<Matrix::float16>(a);
+        Matrix::Representation wa = Matrix::widen(a16);
+
+        Matrix::Representation sum = Matrix::Operations::LowPrecision::add(a16, bias);
+        Matrix::Representation rows = Matrix::Operations::LowPrecision::sum_rows(a16);
+
+        Matrix::Operations::Unary::SumRows sum_rows;
+        CHECK(close(rows, sum_rows(wa)));
+
+        for (u_int64_t i = 0; i < a.num_rows(); i++) {
+            for (u_int64_t j = 0; j < a.num_cols(); j++) CHECK(sum.get(i, j) == wa.get(i, j) + bias.get(0, j));
+        }
+    }
+
+
+    SUBCASE("Elementwise")
+    {
+        Matrix::Representation c = Matrix::Representation(Matrix::Rows(45), Matrix::Columns(70));
+        c = (1 / DAMPEN) * normal_distribution_init(c);
+
+        Matrix::Float16Representation a16 = Matrix::narrow<Matrix::float16>(a);
+        Matrix::Float16Representation c16 = Matrix::narrow<Matrix::float16>(c);
+
+        Matrix::Representation wa = Matrix::widen(a16);
+        Matrix::Representation wc = Matrix::widen(c16);
+
+        Matrix::Representation sum  = Matrix::Operations::LowPrecision::add(a16, c);
+        Matrix::Representation prod = Matrix::Operations::LowPrecision::hadamard(a16, c16);
+        Matrix::Representation relu = Matrix::Operations::LowPrecision::relu(a16);
+        Matrix::Representation relu_gradient = Matrix::Operations::LowPrecision::relu_gradient(a16, c16);
+
+        for (u_int64_t i = 0; i < a.size(); i++) {
+            CHECK(sum.constScanStart()[i]  == wa.constScanStart()[i] + c.constScanStart()[i]);
+            CHECK(prod.constScanStart()[i] == wa.constScanStart()[i] * wc.constScanStart()[i]);
+            CHECK(relu.constScanStart()[i] == std::max(wa.constScanStart()[i], 0.0f));
+            CHECK(relu_gradient.constScanStart()[i] == (wa.constScanStart()[i] > 0 ? wc.constScanStart()[i] : 0.0f));
+        }
+    }
+
+}
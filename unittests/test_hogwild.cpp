@@ -0,0 +1,105 @@
+#include "../deps/doctest.h"
+
+#include "../include/config.h"
+#include "../include/matrix.h"
+#include "../include/generator.h"
+#include "../include/tensor.h"
+#include "../include/tensor_factory.h"
+#include "../include/tensor_forward_wrapper.h"
+#include "../include/network_layer.h"
+#include "../include/activation_layer.h"
+#include "../include/optimizer.h"
+#include "../include/data_parallel.h"
+#include "../include/hogwild.h"
+
+#include <vector>
+
+
+TEST_CASE("Hogwild Asynchronous SGD")
+{
+
+    constexpr u_int64_t SAMPLES = 24;
+    constexpr u_int64_t BATCH   = 4;
+    constexpr float LEARNING_RATE = 0.05f;
+
+    Matrix::Generation::Normal<0, 1> normal_distribution_init;
+
+    auto build = [](NeuralNetwork::Sequential& model) {
+        model.add(std::make_unique<NeuralNetwork::Layer>(
+            std::make_unique<NeuralNetwork::MatrixMultiplyStep>(Matrix::Rows(10), Matrix::Columns(8)),
+            std::make_unique<NeuralNetwork::AddStep>(Matrix::Columns(8))));
+        model.add(std::make_unique<NeuralNetwork::ActivationFunctions::ReLU>());
+        model.add(std::make_unique<NeuralNetwork::Layer>(
+            std::make_unique<NeuralNetwork::MatrixMultiplyStep>(Matrix::Rows(8), Matrix::Columns(3)),
+            std::make_unique<NeuralNetwork::AddStep>(Matrix::Columns(3))));
+    };
+
+    Matrix::Representation inputs = Matrix::Representation(Matrix::Rows(SAMPLES), Matrix::Columns(10));
+    Matrix::Representation labels = Matrix::Representation(Matrix::Rows(SAMPLES), Matrix::Columns(3));
+    inputs = normal_distribution_init(inputs);
+    inputs = (1 / DAMPEN) * inputs;
+
+    // Learnable labels: the largest of the first three features.
+    for (u_int64_t i = 0; i < SAMPLES; i++) {
+        u_int64_t label = 0;
+        for (u_int64_t c = 1; c < 3; c++) if (inputs.get(i, c) > inputs.get(i, label)) label = c;
+        labels.put(i, label, 1);
+    }
+
+    NeuralNetwork::Sequential model;
+    build(model);
+    for (auto& param: model.parameters()) param->release_matrix() = normal_distribution_init(param->release_matrix());
+    auto flat = model.flatten();
+
+    std::vector<float> initial(flat->size());
+    flat->snapshot(initial.data());
+
+
+    SUBCASE("Single Thread Matches The Synchronous Loop")
+    {
+        NeuralNetwork::Sequential reference;
+        build(reference);
+        auto reference_flat = reference.flatten();
+        reference_flat->restore(initial.data());
+
+        NeuralNetwork::Optimization::SGD sgd(reference_flat, LEARNING_RATE);
+        NeuralNetwork::Computation::Graph::TensorOp CE(Matrix::Operations::Metric::CrossEntropy{});
+
+        for (u_int64_t first = 0; first < SAMPLES; first += BATCH) {
+            auto loss = CE(
+                NeuralNetwork::Computation::Graph::TensorConstructor::create(
+                    NeuralNetwork::Training::slice_rows(labels, first, first + BATCH)),
+                reference.forward(NeuralNetwork::Computation::Graph::TensorConstructor::create(
+                    NeuralNetwork::Training::slice_rows(inputs, first, first + BATCH))));
+            loss->backwards();
+            sgd.step();
+        }
+
+        NeuralNetwork::Training::Hogwild trainer(model, build, 1, LEARNING_RATE);
+        trainer.epoch(inputs, labels, BATCH);
+
+        for (size_t k = 0; k < flat->size(); k++) {
+            CHECK(flat->weights()[k] == doctest::Approx(reference_flat->weights()[k]).epsilon(1e-4));
+        }
+    }
+
+
+    SUBCASE("Concurrent Threads Update Shared Weights")
+    {
+        for (auto policy: {NeuralNetwork::Training::UpdatePolicy::RACY,
+                           NeuralNetwork::Training::UpdatePolicy::RELAXED_ATOMIC}) {
+
+            flat->restore(initial.data());
+
+            NeuralNetwork::Training::Hogwild trainer(model, build, 4, LEARNING_RATE, policy);
+            REQUIRE(trainer.workers() == 4);
+
+            float first = trainer.epoch(inputs, labels, BATCH);
+            float last  = first;
+            for (int i = 0; i < 10; i++) last = trainer.epoch(inputs, labels, BATCH);
+
+            CHECK(last < first);
+        }
+    }
+
+}
@@ -0,0 +1,99 @@
+#include "../deps/doctest.h"
+
+#include "../include/matrix.h"
+#include "../include/tensor.h"
+#include "../include/grad_mode.h"
+#include "../include/network_layer.h"
+#include "../include/activation_layer.h"
+#include "../include/inference_engine.h"
+
+#include <cmath>
+#include <vector>
+
+
+TEST_CASE("Ping Pong Inference Engine")
+{
+
+    // Reference: the graph forward, one sample, in no-grad mode.
+    auto forward = [](NeuralNetwork::Sequential& model, const std::vector<float>& x) {
+        NeuralNetwork::Computation::Graph::NoGradGuard no_grad;
+
+        Matrix::Representation m = Matrix::Representation(Matrix::Rows(1), Matrix::Columns(x.size()));
+        std::copy(x.begin(), x.end(), m.scanStart());
+
+        auto out = model.forward(std::make_shared<NeuralNetwork::Computation::Graph::Tensor>(std::move(m)));
+        return std::vector<float>(out->release_matrix().constScanStart(), out->release_matrix().constScanEnd());
+    };
+
+    auto matches = [](const float* y, const std::vector<float>& expected) {
+        bool same = true;
+        for (size_t i = 0; i < expected.size(); i++) same = same && std::abs(y[i] - expected[i]) < 1e-4f * (1 + std::abs(expected[i]));
+        return same;
+    };
+
+    auto sample = [](u_int64_t width, int seed) {
+        std::vector<float> x(width);
+        for (u_int64_t c = 0; c < width; c++) x[c] = std::sin(float(seed * 131 + c));
+        return x;
+    };
+
+
+    SUBCASE("Matches The Graph Forward")
+    {
+        NeuralNetwork::Sequential model;
+        model.add(std::make_unique<NeuralNetwork::Layer>(
+            std::make_unique<NeuralNetwork::MatrixMultiplyStep>(Matrix::Rows(300), Matrix::Columns(1000)),
+            std::make_unique<NeuralNetwork::AddStep>(Matrix::Columns(1000))));
+        model.add(std::make_unique<NeuralNetwork::ActivationFunctions::ReLU>());
+        model.add(std::make_unique<NeuralNetwork::Layer>(
+            std::make_unique<NeuralNetwork::MatrixMultiplyStep>(Matrix::Rows(1000), Matrix::Columns(40)),
+            std::make_unique<NeuralNetwork::AddStep>(Matrix::Columns(40))));
+        model.add(std::make_unique<NeuralNetwork::ActivationFunctions::ReLU>());
+        model.add(std::make_unique<NeuralNetwork::Layer>(
+            std::make_unique<NeuralNetwork::MatrixMultiplyStep>(Matrix::Rows(40), Matrix::Columns(10)),
+            std::make_unique<NeuralNetwork::AddStep>(Matrix::Columns(10))));
+        model.add(std::make_unique<NeuralNetwork::ActivationFunctions::SoftMax>());
+
+        NeuralNetwork::Inference::InferenceEngine engine(model, 300);
+
+        REQUIRE(engine.is_compiled());
+        CHECK(engine.kernels() == 4);
+        CHECK(engine.output_width() == 10);
+
+        for (int seed = 0; seed < 5; seed++) {
+            auto x = sample(300, seed);
+            CHECK(matches(engine.run(x.data()), forward(model, x)));
+        }
+    }
+
+
+    SUBCASE("Leading Activation Leaves The Input Alone")
+    {
+        NeuralNetwork::Sequential model;
+        model.add(std::make_unique<NeuralNetwork::ActivationFunctions::ReLU>());
+        model.add(std::make_unique<NeuralNetwork::Layer>(
+            std::make_unique<NeuralNetwork::MatrixMultiplyStep>(Matrix::Rows(16), Matrix::Columns(6)),
+            std::make_unique<NeuralNetwork::AddStep>(Matrix::Columns(6))));
+
+        NeuralNetwork::Inference::InferenceEngine engine(model, 16);
+        REQUIRE(engine.is_compiled());
+
+        auto x = sample(16, 1);
+        auto copy = x;
+
+        CHECK(matches(engine.run(x.data()), forward(model, x)));
+        CHECK(x == copy);
+    }
+
+
+    SUBCASE("Shape Mismatch Does Not Compile")
+    {
+        NeuralNetwork::Sequential model;
+        model.add(std::make_unique<NeuralNetwork::Layer>(
+            std::make_unique<NeuralNetwork::MatrixMultiplyStep>(Matrix::Rows(8), Matrix::Columns(4)),
+            std::make_unique<NeuralNetwork::AddStep>(Matrix::Columns(4))));
+
+        CHECK(!NeuralNetwork::Inference::InferenceEngine(model, 9).is_compiled());
+        CHECK(NeuralNetwork::Inference::InferenceEngine(model, 8).is_compiled());
+    }
+}
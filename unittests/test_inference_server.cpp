@@ -0,0 +1,264 @@
+#include "../deps/doctest.h"
+
+#include "../include/matrix.h"
+#include "../include/tensor.h"
+#include "../include/tensor_factory.h"
+#include "../include/grad_mode.h"
+#include "../include/network_layer.h"
+#include "../include/activation_layer.h"
+#include "../include/mpmc_queue.h"
+#include "../include/inference_server.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <future>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+
+TEST_CASE("MPMC Queue")
+{
+
+    constexpr int PRODUCERS = 4;
+    constexpr int ITEMS = 5000;
+
+    NeuralNetwork::Serving::MPMCQueue<int> queue(64);
+
+    int value;
+    CHECK(!queue.try_pop(value));
+
+    std::vector<std::thread> threads;
+    std::vector<std::vector<int>> popped(2);
+
+    for (int p = 0; p < PRODUCERS; p++) {
+        threads.emplace_back([&queue, p]() {
+            for (int i = 0; i < ITEMS; i++) {
+                int item = p * ITEMS + i;
+                while (!queue.try_push(std::move(item))) std::this_thread::yield();
+            }
+        });
+    }
+
+    for (int c = 0; c < 2; c++) {
+        threads.emplace_back([&queue, &popped, c]() {
+            while (popped[0].size() + popped[1].size() < PRODUCERS * ITEMS) {
+                int item;
+                if (queue.try_pop(item)) popped[c].push_back(item);
+                else std::this_thread::yield();
+            }
+        });
+    }
+
+    for (auto& thread: threads) thread.join();
+
+    std::set<int> seen(popped[0].begin(), popped[0].end());
+    seen.insert(popped[1].begin(), popped[1].end());
+
+    CHECK(seen.size() == PRODUCERS * ITEMS);
+
+    // FIFO per producer, as every consumer sees it.
+    for (auto& items: popped) {
+        std::vector<int> last(PRODUCERS, -1);
+        bool ordered = true;
+        for (int item: items) {
+            ordered = ordered && item > last[item / ITEMS];
+            last[item / ITEMS] = item;
+        }
+        CHECK(ordered);
+    }
+}
+
+
+TEST_CASE("Batched Inference Server")
+{
+
+    constexpr u_int64_t INPUTS  = 12;
+    constexpr u_int64_t OUTPUTS = 4;
+    constexpr int REQUESTS = 40;
+
+    NeuralNetwork::Sequential model;
+    model.add(std::make_unique<NeuralNetwork::Layer>(
+        std::make_unique<NeuralNetwork::MatrixMultiplyStep>(Matrix::Rows(INPUTS), Matrix::Columns(8)),
+        std::make_unique<NeuralNetwork::AddStep>(Matrix::Columns(8))));
+    model.add(std::make_unique<NeuralNetwork::ActivationFunctions::ReLU>());
+    model.add(std::make_unique<NeuralNetwork::Layer>(
+        std::make_unique<NeuralNetwork::MatrixMultiplyStep>(Matrix::Rows(8), Matrix::Columns(OUTPUTS)),
+        std::make_unique<NeuralNetwork::AddStep>(Matrix::Columns(OUTPUTS))));
+
+    auto sample = [](int i) {
+        std::vector<float> x(INPUTS);
+        for (u_int64_t c = 0; c < INPUTS; c++) x[c] = std::sin(float(i * INPUTS + c));
+        return x;
+    };
+
+    // Computed one sample at a time, before the server owns the model.
+    std::vector<std::vector<float>> expected;
+    {
+        NeuralNetwork::Computation::Graph::NoGradGuard no_grad;
+
+        for (int i = 0; i < REQUESTS; i++) {
+            auto x = sample(i);
+            Matrix::Representation m = Matrix::Representation(Matrix::Rows(1), Matrix::Columns(INPUTS));
+            std::copy(x.begin(), x.end(), m.scanStart());
+
+            auto out = model.forward(std::make_shared<NeuralNetwork::Computation::Graph::Tensor>(std::move(m)));
+            expected.emplace_back(out->release_matrix().constScanStart(), out->release_matrix().constScanEnd());
+        }
+    }
+
+    auto close = [](const std::vector<float>& a, const std::vector<float>& b) {
+        bool same = a.size() == b.size();
+        for (size_t i = 0; same && i < a.size(); i++) same = std::abs(a[i] - b[i]) < 1e-5f;
+        return same;
+    };
+
+
+    SUBCASE("Concurrent Requests Are Batched")
+    {
+        NeuralNetwork::Serving::InferenceServer server(model, INPUTS, 16, std::chrono::milliseconds(20));
+
+        std::vector<std::future<std::vector<float>>> results;
+        for (int i = 0; i < REQUESTS; i++) results.push_back(server.submit(sample(i)));
+
+        bool all = true;
+        for (int i = 0; i < REQUESTS; i++) all = close(results[i].get(), expected[i]) && all;
+        CHECK(all);
+
+        server.stop();
+
+        CHECK(server.requests() == REQUESTS);
+        CHECK(server.batches() < REQUESTS);
+    }
+
+
+    SUBCASE("A Lone Request Runs After The Deadline")
+    {
+        NeuralNetwork::Serving::InferenceServer server(model, INPUTS, 64, std::chrono::microseconds(200));
+
+        auto result = server.submit(sample(3));
+
+        REQUIRE(result.wait_for(std::chrono::seconds(5)) == std::future_status::ready);
+        CHECK(close(result.get(), expected[3]));
+    }
+
+
+    SUBCASE("Serving Never Touches The Graph")
+    {
+        // More batches than the graph registry has entries.
+        constexpr int BATCHES = 2100;
+
+        auto& context = model.parameters().front()->get_context();
+
+        NeuralNetwork::Serving::InferenceServer server(model, INPUTS, 1, std::chrono::microseconds(0));
+
+        bool all = true;
+        for (int i = 0; i < BATCHES; i++) {
+            auto result = server.submit(sample(i % REQUESTS));
+            CHECK(context.is_grad_enabled());
+            all = close(result.get(), expected[i % REQUESTS]) && all;
+        }
+        CHECK(all);
+
+        server.stop();
+
+        CHECK(server.batches() == BATCHES);
+
+        // The model still trains, the server registered nothing.
+        auto x = sample(0);
+        Matrix::Representation m = Matrix::Representation(Matrix::Rows(1), Matrix::Columns(INPUTS));
+        std::copy(x.begin(), x.end(), m.scanStart());
+
+        auto out = model.forward(NeuralNetwork::Computation::Graph::TensorConstructor::create(m));
+        CHECK(out->get_tensor_id() != NeuralNetwork::Computation::Graph::TensorID(0));
+    }
+
+
+    SUBCASE("Unix Socket")
+    {
+        const std::string path = (std::filesystem::temp_directory_path() / "wirikuta_test_server.sock").string();
+
+        NeuralNetwork::Serving::InferenceServer server(model, INPUTS, 8, std::chrono::milliseconds(1));
+        REQUIRE(server.listen(path));
+
+        int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        sockaddr_un address = {};
+        address.sun_family = AF_UNIX;
+        std::strcpy(address.sun_path, path.c_str());
+        REQUIRE(::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0);
+
+        // Pipelined: every request is sent before any response is read.
+        for (int i = 0; i < REQUESTS; i++) {
+            uint32_t count = INPUTS;
+            auto x = sample(i);
+            REQUIRE(::write(fd, &count, sizeof(count)) == sizeof(count));
+            REQUIRE(::write(fd, x.data(), INPUTS * sizeof(float)) == INPUTS * sizeof(float));
+        }
+
+        bool all = true;
+        for (int i = 0; i < REQUESTS; i++) {
+            uint32_t count = 0;
+            std::vector<float> y(OUTPUTS);
+            REQUIRE(::recv(fd, &count, sizeof(count), MSG_WAITALL) == sizeof(count));
+            REQUIRE(count == OUTPUTS);
+            REQUIRE(::recv(fd, y.data(), OUTPUTS * sizeof(float), MSG_WAITALL) == OUTPUTS * sizeof(float));
+            all = close(y, expected[i]) && all;
+        }
+        CHECK(all);
+
+        // A malformed request closes the connection.
+        uint32_t wrong = INPUTS + 1;
+        REQUIRE(::write(fd, &wrong, sizeof(wrong)) == sizeof(wrong));
+        char byte;
+        CHECK(::recv(fd, &byte, 1, 0) == 0);
+
+        ::close(fd);
+        server.stop();
+
+        CHECK(!std::filesystem::exists(path));
+    }
+
+    SUBCASE("Reader Threads Exit With Their Clients")
+    {
+        const std::string path = (std::filesystem::temp_directory_path() / "wirikuta_test_churn.sock").string();
+
+        NeuralNetwork::Serving::InferenceServer server(model, INPUTS, 8, std::chrono::milliseconds(1));
+        REQUIRE(server.listen(path));
+
+        for (int c = 0; c < 64; c++) {
+
+            int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+            sockaddr_un address = {};
+            address.sun_family = AF_UNIX;
+            std::strcpy(address.sun_path, path.c_str());
+            REQUIRE(::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0);
+
+            uint32_t count = INPUTS;
+            auto x = sample(c % REQUESTS);
+            REQUIRE(::write(fd, &count, sizeof(count)) == sizeof(count));
+            REQUIRE(::write(fd, x.data(), INPUTS * sizeof(float)) == INPUTS * sizeof(float));
+
+            std::vector<float> y(OUTPUTS);
+            REQUIRE(::recv(fd, &count, sizeof(count), MSG_WAITALL) == sizeof(count));
+            REQUIRE(::recv(fd, y.data(), OUTPUTS * sizeof(float), MSG_WAITALL) == OUTPUTS * sizeof(float));
+
+            ::close(fd);
+        }
+
+        // Every reader notices its client hung up and exits on its own.
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (server.clients() > 0 && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        CHECK(server.clients() == 0);
+
+        server.stop();
+    }
+}
@@ -0,0 +1,170 @@
+#include "../deps/doctest.h"
+
+#include "../include/config.h"
+#include "../include/matrix.h"
+#include "../include/generator.h"
+#include "../include/network_layer.h"
+#include "../include/activation_layer.h"
+#include "../include/optimizer.h"
+#include "../include/data_parallel.h"
+#include "../include/half_precision.h"
+#include "../include/loss_scaling.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+
+TEST_CASE("Dynamic Loss Scaling")
+{
+    NeuralNetwork::Training::DynamicLossScaler scaler(1024.0f, 2.0f, 0.5f, 3);
+
+    CHECK(!scaler.update(true));
+    CHECK(scaler.scale() == 512.0f);
+    CHECK(scaler.skipped() == 1);
+
+    CHECK(scaler.update(false));
+    CHECK(scaler.update(false));
+    CHECK(scaler.scale() == 512.0f);
+    CHECK(scaler.update(false));
+    CHECK(scaler.scale() == 1024.0f);
+
+    // An overflow restarts the count of clean steps.
+    scaler.update(false);
+    scaler.update(true);
+    scaler.update(false);
+    scaler.update(false);
+    CHECK(scaler.scale() == 512.0f);
+}
+
+
+TEST_CASE("Loss Scaled Training")
+{
+
+    constexpr u_int64_t SAMPLES = 32;
+    constexpr float LEARNING_RATE = 0.01f;
+
+    Matrix::Generation::Normal<0, 1> normal_distribution_init;
+
+    auto build = [](NeuralNetwork::Sequential& model) {
+        model.add(std::make_unique<NeuralNetwork::Layer>(
+            std::make_unique<NeuralNetwork::MatrixMultiplyStep>(Matrix::Rows(10), Matrix::Columns(16)),
+            std::make_unique<NeuralNetwork::AddStep>(Matrix::Columns(16))));
+        model.add(std::make_unique<NeuralNetwork::ActivationFunctions::ReLU>());
+        model.add(std::make_unique<NeuralNetwork::Layer>(
+            std::make_unique<NeuralNetwork::MatrixMultiplyStep>(Matrix::Rows(16), Matrix::Columns(3)),
+            std::make_unique<NeuralNetwork::AddStep>(Matrix::Columns(3))));
+    };
+
+    Matrix::Representation inputs = Matrix::Representation(Matrix::Rows(SAMPLES), Matrix::Columns(10));
+    Matrix::Representation labels = Matrix::Representation(Matrix::Rows(SAMPLES), Matrix::Columns(3));
+    inputs = normal_distribution_init(inputs);
+    inputs = (1 / DAMPEN) * inputs;
+
+    // Learnable labels: the largest of the first three features.
+    for (u_int64_t i = 0; i < SAMPLES; i++) {
+        u_int64_t label = 0;
+        for (u_int64_t c = 1; c < 3; c++) if (inputs.get(i, c) > inputs.get(i, label)) label = c;
+        labels.put(i, label, 1);
+    }
+
+    NeuralNetwork::Sequential model;
+    build(model);
+    for (auto& param: model.parameters()) param->release_matrix() = (1 / DAMPEN / 4) * normal_distribution_init(param->release_matrix());
+    auto flat = model.flatten();
+
+    std::vector<float> initial(flat->size());
+    flat->snapshot(initial.data());
+
+
+    SUBCASE("Unscaled Gradient Matches The fp32 Step To 16-bit Rounding")
+    {
+        NeuralNetwork::Training::train_rows(model, NeuralNetwork::Computation::Graph::GraphContext::get(),
+            inputs, labels, 0, SAMPLES);
+
+        std::vector<float> expected(flat->gradients(), flat->gradients() + flat->size());
+        const float largest = std::abs(*std::max_element(expected.begin(), expected.end(),
+            [](float a, float b) { return std::abs(a) < std::abs(b); }));
+
+        // Weights, activations and the gradients between layers are rounded to 8 and 11 bits of mantissa.
+        auto check = [&](auto& trainer, float tolerance) {
+
+            REQUIRE(trainer.is_compiled());
+            REQUIRE(trainer.step(inputs, labels));
+
+            for (size_t k = 0; k < flat->size(); k++) {
+                CHECK(std::abs(flat->gradients()[k] - expected[k]) <= tolerance * largest);
+            }
+        };
+
+        NeuralNetwork::Training::LossScaledTraining<Matrix::bfloat16> bf16(model);
+        check(bf16, 2e-2f);
+
+        NeuralNetwork::Training::LossScaledTraining<Matrix::float16> fp16(model, NeuralNetwork::Training::DynamicLossScaler(1024.0f));
+        check(fp16, 4e-3f);
+
+        // A step only fills the gradient, the weights are the optimizer's.
+        for (size_t k = 0; k < flat->size(); k++) CHECK(flat->weights()[k] == initial[k]);
+    }
+
+
+    SUBCASE("Weights And Activations Are Stored In 16 Bits")
+    {
+        NeuralNetwork::Training::LossScaledTraining<Matrix::bfloat16> trainer(model);
+        trainer.step(inputs, labels);
+
+        // Both weight matrices, and the input of each of the five kernels.
+        const u_int64_t weights     = 10 * 16 + 16 * 3;
+        const u_int64_t activations = SAMPLES * (10 + 16 + 16 + 16 + 3);
+
+        CHECK(trainer.stored_bytes() == sizeof(Matrix::bfloat16) * (weights + activations));
+        CHECK(trainer.stored_bytes() * 2 == sizeof(float) * (weights + activations));
+    }
+
+
+    SUBCASE("Overflow Skips The Step And Backs Off")
+    {
+        NeuralNetwork::Training::LossScaledTraining<Matrix::float16> trainer(model,
+            NeuralNetwork::Training::DynamicLossScaler(1e8f));
+
+        CHECK(!trainer.step(inputs, labels));
+        CHECK(trainer.scaler().scale() == 0.5e8f);
+        CHECK(trainer.scaler().skipped() == 1);
+        CHECK(std::all_of(flat->gradients(), flat->gradients() + flat->size(), [](float g) { return g == 0; }));
+
+        // The loss itself is reported unscaled.
+        CHECK(std::isfinite(trainer.loss()));
+        CHECK(trainer.loss() < 10 * SAMPLES);
+    }
+
+
+    SUBCASE("Converges In bf16 And fp16")
+    {
+        auto train = [&](auto& trainer) {
+
+            NeuralNetwork::Optimization::SGD sgd(model.flat_parameters(), LEARNING_RATE);
+
+            trainer.step(inputs, labels);
+            const float first = trainer.loss();
+
+            for (int i = 0; i < 150; i++) {
+                if (trainer.step(inputs, labels)) sgd.step();
+            }
+
+            CHECK(trainer.loss() < 0.5f * first);
+        };
+
+        NeuralNetwork::Training::LossScaledTraining<Matrix::bfloat16> bf16(model);
+        train(bf16);
+
+        flat->restore(initial.data());
+
+        NeuralNetwork::Training::LossScaledTraining<Matrix::float16> fp16(model);
+        train(fp16);
+
+        // 65536 times a CE gradient of order one overflows fp16 until the scale backs off.
+        CHECK(fp16.scaler().skipped() > 0);
+        CHECK(fp16.scaler().scale() < 65536.0f);
+    }
+
+}
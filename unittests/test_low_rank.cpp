@@ -0,0 +1,235 @@
+#include "../deps/doctest.h"
+
+#include "../include/matrix.h"
+#include "../include/generator.h"
+#include "../include/m_algorithms.h"
+#include "../include/tensor.h"
+#include "../include/tensor_factory.h"
+#include "../include/tensor_forward_wrapper.h"
+#include "../include/grad_mode.h"
+#include "../include/network_layer.h"
+#include "../include/activation_layer.h"
+#include "../include/inference_engine.h"
+#include "../include/decomposition.h"
+
+#include <cmath>
+#include <vector>
+
+
+namespace {
+
+    // An exactly rank r matrix with singular values r, r - 1, ..., 1.
+    Matrix::Representation low_rank(u_int64_t m, u_int64_t n, u_int64_t r) {
+
+        Matrix::Operations::Binary::Multiplication::ParallelDNC mul;
+
+        Matrix::Operations::Unary::Transpose transpose;
+        Matrix::Generation::Normal<0, 1> normal_distribution_init;
+
+        Matrix::Representation a = Matrix::Representation(Matrix::Rows(m), Matrix::Columns(r));
+        Matrix::Representation b = Matrix::Representation(Matrix::Rows(n), Matrix::Columns(r));
+        a = normal_distribution_init(a);
+        b = normal_distribution_init(b);
+
+        // Orthonormal singular vectors.
+        Matrix::Representation Qa{Matrix::Operations::Decomposition::qr(a).Q};
+        Matrix::Representation Qb{Matrix::Operations::Decomposition::qr(b).Q};
+
+        for (u_int64_t i = 0; i < m; i++) {
+            for (u_int64_t k = 0; k < r; k++) Qa.put(i, k, Qa.get(i, k) * float(r - k));
+        }
+
+        return mul(Qa, transpose(Qb));
+    }
+
+}
+
+
+TEST_CASE("Householder QR")
+{
+
+    Matrix::Operations::Binary::Multiplication::ParallelDNC mul;
+    Matrix::Operations::Unary::Transpose transpose;
+
+    Matrix::Representation A = Matrix::Representation(Matrix::Rows(90), Matrix::Columns(25));
+    for (u_int64_t k = 0; k < A.size(); k++) A.scanStart()[k] = std::sin(float(k * k % 97));
+
+    auto [Q, R] = Matrix::Operations::Decomposition::qr(A);
+
+    REQUIRE(Q.num_rows() == 90);
+    REQUIRE(Q.num_cols() == 25);
+    REQUIRE(R.num_rows() == 25);
+
+    Matrix::Representation QtQ = mul(transpose(Q), Q);
+    Matrix::Representation QR = mul(Q, R);
+
+    for (u_int64_t i = 0; i < 25; i++) {
+        for (u_int64_t j = 0; j < 25; j++) {
+            CHECK(QtQ.get(i, j) == doctest::Approx(i == j ? 1.0f : 0.0f).epsilon(1e-4).scale(1));
+            if (j < i) CHECK(R.get(i, j) == 0);
+        }
+    }
+
+    for (u_int64_t k = 0; k < A.size(); k++) {
+        CHECK(QR.constScanStart()[k] == doctest::Approx(A.constScanStart()[k]).epsilon(1e-4).scale(1));
+    }
+}
+
+
+TEST_CASE("Randomized SVD")
+{
+
+    Matrix::Operations::Binary::Multiplication::ParallelDNC mul;
+    Matrix::Operations::Unary::Transpose transpose;
+
+    Matrix::Representation W = low_rank(120, 80, 6);
+
+
+    SUBCASE("Recovers An Exactly Low Rank Matrix")
+    {
+        auto svd = Matrix::Operations::Decomposition::randomized_svd(W, 6);
+
+        REQUIRE(svd.S.size() == 6);
+        for (u_int64_t k = 0; k < 6; k++) CHECK(svd.S[k] == doctest::Approx(float(6 - k)).epsilon(1e-4));
+
+        Matrix::Representation UtU = mul(transpose(svd.U), svd.U);
+        Matrix::Representation VVt = mul(svd.V, transpose(svd.V));
+
+        for (u_int64_t i = 0; i < 6; i++) {
+            for (u_int64_t j = 0; j < 6; j++) {
+                CHECK(UtU.get(i, j) == doctest::Approx(i == j ? 1.0f : 0.0f).epsilon(1e-4).scale(1));
+                CHECK(VVt.get(i, j) == doctest::Approx(i == j ? 1.0f : 0.0f).epsilon(1e-4).scale(1));
+            }
+        }
+
+        for (u_int64_t i = 0; i < 120; i++) {
+            for (u_int64_t k = 0; k < 6; k++) svd.U.put(i, k, svd.U.get(i, k) * svd.S[k]);
+        }
+
+        CHECK(Matrix::Operations::Decomposition::relative_error(W, svd.U, svd.V) < 1e-4f);
+    }
+
+
+    SUBCASE("Truncation Loses The Tail")
+    {
+        auto svd = Matrix::Operations::Decomposition::randomized_svd(W, 3);
+
+        for (u_int64_t i = 0; i < 120; i++) {
+            for (u_int64_t k = 0; k < 3; k++) svd.U.put(i, k, svd.U.get(i, k) * svd.S[k]);
+        }
+
+        // The dropped singular values are 3, 2 and 1 of a norm of sqrt(91).
+        CHECK(Matrix::Operations::Decomposition::relative_error(W, svd.U, svd.V) == doctest::Approx(std::sqrt(14.0f / 91.0f)).epsilon(1e-3));
+    }
+}
+
+
+TEST_CASE("Low Rank Linear Step")
+{
+
+    constexpr u_int64_t IN = 120;
+    constexpr u_int64_t OUT = 80;
+    constexpr u_int64_t RANK = 6;
+
+    Matrix::Representation W = low_rank(IN, OUT, RANK);
+
+    auto build = [&](NeuralNetwork::Sequential& model, bool factorized) {
+        if (factorized) {
+            model.add(std::make_unique<NeuralNetwork::Layer>(
+                std::make_unique<NeuralNetwork::LowRankLinearStep>(W, RANK),
+                std::make_unique<NeuralNetwork::AddStep>(Matrix::Columns(OUT))));
+        }
+        else {
+            auto dense = std::make_unique<NeuralNetwork::MatrixMultiplyStep>(Matrix::Rows(IN), Matrix::Columns(OUT));
+            std::vector<std::shared_ptr<NeuralNetwork::Computation::Graph::Tensor>> params;
+            dense->collect_parameters(params);
+            params.front()->release_matrix() = Matrix::Representation{W};
+
+            model.add(std::make_unique<NeuralNetwork::Layer>(std::move(dense),
+                std::make_unique<NeuralNetwork::AddStep>(Matrix::Columns(OUT))));
+        }
+
+        model.add(std::make_unique<NeuralNetwork::ActivationFunctions::ReLU>());
+    };
+
+    NeuralNetwork::Sequential dense, factorized;
+    build(dense, false);
+    build(factorized, true);
+
+    // Same bias, so the layers differ only in the weights.
+    factorized.parameters().back()->release_matrix() = Matrix::Representation{dense.parameters().back()->release_matrix()};
+
+    Matrix::Representation x = Matrix::Representation(Matrix::Rows(5), Matrix::Columns(IN));
+    for (u_int64_t k = 0; k < x.size(); k++) x.scanStart()[k] = std::cos(float(k));
+
+
+    SUBCASE("Factors Hold r(m + n) Weights")
+    {
+        NeuralNetwork::LowRankLinearStep step(W, RANK);
+
+        CHECK(step.rank() == RANK);
+        CHECK(step.weight_count() == RANK * (IN + OUT));
+        CHECK(step.reconstruction_error() < 1e-4f);
+
+        auto params = factorized.parameters();
+        REQUIRE(params.size() == 3);
+        CHECK(params[0]->release_matrix().num_cols() == RANK);
+        CHECK(params[1]->release_matrix().num_rows() == RANK);
+    }
+
+
+    SUBCASE("Matches The Dense Forward")
+    {
+        NeuralNetwork::Computation::Graph::NoGradGuard no_grad;
+
+        auto expected = dense.forward(NeuralNetwork::Computation::Graph::TensorConstructor::create(x));
+        auto y = factorized.forward(NeuralNetwork::Computation::Graph::TensorConstructor::create(x));
+
+        const Matrix::Representation& e = expected->release_matrix();
+        const Matrix::Representation& o = y->release_matrix();
+
+        for (u_int64_t k = 0; k < o.size(); k++) {
+            CHECK(o.constScanStart()[k] == doctest::Approx(e.constScanStart()[k]).epsilon(1e-3).scale(1));
+        }
+    }
+
+
+    SUBCASE("Both Factors Train")
+    {
+        Matrix::Representation labels = Matrix::Representation(Matrix::Rows(5), Matrix::Columns(OUT));
+        for (u_int64_t i = 0; i < 5; i++) labels.put(i, i, 1);
+
+        NeuralNetwork::Computation::Graph::TensorOp CE(Matrix::Operations::Metric::CrossEntropy{});
+
+        auto loss = CE(NeuralNetwork::Computation::Graph::TensorConstructor::create(labels),
+            factorized.forward(NeuralNetwork::Computation::Graph::TensorConstructor::create(x)));
+        loss->backwards();
+
+        for (auto& param: factorized.parameters()) {
+            const Matrix::Representation& grad = param->get_grad();
+            REQUIRE(grad.num_rows() == param->release_matrix().num_rows());
+            REQUIRE(grad.num_cols() == param->release_matrix().num_cols());
+
+            float norm = 0;
+            for (u_int64_t k = 0; k < grad.size(); k++) norm += grad.constScanStart()[k] * grad.constScanStart()[k];
+            CHECK(norm > 0);
+        }
+    }
+
+
+    SUBCASE("Compiles Into Two Skinny Kernels")
+    {
+        NeuralNetwork::Inference::InferenceEngine engine(factorized, IN);
+        NeuralNetwork::Inference::InferenceEngine reference(dense, IN);
+
+        REQUIRE(engine.is_compiled());
+        REQUIRE(engine.output_width() == OUT);
+
+        std::vector<float> sample(x.constScanStart(), x.constScanStart() + IN);
+        std::vector<float> expected(reference.run(sample.data()), reference.run(sample.data()) + OUT);
+        const float* y = engine.run(sample.data());
+
+        for (u_int64_t c = 0; c < OUT; c++) CHECK(y[c] == doctest::Approx(expected[c]).epsilon(1e-3).scale(1));
+    }
+
+}
@@ -0,0 +1,213 @@
+#include "../deps/doctest.h"
+
+#include "../include/matrix.h"
+#include "../include/generator.h"
+#include "../include/tensor.h"
+#include "../include/tensor_factory.h"
+#include "../include/tensor_forward_wrapper.h"
+#include "../include/network_layer.h"
+#include "../include/activation_layer.h"
+#include "../include/memory_planner.h"
+
+#include <unordered_map>
+#include <vector>
+
+
+TEST_CASE("Memory Planner Liveness")
+{
+
+    using NeuralNetwork::Computation::Graph::BufferKind;
+
+    auto x  = NeuralNetwork::Computation::Graph::TensorConstructor::create(Matrix::Rows(4), Matrix::Columns(6));
+    auto w1 = NeuralNetwork::Computation::Graph::TensorConstructor::create(Matrix::Rows(6), Matrix::Columns(5));
+    auto w2 = NeuralNetwork::Computation::Graph::TensorConstructor::create(Matrix::Rows(5), Matrix::Columns(3));
+
+    NeuralNetwork::Computation::Graph::TensorOp mm(Matrix::Operations::Binary::Multiplication::ParallelDNC{});
+    NeuralNetwork::Computation::Graph::TensorOp relu(Matrix::Operations::Unary::ReLU{});
+
+    auto h   = mm(x, w1);
+    auto r   = relu(h);
+    auto out = mm(r, w2);
+
+    NeuralNetwork::Computation::Graph::MemoryPlanner planner;
+    auto plan = planner.analyse(*out);
+
+    auto order = out->get_context()._topological_order(out->get_tensor_id());
+    const size_t N = order.size();
+
+    std::unordered_map<u_int16_t, size_t> position;
+    for (size_t i = 0; i < N; i++) position[order[i].get()] = i;
+
+    auto backward_step = [N](size_t forward) { return N + (N - 1 - forward); };
+
+    const size_t ph = position[h->get_tensor_id().get()];
+    const size_t pr = position[r->get_tensor_id().get()];
+    const size_t po = position[out->get_tensor_id().get()];
+
+    // Leaves and the root are persistent, h and r each plan an activation and a gradient.
+    REQUIRE(plan.buffers().size() == 4);
+
+    for (const auto& buffer: plan.buffers()) {
+
+        const bool is_h = buffer.tensor == h->get_tensor_id();
+        REQUIRE((is_h || buffer.tensor == r->get_tensor_id()));
+
+        CHECK(buffer.bytes == 4 * 5 * sizeof(float));
+
+        if (buffer.kind == BufferKind::ACTIVATION) {
+            // Both are re-read by their consumer's backward rule (ReLU, MatrixMultiply).
+            CHECK(buffer.first_use == (is_h ? ph : pr));
+            CHECK(buffer.last_use  == backward_step(is_h ? pr : po));
+        }
+        else {
+            CHECK(buffer.first_use == backward_step(is_h ? pr : po));
+            CHECK(buffer.last_use  == backward_step(is_h ? ph : pr));
+        }
+    }
+}
+
+
+TEST_CASE("Memory Planner Packing And Binding")
+{
+
+    Matrix::Generation::Normal<0, 1> normal_distribution_init;
+
+    NeuralNetwork::Sequential model;
+    model.add(std::make_unique<NeuralNetwork::Layer>(
+        std::make_unique<NeuralNetwork::MatrixMultiplyStep>(Matrix::Rows(12), Matrix::Columns(32)),
+        std::make_unique<NeuralNetwork::AddStep>(Matrix::Columns(32))));
+    model.add(std::make_unique<NeuralNetwork::ActivationFunctions::ReLU>());
+    model.add(std::make_unique<NeuralNetwork::Layer>(
+        std::make_unique<NeuralNetwork::MatrixMultiplyStep>(Matrix::Rows(32), Matrix::Columns(16)),
+        std::make_unique<NeuralNetwork::AddStep>(Matrix::Columns(16))));
+    model.add(std::make_unique<NeuralNetwork::ActivationFunctions::ReLU>());
+    model.add(std::make_unique<NeuralNetwork::Layer>(
+        std::make_unique<NeuralNetwork::MatrixMultiplyStep>(Matrix::Rows(16), Matrix::Columns(4)),
+        std::make_unique<NeuralNetwork::AddStep>(Matrix::Columns(4))));
+
+    for (auto& param: model.parameters()) param->release_matrix() = normal_distribution_init(param->release_matrix());
+
+    Matrix::Representation inputs = Matrix::Representation(Matrix::Rows(8), Matrix::Columns(12));
+    Matrix::Representation labels = Matrix::Representation(Matrix::Rows(8), Matrix::Columns(4));
+    inputs = normal_distribution_init(inputs);
+    for (u_int64_t i = 0; i < 8; i++) labels.put(i, i % 4, 1);
+
+    NeuralNetwork::Computation::Graph::TensorOp CE(Matrix::Operations::Metric::CrossEntropy{});
+
+    auto forward = [&]() {
+        return CE(NeuralNetwork::Computation::Graph::TensorConstructor::create(labels),
+            model.forward(NeuralNetwork::Computation::Graph::TensorConstructor::create(inputs)));
+    };
+
+    auto gradients = [&]() {
+        std::vector<Matrix::Representation> grads;
+        for (auto& param: model.parameters()) grads.emplace_back(param->get_grad());
+        return grads;
+    };
+
+    auto check_matches = [&](const std::vector<Matrix::Representation>& expected, float factor) {
+        auto params = model.parameters();
+        REQUIRE(params.size() == expected.size());
+        for (size_t p = 0; p < params.size(); p++) {
+            REQUIRE(params[p]->get_grad().size() == expected[p].size());
+            for (u_int64_t k = 0; k < expected[p].size(); k++) {
+                CHECK(params[p]->get_grad().constScanStart()[k] ==
+                    doctest::Approx(factor * expected[p].constScanStart()[k]).epsilon(1e-4));
+            }
+        }
+    };
+
+    NeuralNetwork::Computation::Graph::MemoryPlanner planner;
+
+
+    SUBCASE("Overlapping Lifetimes Never Share Bytes")
+    {
+        auto loss = forward();
+        auto plan = planner.analyse(*loss);
+
+        const auto& buffers = plan.buffers();
+        REQUIRE(!buffers.empty());
+
+        for (size_t a = 0; a < buffers.size(); a++) {
+
+            CHECK(buffers[a].offset % NeuralNetwork::Computation::Graph::MemoryPlan::ALIGNMENT == 0);
+            CHECK(buffers[a].offset + buffers[a].bytes <= plan.slab_sizes()[buffers[a].slab]);
+
+            for (size_t b = a + 1; b < buffers.size(); b++) {
+
+                const bool same_slab = buffers[a].slab == buffers[b].slab;
+                const bool live_together = buffers[a].first_use <= buffers[b].last_use && buffers[b].first_use <= buffers[a].last_use;
+                const bool disjoint = buffers[a].offset + buffers[a].bytes <= buffers[b].offset ||
+                                      buffers[b].offset + buffers[b].bytes <= buffers[a].offset;
+
+                if (same_slab && live_together) CHECK(disjoint);
+            }
+        }
+
+        CHECK(plan.planned_peak_bytes() < plan.unplanned_peak_bytes());
+
+        loss->backwards();
+    }
+
+
+    SUBCASE("Replayed Steps Match The Unplanned One")
+    {
+        forward()->backwards();
+        auto expected = gradients();
+
+        auto recorded = forward();
+        auto plan = planner.analyse(*recorded);
+        recorded->backwards();
+
+        for (int step = 0; step < 2; step++) {
+
+            NeuralNetwork::Computation::Graph::MemoryPlan::Replay replay(plan);
+
+            auto loss = forward();
+
+            // Every planned intermediate was allocated straight into its slot.
+            CHECK(plan.placed() == plan.buffers().size() / 2);
+
+            loss->backwards();
+
+            check_matches(expected, 1.0f);
+        }
+    }
+
+
+    SUBCASE("Replayed Backward Accumulates From Zero")
+    {
+        forward()->backwards();
+        auto expected = gradients();
+
+        auto recorded = forward();
+        auto plan = planner.analyse(*recorded);
+
+        model.accumulate_gradients(true);
+        model.zero_grad();
+
+        for (int step = 0; step < 2; step++) {
+            NeuralNetwork::Computation::Graph::MemoryPlan::Replay replay(plan);
+            forward()->backwards();
+        }
+
+        check_matches(expected, 2.0f);
+    }
+
+
+    SUBCASE("A Different Step Falls Back To Allocating")
+    {
+        auto recorded = forward();
+        auto plan = planner.analyse(*recorded);
+        recorded->backwards();
+
+        NeuralNetwork::Computation::Graph::MemoryPlan::Replay replay(plan);
+
+        Matrix::Representation wider = Matrix::Representation(Matrix::Rows(16), Matrix::Columns(12));
+        auto out = model.forward(NeuralNetwork::Computation::Graph::TensorConstructor::create(wider));
+
+        CHECK(plan.placed() == 0);
+        CHECK(!out->release_matrix().is_view());
+    }
+
+}
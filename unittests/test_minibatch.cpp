@@ -0,0 +1,125 @@
+#include "../deps/doctest.h"
+
+#include "../include/matrix.h"
+#include "../include/generator.h"
+#include "../include/m_algorithms.h"
+#include "../include/tensor.h"
+#include "../include/tensor_factory.h"
+#include "../include/tensor_forward_wrapper.h"
+#include "../include/network_layer.h"
+#include "../include/activation_layer.h"
+
+#include <cmath>
+#include <numeric>
+#include <vector>
+
+
+namespace {
+
+    Matrix::Representation row_of(const Matrix::Representation& m, u_int64_t r) {
+
+        Matrix::Representation row = Matrix::Representation(
+            Matrix::Rows(1), Matrix::Columns(m.num_cols()));
+
+        std::copy(m.constScanStart() + r * m.num_cols(), m.constScanStart() + (r + 1) * m.num_cols(), row.scanStart());
+
+        return Matrix::Representation{row};
+    }
+
+    bool close(const Matrix::Representation& a, const Matrix::Representation& b) {
+
+        if (a.num_rows() != b.num_rows() || a.num_cols() != b.num_cols()) return false;
+
+        for (auto l = a.constScanStart(), r = b.constScanStart(); l != a.constScanEnd(); l++, r++) {
+            if (std::fabs(*l - *r) > 1e-3 * (1 + std::fabs(*r))) return false;
+        }
+        return true;
+    }
+
+}
+
+
+TEST_CASE("Minibatch Training")
+{
+
+    constexpr u_int64_t BATCH = 4;
+
+    Matrix::Generation::Normal<0, 1> normal_distribution_init;
+
+
+    SUBCASE("Row Broadcast Addition")
+    {
+        Matrix::Representation bias = Matrix::Representation(Matrix::Rows(1), Matrix::Columns(7));
+        Matrix::Representation batch = Matrix::Representation(Matrix::Rows(BATCH), Matrix::Columns(7));
+        bias  = normal_distribution_init(bias);
+        batch = normal_distribution_init(batch);
+
+        Matrix::Operations::Binary::Addition::Std add;
+        auto out = add(bias, batch);
+
+        CHECK(out.num_rows() == BATCH);
+        CHECK(out.num_cols() == 7);
+        CHECK(out.get(3, 5) == doctest::Approx(bias.get(0, 5) + batch.get(3, 5)));
+    }
+
+    SUBCASE("Row-wise Softmax")
+    {
+        Matrix::Representation batch = Matrix::Representation(Matrix::Rows(BATCH), Matrix::Columns(10));
+        batch = normal_distribution_init(batch);
+
+        Matrix::Operations::Unary::SoftMax softmax;
+        auto out = softmax(batch);
+
+        for (u_int64_t r = 0; r < BATCH; r++) {
+            auto row = row_of(out, r);
+            CHECK(std::accumulate(row.constScanStart(), row.constScanEnd(), 0.0) == doctest::Approx(1.0));
+        }
+    }
+
+    SUBCASE("Batch Gradient Is The Sum Of Sample Gradients")
+    {
+        auto ma = NeuralNetwork::Computation::Graph::TensorConstructor::create(
+            Matrix::Rows(BATCH), Matrix::Columns(12));
+        auto ground_truth = NeuralNetwork::Computation::Graph::TensorConstructor::create(
+            Matrix::Rows(BATCH), Matrix::Columns(5));
+
+        NeuralNetwork::Sequential model;
+
+        model.add(std::make_unique<NeuralNetwork::Layer>(
+            std::make_unique<NeuralNetwork::MatrixMultiplyStep>(Matrix::Rows(12), Matrix::Columns(8)),
+            std::make_unique<NeuralNetwork::AddStep>(Matrix::Columns(8))));
+        model.add(std::make_unique<NeuralNetwork::ActivationFunctions::ReLU>());
+        model.add(std::make_unique<NeuralNetwork::Layer>(
+            std::make_unique<NeuralNetwork::MatrixMultiplyStep>(Matrix::Rows(8), Matrix::Columns(5)),
+            std::make_unique<NeuralNetwork::AddStep>(Matrix::Columns(5))));
+
+        NeuralNetwork::Computation::Graph::TensorOp CE(Matrix::Operations::Metric::CrossEntropy{});
+
+        auto params = model.parameters();
+
+        std::vector<Matrix::Representation> expected;
+        for (auto& param: params) {
+            expected.emplace_back(Matrix::Rows(param->num_rows().get()), Matrix::Columns(param->num_cols().get()));
+        }
+
+        for (u_int64_t r = 0; r < BATCH; r++) {
+
+            auto sample = NeuralNetwork::Computation::Graph::TensorConstructor::create(row_of(ma->release_matrix(), r));
+            auto label  = NeuralNetwork::Computation::Graph::TensorConstructor::create(row_of(ground_truth->release_matrix(), r));
+
+            auto loss = CE(label, model.forward(sample));
+            loss->backwards();
+
+            for (size_t i = 0; i < params.size(); i++) expected[i] += params[i]->get_grad();
+        }
+
+        auto loss = CE(ground_truth, model.forward(ma));
+        loss->backwards();
+
+        for (size_t i = 0; i < params.size(); i++) {
+            CHECK(close(params[i]->get_grad(), expected[i]) == true);
+        }
+    }
+
+
+}
@@ -0,0 +1,130 @@
+#include "../deps/doctest.h"
+
+#include "../include/matrix.h"
+#include "../include/generator.h"
+#include "../include/tensor.h"
+#include "../include/network_layer.h"
+#include "../include/activation_layer.h"
+#include "../include/parameter_buffer.h"
+#include "../include/checkpoint.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+
+TEST_CASE("Model Checkpoint Save And Load")
+{
+
+    auto build = [](NeuralNetwork::Sequential& model) {
+        model.add(std::make_unique<NeuralNetwork::Layer>(
+            std::make_unique<NeuralNetwork::MatrixMultiplyStep>(Matrix::Rows(10), Matrix::Columns(7)),
+            std::make_unique<NeuralNetwork::AddStep>(Matrix::Columns(7))));
+        model.add(std::make_unique<NeuralNetwork::ActivationFunctions::ReLU>());
+        model.add(std::make_unique<NeuralNetwork::Layer>(
+            std::make_unique<NeuralNetwork::MatrixMultiplyStep>(Matrix::Rows(7), Matrix::Columns(3)),
+            std::make_unique<NeuralNetwork::AddStep>(Matrix::Columns(3))));
+    };
+
+    auto same_weights = [](NeuralNetwork::Sequential& left, NeuralNetwork::Sequential& right) {
+        auto a = left.parameters();
+        auto b = right.parameters();
+        bool same = a.size() == b.size();
+        for (size_t i = 0; same && i < a.size(); i++) {
+            same = a[i]->release_matrix() == Matrix::Representation{b[i]->release_matrix()};
+        }
+        return same;
+    };
+
+    const std::string path = (std::filesystem::temp_directory_path() / "wirikuta_test_model.wrkc").string();
+
+    NeuralNetwork::Sequential model;
+    build(model);
+
+
+    SUBCASE("Round Trip")
+    {
+        REQUIRE(model.save(path));
+
+        NeuralNetwork::Sequential restored;
+        build(restored);
+
+        CHECK(!same_weights(model, restored));
+        REQUIRE(restored.load(path));
+        CHECK(same_weights(model, restored));
+
+        auto flat = restored.flat_parameters();
+        REQUIRE(flat);
+        CHECK(reinterpret_cast<uintptr_t>(flat->weights()) % NeuralNetwork::Serialization::CHECKPOINT_ALIGNMENT == 0);
+
+        for (auto& param: restored.parameters()) {
+            CHECK(param->release_matrix().is_view());
+            CHECK(param->get_grad().size() == param->release_matrix().size());
+        }
+    }
+
+
+    SUBCASE("Flattened Models Save The Same File")
+    {
+        const std::string other = path + ".flat";
+
+        REQUIRE(model.save(path));
+        model.flatten();
+        REQUIRE(model.save(other));
+
+        std::ifstream a(path, std::ios::binary), b(other, std::ios::binary);
+        std::vector<char> left((std::istreambuf_iterator<char>(a)), std::istreambuf_iterator<char>());
+        std::vector<char> right((std::istreambuf_iterator<char>(b)), std::istreambuf_iterator<char>());
+
+        CHECK(left == right);
+
+        std::remove(other.c_str());
+    }
+
+
+    SUBCASE("Training After Load Is Copy On Write")
+    {
+        REQUIRE(model.save(path));
+
+        NeuralNetwork::Sequential trained;
+        build(trained);
+        REQUIRE(trained.load(path));
+
+        for (auto& param: trained.parameters()) {
+            auto& matrix = param->release_matrix();
+            std::fill(matrix.scanStart(), matrix.scanEnd(), 42.0f);
+        }
+
+        NeuralNetwork::Sequential reloaded;
+        build(reloaded);
+        REQUIRE(reloaded.load(path));
+
+        CHECK(same_weights(model, reloaded));
+        CHECK(!same_weights(trained, reloaded));
+    }
+
+
+    SUBCASE("Rejects Other Models And Files")
+    {
+        REQUIRE(model.save(path));
+
+        NeuralNetwork::Sequential wider;
+        wider.add(std::make_unique<NeuralNetwork::Layer>(
+            std::make_unique<NeuralNetwork::MatrixMultiplyStep>(Matrix::Rows(10), Matrix::Columns(8)),
+            std::make_unique<NeuralNetwork::AddStep>(Matrix::Columns(8))));
+
+        CHECK(!wider.load(path));
+        CHECK(!wider.flat_parameters());
+
+        NeuralNetwork::Sequential missing;
+        build(missing);
+        CHECK(!missing.load(path + ".missing"));
+
+        std::ofstream(path, std::ios::binary) << "WRKC but nothing after it, not even a full header";
+        CHECK(!NeuralNetwork::Serialization::MappedCheckpoint(path).is_open());
+    }
+
+    std::remove(path.c_str());
+}
@@ -0,0 +1,91 @@
+#include "../deps/doctest.h"
+
+#include "../include/matrix.h"
+#include "../include/tensor.h"
+#include "../include/tensor_factory.h"
+#include "../include/tensor_forward_wrapper.h"
+#include "../include/grad_mode.h"
+#include "../include/network_layer.h"
+#include "../include/activation_layer.h"
+
+#include <memory>
+#include <thread>
+
+
+TEST_CASE("No Grad Inference")
+{
+
+    auto ma = NeuralNetwork::Computation::Graph::TensorConstructor::create(
+        Matrix::Rows(1), Matrix::Columns(30));
+
+    NeuralNetwork::Sequential model;
+
+    model.add(std::make_unique<NeuralNetwork::Layer>(
+        std::make_unique<NeuralNetwork::MatrixMultiplyStep>(Matrix::Rows(30), Matrix::Columns(20)),
+        std::make_unique<NeuralNetwork::AddStep>(Matrix::Columns(20))));
+    model.add(std::make_unique<NeuralNetwork::ActivationFunctions::ReLU>());
+    model.add(std::make_unique<NeuralNetwork::Layer>(
+        std::make_unique<NeuralNetwork::MatrixMultiplyStep>(Matrix::Rows(20), Matrix::Columns(10)),
+        std::make_unique<NeuralNetwork::AddStep>(Matrix::Columns(10))));
+
+    auto recorded = model.forward(ma);
+
+
+    SUBCASE("Output Matches Recorded Forward")
+    {
+        NeuralNetwork::Computation::Graph::NoGradGuard no_grad;
+
+        auto out = model.forward(ma);
+
+        CHECK((out->release_matrix() == Matrix::Representation{recorded->release_matrix()}) == true);
+    }
+
+    SUBCASE("Nothing Is Registered")
+    {
+        NeuralNetwork::Computation::Graph::NoGradGuard no_grad;
+
+        auto out = model.forward(ma);
+
+        CHECK(out->get_tensor_id() == NeuralNetwork::Computation::Graph::TensorID(0));
+        CHECK(out->get_grad().num_rows() == 0);
+        CHECK(out->is_recorded() == false);
+    }
+
+    SUBCASE("Guard Restores Grad Mode")
+    {
+        {
+            NeuralNetwork::Computation::Graph::NoGradGuard no_grad;
+            CHECK(NeuralNetwork::Computation::Graph::GradMode::is_enabled() == false);
+        }
+        CHECK(NeuralNetwork::Computation::Graph::GradMode::is_enabled() == true);
+
+        auto out = model.forward(ma);
+        CHECK(out->get_tensor_id() != NeuralNetwork::Computation::Graph::TensorID(0));
+    }
+
+    SUBCASE("Mode Follows The Context Across Threads")
+    {
+        // A worker resuming a stolen continuation never ran the guard's constructor.
+        NeuralNetwork::Computation::Graph::NoGradGuard no_grad;
+
+        std::shared_ptr<NeuralNetwork::Computation::Graph::Tensor> out;
+        std::thread worker([&]() { out = model.forward(ma); });
+        worker.join();
+
+        CHECK(out->get_tensor_id() == NeuralNetwork::Computation::Graph::TensorID(0));
+        CHECK(&out->get_context() == &ma->get_context());
+    }
+
+    SUBCASE("Guard Leaves Other Contexts Recording")
+    {
+        NeuralNetwork::Computation::Graph::ComputationalGraphMap other;
+        NeuralNetwork::Computation::Graph::NoGradGuard no_grad(other);
+
+        CHECK(other.is_grad_enabled() == false);
+
+        auto out = model.forward(ma);
+        CHECK(out->get_tensor_id() != NeuralNetwork::Computation::Graph::TensorID(0));
+    }
+
+
+}
@@ -0,0 +1,172 @@
+#include "../deps/doctest.h"
+
+#include "../include/matrix.h"
+#include "../include/generator.h"
+#include "../include/tensor.h"
+#include "../include/tensor_factory.h"
+#include "../include/tensor_forward_wrapper.h"
+#include "../include/network_layer.h"
+#include "../include/activation_layer.h"
+#include "../include/optimizer.h"
+
+#include <cmath>
+#include <vector>
+
+
+namespace {
+
+    constexpr u_int64_t R = 37;
+    constexpr u_int64_t C = 113;
+
+    std::vector<float> flatten(const Matrix::Representation& m) {
+        return std::vector<float>(m.constScanStart(), m.constScanEnd());
+    }
+
+    bool close(const Matrix::Representation& a, const std::vector<float>& b) {
+
+        if (a.size() != b.size()) return false;
+
+        for (size_t i = 0; i < b.size(); i++) {
+            if (std::fabs(a.constScanStart()[i] - b[i]) > 1e-5 * (1 + std::fabs(b[i]))) return false;
+        }
+        return true;
+    }
+
+}
+
+
+TEST_CASE("Fused Optimizer Kernels")
+{
+
+    Matrix::Generation::Normal<0, 1> normal_distribution_init;
+
+    auto parameter = NeuralNetwork::Computation::Graph::TensorConstructor::create(
+        Matrix::Rows(R), Matrix::Columns(C));
+    parameter->release_matrix() = normal_distribution_init(parameter->release_matrix());
+
+    Matrix::Representation gradient = Matrix::Representation(Matrix::Rows(R), Matrix::Columns(C));
+    gradient = normal_distribution_init(gradient);
+
+    auto w = flatten(parameter->release_matrix());
+    auto g = flatten(gradient);
+    std::vector<float> m(w.size(), 0), v(w.size(), 0);
+
+    constexpr int STEPS = 3;
+
+
+    SUBCASE("SGD With Nesterov Momentum Matches Reference")
+    {
+        constexpr float lr = 0.1f, mu = 0.9f, wd = 0.01f;
+
+        NeuralNetwork::Optimization::SGD sgd({parameter}, lr, mu, true, wd);
+
+        for (int t = 0; t < STEPS; t++) {
+
+            parameter->get_grad() = Matrix::Representation{gradient};
+            sgd.step();
+
+            for (size_t i = 0; i < w.size(); i++) {
+                float grad = g[i] + wd * w[i];
+                m[i] = mu * m[i] + grad;
+                w[i] -= lr * (grad + mu * m[i]);
+            }
+        }
+
+        CHECK(close(parameter->release_matrix(), w));
+    }
+
+
+    SUBCASE("AdamW Matches Reference")
+    {
+        constexpr float lr = 0.01f, wd = 0.1f, b1 = 0.9f, b2 = 0.999f, eps = 1e-8f;
+
+        NeuralNetwork::Optimization::AdamW adamw({parameter}, lr, wd, b1, b2, eps);
+
+        for (int t = 1; t <= STEPS; t++) {
+
+            parameter->get_grad() = Matrix::Representation{gradient};
+            adamw.step();
+
+            for (size_t i = 0; i < w.size(); i++) {
+                m[i] = b1 * m[i] + (1 - b1) * g[i];
+                v[i] = b2 * v[i] + (1 - b2) * g[i] * g[i];
+                float m_hat = m[i] / (1 - std::pow(b1, t));
+                float v_hat = v[i] / (1 - std::pow(b2, t));
+                w[i] = w[i] * (1 - lr * wd) - lr * m_hat / (std::sqrt(v_hat) + eps);
+            }
+        }
+
+        CHECK(close(parameter->release_matrix(), w));
+    }
+
+
+    SUBCASE("Parameters Without Gradient Are Untouched")
+    {
+        auto untouched = NeuralNetwork::Computation::Graph::TensorConstructor::create(
+            Matrix::Rows(R), Matrix::Columns(C));
+        untouched->release_matrix() = normal_distribution_init(untouched->release_matrix());
+        auto before = flatten(untouched->release_matrix());
+
+        NeuralNetwork::Optimization::Adam adam({untouched}, 0.1f);
+        adam.step();
+
+        CHECK(close(untouched->release_matrix(), before));
+    }
+
+
+    SUBCASE("Late Parameters Are Bias Corrected From Their Own First Step")
+    {
+        constexpr float lr = 0.01f;
+
+        auto early = NeuralNetwork::Computation::Graph::TensorConstructor::create(
+            Matrix::Rows(R), Matrix::Columns(C));
+
+        NeuralNetwork::Optimization::Adam adam({early, parameter}, lr);
+
+        for (int t = 0; t < 5; t++) {
+            early->get_grad() = Matrix::Representation{gradient};
+            adam.step();
+        }
+
+        parameter->get_grad() = Matrix::Representation{gradient};
+        adam.step();
+
+        // A first Adam step moves every weight by about lr, whatever the gradient's scale.
+        for (size_t i = 0; i < w.size(); i++) {
+            CHECK(std::fabs(parameter->release_matrix().constScanStart()[i] - w[i]) == doctest::Approx(lr).epsilon(1e-3));
+        }
+    }
+
+
+    SUBCASE("Adam Reduces Training Loss")
+    {
+        auto ma = NeuralNetwork::Computation::Graph::TensorConstructor::create(
+            Matrix::Rows(1), Matrix::Columns(20));
+        auto ground_truth = NeuralNetwork::Computation::Graph::TensorConstructor::create(
+            Matrix::Rows(1), Matrix::Columns(5));
+        ma->release_matrix() = normal_distribution_init(ma->release_matrix());
+        ground_truth->release_matrix().scanStart()[2] = 1;
+
+        NeuralNetwork::Sequential model;
+        model.add(std::make_unique<NeuralNetwork::Layer>(
+            std::make_unique<NeuralNetwork::MatrixMultiplyStep>(Matrix::Rows(20), Matrix::Columns(5)),
+            std::make_unique<NeuralNetwork::AddStep>(Matrix::Columns(5))));
+
+        NeuralNetwork::Computation::Graph::TensorOp CE(Matrix::Operations::Metric::CrossEntropy{});
+        NeuralNetwork::Optimization::Adam adam(model.parameters(), 0.01f);
+
+        float first = 0, last = 0;
+        for (int i = 0; i < 20; i++) {
+            auto loss = CE(ground_truth, model.forward(ma));
+            loss->backwards();
+            adam.step();
+
+            last = loss->release_matrix().get(0, 0);
+            if (i == 0) first = last;
+        }
+
+        CHECK(adam.step_count() == 20);
+        CHECK(last < first);
+    }
+
+}
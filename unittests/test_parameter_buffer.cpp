@@ -0,0 +1,120 @@
+#include "../deps/doctest.h"
+
+#include "../include/matrix.h"
+#include "../include/generator.h"
+#include "../include/tensor.h"
+#include "../include/tensor_factory.h"
+#include "../include/tensor_forward_wrapper.h"
+#include "../include/network_layer.h"
+#include "../include/activation_layer.h"
+#include "../include/parameter_buffer.h"
+#include "../include/optimizer.h"
+
+#include <cstdint>
+#include <vector>
+
+
+TEST_CASE("Flat Parameter Buffer")
+{
+
+    Matrix::Generation::Normal<0, 1> normal_distribution_init;
+
+    auto ma = NeuralNetwork::Computation::Graph::TensorConstructor::create(
+        Matrix::Rows(2), Matrix::Columns(30));
+    auto ground_truth = NeuralNetwork::Computation::Graph::TensorConstructor::create(
+        Matrix::Rows(2), Matrix::Columns(7));
+    ma->release_matrix() = normal_distribution_init(ma->release_matrix());
+    ground_truth->release_matrix().put(0, 3, 1);
+    ground_truth->release_matrix().put(1, 5, 1);
+
+    NeuralNetwork::Sequential model;
+    model.add(std::make_unique<NeuralNetwork::Layer>(
+        std::make_unique<NeuralNetwork::MatrixMultiplyStep>(Matrix::Rows(30), Matrix::Columns(13)),
+        std::make_unique<NeuralNetwork::AddStep>(Matrix::Columns(13))));
+    model.add(std::make_unique<NeuralNetwork::ActivationFunctions::ReLU>());
+    model.add(std::make_unique<NeuralNetwork::Layer>(
+        std::make_unique<NeuralNetwork::MatrixMultiplyStep>(Matrix::Rows(13), Matrix::Columns(7)),
+        std::make_unique<NeuralNetwork::AddStep>(Matrix::Columns(7))));
+
+    auto params = model.parameters();
+    for (auto& param: params) param->release_matrix() = normal_distribution_init(param->release_matrix());
+
+    std::vector<Matrix::Representation> initial;
+    for (auto& param: params) initial.emplace_back(param->release_matrix());
+
+    NeuralNetwork::Computation::Graph::TensorOp CE(Matrix::Operations::Metric::CrossEntropy{});
+
+    auto train = [&](auto& optimizer) {
+        for (int i = 0; i < 5; i++) {
+            auto loss = CE(ground_truth, model.forward(ma));
+            loss->backwards();
+            optimizer.step();
+        }
+    };
+
+    std::vector<Matrix::Representation> expected;
+    {
+        NeuralNetwork::Optimization::SGD sgd(params, 0.05f, 0.9f);
+        train(sgd);
+        for (auto& param: params) expected.emplace_back(param->release_matrix());
+    }
+
+    for (size_t i = 0; i < params.size(); i++) params[i]->release_matrix() = initial[i];
+
+    auto flat = model.flatten();
+
+
+    SUBCASE("Parameters Become Aligned Views")
+    {
+        REQUIRE(flat->parameters().size() == params.size());
+
+        for (size_t i = 0; i < params.size(); i++) {
+
+            auto& matrix = params[i]->release_matrix();
+
+            CHECK(matrix.is_view());
+            CHECK(params[i]->get_grad().is_view());
+            CHECK(matrix.constScanStart() == flat->weights() + flat->offset_of(i));
+            CHECK(reinterpret_cast<std::uintptr_t>(matrix.constScanStart()) %
+                NeuralNetwork::Computation::Graph::ParameterBuffer::ALIGNMENT == 0);
+            CHECK((matrix == Matrix::Representation{initial[i]}) == true);
+        }
+    }
+
+
+    SUBCASE("Flat Optimizer Step Matches Per Parameter Step")
+    {
+        NeuralNetwork::Optimization::SGD sgd(flat, 0.05f, 0.9f);
+        train(sgd);
+
+        for (size_t i = 0; i < params.size(); i++) {
+            for (u_int64_t k = 0; k < expected[i].size(); k++) {
+                CHECK(params[i]->release_matrix().constScanStart()[k] ==
+                    doctest::Approx(expected[i].constScanStart()[k]).epsilon(1e-4));
+            }
+        }
+    }
+
+
+    SUBCASE("Zero Grad, Snapshot And Restore")
+    {
+        auto loss = CE(ground_truth, model.forward(ma));
+        loss->backwards();
+
+        flat->zero_grad();
+        for (size_t k = 0; k < flat->size(); k++) REQUIRE(flat->gradients()[k] == 0);
+
+        std::vector<float> saved(flat->size());
+        flat->snapshot(saved.data());
+
+        NeuralNetwork::Optimization::SGD sgd(flat, 1.0f, 0, false, 0.5f);
+        sgd.step();
+        CHECK((params[0]->release_matrix() == Matrix::Representation{initial[0]}) == false);
+
+        flat->restore(saved.data());
+        for (size_t i = 0; i < params.size(); i++) {
+            CHECK((params[i]->release_matrix() == Matrix::Representation{initial[i]}) == true);
+        }
+    }
+
+}
@@ -0,0 +1,139 @@
+#include "../deps/doctest.h"
+
+#include "../include/matrix.h"
+#include "../include/generator.h"
+#include "../include/m_algorithms.h"
+#include "../include/network_layer.h"
+#include "../include/activation_layer.h"
+#include "../include/inference_engine.h"
+#include "../include/pruning.h"
+#include "../include/sparse.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+
+TEST_CASE("Block Sparse Representation")
+{
+
+    using Block = Matrix::BlockSparseRepresentation;
+
+    // Odd shapes, so the bottom and right edge blocks are partial.
+    Matrix::Representation W = Matrix::Representation(Matrix::Rows(37), Matrix::Columns(29));
+    for (u_int64_t k = 0; k < W.size(); k++) W.scanStart()[k] = std::sin(float(k));
+
+    // Clear every other block of a 4 x 8 grid.
+    for (u_int64_t i = 0; i < 37; i++) {
+        for (u_int64_t j = 0; j < 29; j++) {
+            if ((i / Block::BLOCK_ROWS + j / Block::BLOCK_COLUMNS) % 2) W.put(i, j, 0);
+        }
+    }
+
+    Block w(W);
+
+    CHECK(w.block_rows() == 10);
+    CHECK(w.block_columns() == 4);
+    CHECK(w.blocks() == 20);
+    CHECK(w.density() == doctest::Approx(0.5));
+    CHECK((w.to_dense() == Matrix::Representation{W}) == true);
+
+    Matrix::Operations::Binary::Multiplication::ParallelDNC mul;
+
+    // 4-row tiles and single rows, the serial and the parallel path.
+    for (u_int64_t n: {1, 7, 300}) {
+
+        Matrix::Representation x = Matrix::Representation(Matrix::Rows(n), Matrix::Columns(37));
+        for (u_int64_t k = 0; k < x.size(); k++) x.scanStart()[k] = std::cos(float(k));
+
+        Matrix::Representation expected = mul(x, W);
+        Matrix::Representation y = Matrix::Operations::Sparse::multiply(x, w);
+
+        for (u_int64_t k = 0; k < y.size(); k++) {
+            CHECK(y.constScanStart()[k] == doctest::Approx(expected.constScanStart()[k]).epsilon(1e-4));
+        }
+    }
+}
+
+
+TEST_CASE("Block Magnitude Pruning")
+{
+
+    Matrix::Generation::Normal<0, 1> normal_distribution_init;
+
+    NeuralNetwork::Sequential model;
+    model.add(std::make_unique<NeuralNetwork::Layer>(
+        std::make_unique<NeuralNetwork::MatrixMultiplyStep>(Matrix::Rows(200), Matrix::Columns(120)),
+        std::make_unique<NeuralNetwork::AddStep>(Matrix::Columns(120))));
+    model.add(std::make_unique<NeuralNetwork::ActivationFunctions::ReLU>());
+    model.add(std::make_unique<NeuralNetwork::Layer>(
+        std::make_unique<NeuralNetwork::MatrixMultiplyStep>(Matrix::Rows(120), Matrix::Columns(10)),
+        std::make_unique<NeuralNetwork::AddStep>(Matrix::Columns(10))));
+
+    for (auto& param: model.parameters()) param->release_matrix() = normal_distribution_init(param->release_matrix());
+
+    auto params = model.parameters();
+    Matrix::Representation original = Matrix::Representation{params.front()->release_matrix()};
+
+
+    SUBCASE("Keeps The Largest Blocks")
+    {
+        auto pruned = NeuralNetwork::Inference::prune_blocks(model, 0.9f);
+
+        REQUIRE(pruned.size() == 2);
+        CHECK(pruned[0]->blocks() == 75);
+        CHECK(pruned[0]->density() == doctest::Approx(0.1).epsilon(0.01));
+
+        // The model now holds the pruned weights.
+        const Matrix::Representation& W = params.front()->release_matrix();
+        CHECK((pruned[0]->to_dense() == Matrix::Representation{W}) == true);
+
+        // Every surviving block outweighs every pruned one.
+        float smallest_kept = 1e30f, largest_pruned = 0;
+
+        for (u_int64_t r = 0; r < 50; r++) {
+            for (u_int64_t c = 0; c < 15; c++) {
+
+                float score = 0;
+                bool kept = false;
+
+                for (u_int64_t i = 4 * r; i < 4 * r + 4; i++) {
+                    for (u_int64_t j = 8 * c; j < 8 * c + 8; j++) {
+                        score += original.get(i, j) * original.get(i, j);
+                        kept |= W.get(i, j) != 0;
+                        if (W.get(i, j) != 0) CHECK(W.get(i, j) == original.get(i, j));
+                    }
+                }
+
+                if (kept) smallest_kept = std::min(smallest_kept, score);
+                else largest_pruned = std::max(largest_pruned, score);
+            }
+        }
+
+        CHECK(largest_pruned <= smallest_kept);
+    }
+
+
+    SUBCASE("Sparse Engine Matches The Dense Engine")
+    {
+        auto pruned = NeuralNetwork::Inference::prune_blocks(model, 0.75f);
+
+        NeuralNetwork::Inference::InferenceEngine dense(model, 200);
+        NeuralNetwork::Inference::InferenceEngine sparse(model, 200, pruned);
+
+        REQUIRE(sparse.is_compiled());
+
+        std::vector<float> x(200);
+        for (u_int64_t c = 0; c < 200; c++) x[c] = std::sin(float(c));
+
+        std::vector<float> expected(dense.run(x.data()), dense.run(x.data()) + dense.output_width());
+        const float* y = sparse.run(x.data());
+
+        for (u_int64_t c = 0; c < 10; c++) CHECK(y[c] == doctest::Approx(expected[c]).epsilon(1e-4));
+
+        // Weights pruned for another model do not compile.
+        pruned.pop_back();
+        CHECK(!NeuralNetwork::Inference::InferenceEngine(model, 200, pruned).is_compiled());
+    }
+
+}
@@ -0,0 +1,106 @@
+#include "../deps/doctest.h"
+
+#include "../include/config.h"
+#include "../include/matrix.h"
+#include "../include/generator.h"
+#include "../include/network_layer.h"
+#include "../include/activation_layer.h"
+#include "../include/inference_engine.h"
+#include "../include/quantization.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+
+TEST_CASE("Int8 Quantization")
+{
+
+    SUBCASE("Per Channel Weights")
+    {
+        Matrix::Representation W = Matrix::Representation(Matrix::Rows(3), Matrix::Columns(2));
+        W.put(0, 0,  1.0f);  W.put(0, 1,  0.01f);
+        W.put(1, 0, -0.5f);  W.put(1, 1, -0.02f);
+        W.put(2, 0,  0.25f); W.put(2, 1,  0.005f);
+
+        NeuralNetwork::Inference::QuantizedMatrix q(W);
+
+        CHECK(q.stride == 32);
+        CHECK(q.scales[0] == doctest::Approx(1.0f / 127));
+        CHECK(q.scales[1] == doctest::Approx(0.02f / 127));
+
+        // Column j is row j, every channel uses its full range.
+        CHECK(q.weights[0] == 127);
+        CHECK(q.weights[1] == -64);
+        CHECK(q.weights[32 + 1] == -127);
+        CHECK(q.row_sums[0] == 127 - 64 + 32);
+        CHECK(std::all_of(q.weights.get() + 3, q.weights.get() + 32, [](int8_t w) { return w == 0; }));
+    }
+
+
+    SUBCASE("Dot Product Does Not Saturate")
+    {
+        std::vector<uint8_t> x(64, NeuralNetwork::Inference::ACTIVATION_MAX);
+        std::vector<int8_t>  w(64, NeuralNetwork::Inference::WEIGHT_MAX);
+        w[5] = -NeuralNetwork::Inference::WEIGHT_MAX;
+
+        CHECK(NeuralNetwork::Inference::dot_u8s8(x.data(), w.data(), 64) == 127 * 127 * 62);
+    }
+
+
+    SUBCASE("Close To The fp32 Engine")
+    {
+        constexpr u_int64_t INPUTS = 200;
+        constexpr u_int64_t SAMPLES = 64;
+
+        NeuralNetwork::Sequential model;
+        model.add(std::make_unique<NeuralNetwork::Layer>(
+            std::make_unique<NeuralNetwork::MatrixMultiplyStep>(Matrix::Rows(INPUTS), Matrix::Columns(100)),
+            std::make_unique<NeuralNetwork::AddStep>(Matrix::Columns(100))));
+        model.add(std::make_unique<NeuralNetwork::ActivationFunctions::ReLU>());
+        model.add(std::make_unique<NeuralNetwork::Layer>(
+            std::make_unique<NeuralNetwork::MatrixMultiplyStep>(Matrix::Rows(100), Matrix::Columns(10)),
+            std::make_unique<NeuralNetwork::AddStep>(Matrix::Columns(10))));
+        model.add(std::make_unique<NeuralNetwork::ActivationFunctions::SoftMax>());
+
+        // Weights scaled by fan-in and unit-scale inputs, as a trained model would see.
+        for (auto& param: model.parameters()) {
+            auto& matrix = param->release_matrix();
+            if (matrix.num_rows() > 1) matrix = (1 / DAMPEN / std::sqrt(float(matrix.num_rows()))) * matrix;
+        }
+
+        Matrix::Generation::Normal<0, 1> normal_distribution_init;
+        Matrix::Representation samples = Matrix::Representation(Matrix::Rows(2 * SAMPLES), Matrix::Columns(INPUTS));
+        samples = normal_distribution_init(samples);
+        samples = (1 / DAMPEN) * samples;
+
+        Matrix::Representation calibration = Matrix::Representation(Matrix::Rows(SAMPLES), Matrix::Columns(INPUTS));
+        std::copy(samples.constScanStart(), samples.constScanStart() + SAMPLES * INPUTS, calibration.scanStart());
+
+        NeuralNetwork::Inference::InferenceEngine fp32(model, INPUTS);
+        NeuralNetwork::Inference::QuantizedInferenceEngine int8(model, INPUTS, calibration);
+
+        REQUIRE(int8.is_compiled());
+        CHECK(int8.output_width() == 10);
+        CHECK(int8.weight_bytes() == 100 * 224 + 10 * 128);
+
+        float worst = 0;
+        int agree = 0;
+
+        // Held-out samples, not the calibration ones.
+        for (u_int64_t s = SAMPLES; s < 2 * SAMPLES; s++) {
+
+            const float* x = samples.constScanStart() + s * INPUTS;
+
+            std::vector<float> expected(fp32.run(x), fp32.run(x) + 10);
+            const float* y = int8.run(x);
+
+            for (int c = 0; c < 10; c++) worst = std::max(worst, std::abs(y[c] - expected[c]));
+
+            agree += std::max_element(y, y + 10) - y == std::max_element(expected.begin(), expected.end()) - expected.begin();
+        }
+
+        CHECK(worst < 0.05f);
+        CHECK(agree >= SAMPLES * 9 / 10);
+    }
+}
@@ -0,0 +1,166 @@
+#include "../deps/doctest.h"
+
+#include "../include/matrix.h"
+#include "../include/tensor.h"
+#include "../include/tensor_factory.h"
+#include "../include/tensor_forward_wrapper.h"
+#include "../include/network_layer.h"
+#include "../include/activation_layer.h"
+
+#include <cmath>
+
+
+TEST_CASE("Reverse Pass Buffers")
+{
+
+    auto ma = NeuralNetwork::Computation::Graph::TensorConstructor::create(
+        Matrix::Rows(1), Matrix::Columns(30));
+    auto ground_truth = NeuralNetwork::Computation::Graph::TensorConstructor::create(
+        Matrix::Rows(1), Matrix::Columns(10));
+
+    NeuralNetwork::Sequential model;
+
+    model.add(std::make_unique<NeuralNetwork::Layer>(
+        std::make_unique<NeuralNetwork::MatrixMultiplyStep>(Matrix::Rows(30), Matrix::Columns(20)),
+        std::make_unique<NeuralNetwork::AddStep>(Matrix::Columns(20))));
+    model.add(std::make_unique<NeuralNetwork::ActivationFunctions::ReLU>());
+    model.add(std::make_unique<NeuralNetwork::Layer>(
+        std::make_unique<NeuralNetwork::MatrixMultiplyStep>(Matrix::Rows(20), Matrix::Columns(10)),
+        std::make_unique<NeuralNetwork::AddStep>(Matrix::Columns(10))));
+
+    NeuralNetwork::Computation::Graph::TensorOp CE(Matrix::Operations::Metric::CrossEntropy{});
+
+    auto out  = model.forward(ma);
+    auto loss = CE(ground_truth, out);
+
+
+    SUBCASE("Gradients Are Allocated Lazily")
+    {
+        CHECK(out->has_grad() == false);
+
+        for (auto& param: model.parameters()) {
+            CHECK(param->has_grad() == false);
+        }
+    }
+
+    SUBCASE("Intermediates Are Released After Backward")
+    {
+        loss->backwards();
+
+        CHECK(out->release_matrix().size() == 0);
+        CHECK(out->has_grad() == false);
+
+        CHECK(loss->release_matrix().size() == 1);
+        CHECK(ma->release_matrix().size() == 30);
+
+        for (auto& param: model.parameters()) {
+            CHECK(param->has_grad() == true);
+            CHECK(param->get_grad().size() == param->release_matrix().size());
+        }
+
+        for (auto it = loss->parameters().begin(); it != loss->parameters().end(); ++it) {
+            *it += -0.001 * it.gradient();
+        }
+    }
+
+
+}
+
+
+TEST_CASE("Reverse Pass Diamond")
+{
+
+    /*
+        r feeds two consumers:
+
+            h = x W,  r = relu(h),  s = r ⊙ k1 + r ⊙ k2
+
+        seeded with ones, dr = k1 + k2 and dW = xᵀ (step(h) ⊙ (k1 + k2)).
+    */
+    Matrix::Representation X = Matrix::Representation(Matrix::Rows(4), Matrix::Columns(5));
+    Matrix::Representation W = Matrix::Representation(Matrix::Rows(5), Matrix::Columns(3));
+    Matrix::Representation K1 = Matrix::Representation(Matrix::Rows(4), Matrix::Columns(3));
+    Matrix::Representation K2 = Matrix::Representation(Matrix::Rows(4), Matrix::Columns(3));
+
+    for (u_int64_t k = 0; k < X.size(); k++) X.scanStart()[k] = std::sin(float(k + 1));
+    for (u_int64_t k = 0; k < W.size(); k++) W.scanStart()[k] = std::cos(float(3 * k + 1));
+    for (u_int64_t k = 0; k < K1.size(); k++) K1.scanStart()[k] = float(k % 5) - 2;
+    for (u_int64_t k = 0; k < K2.size(); k++) K2.scanStart()[k] = 0.5f * float(k % 3);
+
+    auto x  = NeuralNetwork::Computation::Graph::TensorConstructor::create(X);
+    auto w  = NeuralNetwork::Computation::Graph::TensorConstructor::create(W);
+    auto k1 = NeuralNetwork::Computation::Graph::TensorConstructor::create(K1);
+    auto k2 = NeuralNetwork::Computation::Graph::TensorConstructor::create(K2);
+
+    NeuralNetwork::Computation::Graph::TensorOp mm(Matrix::Operations::Binary::Multiplication::ParallelDNC{});
+    NeuralNetwork::Computation::Graph::TensorOp relu(Matrix::Operations::Unary::ReLU{});
+    NeuralNetwork::Computation::Graph::TensorOp had(Matrix::Operations::Binary::HadamardProduct::Std{});
+    NeuralNetwork::Computation::Graph::TensorOp add(Matrix::Operations::Binary::Addition::Std{});
+
+    auto expected = [&]() {
+        Matrix::Representation dW = Matrix::Representation(Matrix::Rows(5), Matrix::Columns(3));
+
+        for (u_int64_t i = 0; i < 4; i++) {
+            for (u_int64_t j = 0; j < 3; j++) {
+
+                float h = 0;
+                for (u_int64_t c = 0; c < 5; c++) h += X.get(i, c) * W.get(c, j);
+
+                const float dh = (h >= 0 ? 1.0f : 0.0f) * (K1.get(i, j) + K2.get(i, j));
+                for (u_int64_t c = 0; c < 5; c++) dW.put(c, j, dW.get(c, j) + X.get(i, c) * dh);
+            }
+        }
+
+        return Matrix::Representation{std::move(dW)};
+    };
+
+    auto run = [&]() {
+        auto h = mm(x, w);
+        auto r = relu(h);
+        auto s = add(had(r, k1), had(r, k2));
+        s->backwards();
+
+        CHECK(h->release_matrix().size() == 0);
+        CHECK(r->release_matrix().size() == 0);
+    };
+
+    Matrix::Representation dW = expected();
+
+
+    SUBCASE("Shared Intermediate Sums Both Consumers")
+    {
+        run();
+
+        REQUIRE(w->get_grad().num_rows() == 5);
+        REQUIRE(w->get_grad().num_cols() == 3);
+
+        for (u_int64_t k = 0; k < dW.size(); k++) {
+            CHECK(w->get_grad().constScanStart()[k] == doctest::Approx(dW.constScanStart()[k]).epsilon(1e-4));
+        }
+    }
+
+
+    SUBCASE("Overwrite Mode Starts Each Pass Fresh")
+    {
+        run();
+        run();
+
+        for (u_int64_t k = 0; k < dW.size(); k++) {
+            CHECK(w->get_grad().constScanStart()[k] == doctest::Approx(dW.constScanStart()[k]).epsilon(1e-4));
+        }
+    }
+
+
+    SUBCASE("Accumulate Mode Sums Passes")
+    {
+        w->set_accumulate_grad(true);
+
+        run();
+        run();
+
+        for (u_int64_t k = 0; k < dW.size(); k++) {
+            CHECK(w->get_grad().constScanStart()[k] == doctest::Approx(2 * dW.constScanStart()[k]).epsilon(1e-4));
+        }
+    }
+
+}
@@ -0,0 +1,235 @@
+#include "../deps/doctest.h"
+
+#include "../include/matrix.h"
+#include "../include/generator.h"
+#include "../include/m_algorithms.h"
+#include "../include/tensor.h"
+#include "../include/tensor_factory.h"
+#include "../include/tensor_forward_wrapper.h"
+#include "../include/network_layer.h"
+#include "../include/activation_layer.h"
+#include "../include/sparse.h"
+
+#include <cmath>
+#include <memory>
+#include <vector>
+
+
+namespace {
+
+    // Roughly one entry in `every` is a small nonzero count, the rest are zeros.
+    Matrix::Representation bag_of_words(u_int64_t rows, u_int64_t columns, u_int64_t every) {
+
+        Matrix::Representation m = Matrix::Representation(Matrix::Rows(rows), Matrix::Columns(columns));
+
+        for (u_int64_t k = 0; k < m.size(); k++) {
+            if ((k * 2654435761u) % every == 0) m.scanStart()[k] = float(1 + k % 3);
+        }
+
+        return Matrix::Representation{std::move(m)};
+    }
+
+}
+
+
+TEST_CASE("Sparse Representation")
+{
+
+    Matrix::Representation dense = bag_of_words(7, 40, 9);
+
+    Matrix::SparseRepresentation x(dense);
+
+    u_int64_t expected = 0;
+    for (u_int64_t k = 0; k < dense.size(); k++) expected += dense.constScanStart()[k] != 0;
+
+    CHECK(x.nonzeros() == expected);
+    CHECK(x.row_offsets().size() == 8);
+    CHECK(x.density() < 0.2);
+    CHECK((x.to_dense() == Matrix::Representation{dense}) == true);
+
+    Matrix::Operations::Unary::Transpose transpose;
+    CHECK((x.transpose().to_dense() == transpose(dense)) == true);
+
+    Matrix::SparseRepresentation y(Matrix::Rows(2), Matrix::Columns(50000), {0, 2, 3}, {7, 4096, 12}, {1.0f, 3.0f, 1.0f});
+
+    CHECK(y.row_nonzeros(0) == 2);
+    CHECK(y.to_dense().get(0, 4096) == 3.0f);
+    CHECK(y.to_dense().get(1, 12) == 1.0f);
+    CHECK(y.bytes() < 100);
+}
+
+
+TEST_CASE("Sparse Kernels")
+{
+
+    Matrix::Generation::Normal<0, 1> normal_distribution_init;
+
+    Matrix::Representation dense = bag_of_words(33, 500, 50);
+    Matrix::SparseRepresentation x(dense);
+
+    Matrix::Representation W = Matrix::Representation(Matrix::Rows(500), Matrix::Columns(19));
+    W = normal_distribution_init(W);
+
+    Matrix::Representation g = Matrix::Representation(Matrix::Rows(33), Matrix::Columns(19));
+    g = normal_distribution_init(g);
+
+    Matrix::Operations::Binary::Multiplication::ParallelDNC mul;
+    Matrix::Operations::Unary::Transpose transpose;
+
+
+    SUBCASE("Multiply Matches The Dense Product")
+    {
+        Matrix::Representation expected = mul(dense, W);
+        Matrix::Representation z = Matrix::Operations::Sparse::multiply(x, W);
+
+        for (u_int64_t k = 0; k < z.size(); k++) {
+            CHECK(z.constScanStart()[k] == doctest::Approx(expected.constScanStart()[k]).epsilon(1e-4));
+        }
+    }
+
+
+    SUBCASE("Weight Gradient Writes Only Touched Rows")
+    {
+        Matrix::Representation expected = mul(transpose(dense), g);
+
+        // Untouched rows must keep whatever they held.
+        Matrix::Representation dW = Matrix::Representation(Matrix::Rows(500), Matrix::Columns(19));
+        std::fill(dW.scanStart(), dW.scanEnd(), 1.0f);
+
+        const u_int64_t touched = Matrix::Operations::Sparse::accumulate_transpose_product(x, g, dW);
+
+        u_int64_t used = 0;
+
+        for (u_int64_t k = 0; k < 500; k++) {
+
+            bool any = false;
+            for (u_int64_t i = 0; i < 33; i++) any |= dense.get(i, k) != 0;
+            used += any;
+
+            for (u_int64_t j = 0; j < 19; j++) {
+                CHECK(dW.get(k, j) == doctest::Approx(1.0f + expected.get(k, j)).epsilon(1e-4));
+            }
+        }
+
+        CHECK(touched == used);
+        CHECK(touched < 500);
+    }
+
+}
+
+
+TEST_CASE("Sparse Input Training")
+{
+
+    constexpr u_int64_t BATCH = 16;
+    constexpr u_int64_t FEATURES = 300;
+
+    Matrix::Generation::Normal<0, 1> normal_distribution_init;
+
+    NeuralNetwork::Sequential model;
+    model.add(std::make_unique<NeuralNetwork::Layer>(
+        std::make_unique<NeuralNetwork::MatrixMultiplyStep>(Matrix::Rows(FEATURES), Matrix::Columns(8)),
+        std::make_unique<NeuralNetwork::AddStep>(Matrix::Columns(8))));
+    model.add(std::make_unique<NeuralNetwork::ActivationFunctions::ReLU>());
+    model.add(std::make_unique<NeuralNetwork::Layer>(
+        std::make_unique<NeuralNetwork::MatrixMultiplyStep>(Matrix::Rows(8), Matrix::Columns(3)),
+        std::make_unique<NeuralNetwork::AddStep>(Matrix::Columns(3))));
+
+    for (auto& param: model.parameters()) param->release_matrix() = normal_distribution_init(param->release_matrix());
+
+    Matrix::Representation inputs = bag_of_words(BATCH, FEATURES, 40);
+    Matrix::Representation labels = Matrix::Representation(Matrix::Rows(BATCH), Matrix::Columns(3));
+    for (u_int64_t i = 0; i < BATCH; i++) labels.put(i, i % 3, 1);
+
+    auto sparse = std::make_shared<const Matrix::SparseRepresentation>(inputs);
+
+    NeuralNetwork::Computation::Graph::TensorOp CE(Matrix::Operations::Metric::CrossEntropy{});
+
+    auto run = [&](bool use_sparse) {
+        auto y = NeuralNetwork::Computation::Graph::TensorConstructor::create(labels);
+        auto x = NeuralNetwork::Computation::Graph::TensorConstructor::create(inputs);
+
+        auto loss = CE(y, use_sparse ? model.forward_sparse(sparse) : model.forward(x));
+        loss->backwards();
+
+        std::vector<Matrix::Representation> grads;
+        for (auto& param: model.parameters()) grads.emplace_back(param->get_grad());
+        return grads;
+    };
+
+    auto check_matches = [](const std::vector<Matrix::Representation>& a, const std::vector<Matrix::Representation>& b, float factor) {
+        REQUIRE(a.size() == b.size());
+        for (size_t p = 0; p < a.size(); p++) {
+            for (u_int64_t k = 0; k < a[p].size(); k++) {
+                CHECK(a[p].constScanStart()[k] == doctest::Approx(factor * b[p].constScanStart()[k]).epsilon(1e-4));
+            }
+        }
+    };
+
+
+    SUBCASE("Gradients Match The Dense Input")
+    {
+        auto expected = run(false);
+        auto grads = run(true);
+
+        check_matches(grads, expected, 1.0f);
+
+        // A feature no sample has gets no weight gradient.
+        for (u_int64_t k = 0; k < FEATURES; k++) {
+            bool any = false;
+            for (u_int64_t i = 0; i < BATCH; i++) any |= inputs.get(i, k) != 0;
+            if (!any) CHECK(grads.front().get(k, 0) == 0.0f);
+        }
+    }
+
+
+    SUBCASE("Overwrite And Accumulate Modes")
+    {
+        auto expected = run(false);
+
+        run(true);
+        check_matches(run(true), expected, 1.0f);
+
+        model.accumulate_gradients(true);
+        model.zero_grad();
+
+        run(true);
+        check_matches(run(true), expected, 2.0f);
+    }
+
+
+    SUBCASE("Rows A Previous Batch Touched Are Cleared")
+    {
+        auto expected = run(false);
+
+        auto other = std::make_shared<const Matrix::SparseRepresentation>(bag_of_words(BATCH, FEATURES, 7));
+
+        auto step = [&](std::shared_ptr<const Matrix::SparseRepresentation> batch) {
+            auto y = NeuralNetwork::Computation::Graph::TensorConstructor::create(labels);
+            CE(y, model.forward_sparse(batch))->backwards();
+        };
+
+        step(other);
+        check_matches(run(true), expected, 1.0f);
+
+        model.flatten();
+
+        step(other);
+        check_matches(run(true), expected, 1.0f);
+    }
+
+
+    SUBCASE("Inference Without The Graph")
+    {
+        auto y = model.forward(NeuralNetwork::Computation::Graph::TensorConstructor::create(inputs));
+
+        NeuralNetwork::Computation::Graph::NoGradGuard no_grad;
+
+        auto z = model.forward_sparse(sparse);
+
+        for (u_int64_t k = 0; k < z->release_matrix().size(); k++) {
+            CHECK(z->release_matrix().constScanStart()[k] == doctest::Approx(y->release_matrix().constScanStart()[k]).epsilon(1e-4));
+        }
+    }
+
+}